@@ -31,6 +31,10 @@
 #include "applier.h"
 
 #include <msgpuck.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
 
 #include "xlog.h"
 #include "fiber.h"
@@ -38,6 +42,8 @@
 #include "iostream.h"
 #include "coio.h"
 #include "coio_buf.h"
+#include "coio_file.h"
+#include "crc32.h"
 #include "wal.h"
 #include "xrow.h"
 #include "replication.h"
@@ -50,7 +56,10 @@
 #include "session.h"
 #include "cfg.h"
 #include "schema.h"
+#include "space.h"
+#include "index.h"
 #include "txn.h"
+#include "memtx_tx.h"
 #include "box.h"
 #include "xrow.h"
 #include "scoped_guard.h"
@@ -106,6 +115,7 @@ applier_log_error(struct applier *applier, struct error *e)
 	case APPLIER_FOLLOW:
 	case APPLIER_INITIAL_JOIN:
 	case APPLIER_FINAL_JOIN:
+	case APPLIER_FETCH_CHECKPOINT:
 		say_info("can't read row");
 		break;
 	default:
@@ -541,6 +551,218 @@ applier_fetch_snapshot(struct applier *applier)
 	applier_set_state(applier, APPLIER_READY);
 }
 
+/**
+ * Format the path to store a checkpoint file received from
+ * the master at: snapshots go to memtx_dir, all other files
+ * go to vinyl_dir, see box_process_fetch_checkpoint().
+ */
+static void
+applier_checkpoint_file_path(const struct file_request *file,
+			     char *path, size_t size)
+{
+	if (file->name_len == 0 || file->name[0] == '/' ||
+	    memmem(file->name, file->name_len, "..", 2) != NULL ||
+	    memchr(file->name, '\0', file->name_len) != NULL) {
+		tnt_raise(ClientError, ER_INVALID_MSGPACK,
+			  "invalid file name");
+	}
+	const char *name = tt_cstr(file->name, file->name_len);
+	const char *ext = strrchr(name, '.');
+	const char *dir = ext != NULL && strcmp(ext, ".snap") == 0 ?
+			  cfg_gets("memtx_dir") : cfg_gets("vinyl_dir");
+	if (snprintf(path, size, "%s/%s", dir, name) >= (int)size) {
+		tnt_raise(ClientError, ER_INVALID_MSGPACK,
+			  "invalid file name");
+	}
+}
+
+/**
+ * Receive a checkpoint file sent by relay_send_file() and write it
+ * to @path with the ".inprogress" suffix. The instance UUID stored
+ * in the meta of snapshot and vylog files is replaced with the UUID
+ * of this instance, because otherwise recovery would refuse to load
+ * them. The caller is supposed to rename the file once it's done.
+ */
+static void
+applier_recv_file(struct applier *applier, const struct file_request *file,
+		  const char *path)
+{
+	struct iostream *io = &applier->io;
+	struct ibuf *ibuf = &applier->ibuf;
+	struct xrow_header row;
+
+	const char *ext = strrchr(path, '.');
+	bool is_xlog = ext != NULL && (strcmp(ext, ".snap") == 0 ||
+				       strcmp(ext, ".vylog") == 0);
+	char tmp_path[PATH_MAX];
+	snprintf(tmp_path, sizeof(tmp_path), "%s.inprogress", path);
+	if (mkdirpath(tmp_path) != 0) {
+		diag_set(SystemError, "failed to create path '%s'", tmp_path);
+		diag_raise();
+	}
+	int fd = coio_file_open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		diag_set(SystemError, "failed to open file '%s'", tmp_path);
+		diag_raise();
+	}
+	auto fd_guard = make_scoped_guard([=] { coio_file_close(fd); });
+
+	uint64_t offset = 0;
+	uint32_t crc32 = 0;
+	struct file_request chunk;
+	while (true) {
+		coio_read_xrow(io, ibuf, &row);
+		applier->last_row_time = ev_monotonic_now(loop());
+		if (iproto_type_is_error(row.type)) {
+			xrow_decode_error_xc(&row);
+		} else if (row.type == IPROTO_FILE_END) {
+			break;
+		} else if (row.type != IPROTO_FILE_DATA) {
+			tnt_raise(ClientError, ER_UNKNOWN_REQUEST_TYPE,
+				  (uint32_t)row.type);
+		}
+		xrow_decode_file_xc(&row, &chunk);
+		if (offset + chunk.data_len > file->size)
+			break;
+		crc32 = crc32_calc(crc32, chunk.data, chunk.data_len);
+		/* The meta is checked by the CRC in its original form. */
+		if (offset == 0 && is_xlog &&
+		    xlog_meta_set_instance_uuid((char *)chunk.data,
+						chunk.data_len,
+						&INSTANCE_UUID) != 0)
+			diag_raise();
+		if (coio_pwrite(fd, chunk.data, chunk.data_len,
+				offset) < 0) {
+			diag_set(SystemError, "failed to write file '%s'",
+				 tmp_path);
+			diag_raise();
+		}
+		offset += chunk.data_len;
+	}
+	xrow_decode_file_xc(&row, &chunk);
+	if (row.type != IPROTO_FILE_END || offset != file->size ||
+	    chunk.crc32 != crc32) {
+		tnt_raise(ClientError, ER_INVALID_MSGPACK,
+			  tt_sprintf("corrupted file '%s'", path));
+	}
+	if (coio_fsync(fd) < 0) {
+		diag_set(SystemError, "failed to sync file '%s'", tmp_path);
+		diag_raise();
+	}
+}
+
+/**
+ * Rename a checkpoint file received by applier_recv_file().
+ */
+static void
+applier_commit_file(const char *path)
+{
+	const char *tmp_path = tt_sprintf("%s.inprogress", path);
+	if (coio_rename(tmp_path, path) < 0) {
+		diag_set(SystemError, "failed to rename file '%s'", tmp_path);
+		diag_raise();
+	}
+}
+
+/**
+ * Execute and process FETCH_CHECKPOINT request: download the files
+ * of the last checkpoint of the master to the local directories.
+ * The instance is then recovered from the files as from a backup
+ * and registered, see bootstrap_from_checkpoint().
+ *
+ * Returns false if the master doesn't support the request, in
+ * which case the instance must be bootstrapped with JOIN.
+ */
+static bool
+applier_fetch_checkpoint(struct applier *applier)
+{
+	if (applier->fetch_checkpoint_is_unsupported)
+		return false;
+
+	/* Send FETCH_CHECKPOINT request */
+	struct iostream *io = &applier->io;
+	struct ibuf *ibuf = &applier->ibuf;
+	struct xrow_header row;
+
+	xrow_encode_fetch_checkpoint_xc(&row, &INSTANCE_UUID);
+	coio_write_xrow(io, &row);
+	coio_read_xrow(io, ibuf, &row);
+	if (iproto_type_is_error(row.type)) try {
+		xrow_decode_error_xc(&row);
+	} catch (ClientError *e) {
+		if (e->errcode() != ER_UNKNOWN_REQUEST_TYPE)
+			e->raise();
+		/*
+		 * Master isn't aware of FETCH_CHECKPOINT request.
+		 * Let bootstrap_from_checkpoint() know that it has
+		 * to fall back on JOIN. Don't yield in the catch block,
+		 * see applier_f().
+		 */
+		applier->fetch_checkpoint_is_unsupported = true;
+	}
+	if (applier->fetch_checkpoint_is_unsupported) {
+		say_info("master doesn't support checkpoint fetching, "
+			 "falling back on join");
+		applier_set_state(applier, APPLIER_FETCH_CHECKPOINT);
+		applier_set_state(applier, APPLIER_READY);
+		return false;
+	}
+	if (row.type != IPROTO_OK) {
+		tnt_raise(ClientError, ER_UNKNOWN_REQUEST_TYPE,
+			  (uint32_t)row.type);
+	}
+	struct vclock vclock;
+	xrow_decode_vclock_xc(&row, &vclock);
+	say_info("fetching checkpoint %s", vclock_to_string(&vclock));
+
+	applier_set_state(applier, APPLIER_FETCH_CHECKPOINT);
+
+	/*
+	 * The snapshot is renamed last so that a failure to
+	 * download the rest of the files doesn't leave a valid
+	 * checkpoint behind.
+	 */
+	char snap_path[PATH_MAX] = "";
+	uint64_t file_count = 0;
+	uint64_t byte_count = 0;
+	while (true) {
+		coio_read_xrow(io, ibuf, &row);
+		applier->last_row_time = ev_monotonic_now(loop());
+		if (iproto_type_is_error(row.type)) {
+			xrow_decode_error_xc(&row);
+		} else if (row.type == IPROTO_OK) {
+			break;
+		} else if (row.type != IPROTO_FILE) {
+			tnt_raise(ClientError, ER_UNKNOWN_REQUEST_TYPE,
+				  (uint32_t)row.type);
+		}
+		struct file_request file;
+		xrow_decode_file_xc(&row, &file);
+		char path[PATH_MAX];
+		applier_checkpoint_file_path(&file, path, sizeof(path));
+		applier_recv_file(applier, &file, path);
+		const char *ext = strrchr(path, '.');
+		if (ext != NULL && strcmp(ext, ".snap") == 0)
+			strlcpy(snap_path, path, sizeof(snap_path));
+		else
+			applier_commit_file(path);
+		file_count++;
+		byte_count += file.size;
+		say_info_ratelimited("%llu files received, %.1f MB",
+				     (unsigned long long)file_count,
+				     byte_count / 1e6);
+	}
+	if (*snap_path == '\0')
+		tnt_raise(ClientError, ER_MISSING_SNAPSHOT);
+	applier_commit_file(snap_path);
+
+	say_info("checkpoint received: %llu files, %.1f MB",
+		 (unsigned long long)file_count, byte_count / 1e6);
+
+	applier_set_state(applier, APPLIER_FETCHED_CHECKPOINT);
+	return true;
+}
+
 struct applier_read_ctx {
 	struct ibuf *ibuf;
 	struct applier_tx_row *(*alloc_row)(struct applier *);
@@ -1033,9 +1255,15 @@ applier_handle_raft_request(struct applier *applier, struct raft_request *req)
 	return box_raft_process(req, applier->instance_id);
 }
 
-static int
-apply_plain_tx(uint32_t replica_id, struct stailq *rows,
-	       bool skip_conflict, bool use_triggers)
+/**
+ * Execute all rows of a transaction received from a master,
+ * but don't commit it. Returns the transaction ready to be
+ * committed or NULL on error, in which case the transaction
+ * is rolled back.
+ */
+static struct txn *
+apply_plain_tx_prepare(uint32_t replica_id, struct stailq *rows,
+		       bool skip_conflict, bool use_triggers)
 {
 	/*
 	 * Explicitly begin the transaction so that we can
@@ -1046,7 +1274,7 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 	struct txn *txn = txn_begin();
 	struct applier_tx_row *item;
 	if (txn == NULL)
-		 return -1;
+		 return NULL;
 
 	stailq_foreach_entry(item, rows, next) {
 		struct xrow_header *row = &item->row;
@@ -1127,11 +1355,21 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 		trigger_create(on_wal_write, applier_txn_wal_write_cb, rcb, NULL);
 		txn_on_wal_write(txn, on_wal_write);
 	}
-
-	return txn_commit_try_async(txn);
+	return txn;
 fail:
 	txn_abort(txn);
-	return -1;
+	return NULL;
+}
+
+static int
+apply_plain_tx(uint32_t replica_id, struct stailq *rows,
+	       bool skip_conflict, bool use_triggers)
+{
+	struct txn *txn = apply_plain_tx_prepare(replica_id, rows,
+						 skip_conflict, use_triggers);
+	if (txn == NULL)
+		return -1;
+	return txn_commit_try_async(txn);
 }
 
 /** A simpler version of applier_apply_tx() for final join stage. */
@@ -1460,6 +1698,307 @@ applier_handle_raft(struct applier *applier, struct applier_tx_row *txr)
 	return 0;
 }
 
+enum {
+	/**
+	 * Max number of keys modified by transactions applied
+	 * concurrently. A transaction that modifies more keys
+	 * is applied alone.
+	 */
+	APPLIER_APPLY_GROUP_KEYS_MAX = 1024,
+};
+
+/**
+ * A group of transactions received from a master that modify
+ * different keys and so can be applied concurrently, each in
+ * its own fiber. This helps when applying a transaction yields,
+ * e.g. on a Vinyl disk read. Transactions are still committed
+ * strictly in the order they were received in so that the WAL
+ * gets them in the LSN order. Since commits don't wait for WAL,
+ * all transactions of a group are submitted to WAL in one batch.
+ */
+struct applier_apply_group {
+	/** The applier the transactions were received by. */
+	struct applier *applier;
+	/** Order latch of the instance that originated the rows. */
+	struct latch *latch;
+	/** Id of the instance that originated the rows. */
+	uint32_t replica_id;
+	/** Number of transactions in the group. */
+	int tx_count;
+	/** Number of transactions that haven't been committed yet. */
+	int active_count;
+	/** Sequence number of the transaction to commit next. */
+	int next_commit;
+	/** Set if any transaction of the group failed to apply. */
+	bool is_failed;
+	/** Error of the first failed transaction. */
+	struct diag diag;
+	/** Signaled when a transaction is committed. */
+	struct fiber_cond cond;
+	/** Number of keys in the key_hashes array. */
+	int key_count;
+	/** Hashes of the keys modified by the transactions. */
+	uint32_t key_hashes[APPLIER_APPLY_GROUP_KEYS_MAX];
+};
+
+static void
+applier_apply_group_create(struct applier_apply_group *group,
+			   struct applier *applier)
+{
+	memset(group, 0, sizeof(*group));
+	group->applier = applier;
+	diag_create(&group->diag);
+	fiber_cond_create(&group->cond);
+}
+
+static void
+applier_apply_group_destroy(struct applier_apply_group *group)
+{
+	diag_destroy(&group->diag);
+	fiber_cond_destroy(&group->cond);
+}
+
+/**
+ * Wait for all transactions of a group to complete and release
+ * the order latch.
+ */
+static void
+applier_apply_group_join(struct applier_apply_group *group)
+{
+	while (group->active_count > 0)
+		fiber_cond_wait(&group->cond);
+	if (group->latch != NULL)
+		latch_unlock(group->latch);
+	group->latch = NULL;
+}
+
+/**
+ * Wait for all transactions of a group to complete and reset
+ * the group so that it can be reused. Returns -1 and sets diag
+ * if any of the transactions failed.
+ */
+static int
+applier_apply_group_flush(struct applier_apply_group *group)
+{
+	applier_apply_group_join(group);
+	if (group->tx_count > 0) {
+		group->applier->apply_tx_count += group->tx_count;
+		group->applier->apply_group_count++;
+	}
+	group->tx_count = 0;
+	group->next_commit = 0;
+	group->key_count = 0;
+	if (group->is_failed) {
+		group->is_failed = false;
+		diag_move(&group->diag, diag_get());
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Check if rows of a space may be applied concurrently with
+ * other transactions given that they modify different primary
+ * keys. It isn't so if applying a row may read or modify other
+ * keys, e.g. because of a unique secondary index or a trigger,
+ * or if the engine doesn't allow yields in transactions.
+ */
+static bool
+applier_space_allows_parallel_apply(struct space *space)
+{
+	if (space_is_system(space) || space->index_count == 0 ||
+	    space_index(space, 0) == NULL)
+		return false;
+	/*
+	 * A transaction of a group is prepared first and then waits
+	 * for the preceding transactions to be committed. Without
+	 * MVCC, memtx aborts a transaction that yields.
+	 */
+	if (space_is_memtx(space) && !memtx_tx_manager_use_mvcc_engine)
+		return false;
+	if (!rlist_empty(&space->before_replace) ||
+	    !rlist_empty(&space->on_replace) ||
+	    space->sql_triggers != NULL)
+		return false;
+	if (space->has_foreign_keys ||
+	    !rlist_empty(&space->space_cache_pin_list) ||
+	    !rlist_empty(&space->parent_fk_constraint) ||
+	    !rlist_empty(&space->child_fk_constraint))
+		return false;
+	for (uint32_t i = 1; i < space->index_count; i++) {
+		if (space->index[i]->def->opts.is_unique)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Calculate hashes of the primary keys modified by a transaction.
+ * Returns the number of hashes stored in @a hashes or -1 if the
+ * transaction can't be applied concurrently with others.
+ */
+static int
+applier_tx_key_hashes(struct stailq *rows, uint32_t *hashes, int max)
+{
+	int count = 0;
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, rows, next) {
+		struct request *request = &item->req.dml;
+		if (request->type == IPROTO_NOP)
+			continue;
+		if (count >= max)
+			return -1;
+		struct space *space = space_by_id(request->space_id);
+		if (space == NULL ||
+		    !applier_space_allows_parallel_apply(space))
+			return -1;
+		struct key_def *key_def = space_index(space, 0)->def->key_def;
+		const char *key;
+		switch (request->type) {
+		case IPROTO_INSERT:
+		case IPROTO_REPLACE:
+		case IPROTO_UPSERT:
+			key = tuple_extract_key_raw(request->tuple,
+						    request->tuple_end,
+						    key_def, MULTIKEY_NONE,
+						    NULL);
+			break;
+		case IPROTO_DELETE:
+		case IPROTO_UPDATE:
+			key = request->index_id == 0 ? request->key : NULL;
+			break;
+		default:
+			key = NULL;
+			break;
+		}
+		if (key == NULL) {
+			diag_clear(diag_get());
+			return -1;
+		}
+		uint32_t part_count = mp_decode_array(&key);
+		if (part_count != key_def->part_count ||
+		    exact_key_validate(key_def, key, part_count) != 0) {
+			diag_clear(diag_get());
+			return -1;
+		}
+		hashes[count++] = key_hash(key, key_def) ^
+				  (request->space_id * 0x9e3779b1);
+	}
+	return count;
+}
+
+/** Apply a transaction of a group in a separate fiber. */
+static int
+applier_apply_group_f(va_list ap)
+{
+	struct applier_apply_group *group =
+		va_arg(ap, struct applier_apply_group *);
+	struct stailq *rows = va_arg(ap, struct stailq *);
+	int seq = va_arg(ap, int);
+	struct xrow_header *last_row =
+		&stailq_last_entry(rows, struct applier_tx_row, next)->row;
+	struct txn *txn = apply_plain_tx_prepare(
+		group->applier->instance_id, rows,
+		replication_skip_conflict, true);
+	/* Wait for the preceding transactions to be committed. */
+	while (group->next_commit != seq)
+		fiber_cond_wait(&group->cond);
+	int rc = -1;
+	if (txn != NULL && group->is_failed) {
+		/*
+		 * A preceding transaction failed, so committing
+		 * this one would leave a gap in the vclock.
+		 */
+		txn_abort(txn);
+		rc = 0;
+	} else if (txn != NULL) {
+		rc = txn_commit_try_async(txn);
+		if (rc == 0) {
+			vclock_follow(&replicaset.applier.vclock,
+				      last_row->replica_id, last_row->lsn);
+		}
+	}
+	if (rc != 0 && !group->is_failed) {
+		group->is_failed = true;
+		diag_move(diag_get(), &group->diag);
+	}
+	group->next_commit++;
+	group->active_count--;
+	fiber_cond_broadcast(&group->cond);
+	return 0;
+}
+
+/**
+ * Try to add a transaction to a group of concurrently applied
+ * transactions and start applying it. Returns true if the
+ * transaction was added or skipped because it had already been
+ * applied, false if it can't be added to the group.
+ */
+static bool
+applier_apply_group_add(struct applier_apply_group *group,
+			struct stailq *rows)
+{
+	struct xrow_header *first_row =
+		&stailq_first_entry(rows, struct applier_tx_row, next)->row;
+	struct xrow_header *last_row =
+		&stailq_last_entry(rows, struct applier_tx_row, next)->row;
+	if (first_row->lsn == 0 ||
+	    iproto_type_is_synchro_request(first_row->type))
+		return false;
+	if (group->tx_count >= replication_apply_parallelism)
+		return false;
+	/*
+	 * The group holds the order latch of the first origin even if
+	 * it hasn't started any transaction yet, because the ones added
+	 * before were already applied. Don't admit another origin then,
+	 * otherwise its transactions may be applied twice in full mesh.
+	 */
+	if (group->latch != NULL && first_row->replica_id != group->replica_id)
+		return false;
+	uint32_t *hashes = group->key_hashes + group->key_count;
+	int count = applier_tx_key_hashes(rows, hashes,
+			APPLIER_APPLY_GROUP_KEYS_MAX - group->key_count);
+	if (count < 0)
+		return false;
+	for (int i = 0; i < count; i++) {
+		for (int j = 0; j < group->key_count; j++) {
+			if (hashes[i] == group->key_hashes[j])
+				return false;
+		}
+	}
+	if (group->latch == NULL) {
+		assert(group->tx_count == 0);
+		struct replica *replica = replica_by_id(first_row->replica_id);
+		group->latch = replica != NULL ? &replica->order_latch :
+			       &replicaset.applier.order_latch;
+		group->replica_id = first_row->replica_id;
+		latch_lock(group->latch);
+	}
+	if (vclock_get(&replicaset.applier.vclock,
+		       last_row->replica_id) >= last_row->lsn)
+		return true;
+	if (vclock_get(&replicaset.applier.vclock,
+		       first_row->replica_id) >= first_row->lsn) {
+		/*
+		 * Part of the transaction has already been applied,
+		 * let applier_apply_tx() handle it.
+		 */
+		return false;
+	}
+	applier_synchro_filter_tx(rows);
+	struct fiber *f = fiber_new("applier_apply", applier_apply_group_f);
+	if (f == NULL) {
+		diag_log();
+		return false;
+	}
+	fiber_set_session(f, current_session());
+	fiber_set_user(f, effective_user());
+	group->key_count += count;
+	group->active_count++;
+	fiber_start(f, group, rows, group->tx_count++);
+	return true;
+}
+
 /**
  * The tx part of applier-in-thread machinery. Apply all the parsed
  * transactions.
@@ -1469,12 +2008,36 @@ applier_process_batch(struct cmsg *base)
 {
 	struct applier_data_msg *msg = (struct applier_data_msg *)base;
 	struct applier *applier = msg->base.applier;
+	bool is_parallel = replication_apply_parallelism > 1 &&
+			   applier->state != APPLIER_FINAL_JOIN;
+	struct applier_apply_group group;
+	applier_apply_group_create(&group, applier);
+	auto group_guard = make_scoped_guard([&] {
+		/* Don't leave running fibers referencing the group. */
+		applier_apply_group_join(&group);
+		applier_apply_group_destroy(&group);
+	});
 	struct applier_tx *tx;
 	stailq_foreach_entry(tx, &msg->txs, next) {
 		struct applier_tx_row *txr =
 			stailq_first_entry(&tx->rows, struct applier_tx_row,
 					    next);
 		raft_process_heartbeat(box_raft(), applier->instance_id);
+		if (is_parallel) {
+			if (applier_apply_group_add(&group, &tx->rows))
+				continue;
+			/*
+			 * The transaction conflicts with the group
+			 * or can't be applied concurrently at all.
+			 * Flush the group and retry.
+			 */
+			if (applier_apply_group_flush(&group) != 0)
+				diag_raise();
+			if (applier_apply_group_add(&group, &tx->rows))
+				continue;
+			if (applier_apply_group_flush(&group) != 0)
+				diag_raise();
+		}
 		if (txr->row.lsn == 0) {
 			if (applier_handle_raft(applier, txr) != 0)
 				diag_raise();
@@ -1482,6 +2045,9 @@ applier_process_batch(struct cmsg *base)
 			applier_check_sync(applier);
 		} else if (applier_apply_tx(applier, &tx->rows) != 0) {
 			diag_raise();
+		} else {
+			applier->apply_tx_count++;
+			applier->apply_group_count++;
 		}
 		if (applier->state == APPLIER_FINAL_JOIN &&
 		    instance_id != REPLICA_ID_NIL) {
@@ -1491,6 +2057,8 @@ applier_process_batch(struct cmsg *base)
 			applier_set_state(applier, APPLIER_FOLLOW);
 		}
 	}
+	if (applier_apply_group_flush(&group) != 0)
+		diag_raise();
 
 	/* Return the message to applier thread. */
 	cmsg_init(&msg->base.base, return_route);
@@ -1952,7 +2520,9 @@ applier_subscribe(struct applier *applier)
 	 */
 	uint32_t id_filter = box_is_orphan() ? 0 : 1 << instance_id;
 	xrow_encode_subscribe_xc(&row, &REPLICASET_UUID, &INSTANCE_UUID,
-				 &vclock, replication_anon, id_filter);
+				 &vclock, replication_anon, id_filter,
+				 applier->space_filter,
+				 applier->space_filter_size);
 	coio_write_xrow(io, &row);
 
 	/* Read SUBSCRIBE response */
@@ -2116,10 +2686,18 @@ applier_f(va_list ap)
 				 *
 				 * The join will pause the applier
 				 * until WAL is created.
+				 *
+				 * If replication_bootstrap_files is set,
+				 * try to download the master's checkpoint
+				 * and then register like an anonymous
+				 * replica does.
 				 */
 				was_anon = replication_anon;
 				if (replication_anon)
 					applier_fetch_snapshot(applier);
+				else if (replication_bootstrap_files &&
+					 applier_fetch_checkpoint(applier))
+					was_anon = true;
 				else
 					applier_join(applier);
 			}
@@ -2274,12 +2852,47 @@ applier_stop(struct applier *applier)
 	applier->fiber = NULL;
 }
 
+/**
+ * Parse the 'spaces' URI parameter, which lists ids of user
+ * spaces to subscribe to. Returns 0 on success, -1 on invalid
+ * parameter value.
+ */
+static int
+applier_parse_space_filter(struct applier *applier, const struct uri *uri)
+{
+	int count = uri_param_count(uri, "spaces");
+	if (count == 0)
+		return 0;
+	uint32_t *ids = (uint32_t *)xmalloc(count * sizeof(*ids));
+	for (int i = 0; i < count; i++) {
+		const char *value = uri_param(uri, "spaces", i);
+		char *end;
+		errno = 0;
+		unsigned long long id = strtoull(value, &end, 10);
+		if (*value == '\0' || *value == '-' || *end != '\0' ||
+		    errno != 0 || id > UINT32_MAX) {
+			diag_set(IllegalParams, "Invalid spaces: %s", value);
+			free(ids);
+			return -1;
+		}
+		ids[i] = id;
+	}
+	applier->space_filter = ids;
+	applier->space_filter_size = count;
+	return 0;
+}
+
 struct applier *
 applier_new(struct uri *uri)
 {
 	struct applier *applier = (struct applier *)
 		xcalloc(1, sizeof(struct applier));
+	if (applier_parse_space_filter(applier, uri) != 0) {
+		free(applier);
+		diag_raise();
+	}
 	if (iostream_ctx_create(&applier->io_ctx, IOSTREAM_CLIENT, uri) != 0) {
+		free(applier->space_filter);
 		free(applier);
 		diag_raise();
 	}
@@ -2303,6 +2916,7 @@ applier_delete(struct applier *applier)
 	iostream_ctx_destroy(&applier->io_ctx);
 	ibuf_destroy(&applier->ibuf);
 	uri_destroy(&applier->uri);
+	free(applier->space_filter);
 	trigger_destroy(&applier->on_state);
 	diag_destroy(&applier->diag);
 	free(applier);
@@ -72,6 +72,8 @@ enum { APPLIER_SOURCE_MAXLEN = 1024 }; /* enough to fit URI with passwords */
 	_(APPLIER_FETCHED_SNAPSHOT, 14)                              \
 	_(APPLIER_REGISTER, 15)                                      \
 	_(APPLIER_REGISTERED, 16)                                    \
+	_(APPLIER_FETCH_CHECKPOINT, 17)                              \
+	_(APPLIER_FETCHED_CHECKPOINT, 18)                            \
 
 /** States for the applier */
 ENUM(applier_state, applier_STATE);
@@ -145,6 +147,13 @@ struct applier {
 	ev_tstamp last_row_time;
 	/** Number of seconds this replica is behind the remote master */
 	ev_tstamp lag;
+	/** Number of transactions applied by this applier. */
+	int64_t apply_tx_count;
+	/**
+	 * Number of groups of transactions applied concurrently,
+	 * a transaction applied alone counts as a group, too.
+	 */
+	int64_t apply_group_count;
 	/** The last box_error_code() logged to avoid log flooding */
 	uint32_t last_logged_errcode;
 	/** Remote instance ID. */
@@ -153,10 +162,24 @@ struct applier {
 	struct tt_uuid uuid;
 	/** Remote URI (parsed) */
 	struct uri uri;
+	/**
+	 * Ids of user spaces to subscribe to, set by the 'spaces'
+	 * URI parameter. Rows of other user spaces are received
+	 * as NOPs. NULL if all spaces are replicated.
+	 */
+	uint32_t *space_filter;
+	/** Number of ids in the space filter. */
+	uint32_t space_filter_size;
 	/** Remote version encoded as a number, see version_id() macro */
 	uint32_t version_id;
 	/** Remote ballot at the time of connect. */
 	struct ballot ballot;
+	/**
+	 * Set if the master doesn't support FETCH_CHECKPOINT so
+	 * the replica has to be bootstrapped with JOIN, see
+	 * applier_fetch_checkpoint().
+	 */
+	bool fetch_checkpoint_is_unsupported;
 	/** Remote address */
 	union {
 		struct sockaddr addr;
@@ -34,6 +34,7 @@
 
 #include "lua/utils.h" /* lua_hash() */
 #include "fiber_pool.h"
+#include "busy_poll.h"
 #include <say.h>
 #include <scoped_guard.h>
 #include "identifier.h"
@@ -64,6 +65,7 @@
 #include "user.h"
 #include "cfg.h"
 #include "coio.h"
+#include "coio_file.h"
 #include "replication.h" /* replica */
 #include "title.h"
 #include "xrow.h"
@@ -79,12 +81,14 @@
 #include "func.h"
 #include "sequence.h"
 #include "sql_stmt_cache.h"
+#include "box_stmt.h"
 #include "msgpack.h"
 #include "raft.h"
 #include "watcher.h"
 #include "audit.h"
 #include "trivia/util.h"
 #include "version.h"
+#include "info/info.h"
 
 static char status[64] = "unknown";
 
@@ -131,6 +135,9 @@ static bool is_box_configured = false;
 static bool is_ro = true;
 static fiber_cond ro_cond;
 
+/** Busy polling of the tx thread event loop. */
+static struct busy_poll tx_busy_poll;
+
 /**
  * The following flag is set if the instance failed to
  * synchronize to a sufficient number of replicas to form
@@ -811,6 +818,20 @@ box_check_replication_threads(void)
 	return 0;
 }
 
+static int
+box_check_replication_apply_parallelism(void)
+{
+	int value = cfg_geti("replication_apply_parallelism");
+	if (value <= 0 || value > REPLICATION_APPLY_PARALLELISM_MAX) {
+		diag_set(ClientError, ER_CFG, "replication_apply_parallelism",
+			 tt_sprintf("must be greater than 0, less than or "
+				    "equal to %d",
+				    REPLICATION_APPLY_PARALLELISM_MAX));
+		return -1;
+	}
+	return value;
+}
+
 static int
 box_check_listen(void)
 {
@@ -1075,6 +1096,65 @@ box_check_wal_queue_max_size(void)
 	return size;
 }
 
+static double
+box_check_wal_group_commit_delay(void)
+{
+	double value = cfg_getd("wal_group_commit_delay");
+	if (value < 0) {
+		diag_set(ClientError, ER_CFG, "wal_group_commit_delay",
+			 "value must be >= 0");
+		return -1;
+	}
+	return value;
+}
+
+static int
+box_check_wal_group_commit_min_batch(void)
+{
+	int64_t value = cfg_geti64("wal_group_commit_min_batch");
+	if (value <= 0 || value > INT32_MAX) {
+		diag_set(ClientError, ER_CFG, "wal_group_commit_min_batch",
+			 "value must be > 0");
+		return -1;
+	}
+	return value;
+}
+
+static double
+box_check_busy_poll_timeout(void)
+{
+	double value = cfg_getd("busy_poll_timeout");
+	if (value < 0) {
+		diag_set(ClientError, ER_CFG, "busy_poll_timeout",
+			 "value must be >= 0");
+		return -1;
+	}
+	return value;
+}
+
+static int
+box_check_net_msg_max_per(const char *option)
+{
+	int value = cfg_geti(option);
+	if (value < 0) {
+		diag_set(ClientError, ER_CFG, option, "value must be >= 0");
+		return -1;
+	}
+	return value;
+}
+
+static int64_t
+box_check_net_stmt_cache_size(void)
+{
+	int64_t size = cfg_geti64("net_stmt_cache_size");
+	if (size < 0) {
+		diag_set(ClientError, ER_CFG, "net_stmt_cache_size",
+			 "must be non-negative");
+		return -1;
+	}
+	return size;
+}
+
 static double
 box_check_wal_cleanup_delay(void)
 {
@@ -1271,6 +1351,8 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_replication_threads() < 0)
 		diag_raise();
+	if (box_check_replication_apply_parallelism() < 0)
+		diag_raise();
 	box_check_replication_sync_timeout();
 	box_check_readahead(cfg_geti("readahead"));
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
@@ -1280,6 +1362,18 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_wal_cleanup_delay() < 0)
 		diag_raise();
+	if (box_check_busy_poll_timeout() < 0)
+		diag_raise();
+	if (box_check_net_msg_max_per("net_msg_max_per_connection") < 0)
+		diag_raise();
+	if (box_check_net_msg_max_per("net_msg_max_per_user") < 0)
+		diag_raise();
+	if (box_check_net_stmt_cache_size() < 0)
+		diag_raise();
+	if (box_check_wal_group_commit_delay() < 0)
+		diag_raise();
+	if (box_check_wal_group_commit_min_batch() < 0)
+		diag_raise();
 	if (box_check_memory_quota("memtx_memory") < 0)
 		diag_raise();
 	box_check_memtx_min_tuple_size(cfg_geti64("memtx_min_tuple_size"));
@@ -1484,6 +1578,22 @@ box_set_replication_skip_conflict(void)
 	replication_skip_conflict = cfg_geti("replication_skip_conflict");
 }
 
+void
+box_set_replication_bootstrap_files(void)
+{
+	replication_bootstrap_files = cfg_geti("replication_bootstrap_files");
+}
+
+int
+box_set_replication_apply_parallelism(void)
+{
+	int value = box_check_replication_apply_parallelism();
+	if (value < 0)
+		return -1;
+	replication_apply_parallelism = value;
+	return 0;
+}
+
 void
 box_set_replication_anon(void)
 {
@@ -2056,6 +2166,19 @@ box_set_wal_queue_max_size(void)
 	return 0;
 }
 
+int
+box_set_wal_group_commit(void)
+{
+	double delay = box_check_wal_group_commit_delay();
+	if (delay < 0)
+		return -1;
+	int min_batch = box_check_wal_group_commit_min_batch();
+	if (min_batch < 0)
+		return -1;
+	wal_set_group_commit(delay, min_batch);
+	return 0;
+}
+
 int
 box_set_wal_cleanup_delay(void)
 {
@@ -2119,6 +2242,47 @@ box_set_net_msg_max(void)
 				IPROTO_FIBER_POOL_SIZE_FACTOR);
 }
 
+int
+box_set_net_msg_max_per_connection(void)
+{
+	int value = box_check_net_msg_max_per("net_msg_max_per_connection");
+	if (value < 0)
+		return -1;
+	iproto_set_msg_max_per_connection(value);
+	return 0;
+}
+
+int
+box_set_net_msg_max_per_user(void)
+{
+	int value = box_check_net_msg_max_per("net_msg_max_per_user");
+	if (value < 0)
+		return -1;
+	iproto_set_msg_max_per_user(value);
+	return 0;
+}
+
+int
+box_set_net_stmt_cache_size(void)
+{
+	int64_t size = box_check_net_stmt_cache_size();
+	if (size < 0)
+		return -1;
+	box_stmt_cache_set_size(size);
+	return 0;
+}
+
+int
+box_set_busy_poll_timeout(void)
+{
+	double timeout = box_check_busy_poll_timeout();
+	if (timeout < 0)
+		return -1;
+	busy_poll_set_timeout(&tx_busy_poll, timeout);
+	iproto_set_busy_poll(timeout);
+	return 0;
+}
+
 int
 box_set_prepared_stmt_cache_size(void)
 {
@@ -2290,10 +2454,17 @@ box_index_id_by_name(uint32_t space_id, const char *name, uint32_t len)
 int
 box_process1(struct request *request, box_tuple_t **result)
 {
-	/* Allow to write to temporary spaces in read-only mode. */
 	struct space *space = space_cache_find(request->space_id);
 	if (space == NULL)
 		return -1;
+	return box_process_space(request, space, result);
+}
+
+int
+box_process_space(struct request *request, struct space *space,
+		  box_tuple_t **result)
+{
+	/* Allow to write to temporary spaces in read-only mode. */
 	if (!space_is_temporary(space) &&
 	    space_group_id(space) != GROUP_LOCAL &&
 	    box_check_writable() != 0)
@@ -2325,27 +2496,31 @@ box_select(uint32_t space_id, uint32_t index_id,
 	   const char *key, const char *key_end,
 	   struct port *port)
 {
-	(void)key_end;
-
-	rmean_collect(rmean_box, IPROTO_SELECT, 1);
-
-	if (iterator < 0 || iterator >= iterator_type_MAX) {
-		diag_set(ClientError, ER_ILLEGAL_PARAMS,
-			 "Invalid iterator type");
-		diag_log();
-		return -1;
-	}
+	return box_select_chunked(space_id, index_id, iterator, offset, limit,
+				  key, key_end, 0, NULL, NULL, port);
+}
 
-	struct space *space = space_cache_find(space_id);
-	if (space == NULL)
-		return -1;
-	if (access_check_space(space, PRIV_R) != 0)
-		return -1;
-	struct index *index = index_find(space, index_id);
-	if (index == NULL)
-		return -1;
+/**
+ * Select from an index that has been looked up, see
+ * box_select_chunked(). The user must be allowed to read the
+ * space.
+ */
+static int
+box_select_from_index(struct space *space, struct index *index,
+		      enum iterator_type type, uint32_t offset,
+		      uint32_t limit, const char *key, uint32_t chunk_size,
+		      box_select_chunk_f on_chunk, void *arg,
+		      struct port *port)
+{
+	/*
+	 * The chunk callback yields. Only tree iterators are
+	 * guaranteed to survive concurrent modifications of
+	 * the index, and a yield may abort a transaction, so
+	 * don't split the result otherwise.
+	 */
+	if (index->def->type != TREE || in_txn() != NULL)
+		chunk_size = 0;
 
-	enum iterator_type type = (enum iterator_type) iterator;
 	uint32_t part_count = key ? mp_decode_array(&key) : 0;
 	if (key_validate(index->def, type, key, part_count))
 		return -1;
@@ -2383,6 +2558,14 @@ box_select(uint32_t space_id, uint32_t index_id,
 		if (rc != 0)
 			break;
 		found++;
+		if (chunk_size > 0 && found < limit &&
+		    ((struct port_c *)port)->size >= (int)chunk_size) {
+			rc = on_chunk(port, arg);
+			port_destroy(port);
+			port_c_create(port);
+			if (rc != 0)
+				break;
+		}
 	}
 	iterator_delete(it);
 
@@ -2395,6 +2578,58 @@ box_select(uint32_t space_id, uint32_t index_id,
 	return 0;
 }
 
+int
+box_select_chunked(uint32_t space_id, uint32_t index_id,
+		   int iterator, uint32_t offset, uint32_t limit,
+		   const char *key, const char *key_end,
+		   uint32_t chunk_size, box_select_chunk_f on_chunk,
+		   void *arg, struct port *port)
+{
+	(void)key_end;
+	assert(chunk_size == 0 || on_chunk != NULL);
+
+	rmean_collect(rmean_box, IPROTO_SELECT, 1);
+
+	if (iterator < 0 || iterator >= iterator_type_MAX) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "Invalid iterator type");
+		diag_log();
+		return -1;
+	}
+
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		return -1;
+	if (access_check_space(space, PRIV_R) != 0)
+		return -1;
+	struct index *index = index_find(space, index_id);
+	if (index == NULL)
+		return -1;
+	return box_select_from_index(space, index,
+				     (enum iterator_type)iterator, offset,
+				     limit, key, chunk_size, on_chunk, arg,
+				     port);
+}
+
+int
+box_select_index(struct space *space, struct index *index,
+		 int iterator, uint32_t offset, uint32_t limit,
+		 const char *key, const char *key_end,
+		 uint32_t chunk_size, box_select_chunk_f on_chunk,
+		 void *arg, struct port *port)
+{
+	(void)key_end;
+	assert(chunk_size == 0 || on_chunk != NULL);
+	assert(iterator >= 0 && iterator < iterator_type_MAX);
+
+	rmean_collect(rmean_box, IPROTO_SELECT, 1);
+
+	return box_select_from_index(space, index,
+				     (enum iterator_type)iterator, offset,
+				     limit, key, chunk_size, on_chunk, arg,
+				     port);
+}
+
 API_EXPORT int
 box_insert(uint32_t space_id, const char *tuple, const char *tuple_end,
 	   box_tuple_t **result)
@@ -2438,6 +2673,25 @@ box_delete(uint32_t space_id, uint32_t index_id, const char *key,
 	return box_process1(&request, result);
 }
 
+API_EXPORT int
+box_delete_range(uint32_t space_id, uint32_t index_id, const char *key,
+		 const char *key_end, const char *end_key,
+		 const char *end_key_end)
+{
+	mp_tuple_assert(key, key_end);
+	mp_tuple_assert(end_key, end_key_end);
+	struct request request;
+	memset(&request, 0, sizeof(request));
+	request.type = IPROTO_DELETE_RANGE;
+	request.space_id = space_id;
+	request.index_id = index_id;
+	request.key = key;
+	request.key_end = key_end;
+	request.end_key = end_key;
+	request.end_key_end = end_key_end;
+	return box_process1(&request, NULL);
+}
+
 API_EXPORT int
 box_update(uint32_t space_id, uint32_t index_id, const char *key,
 	   const char *key_end, const char *ops, const char *ops_end,
@@ -2727,6 +2981,205 @@ box_process_fetch_snapshot(struct iostream *io,
 	coio_write_xrow(io, &row);
 }
 
+/** Paths of checkpoint files collected by engine backup callbacks. */
+struct checkpoint_files {
+	char **paths;
+	int count;
+};
+
+static int
+checkpoint_files_add_cb(const char *path, void *arg)
+{
+	struct checkpoint_files *files = (struct checkpoint_files *)arg;
+	files->paths = (char **)xrealloc(files->paths, (files->count + 1) *
+					 sizeof(*files->paths));
+	files->paths[files->count++] = xstrdup(path);
+	return 0;
+}
+
+/**
+ * Return the name of a checkpoint file relative to the directory
+ * of the engine owning it: memtx_dir for snapshots, vinyl_dir for
+ * all other files.
+ */
+static const char *
+checkpoint_file_name(const char *path)
+{
+	const char *ext = strrchr(path, '.');
+	const char *dir = ext != NULL && strcmp(ext, ".snap") == 0 ?
+			  cfg_gets("memtx_dir") : cfg_gets("vinyl_dir");
+	size_t dir_len = strlen(dir);
+	if (strncmp(path, dir, dir_len) != 0 || path[dir_len] != '/') {
+		tnt_raise(ClientError, ER_UNSUPPORTED, "Checkpoint fetching",
+			  tt_sprintf("file '%s' outside of '%s'", path, dir));
+	}
+	return path + dir_len + 1;
+}
+
+/**
+ * Send a checkpoint file to a replica. The data of group-local spaces
+ * must not be sent, so the snapshot and the vylog are replaced with
+ * their copies without it written to temporary files.
+ */
+static void
+checkpoint_send_file(struct iostream *io, uint64_t sync, const char *path,
+		     const struct vclock *vclock,
+		     const struct tt_uuid *instance_uuid)
+{
+	const char *name = checkpoint_file_name(path);
+	const char *ext = strrchr(name, '.');
+	char copy[PATH_MAX];
+	int rc;
+	if (ext != NULL && strcmp(ext, ".snap") == 0) {
+		snprintf(copy, sizeof(copy), "%s/%s.snap",
+			 cfg_gets("memtx_dir"), tt_uuid_str(instance_uuid));
+		struct memtx_engine *memtx =
+			(struct memtx_engine *)engine_by_name("memtx");
+		rc = memtx_engine_copy_global_snapshot(memtx, vclock, copy);
+	} else if (ext != NULL && strcmp(ext, ".vylog") == 0) {
+		snprintf(copy, sizeof(copy), "%s/%s.vylog",
+			 cfg_gets("vinyl_dir"), tt_uuid_str(instance_uuid));
+		rc = vinyl_engine_write_global_vylog(engine_by_name("vinyl"),
+						     vclock, copy);
+	} else {
+		relay_send_file(io, sync, path, name);
+		return;
+	}
+	if (rc != 0)
+		diag_raise();
+	/* The copy is created with the .inprogress suffix. */
+	char copy_path[PATH_MAX];
+	snprintf(copy_path, sizeof(copy_path), "%s.inprogress", copy);
+	auto copy_guard = make_scoped_guard([&] {
+		if (coio_unlink(copy_path) != 0)
+			say_syserror("failed to delete file '%s'", copy_path);
+	});
+	relay_send_file(io, sync, copy_path, name);
+}
+
+void
+box_process_fetch_checkpoint(struct iostream *io,
+			     const struct xrow_header *header)
+{
+	/*
+	 * FETCH_CHECKPOINT protocol
+	 * =========================
+	 *
+	 * Replica => Master
+	 *
+	 * => FETCH_CHECKPOINT { INSTANCE_UUID, SERVER_VERSION }
+	 * <= OK { VCLOCK: checkpoint_vclock }
+	 * <= FILE { FILE_NAME, FILE_SIZE }
+	 * <= FILE_DATA { FILE_CHUNK }
+	 *    ...
+	 * <= FILE_DATA { FILE_CHUNK }
+	 * <= FILE_END { FILE_CRC32 }
+	 *    ... the same for the other checkpoint files ...
+	 * <= OK { VCLOCK: checkpoint_vclock }
+	 *
+	 * The files are sent as they are stored on disk, except that
+	 * the data of group-local spaces is omitted, like on JOIN. The
+	 * replica recovers from them as from a backup and then registers
+	 * with REGISTER in the same connection, which sends it the rows
+	 * written after the checkpoint. Masters that don't support the
+	 * request reply with ER_UNKNOWN_REQUEST_TYPE, in which case the
+	 * replica falls back on JOIN.
+	 */
+	assert(header->type == IPROTO_FETCH_CHECKPOINT);
+
+	struct tt_uuid instance_uuid;
+	uint32_t replica_version_id;
+	xrow_decode_join_xc(header, &instance_uuid, &replica_version_id);
+
+	/* Check that bootstrap has been finished */
+	if (!is_box_configured)
+		tnt_raise(ClientError, ER_LOADING);
+
+	/* Forbid connection to itself */
+	if (tt_uuid_is_equal(&instance_uuid, &INSTANCE_UUID))
+		tnt_raise(ClientError, ER_CONNECTION_TO_SELF);
+
+	/* Check permissions */
+	access_check_universe_xc(PRIV_R);
+
+	/* Forbid replication with disabled WAL */
+	if (wal_mode() == WAL_NONE) {
+		tnt_raise(ClientError, ER_UNSUPPORTED, "Replication",
+			  "wal_mode = 'none'");
+	}
+
+	struct gc_checkpoint *checkpoint = gc_last_checkpoint();
+	if (checkpoint == NULL)
+		tnt_raise(ClientError, ER_MISSING_SNAPSHOT);
+
+	/* Don't let the garbage collector delete the files we send. */
+	struct gc_checkpoint_ref gc_ref;
+	gc_ref_checkpoint(checkpoint, &gc_ref, "replica %s",
+			  tt_uuid_str(&instance_uuid));
+	auto gc_guard = make_scoped_guard([&] {
+		gc_unref_checkpoint(&gc_ref);
+	});
+	/*
+	 * Don't let it delete the WAL the replica will need to register
+	 * either: copying the files may take long. See also
+	 * box_process_register().
+	 */
+	struct gc_consumer *gc = gc_consumer_register(&checkpoint->vclock,
+				"replica %s", tt_uuid_str(&instance_uuid));
+	if (gc == NULL)
+		diag_raise();
+	auto gc_consumer_guard = make_scoped_guard([&] {
+		gc_consumer_unregister(gc);
+	});
+
+	struct checkpoint_files files = {NULL, 0};
+	auto files_guard = make_scoped_guard([&] {
+		for (int i = 0; i < files.count; i++)
+			free(files.paths[i]);
+		free(files.paths);
+	});
+	/*
+	 * Only memtx and vinyl store data on disk. Vinyl files of
+	 * group-local spaces are skipped.
+	 */
+	struct engine *memtx = engine_by_name("memtx");
+	if (memtx->vtab->backup(memtx, &checkpoint->vclock,
+				checkpoint_files_add_cb, &files) != 0 ||
+	    vinyl_engine_backup_global(engine_by_name("vinyl"),
+				       &checkpoint->vclock,
+				       checkpoint_files_add_cb, &files) != 0)
+		diag_raise();
+
+	say_info("sending checkpoint %s to replica %s at %s",
+		 vclock_to_string(&checkpoint->vclock),
+		 tt_uuid_str(&instance_uuid), sio_socketname(io->fd));
+
+	struct xrow_header row;
+	xrow_encode_vclock_xc(&row, &checkpoint->vclock);
+	row.sync = header->sync;
+	coio_write_xrow(io, &row);
+
+	for (int i = 0; i < files.count; i++) {
+		checkpoint_send_file(io, header->sync, files.paths[i],
+				     &checkpoint->vclock, &instance_uuid);
+	}
+	say_info("checkpoint sent.");
+
+	xrow_encode_vclock_xc(&row, &checkpoint->vclock);
+	row.sync = header->sync;
+	coio_write_xrow(io, &row);
+
+	/*
+	 * Keep the WAL pinned until the replica registers or the
+	 * connection is closed.
+	 */
+	struct session *session = current_session();
+	if (session->checkpoint_gc != NULL)
+		gc_consumer_unregister(session->checkpoint_gc);
+	session->checkpoint_gc = gc;
+	gc_consumer_guard.is_active = false;
+}
+
 void
 box_process_register(struct iostream *io, const struct xrow_header *header)
 {
@@ -2762,6 +3215,8 @@ box_process_register(struct iostream *io, const struct xrow_header *header)
 			  "wal_mode = 'none'");
 	}
 
+	ERROR_INJECT_YIELD(ERRINJ_REPLICA_REGISTER_DELAY);
+
 	/* @sa box_process_subscribe(). */
 	vclock_reset(&replica_vclock, 0, vclock_get(&replicaset.vclock, 0));
 	struct gc_consumer *gc = gc_consumer_register(&replica_vclock,
@@ -2810,6 +3265,13 @@ box_process_register(struct iostream *io, const struct xrow_header *header)
 		gc_consumer_unregister(replica->gc);
 	replica->gc = gc;
 	gc_guard.is_active = false;
+
+	/* The replica pins the WAL now, see box_process_fetch_checkpoint(). */
+	struct session *session = current_session();
+	if (session->checkpoint_gc != NULL) {
+		gc_consumer_unregister(session->checkpoint_gc);
+		session->checkpoint_gc = NULL;
+	}
 }
 
 void
@@ -2973,9 +3435,11 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	uint32_t replica_version_id;
 	bool anon;
 	uint32_t id_filter;
+	uint32_t *space_filter;
+	uint32_t space_filter_size;
 	xrow_decode_subscribe_xc(header, &peer_replicaset_uuid, &replica_uuid,
 				 &replica_clock, &replica_version_id, &anon,
-				 &id_filter);
+				 &id_filter, &space_filter, &space_filter_size);
 
 	/* Forbid connection to itself */
 	if (tt_uuid_is_equal(&replica_uuid, &INSTANCE_UUID))
@@ -3117,7 +3581,8 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	 * indefinitely).
 	 */
 	relay_subscribe(replica, io, header->sync, &replica_clock,
-			replica_version_id, id_filter);
+			replica_version_id, id_filter, space_filter,
+			space_filter_size);
 }
 
 void
@@ -3177,6 +3642,7 @@ box_free(void)
 		audit_log_free();
 		sql_built_in_functions_cache_free();
 	}
+	busy_poll_destroy(&tx_busy_poll);
 }
 
 static void
@@ -3340,6 +3806,82 @@ bootstrap_from_master(struct replica *master)
 		panic("failed to create a checkpoint");
 }
 
+/**
+ * Bootstrap from the files of the last checkpoint of the remote
+ * master. Falls back on bootstrap_from_master() if the master
+ * doesn't support it.
+ * \pre  master->applier->state == APPLIER_CONNECTED
+ * \post master->applier->state == APPLIER_READY
+ */
+static void
+bootstrap_from_checkpoint(struct replica *master)
+{
+	struct applier *applier = master->applier;
+	assert(applier != NULL);
+	applier_resume_to_state(applier, APPLIER_READY, TIMEOUT_INFINITY);
+	assert(applier->state == APPLIER_READY);
+
+	say_info("bootstrapping replica from checkpoint of %s at %s",
+		 tt_uuid_str(&master->uuid),
+		 sio_strfaddr(&applier->addr, applier->addr_len));
+
+	/*
+	 * Send FETCH_CHECKPOINT request to master
+	 * See box_process_fetch_checkpoint().
+	 */
+	assert(!tt_uuid_is_nil(&INSTANCE_UUID));
+	applier_resume_to_state(applier, APPLIER_FETCH_CHECKPOINT,
+				TIMEOUT_INFINITY);
+	if (applier->fetch_checkpoint_is_unsupported)
+		return bootstrap_from_master(master);
+	applier_resume_to_state(applier, APPLIER_FETCHED_CHECKPOINT,
+				TIMEOUT_INFINITY);
+
+	/*
+	 * Pick up the downloaded snapshot. Its vclock is taken from
+	 * the file meta, because the vclock sent by the master lacks
+	 * the local component.
+	 */
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	struct vclock checkpoint_vclock;
+	xdir_scan_xc(&memtx->snap_dir, true);
+	if (xdir_last_vclock(&memtx->snap_dir, &checkpoint_vclock) < 0)
+		tnt_raise(ClientError, ER_MISSING_SNAPSHOT);
+	gc_add_checkpoint(&checkpoint_vclock);
+	vclock_copy(&replicaset.vclock, &checkpoint_vclock);
+	say_info("instance vclock %s", vclock_to_string(&replicaset.vclock));
+
+	/*
+	 * Recover the files as if they were restored from a backup.
+	 * See local_recovery().
+	 */
+	engine_begin_initial_recovery_xc(&checkpoint_vclock);
+	recovery_journal_create(&replicaset.vclock);
+	memtx_engine_recover_snapshot_xc(memtx, &checkpoint_vclock);
+	engine_begin_final_recovery_xc();
+
+	/*
+	 * Unlike bootstrap_from_master(), there's no need to make
+	 * the initial checkpoint, because we already have one, so
+	 * enable WAL right away. This also clears the recovery
+	 * journal created on stack.
+	 */
+	if (wal_enable() != 0)
+		diag_raise();
+	engine_end_recovery_xc();
+
+	/*
+	 * Register the new replica. The master sends the rows
+	 * written after the checkpoint, including registration.
+	 * See box_process_register().
+	 */
+	applier_resume_to_state(applier, APPLIER_REGISTERED, TIMEOUT_INFINITY);
+	applier_resume_to_state(applier, APPLIER_READY, TIMEOUT_INFINITY);
+	assert(applier->state == APPLIER_READY);
+}
+
 /**
  * Bootstrap a new instance either as the first master in a
  * replica set or as a replica of an existing master.
@@ -3383,7 +3925,10 @@ bootstrap(const struct tt_uuid *instance_uuid,
 	assert(master == NULL || master->applier != NULL);
 
 	if (master != NULL && !tt_uuid_is_equal(&master->uuid, &INSTANCE_UUID)) {
-		bootstrap_from_master(master);
+		if (replication_bootstrap_files && !replication_anon)
+			bootstrap_from_checkpoint(master);
+		else
+			bootstrap_from_master(master);
 		/* Check replica set UUID */
 		if (!tt_uuid_is_nil(replicaset_uuid) &&
 		    !tt_uuid_is_equal(replicaset_uuid, &REPLICASET_UUID)) {
@@ -3637,6 +4182,7 @@ box_init(void)
 	sequence_init();
 	box_raft_init();
 	box_watcher_init();
+	busy_poll_create(&tx_busy_poll, loop());
 }
 
 bool
@@ -3683,6 +4229,12 @@ box_cfg_xc(void)
 	if (box_set_prepared_stmt_cache_size() != 0)
 		diag_raise();
 	box_set_net_msg_max();
+	if (box_set_net_msg_max_per_connection() != 0)
+		diag_raise();
+	if (box_set_net_msg_max_per_user() != 0)
+		diag_raise();
+	if (box_set_busy_poll_timeout() != 0)
+		diag_raise();
 	box_set_readahead();
 	box_set_too_long_threshold();
 	box_set_replication_timeout();
@@ -3695,6 +4247,9 @@ box_cfg_xc(void)
 		diag_raise();
 	box_set_replication_sync_timeout();
 	box_set_replication_skip_conflict();
+	box_set_replication_bootstrap_files();
+	if (box_set_replication_apply_parallelism() != 0)
+		diag_raise();
 	box_set_replication_anon();
 
 	struct gc_checkpoint *checkpoint = gc_last_checkpoint();
@@ -3935,5 +4490,23 @@ box_reset_stat(void)
 	rmean_cleanup(rmean_box);
 	rmean_cleanup(rmean_error);
 	engine_reset_stat();
+	wal_reset_stat();
 	space_foreach(box_reset_space_stat, NULL);
 }
+
+void
+box_busy_poll_stat(struct info_handler *h)
+{
+	struct iproto_stats stats;
+	iproto_stats_get(&stats);
+	info_begin(h);
+	info_table_begin(h, "tx");
+	info_append_double(h, "time", tx_busy_poll.spin_time);
+	info_append_int(h, "sleeps", tx_busy_poll.sleep_count);
+	info_table_end(h);
+	info_table_begin(h, "iproto");
+	info_append_double(h, "time", stats.busy_poll_time);
+	info_append_int(h, "sleeps", stats.busy_poll_sleeps);
+	info_table_end(h);
+	info_end(h);
+}
@@ -51,7 +51,9 @@ struct obuf;
 struct iostream;
 struct auth_request;
 struct space;
+struct index;
 struct vclock;
+struct info_handler;
 
 /**
  * Pointer to TX thread local vclock.
@@ -198,6 +200,12 @@ const char *box_status(void);
 void
 box_reset_stat(void);
 
+/**
+ * Report busy polling statistics of the tx and iproto threads.
+ */
+void
+box_busy_poll_stat(struct info_handler *h);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 
@@ -209,6 +217,11 @@ void
 box_process_fetch_snapshot(struct iostream *io,
 			   const struct xrow_header *header);
 
+/** Send files of the last checkpoint to the replica. */
+void
+box_process_fetch_checkpoint(struct iostream *io,
+			     const struct xrow_header *header);
+
 /** Register a replica */
 void
 box_process_register(struct iostream *io, const struct xrow_header *header);
@@ -258,6 +271,7 @@ void box_set_checkpoint_interval(void);
 void box_set_checkpoint_wal_threshold(void);
 int box_set_wal_queue_max_size(void);
 int box_set_wal_cleanup_delay(void);
+int box_set_wal_group_commit(void);
 void box_set_memtx_memory(void);
 void box_set_memtx_max_tuple_size(void);
 void box_set_vinyl_memory(void);
@@ -275,8 +289,14 @@ int box_set_replication_synchro_quorum(void);
 int box_set_replication_synchro_timeout(void);
 void box_set_replication_sync_timeout(void);
 void box_set_replication_skip_conflict(void);
+void box_set_replication_bootstrap_files(void);
+int box_set_replication_apply_parallelism(void);
 void box_set_replication_anon(void);
 void box_set_net_msg_max(void);
+int box_set_net_msg_max_per_connection(void);
+int box_set_net_msg_max_per_user(void);
+int box_set_net_stmt_cache_size(void);
+int box_set_busy_poll_timeout(void);
 int box_set_crash(void);
 int box_set_txn_timeout(void);
 
@@ -307,6 +327,43 @@ box_select(uint32_t space_id, uint32_t index_id,
 	   const char *key, const char *key_end,
 	   struct port *port);
 
+/**
+ * Callback invoked by box_select_chunked() for every full chunk
+ * of tuples. The port is destroyed after the callback returns.
+ * The callback may yield. Returns 0 on success, -1 on error,
+ * which aborts the select.
+ */
+typedef int
+(*box_select_chunk_f)(struct port *port, void *arg);
+
+/**
+ * Same as box_select(), but passes the result to @a on_chunk in
+ * chunks of @a chunk_size tuples as the index is iterated, so
+ * that a big result set is never kept in memory as a whole. The
+ * remaining tuples (less than @a chunk_size) are returned in
+ * @a port. Zero @a chunk_size disables chunking. Since the
+ * callback may yield, tuples of different chunks may belong to
+ * different read views.
+ */
+int
+box_select_chunked(uint32_t space_id, uint32_t index_id,
+		   int iterator, uint32_t offset, uint32_t limit,
+		   const char *key, const char *key_end,
+		   uint32_t chunk_size, box_select_chunk_f on_chunk,
+		   void *arg, struct port *port);
+
+/**
+ * Same as box_select_chunked(), but takes a space and an index
+ * that have been looked up, e.g. by a prepared statement. Doesn't
+ * check that the user may read the space, the caller must do it.
+ */
+int
+box_select_index(struct space *space, struct index *index,
+		 int iterator, uint32_t offset, uint32_t limit,
+		 const char *key, const char *key_end,
+		 uint32_t chunk_size, box_select_chunk_f on_chunk,
+		 void *arg, struct port *port);
+
 /** \cond public */
 
 /*
@@ -420,6 +477,29 @@ API_EXPORT int
 box_delete(uint32_t space_id, uint32_t index_id, const char *key,
 	   const char *key_end, box_tuple_t **result);
 
+/**
+ * Execute a DELETE_RANGE request: delete all tuples with primary
+ * keys in the range [key, end_key). A partial key bounds the range
+ * by its prefix, an empty key means no bound. Only supported by
+ * the primary index of a vinyl space.
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param key encoded inclusive lower bound in MsgPack Array format.
+ * \param key_end the end of encoded \a key.
+ * \param end_key encoded exclusive upper bound in MsgPack Array format.
+ * \param end_key_end the end of encoded \a end_key.
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ * \sa \code box.space[space_id].index[index_id]:delete_range(key,
+ *                                                          end_key)
+ * \endcode
+ */
+API_EXPORT int
+box_delete_range(uint32_t space_id, uint32_t index_id, const char *key,
+		 const char *key_end, const char *end_key,
+		 const char *end_key_end);
+
 /**
  * Execute an UPDATE request.
  *
@@ -548,6 +628,14 @@ box_session_push(const char *data, const char *data_end);
 int
 box_process1(struct request *request, box_tuple_t **result);
 
+/**
+ * Same as box_process1(), but takes a space that has been looked
+ * up, e.g. by a prepared statement.
+ */
+int
+box_process_space(struct request *request, struct space *space,
+		  box_tuple_t **result);
+
 /**
  * Execute request on given space.
  *
@@ -0,0 +1,306 @@
+/*
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "box_stmt.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "assoc.h"
+#include "diag.h"
+#include "error.h"
+#include "fiber.h"
+#include "index.h"
+#include "iproto_constants.h"
+#include "session.h"
+#include "space.h"
+#include "space_cache.h"
+#include "tt_static.h"
+#include "xrow.h"
+#include "xrow_update.h"
+
+/** Memory used by prepared statements of all sessions. */
+static size_t box_stmt_mem_used;
+/** Limit on box_stmt_mem_used, see box.cfg.net_stmt_cache_size. */
+static size_t box_stmt_mem_quota = 5 * 1024 * 1024;
+
+/**
+ * Amount of memory accounted for a statement: the statement
+ * itself and its entry in the session hash.
+ */
+static inline size_t
+box_stmt_sizeof(uint32_t ops_len)
+{
+	return sizeof(struct box_stmt) + ops_len +
+	       sizeof(struct mh_i32ptr_node_t);
+}
+
+void
+box_stmt_cache_set_size(size_t size)
+{
+	box_stmt_mem_quota = size;
+}
+
+static struct box_stmt *
+box_stmt_new(const struct request *request)
+{
+	const char *ops = NULL;
+	const char *ops_end = NULL;
+	if (request->stmt_type == IPROTO_UPDATE) {
+		/* UPDATE operations are sent in IPROTO_TUPLE. */
+		ops = request->tuple;
+		ops_end = request->tuple_end;
+	} else if (request->stmt_type == IPROTO_UPSERT) {
+		ops = request->ops;
+		ops_end = request->ops_end;
+	}
+	uint32_t ops_len = ops_end - ops;
+	if (box_stmt_mem_used + box_stmt_sizeof(ops_len) > box_stmt_mem_quota) {
+		diag_set(ClientError, ER_STMT_CACHE_FULL);
+		return NULL;
+	}
+	size_t size = sizeof(struct box_stmt) + ops_len;
+	struct box_stmt *stmt = malloc(size);
+	if (stmt == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "struct box_stmt");
+		return NULL;
+	}
+	box_stmt_mem_used += box_stmt_sizeof(ops_len);
+	stmt->type = request->stmt_type;
+	stmt->space_id = request->space_id;
+	stmt->index_id = request->index_id;
+	stmt->iterator = request->iterator;
+	stmt->offset = request->offset;
+	stmt->limit = request->limit;
+	stmt->index_base = request->index_base;
+	stmt->refs = 1;
+	/* Force the lookup on the first use. */
+	stmt->space_cache_version = space_cache_version - 1;
+	stmt->space = NULL;
+	stmt->index = NULL;
+	stmt->ops_len = ops_len;
+	if (ops_len > 0)
+		memcpy(stmt->ops, ops, ops_len);
+	return stmt;
+}
+
+static inline void
+box_stmt_delete(struct box_stmt *stmt)
+{
+	assert(stmt->refs == 0);
+	assert(box_stmt_mem_used >= box_stmt_sizeof(stmt->ops_len));
+	box_stmt_mem_used -= box_stmt_sizeof(stmt->ops_len);
+	free(stmt);
+}
+
+void
+box_stmt_unref(struct box_stmt *stmt)
+{
+	assert(stmt->refs > 0);
+	if (--stmt->refs == 0)
+		box_stmt_delete(stmt);
+}
+
+/**
+ * Look up the space and the index of a statement and check its
+ * update operations against the space format, unless it's been
+ * done since the space cache last changed.
+ */
+static int
+box_stmt_resolve(struct box_stmt *stmt)
+{
+	if (stmt->space_cache_version == space_cache_version)
+		return 0;
+	struct space *space = space_cache_find(stmt->space_id);
+	if (space == NULL)
+		return -1;
+	struct index *index = index_find(space, stmt->index_id);
+	if (index == NULL)
+		return -1;
+	if (stmt->ops_len > 0 &&
+	    xrow_update_check_ops(stmt->ops, stmt->ops + stmt->ops_len,
+				  space->format, stmt->index_base) != 0)
+		return -1;
+	stmt->space = space;
+	stmt->index = index;
+	stmt->space_cache_version = space_cache_version;
+	return 0;
+}
+
+static struct box_stmt *
+box_stmt_find(struct session *session, uint32_t stmt_id)
+{
+	if (session->box_stmts == NULL)
+		return NULL;
+	mh_int_t i = mh_i32ptr_find(session->box_stmts, stmt_id, NULL);
+	if (i == mh_end(session->box_stmts))
+		return NULL;
+	return mh_i32ptr_node(session->box_stmts, i)->val;
+}
+
+int
+box_stmt_prepare(const struct request *request, uint32_t *stmt_id)
+{
+	user_access_t access;
+	switch (request->stmt_type) {
+	case IPROTO_SELECT:
+		access = PRIV_R;
+		break;
+	case IPROTO_INSERT:
+	case IPROTO_REPLACE:
+	case IPROTO_UPDATE:
+	case IPROTO_DELETE:
+	case IPROTO_UPSERT:
+		access = PRIV_W;
+		break;
+	default:
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 tt_sprintf("can't prepare request of type %u",
+				    (unsigned)request->stmt_type));
+		return -1;
+	}
+	if ((request->stmt_type == IPROTO_UPDATE && request->tuple == NULL) ||
+	    (request->stmt_type == IPROTO_UPSERT && request->ops == NULL)) {
+		diag_set(ClientError, ER_MISSING_REQUEST_FIELD,
+			 iproto_key_name(request->stmt_type == IPROTO_UPDATE ?
+					 IPROTO_TUPLE : IPROTO_OPS));
+		return -1;
+	}
+	if (request->stmt_type == IPROTO_SELECT &&
+	    request->iterator >= iterator_type_MAX) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "Invalid iterator type");
+		return -1;
+	}
+	struct box_stmt *stmt = box_stmt_new(request);
+	if (stmt == NULL)
+		return -1;
+	/*
+	 * Access is checked again on execution, here we only
+	 * want to report a misspelled space or index early.
+	 */
+	if (box_stmt_resolve(stmt) != 0 ||
+	    access_check_space(stmt->space, access) != 0) {
+		box_stmt_unref(stmt);
+		return -1;
+	}
+
+	struct session *session = current_session();
+	if (session->box_stmts == NULL)
+		session->box_stmts = mh_i32ptr_new();
+	uint32_t id = session->box_stmt_id_max;
+	do {
+		id++;
+	} while (id == 0 || box_stmt_find(session, id) != NULL);
+	session->box_stmt_id_max = id;
+	const struct mh_i32ptr_node_t node = { id, stmt };
+	mh_i32ptr_put(session->box_stmts, &node, NULL, NULL);
+	*stmt_id = id;
+	return 0;
+}
+
+int
+box_stmt_unprepare(uint32_t stmt_id)
+{
+	struct session *session = current_session();
+	struct box_stmt *stmt = box_stmt_find(session, stmt_id);
+	if (stmt == NULL) {
+		diag_set(ClientError, ER_WRONG_QUERY_ID, stmt_id);
+		return -1;
+	}
+	mh_int_t i = mh_i32ptr_find(session->box_stmts, stmt_id, NULL);
+	mh_i32ptr_del(session->box_stmts, i, NULL);
+	box_stmt_unref(stmt);
+	return 0;
+}
+
+int
+box_stmt_bind(struct request *request, struct box_stmt **result)
+{
+	struct box_stmt *stmt = box_stmt_find(current_session(),
+					      request->stmt_id);
+	if (stmt == NULL) {
+		diag_set(ClientError, ER_WRONG_QUERY_ID, request->stmt_id);
+		return -1;
+	}
+	if (stmt->type != request->type) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 tt_sprintf("statement %u is prepared for %s",
+				    (unsigned)request->stmt_id,
+				    iproto_type_name(stmt->type)));
+		return -1;
+	}
+	enum iproto_key arg_key = IPROTO_KEY;
+	const char *arg = request->key;
+	if (stmt->type == IPROTO_INSERT || stmt->type == IPROTO_REPLACE ||
+	    stmt->type == IPROTO_UPSERT) {
+		arg_key = IPROTO_TUPLE;
+		arg = request->tuple;
+	}
+	if (arg == NULL) {
+		diag_set(ClientError, ER_MISSING_REQUEST_FIELD,
+			 iproto_key_name(arg_key));
+		return -1;
+	}
+	if (box_stmt_resolve(stmt) != 0)
+		return -1;
+	/* The select is executed bypassing the space lookup. */
+	if (stmt->type == IPROTO_SELECT &&
+	    access_check_space(stmt->space, PRIV_R) != 0)
+		return -1;
+	request->space_id = stmt->space_id;
+	request->index_id = stmt->index_id;
+	request->iterator = stmt->iterator;
+	request->offset = stmt->offset;
+	request->limit = stmt->limit;
+	request->index_base = stmt->index_base;
+	if (stmt->type == IPROTO_UPDATE) {
+		request->tuple = stmt->ops;
+		request->tuple_end = stmt->ops + stmt->ops_len;
+	} else if (stmt->type == IPROTO_UPSERT) {
+		request->ops = stmt->ops;
+		request->ops_end = stmt->ops + stmt->ops_len;
+	}
+	stmt->refs++;
+	*result = stmt;
+	return 0;
+}
+
+void
+box_stmt_hash_erase(struct mh_i32ptr_t *hash)
+{
+	if (hash == NULL)
+		return;
+	mh_int_t i;
+	mh_foreach(hash, i)
+		box_stmt_unref(mh_i32ptr_node(hash, i)->val);
+	mh_i32ptr_delete(hash);
+}
@@ -0,0 +1,148 @@
+#pragma once
+/*
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct request;
+struct space;
+struct index;
+struct mh_i32ptr_t;
+
+/**
+ * A SELECT or DML request prepared with IPROTO_BOX_PREPARE.
+ * Stores the request parameters that don't change between
+ * calls, so that a client sends only the key or the tuple.
+ * Statements are private to the session that prepared them.
+ */
+struct box_stmt {
+	/** Request type: IPROTO_SELECT, IPROTO_INSERT, etc. */
+	uint16_t type;
+	uint32_t space_id;
+	uint32_t index_id;
+	uint32_t iterator;
+	uint32_t offset;
+	uint32_t limit;
+	int index_base;
+	/**
+	 * Number of references: one is held by the session hash,
+	 * one by each request executing the statement.
+	 */
+	int refs;
+	/**
+	 * Value of space_cache_version when the space and the
+	 * index were looked up and the update operations were
+	 * checked. The space cache is also changed by truncate,
+	 * which doesn't bump schema_version.
+	 */
+	uint32_t space_cache_version;
+	/** Space of the statement, valid while the cache is. */
+	struct space *space;
+	/** Index of the statement, valid while the cache is. */
+	struct index *index;
+	/** Size of update operations, 0 unless UPDATE or UPSERT. */
+	uint32_t ops_len;
+	/** Update operations of UPDATE or UPSERT. */
+	char ops[0];
+};
+
+/**
+ * Set the limit on memory used by prepared statements of all
+ * sessions. Statements that are already prepared are kept if
+ * the limit is reduced below the memory they use, but no new
+ * statements can be prepared until enough of them are freed.
+ */
+void
+box_stmt_cache_set_size(size_t size);
+
+/**
+ * Prepare a statement described by a decoded IPROTO_BOX_PREPARE
+ * request in the current session. Checks that the space and the
+ * index exist, that the user may access the space and that the
+ * update operations are valid. Fails if the memory limit for
+ * prepared statements has been reached.
+ * @param request Request with the statement type and parameters.
+ * @param[out] stmt_id Id of the new statement.
+ * @retval 0 Success.
+ * @retval -1 Error, the diag is set.
+ */
+int
+box_stmt_prepare(const struct request *request, uint32_t *stmt_id);
+
+/**
+ * Deallocate a statement prepared in the current session.
+ * @retval 0 Success.
+ * @retval -1 No such statement, the diag is set.
+ */
+int
+box_stmt_unprepare(uint32_t stmt_id);
+
+/**
+ * Fill the parameters of a request referring to a statement
+ * prepared in the current session with IPROTO_STMT_ID. The space
+ * and the index are looked up and the update operations are
+ * checked again only if the space cache has changed since the
+ * last execution. For SELECT, checks that the user may read the
+ * space, DML requests are checked on execution.
+ *
+ * The request points to the update operations of the statement,
+ * so the statement is referenced to stay valid if it's
+ * deallocated while the request yields. The caller must drop
+ * the reference with box_stmt_unref() once the request is
+ * executed. The space and the index pointers of the statement
+ * may be used until the caller yields.
+ * @param request Request to fill.
+ * @param[out] stmt Referenced statement.
+ * @retval 0 Success.
+ * @retval -1 No such statement, the statement type doesn't
+ *            match the request type, the request misses the
+ *            key or the tuple, or the space, the index or the
+ *            update operations are not valid anymore, the diag
+ *            is set.
+ */
+int
+box_stmt_bind(struct request *request, struct box_stmt **stmt);
+
+/** Drop a reference taken by box_stmt_bind(). */
+void
+box_stmt_unref(struct box_stmt *stmt);
+
+/** Delete all statements of a session hash and the hash itself. */
+void
+box_stmt_hash_erase(struct mh_i32ptr_t *hash);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -293,6 +293,8 @@ struct errcode_record {
 	/*238 */_(ER_FOREIGN_KEY_INTEGRITY,	"Foreign key '%s' integrity check failed: %s") \
 	/*239 */_(ER_FIELD_FOREIGN_KEY_FAILED,	"Foreign key constraint '%s' failed for field '%s': %s") \
 	/*239 */_(ER_COMPLEX_FOREIGN_KEY_FAILED, "Foreign key constraint '%s' failed: %s") \
+	/*241 */_(ER_TOO_MANY_REQUESTS,		"Too many requests of user '%s' are in progress") \
+	/*242 */_(ER_STMT_CACHE_FULL,		"Memory limit for prepared statements has been reached") \
 
 /*
  * !IMPORTANT! Please follow instructions at start of the file
@@ -39,6 +39,9 @@ const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE" };
 
 const char *rtree_index_distance_type_strs[] = { "EUCLID", "MANHATTAN" };
 
+const char *vy_compaction_policy_strs[] = { "tiered", "leveled" };
+const char *bloom_type_strs[] = { "classic", "split_block" };
+
 const struct index_opts index_opts_default = {
 	/* .unique              = */ true,
 	/* .dimension           = */ 2,
@@ -48,6 +51,10 @@ const struct index_opts index_opts_default = {
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
 	/* .bloom_fpr           = */ 0.05,
+	/* .compaction_policy   = */ VY_COMPACTION_POLICY_TIERED,
+	/* .bloom_type          = */ BLOOM_CLASSIC,
+	/* .compression_dict    = */ false,
+	/* .blob_threshold      = */ 0,
 	/* .lsn                 = */ 0,
 	/* .stat                = */ NULL,
 	/* .func                = */ 0,
@@ -64,6 +71,14 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("run_count_per_level", OPT_INT64, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF_ENUM("compaction_policy", vy_compaction_policy,
+		     struct index_opts, compaction_policy, NULL),
+	OPT_DEF_ENUM("bloom_type", bloom_type, struct index_opts,
+		     bloom_type, NULL),
+	OPT_DEF("compression_dict", OPT_BOOL, struct index_opts,
+		compression_dict),
+	OPT_DEF("blob_threshold", OPT_INT64, struct index_opts,
+		blob_threshold),
 	OPT_DEF("lsn", OPT_INT64, struct index_opts, lsn),
 	OPT_DEF("func", OPT_UINT32, struct index_opts, func_id),
 	OPT_DEF_LEGACY("sql"),
@@ -33,6 +33,7 @@
 
 #include "key_def.h"
 #include "opt_def.h"
+#include "salad/bloom.h"
 #include "small/rlist.h"
 
 #if defined(__cplusplus)
@@ -58,6 +59,23 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+enum vy_compaction_policy {
+	/*
+	 * Size-tiered compaction: a level may store up to
+	 * run_count_per_level runs.
+	 */
+	VY_COMPACTION_POLICY_TIERED,
+	/*
+	 * Leveled compaction: a level may store at most one run
+	 * so read amplification is bounded by the level count.
+	 */
+	VY_COMPACTION_POLICY_LEVELED,
+	vy_compaction_policy_MAX
+};
+extern const char *vy_compaction_policy_strs[];
+
+extern const char *bloom_type_strs[];
+
 /** Simple alias to represent logarithm metrics. */
 typedef int16_t log_est_t;
 
@@ -153,6 +171,24 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/**
+	 * Policy used for picking runs to compact in each range
+	 * of the LSM tree.
+	 */
+	enum vy_compaction_policy compaction_policy;
+	/** Type of bloom filters used by Vinyl runs. */
+	enum bloom_type bloom_type;
+	/**
+	 * Compress run pages with a zstd dictionary trained
+	 * on statements written by dump.
+	 */
+	bool compression_dict;
+	/**
+	 * Payloads of tuples that are equal to or bigger than
+	 * this size are stored in value log files instead of run
+	 * files of the primary index. 0 disables the value log.
+	 */
+	int64_t blob_threshold;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -213,6 +249,14 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
+	if (o1->bloom_type != o2->bloom_type)
+		return o1->bloom_type < o2->bloom_type ? -1 : 1;
+	if (o1->compaction_policy != o2->compaction_policy)
+		return o1->compaction_policy < o2->compaction_policy ? -1 : 1;
+	if (o1->compression_dict != o2->compression_dict)
+		return o1->compression_dict < o2->compression_dict ? -1 : 1;
+	if (o1->blob_threshold != o2->blob_threshold)
+		return o1->blob_threshold < o2->blob_threshold ? -1 : 1;
 	if (o1->func_id != o2->func_id)
 		return o1->func_id - o2->func_id;
 	if (o1->hint != o2->hint)
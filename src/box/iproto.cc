@@ -37,6 +37,7 @@
 #include <msgpuck.h>
 #include <small/ibuf.h>
 #include <small/obuf.h>
+#include <small/mempool.h>
 #include <base64.h>
 
 #include "version.h"
@@ -64,16 +65,27 @@
 #include "iproto_features.h"
 #include "rmean.h"
 #include "execute.h"
+#include "box_stmt.h"
 #include "errinj.h"
 #include "tt_static.h"
 #include "salad/stailq.h"
 #include "assoc.h"
 #include "txn.h"
 #include "on_shutdown.h"
+#include "busy_poll.h"
+#include "clock.h"
+#include "latency.h"
+#include "user.h"
 
 enum {
 	IPROTO_SALT_SIZE = 32,
 	IPROTO_PACKET_SIZE_MAX = 2UL * 1024 * 1024 * 1024,
+	/**
+	 * Max number of SELECT requests processed by the tx thread
+	 * in one fiber, see iproto_enqueue_batch(). Limits the delay
+	 * of the first reply in a batch.
+	 */
+	IPROTO_SELECT_BATCH_MAX = 32,
 };
 
 enum {
@@ -126,6 +138,56 @@ iproto_wpos_create(struct iproto_wpos *wpos, struct obuf *out)
 	wpos->svp = obuf_create_svp(out);
 }
 
+enum {
+	/**
+	 * Tuples of at least this size are sent to the client right
+	 * from the tuple memory instead of being copied to the output
+	 * buffer. Copying a smaller tuple is cheaper than pinning it
+	 * and writing it in a separate iovec.
+	 */
+	IPROTO_TUPLE_REF_MIN_SIZE = 1024,
+	/** Max number of iovecs written by iproto_flush() at once. */
+	IPROTO_FLUSH_IOV_MAX = 2 * (SMALL_OBUF_IOV_MAX + 1),
+};
+
+/**
+ * A tuple sent to the client without copying its data to the
+ * output buffer. The iproto thread writes the data to the socket
+ * right from the tuple when the output reaches the position the
+ * data was dumped at. The tuple is referenced until the output
+ * buffer is reset by the tx thread, i.e. for as long as a copy
+ * in the buffer would live.
+ */
+struct iproto_tuple_ref {
+	/**
+	 * Next reference in the same output buffer. Written by
+	 * the tx thread with release semantics, read by the
+	 * iproto thread with acquire semantics.
+	 */
+	struct iproto_tuple_ref *next;
+	/** Position in the output buffer the data goes at. */
+	struct obuf_svp svp;
+	/** Referenced tuple. */
+	struct tuple *tuple;
+	/** Tuple data. */
+	const char *data;
+	/** Size of the tuple data. */
+	uint32_t size;
+};
+
+/** Tuple references of an output buffer, ordered by position. */
+struct iproto_tuple_ref_list {
+	struct iproto_tuple_ref *first;
+	struct iproto_tuple_ref *last;
+};
+
+static inline void
+iproto_tuple_ref_list_create(struct iproto_tuple_ref_list *list)
+{
+	list->first = NULL;
+	list->last = NULL;
+}
+
 struct iproto_thread {
 	/**
 	 * Slab cache used for allocating memory for output network buffers
@@ -161,18 +223,26 @@ struct iproto_thread {
 	struct cmsg_hop misc_route[2];
 	struct cmsg_hop call_route[2];
 	struct cmsg_hop select_route[2];
+	struct cmsg_hop select_batch_route[2];
 	struct cmsg_hop process1_route[2];
 	struct cmsg_hop sql_route[2];
 	struct cmsg_hop join_route[2];
 	struct cmsg_hop subscribe_route[2];
 	struct cmsg_hop error_route[2];
 	struct cmsg_hop push_route[2];
+	struct cmsg_hop fetch_route[1];
+	struct cmsg_hop fetch_ack_route[1];
 	struct cmsg_hop *dml_route[IPROTO_TYPE_STAT_MAX];
 	struct cmsg_hop connect_route[2];
 	/*
 	 * Iproto thread memory pools
 	 */
 	struct mempool iproto_msg_pool;
+	/**
+	 * Pool of struct iproto_tuple_ref. Used by the tx thread,
+	 * allocates from net_slabc.
+	 */
+	struct mempool tuple_ref_pool;
 	struct mempool iproto_connection_pool;
 	struct mempool iproto_stream_pool;
 	/*
@@ -191,6 +261,8 @@ struct iproto_thread {
 	struct evio_service binary;
 	/** Requests count currently pending in stream queue. */
 	size_t requests_in_stream_queue;
+	/** Busy polling of the thread event loop. */
+	struct busy_poll busy_poll;
 	/**
 	 * The following fields are used exclusively by the tx thread.
 	 * Align them to prevent false-sharing.
@@ -201,6 +273,11 @@ struct iproto_thread {
 		size_t requests_in_progress;
 		/** Iproto thread stat collected in tx thread. */
 		struct rmean *rmean;
+		/**
+		 * Time requests spend in the queue before the tx
+		 * thread starts processing them.
+		 */
+		struct latency queue_latency;
 	} tx;
 };
 
@@ -237,6 +314,30 @@ struct iproto_kharon {
 	struct iproto_wpos wpos;
 };
 
+/**
+ * State of a SELECT request with IPROTO_FETCH_SIZE, which sends
+ * its reply in chunks as the index is iterated. Each chunk is
+ * carried to the iproto thread by the message, which returns to
+ * tx only when the chunk has been written to the socket, so the
+ * tx thread doesn't produce data faster than the client reads
+ * it.
+ */
+struct iproto_fetch {
+	/**
+	 * Tx thread sets wpos to the end of the chunk, iproto
+	 * returns it set to the last flushed position.
+	 */
+	struct iproto_kharon kharon;
+	/** Link in iproto_connection::fetch_queue. */
+	struct stailq_entry in_queue;
+	/** Fiber waiting for the message to return to tx. */
+	struct fiber *fiber;
+	/** True while the message is in the iproto thread. */
+	bool is_sent;
+	/** Set by iproto if the chunk couldn't be delivered. */
+	bool is_closed;
+};
+
 /**
  * Network readahead. A signed integer to avoid
  * automatic type coercion to an unsigned type.
@@ -257,6 +358,24 @@ unsigned iproto_readahead = 16320;
 /* The maximal number of iproto messages in fly. */
 static int iproto_msg_max = IPROTO_MSG_MAX_MIN;
 
+/*
+ * The maximal number of iproto messages of one connection
+ * in fly, 0 if unlimited.
+ */
+static int iproto_msg_max_per_connection;
+
+/*
+ * The maximal number of requests of one user processed by
+ * the tx thread at the same time, 0 if unlimited.
+ */
+static int tx_msg_max_per_user;
+
+/*
+ * Number of requests processed by the tx thread, indexed by
+ * the auth token of the user who sent them.
+ */
+static int tx_user_requests[BOX_USER_MAX + 1];
+
 int
 iproto_addr_count(void)
 {
@@ -344,6 +463,13 @@ struct iproto_msg
 	 * ibuf object.
 	 */
 	size_t len;
+	/** Time the request was read from the socket, monotonic. */
+	double recv_time;
+	/**
+	 * Auth token of the user the request is accounted to in
+	 * tx_user_requests, see tx_start_msg().
+	 */
+	uint8_t auth_token;
 	/**
 	 * Position in the connection output buffer. When sending a
 	 * message to the tx thread, iproto sets it to its current
@@ -374,6 +500,17 @@ struct iproto_msg
 	struct stailq_entry in_stream;
 	/** Stream that owns this message, or NULL. */
 	struct iproto_stream *stream;
+	/**
+	 * SELECT requests following this one in the input buffer,
+	 * which are processed by the tx thread in the same fiber,
+	 * see iproto_enqueue_batch(). Only replies of the whole
+	 * batch are flushed.
+	 */
+	struct stailq batch;
+	/** A link in the batch of the leading message. */
+	struct stailq_entry in_batch;
+	/** Used to stream the reply of a SELECT in chunks. */
+	struct iproto_fetch fetch;
 };
 
 static struct iproto_msg *
@@ -385,6 +522,13 @@ iproto_msg_new(struct iproto_connection *con);
 static void
 iproto_resume(struct iproto_thread *iproto_thread);
 
+/**
+ * Resume a connection stopped by the per-connection message
+ * limit, if it's below the limit again.
+ */
+static void
+iproto_connection_resume_msg_max(struct iproto_connection *con);
+
 static void
 iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		  bool *stop_input);
@@ -410,11 +554,13 @@ const char *rmean_net_strings[RMEAN_NET_LAST] = {
 
 enum rmean_tx_name {
 	REQUESTS_IN_PROGRESS,
+	REQUESTS_SHED,
 	RMEAN_TX_LAST,
 };
 
 const char *rmean_tx_strings[RMEAN_TX_LAST] = {
 	"REQUESTS_IN_PROGRESS",
+	"REQUESTS_SHED",
 };
 
 static void
@@ -531,12 +677,26 @@ struct iproto_connection
 	 * is flushed by the iproto thread.
 	 */
 	struct obuf obuf[2];
+	/**
+	 * Tuples referenced by the output buffers, see struct
+	 * iproto_tuple_ref. Appended by the tx thread, which
+	 * frees them when the buffer is reset.
+	 */
+	struct iproto_tuple_ref_list obuf_refs[2];
 	/**
 	 * Position in the output buffer that points to the beginning
 	 * of the data awaiting to be flushed. Advanced by the iproto
 	 * thread upon successfull flush.
 	 */
 	struct iproto_wpos wpos;
+	/**
+	 * Last tuple reference of the output buffer at wpos
+	 * flushed to the socket, NULL if none. Accessed only
+	 * by the iproto thread.
+	 */
+	struct iproto_tuple_ref *wref;
+	/** Number of bytes of the next tuple reference flushed. */
+	uint32_t wref_offset;
 	/**
 	 * Position in the output buffer that points to the end of the
 	 * data awaiting to be flushed. Advanced by the iproto thread
@@ -562,6 +722,14 @@ struct iproto_connection
 	 * connections.
 	 */
 	int long_poll_count;
+	/** Number of messages of the connection in fly. */
+	int msg_count;
+	/**
+	 * Set if the connection input is stopped because the
+	 * connection reached iproto_msg_max_per_connection. The
+	 * input is resumed when one of its messages is deleted.
+	 */
+	bool is_msg_max_stopped;
 	/** I/O stream used for communication with the client. */
 	struct iostream io;
 	struct ev_io input;
@@ -632,6 +800,12 @@ struct iproto_connection
 	 *                          ...
 	 */
 	struct iproto_kharon kharon;
+	/**
+	 * Chunks of streamed SELECT replies waiting to be flushed,
+	 * see struct iproto_fetch. Accessible only from iproto
+	 * thread.
+	 */
+	struct stailq fetch_queue;
 	/**
 	 * The following fields are used exclusively by the tx thread.
 	 * Align them to prevent false-sharing.
@@ -718,11 +892,27 @@ iproto_check_msg_max(struct iproto_thread *iproto_thread)
 	return request_count > (size_t) iproto_msg_max;
 }
 
+/**
+ * Return true if the connection has used up its share of
+ * messages, see iproto_msg_max_per_connection.
+ */
+static inline bool
+iproto_connection_check_msg_max(struct iproto_connection *con)
+{
+	return iproto_msg_max_per_connection != 0 &&
+	       con->msg_count >= iproto_msg_max_per_connection;
+}
+
 static inline void
 iproto_msg_delete(struct iproto_msg *msg)
 {
-	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
-	mempool_free(&msg->connection->iproto_thread->iproto_msg_pool, msg);
+	struct iproto_connection *con = msg->connection;
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	mempool_free(&iproto_thread->iproto_msg_pool, msg);
+	assert(con->msg_count > 0);
+	con->msg_count--;
+	if (con->is_msg_max_stopped)
+		iproto_connection_resume_msg_max(con);
 	iproto_resume(iproto_thread);
 }
 
@@ -754,6 +944,12 @@ iproto_msg_new(struct iproto_connection *con)
 	msg->close_connection = false;
 	msg->connection = con;
 	msg->stream = NULL;
+	stailq_create(&msg->batch);
+	msg->fetch.fiber = NULL;
+	msg->fetch.is_sent = false;
+	msg->fetch.is_closed = false;
+	msg->recv_time = clock_monotonic();
+	con->msg_count++;
 	rmean_collect(con->iproto_thread->rmean, IPROTO_REQUESTS, 1);
 	return msg;
 }
@@ -765,7 +961,8 @@ static inline void
 iproto_connection_feed_input(struct iproto_connection *con)
 {
 	assert(con->state == IPROTO_CONNECTION_ALIVE);
-	if (!ev_is_active(&con->input) && rlist_empty(&con->in_stop_list))
+	if (!ev_is_active(&con->input) && rlist_empty(&con->in_stop_list) &&
+	    !con->is_msg_max_stopped)
 		ev_feed_event(con->loop, &con->input, EV_CUSTOM);
 }
 
@@ -843,6 +1040,24 @@ iproto_connection_stop_msg_max_limit(struct iproto_connection *con)
 		       &con->in_stop_list);
 }
 
+/**
+ * Stop input when the connection has too many messages in fly.
+ * Unlike the net_msg_max limit, only this connection is stopped,
+ * so a client sending requests faster than they are processed
+ * doesn't hold back the others. The input is resumed as soon as
+ * one of the connection messages completes.
+ */
+static inline void
+iproto_connection_stop_msg_max_per_connection(struct iproto_connection *con)
+{
+	assert(rlist_empty(&con->in_stop_list));
+	say_warn_ratelimited("stopping input on connection %s, "
+			     "net_msg_max_per_connection limit is reached",
+			     iproto_connection_name(con));
+	ev_io_stop(con->loop, &con->input);
+	con->is_msg_max_stopped = true;
+}
+
 /**
  * Send a destroy message to TX thread in case all requests are
  * finished.
@@ -872,6 +1087,32 @@ iproto_connection_try_to_start_destroy(struct iproto_connection *con)
 	cpipe_push(&con->iproto_thread->tx_pipe, &con->destroy_msg);
 }
 
+/**
+ * Return a chunk message of a streamed SELECT to the tx thread
+ * along with the last flushed position.
+ */
+static void
+net_end_fetch(struct iproto_connection *con, struct iproto_fetch *fetch)
+{
+	fetch->is_closed = con->state != IPROTO_CONNECTION_ALIVE ||
+			   !con->can_write;
+	fetch->kharon.wpos = con->wpos;
+	cmsg_init(&fetch->kharon.base, con->iproto_thread->fetch_ack_route);
+	cpipe_push(&con->iproto_thread->tx_pipe, &fetch->kharon.base);
+}
+
+/** Return all chunk messages waiting for the output flush to tx. */
+static void
+iproto_connection_end_fetch(struct iproto_connection *con)
+{
+	while (!stailq_empty(&con->fetch_queue)) {
+		struct iproto_fetch *fetch =
+			stailq_shift_entry(&con->fetch_queue,
+					   struct iproto_fetch, in_queue);
+		net_end_fetch(con, fetch);
+	}
+}
+
 /**
  * Initiate a connection shutdown. This method may
  * be invoked many times, and does the internal
@@ -916,6 +1157,8 @@ iproto_connection_close(struct iproto_connection *con)
 		cpipe_push(&con->iproto_thread->tx_pipe, &con->disconnect_msg);
 		assert(con->state == IPROTO_CONNECTION_ALIVE);
 		con->state = IPROTO_CONNECTION_CLOSED;
+		/* Nothing will be flushed, release the waiters. */
+		iproto_connection_end_fetch(con);
 	} else if (con->state == IPROTO_CONNECTION_PENDING_DESTROY) {
 		iproto_connection_try_to_start_destroy(con);
 	} else {
@@ -1071,11 +1314,48 @@ iproto_msg_start_processing_in_stream(struct iproto_msg *msg)
 	return 1;
 }
 
+/**
+ * Check if a message can be added to a batch of SELECT requests
+ * processed by the tx thread in one fiber. Only successfully
+ * decoded SELECT requests that don't belong to any stream are
+ * batched: they don't depend on the session transaction state,
+ * and an error in one of them doesn't affect the others. A SELECT
+ * with IPROTO_FETCH_SIZE may wait for the client, so it must not
+ * hold back the requests following it.
+ */
+static inline bool
+iproto_msg_is_batchable(struct iproto_msg *msg)
+{
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
+	return msg->base.route == iproto_thread->select_route &&
+	       msg->stream == NULL && msg->dml.fetch_size == 0;
+}
+
+/**
+ * Push a batch of SELECT requests to the tx thread. A batch of
+ * one request is processed as a regular SELECT.
+ */
+static inline void
+iproto_push_select_batch(struct iproto_connection *con,
+			 struct iproto_msg *batch)
+{
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	if (!stailq_empty(&batch->batch))
+		cmsg_init(&batch->base, iproto_thread->select_batch_route);
+	cpipe_push_input(&iproto_thread->tx_pipe, &batch->base);
+}
+
 /**
  * Enqueue all requests which were read up. If a request limit is
  * reached - stop the connection input even if not the whole batch
  * is enqueued. Else try to read more feeding read event to the
  * event loop.
+ *
+ * Consecutive SELECT requests are coalesced into one message
+ * so that a pipelining client doesn't pay for a cbus delivery
+ * and a fiber switch per request. Each request still gets its
+ * own reply, with its own sync and error.
+ *
  * @param con Connection to enqueue in.
  * @param in Buffer to parse.
  *
@@ -1089,8 +1369,20 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 	int n_requests = 0;
 	bool stop_input = false;
 	const char *errmsg;
+	/* Batch of SELECT requests that hasn't been pushed yet. */
+	struct iproto_msg *batch = NULL;
+	int batch_size = 0;
 	while (con->parse_size != 0 && !stop_input) {
+		if (iproto_connection_check_msg_max(con)) {
+			if (batch != NULL)
+				iproto_push_select_batch(con, batch);
+			iproto_connection_stop_msg_max_per_connection(con);
+			cpipe_flush_input(&con->iproto_thread->tx_pipe);
+			return 0;
+		}
 		if (iproto_check_msg_max(con->iproto_thread)) {
+			if (batch != NULL)
+				iproto_push_select_batch(con, batch);
 			iproto_connection_stop_msg_max_limit(con);
 			cpipe_flush_input(&con->iproto_thread->tx_pipe);
 			return 0;
@@ -1101,6 +1393,8 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		if (mp_typeof(*pos) != MP_UINT) {
 			errmsg = "packet length";
 err_msgpack:
+			if (batch != NULL)
+				iproto_push_select_batch(con, batch);
 			cpipe_flush_input(&con->iproto_thread->tx_pipe);
 			diag_set(ClientError, ER_INVALID_MSGPACK,
 				 errmsg);
@@ -1124,6 +1418,8 @@ err_msgpack:
 			 * Do not treat it as an error - just wait
 			 * until some of requests are finished.
 			 */
+			if (batch != NULL)
+				iproto_push_select_batch(con, batch);
 			iproto_connection_stop_msg_max_limit(con);
 			return 0;
 		}
@@ -1137,13 +1433,36 @@ err_msgpack:
 		int rc = iproto_msg_start_processing_in_stream(msg);
 		if (rc < 0) {
 			iproto_msg_delete(msg);
+			if (batch != NULL)
+				iproto_push_select_batch(con, batch);
 			return -1;
 		}
 		/*
 		 * rc > 0, means that stream pending requests queue is not
 		 * empty, skip push.
 		 */
-		if (rc == 0) {
+		if (rc == 0 && iproto_msg_is_batchable(msg)) {
+			if (batch != NULL &&
+			    batch_size < IPROTO_SELECT_BATCH_MAX) {
+				stailq_add_tail_entry(&batch->batch, msg,
+						      in_batch);
+				batch_size++;
+			} else {
+				if (batch != NULL)
+					iproto_push_select_batch(con, batch);
+				batch = msg;
+				batch_size = 1;
+			}
+			n_requests++;
+		} else if (rc == 0) {
+			/*
+			 * Keep the order of requests in the tx
+			 * pipe: push the pending batch first.
+			 */
+			if (batch != NULL) {
+				iproto_push_select_batch(con, batch);
+				batch = NULL;
+			}
 			/*
 			 * This can't throw, but should not be
 			 * done in case of exception.
@@ -1157,6 +1476,8 @@ err_msgpack:
 		assert(con->parse_size >= (size_t) (reqend - reqstart));
 		con->parse_size -= reqend - reqstart;
 	}
+	if (batch != NULL)
+		iproto_push_select_batch(con, batch);
 	if (stop_input) {
 		/**
 		 * Don't mess with the file descriptor
@@ -1214,6 +1535,28 @@ iproto_connection_resume(struct iproto_connection *con)
 	}
 }
 
+static void
+iproto_connection_resume_msg_max(struct iproto_connection *con)
+{
+	assert(con->is_msg_max_stopped);
+	if (iproto_connection_check_msg_max(con))
+		return;
+	con->is_msg_max_stopped = false;
+	if (con->state != IPROTO_CONNECTION_ALIVE)
+		return;
+	if (iproto_check_msg_max(con->iproto_thread)) {
+		iproto_connection_stop_msg_max_limit(con);
+		return;
+	}
+	/* Enqueue the requests read up while the input was stopped. */
+	if (iproto_enqueue_batch(con, con->p_ibuf) != 0) {
+		struct error *e = box_error_last();
+		iproto_write_error(&con->io, e, ::schema_version, 0);
+		error_log(e);
+		iproto_connection_close(con);
+	}
+}
+
 /**
  * Resume as many connections as possible until a request limit is
  * reached. By design of iproto_enqueue_batch(), a paused
@@ -1259,6 +1602,10 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 		iproto_connection_stop_msg_max_limit(con);
 		return;
 	}
+	if (iproto_connection_check_msg_max(con)) {
+		iproto_connection_stop_msg_max_per_connection(con);
+		return;
+	}
 
 	try {
 		/* Ensure we have sufficient space for the next round.  */
@@ -1302,6 +1649,73 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	}
 }
 
+/**
+ * Return the tuple reference following @a ref in the output
+ * buffer at wpos, or the first one if @a ref is NULL. Returns
+ * NULL if there's no such reference before @a end.
+ */
+static inline struct iproto_tuple_ref *
+iproto_next_tuple_ref(struct iproto_connection *con,
+		      const struct iproto_tuple_ref *ref,
+		      const struct obuf_svp *end)
+{
+	struct iproto_tuple_ref *next;
+	if (ref == NULL) {
+		struct iproto_tuple_ref_list *list =
+			&con->obuf_refs[con->wpos.obuf - con->obuf];
+		next = __atomic_load_n(&list->first, __ATOMIC_ACQUIRE);
+	} else {
+		next = __atomic_load_n(&ref->next, __ATOMIC_ACQUIRE);
+	}
+	/*
+	 * References of replies not passed to the iproto thread
+	 * yet are always past the end, because a reply starts
+	 * with a header written to the buffer.
+	 */
+	if (next == NULL || next->svp.used > end->used)
+		return NULL;
+	return next;
+}
+
+/**
+ * Fill iovecs with the output buffer data between two positions.
+ * Returns the number of iovecs filled.
+ */
+static int
+iproto_obuf_to_iov(struct obuf *obuf, const struct obuf_svp *begin,
+		   const struct obuf_svp *end, struct iovec *iov)
+{
+	int iovcnt = end->pos - begin->pos + 1;
+	/*
+	 * iov[i].iov_len may be concurrently modified in tx thread,
+	 * but only for the last position.
+	 */
+	memcpy(iov, obuf->iov + begin->pos, iovcnt * sizeof(struct iovec));
+	sio_add_to_iov(iov, -begin->iov_len);
+	/* *Overwrite* iov_len of the last pos as it may be garbage. */
+	iov[iovcnt-1].iov_len = end->iov_len - begin->iov_len * (iovcnt == 1);
+	return iovcnt;
+}
+
+/**
+ * Advance a position in the output buffer by @a size bytes,
+ * not crossing @a end.
+ */
+static void
+iproto_obuf_svp_advance(struct obuf *obuf, struct obuf_svp *svp,
+			const struct obuf_svp *end, size_t size)
+{
+	assert(svp->used + size <= end->used);
+	svp->used += size;
+	size += svp->iov_len;
+	/* Only the length of the last position may change. */
+	while (svp->pos < end->pos && size >= obuf->iov[svp->pos].iov_len) {
+		size -= obuf->iov[svp->pos].iov_len;
+		svp->pos++;
+	}
+	svp->iov_len = size;
+}
+
 /** writev() to the socket and handle the result. */
 static int
 iproto_flush(struct iproto_connection *con)
@@ -1315,51 +1729,96 @@ iproto_flush(struct iproto_connection *con)
 		 * Flush the current buffer before
 		 * advancing to the next one.
 		 */
-		if (begin->used == obuf_end.used) {
+		if (begin->used == obuf_end.used &&
+		    iproto_next_tuple_ref(con, con->wref, &obuf_end) == NULL) {
 			obuf = con->wpos.obuf = con->wend.obuf;
 			obuf_svp_reset(begin);
+			con->wref = NULL;
+			con->wref_offset = 0;
 		} else {
 			end = &obuf_end;
 		}
 	}
-	if (begin->used == end->used) {
+	struct iproto_tuple_ref *ref =
+		iproto_next_tuple_ref(con, con->wref, end);
+	if (begin->used == end->used && ref == NULL) {
 		/* Nothing to do. */
 		return 1;
 	}
 	if (!con->can_write) {
 		/* Receiving end was closed. Discard the output. */
 		*begin = *end;
+		for (; ref != NULL; ref = iproto_next_tuple_ref(con, ref, end))
+			con->wref = ref;
+		con->wref_offset = 0;
 		return 0;
 	}
-	assert(begin->used < end->used);
-	struct iovec iov[SMALL_OBUF_IOV_MAX+1];
-	struct iovec *src = obuf->iov;
-	int iovcnt = end->pos - begin->pos + 1;
+	assert(begin->used <= end->used);
 	/*
-	 * iov[i].iov_len may be concurrently modified in tx thread,
-	 * but only for the last position.
+	 * Collect the buffer chunks up to the end position. Data
+	 * of referenced tuples goes between them.
 	 */
-	memcpy(iov, src + begin->pos, iovcnt * sizeof(struct iovec));
-	sio_add_to_iov(iov, -begin->iov_len);
-	/* *Overwrite* iov_len of the last pos as it may be garbage. */
-	iov[iovcnt-1].iov_len = end->iov_len - begin->iov_len * (iovcnt == 1);
+	struct iovec iov[IPROTO_FLUSH_IOV_MAX];
+	int iovcnt = 0;
+	int refcnt = 0;
+	bool is_complete = false;
+	struct obuf_svp pos = *begin;
+	uint32_t ref_offset = con->wref_offset;
+	while (true) {
+		const struct obuf_svp *seg_end = ref != NULL ? &ref->svp : end;
+		/* Reserve room for the chunks and the tuple. */
+		if (iovcnt + seg_end->pos - pos.pos + 2 > IPROTO_FLUSH_IOV_MAX)
+			break;
+		if (pos.used < seg_end->used) {
+			iovcnt += iproto_obuf_to_iov(obuf, &pos, seg_end,
+						     iov + iovcnt);
+		}
+		if (ref == NULL) {
+			is_complete = true;
+			break;
+		}
+		iov[iovcnt].iov_base = (char *)ref->data + ref_offset;
+		iov[iovcnt].iov_len = ref->size - ref_offset;
+		iovcnt++;
+		refcnt++;
+		ref_offset = 0;
+		pos = ref->svp;
+		ref = iproto_next_tuple_ref(con, ref, end);
+	}
+	assert(iovcnt > 0);
 
 	ssize_t nwr = iostream_writev(&con->io, iov, iovcnt);
 	if (nwr >= 0) {
 		/* Count statistics */
 		rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
-		if (begin->used + nwr == end->used) {
-			*begin = *end;
-			return 0;
+		/* Advance the write position past the written data. */
+		size_t left = nwr;
+		ref = iproto_next_tuple_ref(con, con->wref, end);
+		for (int i = 0; i < refcnt || is_complete; i++) {
+			const struct obuf_svp *seg_end =
+				i < refcnt ? &ref->svp : end;
+			size_t seg_size = seg_end->used - begin->used;
+			if (left < seg_size) {
+				iproto_obuf_svp_advance(obuf, begin, seg_end,
+							left);
+				return IOSTREAM_WANT_WRITE;
+			}
+			left -= seg_size;
+			*begin = *seg_end;
+			if (i == refcnt)
+				break;
+			uint32_t ref_size = ref->size - con->wref_offset;
+			if (left < ref_size) {
+				con->wref_offset += left;
+				return IOSTREAM_WANT_WRITE;
+			}
+			left -= ref_size;
+			con->wref = ref;
+			con->wref_offset = 0;
+			ref = iproto_next_tuple_ref(con, ref, end);
 		}
-		size_t offset = 0;
-		int advance = 0;
-		advance = sio_move_iov(iov, nwr, &offset);
-		begin->used += nwr;             /* advance write position */
-		begin->iov_len = advance == 0 ? begin->iov_len + offset: offset;
-		begin->pos += advance;
-		assert(begin->pos <= end->pos);
-		return IOSTREAM_WANT_WRITE;
+		assert(left == 0);
+		return 0;
 	} else if (nwr == IOSTREAM_ERROR) {
 		/*
 		 * Don't close the connection on write error. Log the error and
@@ -1369,7 +1828,6 @@ iproto_flush(struct iproto_connection *con)
 		 */
 		diag_log();
 		con->can_write = false;
-		*begin = *end;
 		return 0;
 	}
 	return nwr;
@@ -1395,6 +1853,8 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 	}
 	if (ev_is_active(&con->output))
 		ev_io_stop(con->loop, &con->output);
+	/* All output has been flushed, wake up streamed SELECTs. */
+	iproto_connection_end_fetch(con);
 	/*
 	 * If the out channel isn't clogged, we can read more requests.
 	 * Note, we trigger input even if we didn't write any responses
@@ -1428,13 +1888,20 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 		    iproto_readahead);
 	con->p_ibuf = &con->ibuf[0];
 	con->tx.p_obuf = &con->obuf[0];
+	iproto_tuple_ref_list_create(&con->obuf_refs[0]);
+	iproto_tuple_ref_list_create(&con->obuf_refs[1]);
 	iproto_wpos_create(&con->wpos, con->tx.p_obuf);
 	iproto_wpos_create(&con->wend, con->tx.p_obuf);
+	con->wref = NULL;
+	con->wref_offset = 0;
 	con->parse_size = 0;
 	con->can_write = true;
 	con->long_poll_count = 0;
+	con->msg_count = 0;
+	con->is_msg_max_stopped = false;
 	con->session = NULL;
 	rlist_create(&con->in_stop_list);
+	stailq_create(&con->fetch_queue);
 	/* It may be very awkward to allocate at close. */
 	cmsg_init(&con->destroy_msg, con->iproto_thread->destroy_route);
 	cmsg_init(&con->disconnect_msg, con->iproto_thread->disconnect_route);
@@ -1555,8 +2022,9 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 	case IPROTO_UPDATE:
 	case IPROTO_DELETE:
 	case IPROTO_UPSERT:
-		if (xrow_decode_dml(&msg->header, &msg->dml,
-				    dml_request_key_map(type)))
+	case IPROTO_DELETE_RANGE:
+		if (xrow_decode_dml_iproto(&msg->header, &msg->dml,
+					   dml_request_key_map(type)))
 			goto error;
 		/*
 		 * In contrast to replication requests, for a client request
@@ -1603,6 +2071,11 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 			goto error;
 		cmsg_init(&msg->base, iproto_thread->sql_route);
 		break;
+	case IPROTO_BOX_PREPARE:
+		if (xrow_decode_dml(&msg->header, &msg->dml, 0) != 0)
+			goto error;
+		cmsg_init(&msg->base, iproto_thread->misc_route);
+		break;
 	case IPROTO_PING:
 		cmsg_init(&msg->base, iproto_thread->misc_route);
 		break;
@@ -1618,6 +2091,7 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		break;
 	case IPROTO_JOIN:
 	case IPROTO_FETCH_SNAPSHOT:
+	case IPROTO_FETCH_CHECKPOINT:
 	case IPROTO_REGISTER:
 		cmsg_init(&msg->base, iproto_thread->join_route);
 		*stop_input = true;
@@ -1734,6 +2208,185 @@ net_finish_disconnect(struct cmsg *m)
 	iproto_connection_try_to_start_destroy(con);
 }
 
+/** Unreference the tuples of a list and free the references. */
+static void
+tx_tuple_ref_list_destroy(struct iproto_thread *iproto_thread,
+			  struct iproto_tuple_ref_list *list)
+{
+	struct iproto_tuple_ref *ref = list->first;
+	while (ref != NULL) {
+		struct iproto_tuple_ref *next = ref->next;
+		tuple_unref(ref->tuple);
+		mempool_free(&iproto_thread->tuple_ref_pool, ref);
+		ref = next;
+	}
+	iproto_tuple_ref_list_create(list);
+}
+
+/**
+ * Reset an output buffer flushed by the iproto thread and release
+ * the tuples it references.
+ */
+static void
+tx_reset_obuf(struct iproto_connection *con, struct obuf *obuf)
+{
+	obuf_reset(obuf);
+	tx_tuple_ref_list_destroy(con->iproto_thread,
+				  &con->obuf_refs[obuf - con->obuf]);
+}
+
+/**
+ * Reference a tuple dumped to the output buffer instead of copying
+ * its data. The reference is added to @a refs, which is private to
+ * the reply being written, see tx_commit_tuple_refs().
+ */
+static int
+tx_add_tuple_ref(struct iproto_connection *con, struct obuf *out,
+		 struct tuple *tuple, struct iproto_tuple_ref_list *refs)
+{
+	struct iproto_tuple_ref *ref = (struct iproto_tuple_ref *)
+		mempool_alloc(&con->iproto_thread->tuple_ref_pool);
+	if (ref == NULL) {
+		diag_set(OutOfMemory, sizeof(*ref), "mempool_alloc",
+			 "struct iproto_tuple_ref");
+		return -1;
+	}
+	ref->next = NULL;
+	ref->svp = obuf_create_svp(out);
+	ref->tuple = tuple;
+	ref->data = tuple_data_range(tuple, &ref->size);
+	tuple_ref(tuple);
+	if (refs->last == NULL)
+		refs->first = ref;
+	else
+		refs->last->next = ref;
+	refs->last = ref;
+	return 0;
+}
+
+/**
+ * Pass the tuple references of a complete reply to the iproto
+ * thread by appending them to the output buffer list. Must be
+ * called before the write position of the reply is created.
+ */
+static void
+tx_commit_tuple_refs(struct iproto_connection *con, struct obuf *out,
+		     struct iproto_tuple_ref_list *refs)
+{
+	if (refs->first == NULL)
+		return;
+	struct iproto_tuple_ref_list *list = &con->obuf_refs[out - con->obuf];
+	if (list->last == NULL)
+		__atomic_store_n(&list->first, refs->first, __ATOMIC_RELEASE);
+	else
+		__atomic_store_n(&list->last->next, refs->first,
+				 __ATOMIC_RELEASE);
+	list->last = refs->last;
+	iproto_tuple_ref_list_create(refs);
+}
+
+/** Output of a reply that references big tuples. */
+struct tx_dump_ctx {
+	struct iproto_connection *con;
+	struct obuf *out;
+	struct iproto_tuple_ref_list *refs;
+};
+
+/**
+ * Write a tuple to the reply: copy a small tuple, reference
+ * a big one. Used as port_dump_tuple_f.
+ */
+static int
+tx_dump_tuple(struct tuple *tuple, void *arg)
+{
+	struct tx_dump_ctx *ctx = (struct tx_dump_ctx *)arg;
+	if (tuple_bsize(tuple) < IPROTO_TUPLE_REF_MIN_SIZE)
+		return tuple_to_obuf(tuple, ctx->out);
+	return tx_add_tuple_ref(ctx->con, ctx->out, tuple, ctx->refs);
+}
+
+/**
+ * Dump a Lua port, passing returned tuples to tx_dump_tuple().
+ * On failure the references added to @a refs are released.
+ */
+static int
+tx_dump_port_lua(struct iproto_connection *con, struct port *port,
+		 struct obuf *out, struct iproto_tuple_ref_list *refs,
+		 bool is_16)
+{
+	struct tx_dump_ctx ctx = {con, out, refs};
+	int rc = port_lua_dump_with_tuples(port, out, is_16,
+					   tx_dump_tuple, &ctx);
+	if (rc < 0)
+		tx_tuple_ref_list_destroy(con->iproto_thread, refs);
+	return rc;
+}
+
+/**
+ * Dump a port to the output buffer like port_dump_msgpack_16(),
+ * but reference big tuples instead of copying their data. On
+ * failure the references added to @a refs are released.
+ */
+static int
+tx_dump_port_16(struct iproto_connection *con, struct port *base,
+		struct obuf *out, struct iproto_tuple_ref_list *refs)
+{
+	if (base->vtab == &port_lua_vtab)
+		return tx_dump_port_lua(con, base, out, refs, true);
+	if (base->vtab != &port_c_vtab)
+		return port_dump_msgpack_16(base, out);
+	struct tx_dump_ctx ctx = {con, out, refs};
+	struct port_c *port = (struct port_c *)base;
+	struct port_c_entry *pe;
+	for (pe = port->first; pe != NULL; pe = pe->next) {
+		uint32_t size = pe->mp_size;
+		if (size == 0) {
+			if (tx_dump_tuple(pe->tuple, &ctx) != 0)
+				goto error;
+		} else if (obuf_dup(out, pe->mp, size) != size) {
+			diag_set(OutOfMemory, size, "obuf_dup", "data");
+			goto error;
+		}
+		ERROR_INJECT(ERRINJ_PORT_DUMP, {
+			diag_set(OutOfMemory,
+				 size == 0 ? tuple_size(pe->tuple) : size,
+				 "obuf_dup", "data");
+			goto error;
+		});
+	}
+	return port->size;
+error:
+	tx_tuple_ref_list_destroy(con->iproto_thread, refs);
+	return -1;
+}
+
+/**
+ * Dump a port to the output buffer like port_dump_msgpack(), but
+ * reference big tuples instead of copying their data. On failure
+ * the references added to @a refs are released.
+ */
+static int
+tx_dump_port(struct iproto_connection *con, struct port *base,
+	     struct obuf *out, struct iproto_tuple_ref_list *refs)
+{
+	if (base->vtab == &port_lua_vtab)
+		return tx_dump_port_lua(con, base, out, refs, false);
+	if (base->vtab != &port_c_vtab)
+		return port_dump_msgpack(base, out);
+	/* Same as port_c_dump_msgpack(). */
+	struct port_c *port = (struct port_c *)base;
+	char *size_buf = (char *)obuf_alloc(out, mp_sizeof_array(port->size));
+	if (size_buf == NULL) {
+		diag_set(OutOfMemory, mp_sizeof_array(port->size),
+			 "obuf_alloc", "size_buf");
+		return -1;
+	}
+	mp_encode_array(size_buf, port->size);
+	if (tx_dump_port_16(con, base, out, refs) < 0)
+		return -1;
+	return 1;
+}
+
 /**
  * Destroy the session object, as well as output buffers of the
  * connection.
@@ -1754,6 +2407,8 @@ tx_process_destroy(struct cmsg *m)
 	 */
 	obuf_destroy(&con->obuf[0]);
 	obuf_destroy(&con->obuf[1]);
+	tx_tuple_ref_list_destroy(con->iproto_thread, &con->obuf_refs[0]);
+	tx_tuple_ref_list_destroy(con->iproto_thread, &con->obuf_refs[1]);
 }
 
 /**
@@ -1832,7 +2487,7 @@ tx_accept_wpos(struct iproto_connection *con, const struct iproto_wpos *wpos)
 		 * buffers are never flushed out of order.
 		 */
 		if (obuf_size(prev) != 0)
-			obuf_reset(prev);
+			tx_reset_obuf(con, prev);
 	}
 	if (obuf_size(con->tx.p_obuf) != 0 && obuf_size(prev) == 0) {
 		/*
@@ -1862,16 +2517,32 @@ tx_prepare_transaction_for_request(struct iproto_msg *msg)
 	assert(!in_txn() || msg->stream != NULL);
 }
 
+/**
+ * Prepare the current fiber to process a request. Unlike
+ * tx_accept_msg(), doesn't touch the output buffers, so it's
+ * used for all but the first request of a SELECT batch.
+ */
+static inline void
+tx_start_msg(struct iproto_msg *msg)
+{
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
+	struct session *session = msg->connection->session;
+	tx_fiber_init(session, msg->header.sync);
+	tx_prepare_transaction_for_request(msg);
+	iproto_thread->tx.requests_in_progress++;
+	rmean_collect(iproto_thread->tx.rmean, REQUESTS_IN_PROGRESS, 1);
+	latency_collect(&iproto_thread->tx.queue_latency,
+			clock_monotonic() - msg->recv_time);
+	msg->auth_token = session->credentials.auth_token;
+	tx_user_requests[msg->auth_token]++;
+}
+
 static inline struct iproto_msg *
 tx_accept_msg(struct cmsg *m)
 {
 	struct iproto_msg *msg = (struct iproto_msg *) m;
 	tx_accept_wpos(msg->connection, &msg->wpos);
-	tx_fiber_init(msg->connection->session, msg->header.sync);
-	tx_prepare_transaction_for_request(msg);
-	msg->connection->iproto_thread->tx.requests_in_progress++;
-	rmean_collect(msg->connection->iproto_thread->tx.rmean,
-		      REQUESTS_IN_PROGRESS, 1);
+	tx_start_msg(msg);
 	return msg;
 }
 
@@ -1883,6 +2554,34 @@ tx_end_msg(struct iproto_msg *msg)
 		msg->stream->txn = txn_detach();
 	}
 	msg->connection->iproto_thread->tx.requests_in_progress--;
+	assert(tx_user_requests[msg->auth_token] > 0);
+	tx_user_requests[msg->auth_token]--;
+}
+
+/**
+ * Shed a request if its user has more than net_msg_max_per_user
+ * requests in progress, so that one user can't take up all tx
+ * fibers and stall the others. The admin user is exempt to be
+ * able to manage an overloaded instance. Only requests doing
+ * actual work are checked, while pings, authentication and other
+ * service requests are always processed.
+ */
+static int
+tx_check_user_quota(struct iproto_msg *msg)
+{
+	/* The request itself is already accounted. */
+	if (tx_msg_max_per_user == 0 ||
+	    tx_user_requests[msg->auth_token] <= tx_msg_max_per_user)
+		return 0;
+	struct credentials *cr = &msg->connection->session->credentials;
+	if (cr->uid == ADMIN)
+		return 0;
+	struct user *user = user_by_id(cr->uid);
+	diag_set(ClientError, ER_TOO_MANY_REQUESTS,
+		 user != NULL ? user->def->name : "");
+	rmean_collect(msg->connection->iproto_thread->tx.rmean,
+		      REQUESTS_SHED, 1);
+	return -1;
 }
 
 /**
@@ -2002,20 +2701,47 @@ tx_process1(struct cmsg *m)
 	struct iproto_msg *msg = tx_accept_msg(m);
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
+	if (tx_check_user_quota(msg) != 0)
+		goto error;
 
 	struct tuple *tuple;
 	struct obuf_svp svp;
 	struct obuf *out;
+	struct iproto_tuple_ref_list refs;
+	iproto_tuple_ref_list_create(&refs);
 	tx_inject_delay();
-	if (box_process1(&msg->dml, &tuple) != 0)
+	/*
+	 * Bind after the delay: the space of a statement is valid
+	 * only until the fiber yields.
+	 */
+	if (msg->dml.stmt_id != 0) {
+		struct box_stmt *stmt;
+		if (box_stmt_bind(&msg->dml, &stmt) != 0)
+			goto error;
+		int rc = box_process_space(&msg->dml, stmt->space, &tuple);
+		box_stmt_unref(stmt);
+		if (rc != 0)
+			goto error;
+	} else if (box_process1(&msg->dml, &tuple) != 0) {
 		goto error;
+	}
 	out = msg->connection->tx.p_obuf;
 	if (iproto_prepare_select(out, &svp) != 0)
 		goto error;
-	if (tuple && tuple_to_obuf(tuple, out))
-		goto error;
+	if (tuple != NULL) {
+		int rc;
+		if (tuple_bsize(tuple) < IPROTO_TUPLE_REF_MIN_SIZE)
+			rc = tuple_to_obuf(tuple, out);
+		else
+			rc = tx_add_tuple_ref(msg->connection, out, tuple, &refs);
+		if (rc != 0) {
+			obuf_rollback_to_svp(out, &svp);
+			goto error;
+		}
+	}
 	iproto_reply_select(out, &svp, msg->header.sync, ::schema_version,
 			    tuple != 0);
+	tx_commit_tuple_refs(msg->connection, out, &refs);
 	iproto_wpos_create(&msg->wpos, out);
 	tx_end_msg(msg);
 	return;
@@ -2024,23 +2750,122 @@ error:
 	tx_end_msg(msg);
 }
 
+/**
+ * Wait until the chunk message of a streamed SELECT returns
+ * from the iproto thread.
+ */
 static void
-tx_process_select(struct cmsg *m)
+tx_fetch_wait(struct iproto_msg *msg)
+{
+	struct iproto_fetch *fetch = &msg->fetch;
+	while (fetch->is_sent) {
+		fetch->fiber = fiber();
+		fiber_yield();
+	}
+	fetch->fiber = NULL;
+}
+
+/**
+ * Write a chunk of a streamed SELECT reply to the output buffer
+ * and send it to the iproto thread. Before writing, wait until
+ * the previous chunk is flushed to the socket, so that a slow
+ * client doesn't make the output buffer grow unbounded.
+ */
+static int
+tx_fetch_send_chunk(struct port *port, void *arg)
+{
+	struct iproto_msg *msg = (struct iproto_msg *)arg;
+	struct iproto_connection *con = msg->connection;
+	struct iproto_fetch *fetch = &msg->fetch;
+	tx_fetch_wait(msg);
+	if (fetch->is_closed) {
+		diag_set(ClientError, ER_SESSION_CLOSED);
+		return -1;
+	}
+	struct obuf *out = con->tx.p_obuf;
+	struct obuf_svp svp;
+	struct iproto_tuple_ref_list refs;
+	iproto_tuple_ref_list_create(&refs);
+	if (iproto_prepare_select(out, &svp) != 0)
+		return -1;
+	int count = tx_dump_port_16(con, port, out, &refs);
+	if (count < 0) {
+		obuf_rollback_to_svp(out, &svp);
+		return -1;
+	}
+	iproto_reply_select_chunk(out, &svp, msg->header.sync,
+				  ::schema_version, count);
+	tx_commit_tuple_refs(con, out, &refs);
+	cmsg_init(&fetch->kharon.base, con->iproto_thread->fetch_route);
+	iproto_wpos_create(&fetch->kharon.wpos, out);
+	fetch->is_sent = true;
+	cpipe_push(&con->iproto_thread->net_pipe, &fetch->kharon.base);
+	return 0;
+}
+
+static void
+tx_end_fetch(struct cmsg *m)
+{
+	struct iproto_fetch *fetch = (struct iproto_fetch *)m;
+	struct iproto_msg *msg = container_of(fetch, struct iproto_msg, fetch);
+	tx_accept_wpos(msg->connection, &fetch->kharon.wpos);
+	fetch->is_sent = false;
+	if (fetch->fiber != NULL)
+		fiber_wakeup(fetch->fiber);
+}
+
+/**
+ * Execute a SELECT request and write the reply or the error
+ * to the output buffer.
+ */
+static void
+tx_process_select_msg(struct iproto_msg *msg)
 {
-	struct iproto_msg *msg = tx_accept_msg(m);
 	struct obuf *out;
 	struct obuf_svp svp;
 	struct port port;
 	int count;
 	int rc;
+	uint32_t chunk_size;
+	struct box_stmt *stmt = NULL;
 	struct request *req = &msg->dml;
+	struct iproto_tuple_ref_list refs;
+	iproto_tuple_ref_list_create(&refs);
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
+	if (tx_check_user_quota(msg) != 0)
+		goto error;
 
 	tx_inject_delay();
-	rc = box_select(req->space_id, req->index_id,
-			req->iterator, req->offset, req->limit,
-			req->key, req->key_end, &port);
+	/*
+	 * Bind after the delay: the space and the index of a
+	 * statement are valid only until the fiber yields.
+	 */
+	if (req->stmt_id != 0 && box_stmt_bind(req, &stmt) != 0)
+		goto error;
+	/*
+	 * Stream the result in chunks. The final reply carries
+	 * the remaining tuples. Requests of a stream aren't
+	 * streamed, because a yield would abort the stream
+	 * transaction.
+	 */
+	chunk_size = msg->header.stream_id == 0 ? req->fetch_size : 0;
+	if (stmt != NULL) {
+		rc = box_select_index(stmt->space, stmt->index,
+				      req->iterator, req->offset, req->limit,
+				      req->key, req->key_end, chunk_size,
+				      tx_fetch_send_chunk, msg, &port);
+		box_stmt_unref(stmt);
+	} else {
+		rc = box_select_chunked(req->space_id, req->index_id,
+					req->iterator, req->offset,
+					req->limit, req->key, req->key_end,
+					chunk_size, tx_fetch_send_chunk,
+					msg, &port);
+	}
+	/* The chunk message is a part of msg, wait for it. */
+	if (chunk_size > 0)
+		tx_fetch_wait(msg);
 	if (rc < 0)
 		goto error;
 
@@ -2052,7 +2877,7 @@ tx_process_select(struct cmsg *m)
 	/*
 	 * SELECT output format has not changed since Tarantool 1.6
 	 */
-	count = port_dump_msgpack_16(&port, out);
+	count = tx_dump_port_16(msg->connection, &port, out, &refs);
 	port_destroy(&port);
 	if (count < 0) {
 		/* Discard the prepared select. */
@@ -2061,14 +2886,47 @@ tx_process_select(struct cmsg *m)
 	}
 	iproto_reply_select(out, &svp, msg->header.sync,
 			    ::schema_version, count);
+	tx_commit_tuple_refs(msg->connection, out, &refs);
 	iproto_wpos_create(&msg->wpos, out);
-	tx_end_msg(msg);
 	return;
 error:
 	tx_reply_error(msg);
+}
+
+static void
+tx_process_select(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	tx_process_select_msg(msg);
 	tx_end_msg(msg);
 }
 
+/**
+ * Process a batch of SELECT requests coalesced by the iproto
+ * thread in one fiber. Replies are written to the output buffer
+ * one after another, and the write position of the last one is
+ * returned to the iproto thread in the leading message.
+ */
+static void
+tx_process_select_batch(struct cmsg *m)
+{
+	struct iproto_msg *batch = tx_accept_msg(m);
+	tx_process_select_msg(batch);
+	tx_end_msg(batch);
+	struct iproto_msg *msg;
+	stailq_foreach_entry(msg, &batch->batch, in_batch) {
+		/*
+		 * Run on_stop triggers of the previous request,
+		 * as the fiber pool does between messages.
+		 */
+		fiber_on_stop(fiber());
+		tx_start_msg(msg);
+		tx_process_select_msg(msg);
+		tx_end_msg(msg);
+		batch->wpos = msg->wpos;
+	}
+}
+
 static int
 tx_process_call_on_yield(struct trigger *trigger, void *event)
 {
@@ -2086,6 +2944,8 @@ tx_process_call(struct cmsg *m)
 	struct iproto_msg *msg = tx_accept_msg(m);
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
+	if (tx_check_user_quota(msg) != 0)
+		goto error;
 
 	/*
 	 * CALL/EVAL should copy its arguments so we can discard
@@ -2140,6 +3000,8 @@ tx_process_call(struct cmsg *m)
 	int count;
 	struct obuf *out;
 	struct obuf_svp svp;
+	struct iproto_tuple_ref_list refs;
+	iproto_tuple_ref_list_create(&refs);
 
 	out = msg->connection->tx.p_obuf;
 	if (iproto_prepare_select(out, &svp) != 0) {
@@ -2148,9 +3010,9 @@ tx_process_call(struct cmsg *m)
 	}
 
 	if (msg->header.type == IPROTO_CALL_16)
-		count = port_dump_msgpack_16(&port, out);
+		count = tx_dump_port_16(msg->connection, &port, out, &refs);
 	else
-		count = port_dump_msgpack(&port, out);
+		count = tx_dump_port(msg->connection, &port, out, &refs);
 	port_destroy(&port);
 	if (count < 0) {
 		obuf_rollback_to_svp(out, &svp);
@@ -2159,6 +3021,7 @@ tx_process_call(struct cmsg *m)
 
 	iproto_reply_select(out, &svp, msg->header.sync,
 			    ::schema_version, count);
+	tx_commit_tuple_refs(msg->connection, out, &refs);
 	iproto_wpos_create(&msg->wpos, out);
 	tx_end_msg(msg);
 	return;
@@ -2173,6 +3036,27 @@ tx_process_id(struct iproto_connection *con, const struct id_request *id)
 	con->session->meta.features = id->features;
 }
 
+/**
+ * Prepare a box statement or, if the request has no statement
+ * type, deallocate the statement with the given id.
+ */
+static void
+tx_process_box_prepare(struct iproto_msg *msg, struct obuf *out)
+{
+	const struct request *request = &msg->dml;
+	if (request->stmt_type == 0) {
+		if (box_stmt_unprepare(request->stmt_id) != 0)
+			diag_raise();
+		iproto_reply_ok_xc(out, msg->header.sync, ::schema_version);
+		return;
+	}
+	uint32_t stmt_id;
+	if (box_stmt_prepare(request, &stmt_id) != 0)
+		diag_raise();
+	iproto_reply_stmt_id_xc(out, stmt_id, msg->header.sync,
+				::schema_version);
+}
+
 static void
 iproto_session_notify(struct session *session,
 		      const char *key, size_t key_len,
@@ -2205,6 +3089,9 @@ tx_process_misc(struct cmsg *m)
 			iproto_reply_id_xc(out, msg->header.sync,
 					   ::schema_version);
 			break;
+		case IPROTO_BOX_PREPARE:
+			tx_process_box_prepare(msg, out);
+			break;
 		case IPROTO_VOTE_DEPRECATED:
 			iproto_reply_vclock_xc(out, &replicaset.vclock,
 					       msg->header.sync,
@@ -2254,6 +3141,8 @@ tx_process_sql(struct cmsg *m)
 
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
+	if (tx_check_user_quota(msg) != 0)
+		goto error;
 	assert(msg->header.type == IPROTO_EXECUTE ||
 	       msg->header.type == IPROTO_PREPARE);
 	tx_inject_delay();
@@ -2315,6 +3204,7 @@ tx_process_sql(struct cmsg *m)
 		if (iproto_reply_ok(out, msg->header.sync, schema_version) != 0)
 			goto error;
 		iproto_wpos_create(&msg->wpos, out);
+		tx_end_msg(msg);
 		return;
 	}
 	struct obuf_svp header_svp;
@@ -2358,6 +3248,9 @@ tx_process_replication(struct cmsg *m)
 		case IPROTO_FETCH_SNAPSHOT:
 			box_process_fetch_snapshot(io, &msg->header);
 			break;
+		case IPROTO_FETCH_CHECKPOINT:
+			box_process_fetch_checkpoint(io, &msg->header);
+			break;
 		case IPROTO_REGISTER:
 			box_process_register(io, &msg->header);
 			break;
@@ -2460,6 +3353,46 @@ net_send_msg(struct cmsg *m)
 	iproto_msg_delete(msg);
 }
 
+/**
+ * Flush a chunk of a streamed SELECT reply. The message is
+ * returned to tx when all output written so far is flushed,
+ * see iproto_connection_end_fetch().
+ */
+static void
+net_send_fetch(struct cmsg *m)
+{
+	struct iproto_fetch *fetch = (struct iproto_fetch *)m;
+	struct iproto_msg *msg = container_of(fetch, struct iproto_msg, fetch);
+	struct iproto_connection *con = msg->connection;
+	con->wend = fetch->kharon.wpos;
+	if (con->state == IPROTO_CONNECTION_ALIVE) {
+		stailq_add_tail_entry(&con->fetch_queue, fetch, in_queue);
+		iproto_connection_feed_output(con);
+	} else {
+		net_end_fetch(con, fetch);
+	}
+}
+
+/**
+ * Complete sending replies to a batch of SELECT requests:
+ * discard the input of all requests of the batch and flush
+ * output once.
+ */
+static void
+net_send_select_batch(struct cmsg *m)
+{
+	struct iproto_msg *batch = (struct iproto_msg *) m;
+	while (!stailq_empty(&batch->batch)) {
+		struct iproto_msg *msg =
+			stailq_shift_entry(&batch->batch, struct iproto_msg,
+					   in_batch);
+		assert(msg->len != 0);
+		msg->p_ibuf->rpos += msg->len;
+		iproto_msg_delete(msg);
+	}
+	net_send_msg(m);
+}
+
 /**
  * Complete sending an iproto error:
  * recycle the error object and flush output.
@@ -2607,6 +3540,19 @@ iproto_on_accept(struct evio_service *service, struct iostream *io,
 		return -1;
 	}
 	iostream_move(&con->io, io);
+#ifdef SO_BUSY_POLL
+	if (iproto_thread->busy_poll.timeout > 0) {
+		/*
+		 * Let the kernel poll the device queue on reads.
+		 * Raising the value above net.core.busy_read needs
+		 * CAP_NET_ADMIN, so a failure is ignored.
+		 */
+		int usec = MIN(iproto_thread->busy_poll.timeout * 1e6,
+			       (double)INT32_MAX);
+		(void)setsockopt(con->io.fd, SOL_SOCKET, SO_BUSY_POLL,
+				 &usec, sizeof(usec));
+	}
+#endif
 	cmsg_init(&msg->base, iproto_thread->connect_route);
 	msg->p_ibuf = con->p_ibuf;
 	msg->wpos = con->wpos;
@@ -2633,6 +3579,7 @@ net_cord_f(va_list  ap)
 
 	evio_service_create(loop(), &iproto_thread->binary, "binary",
 			    iproto_on_accept, iproto_thread);
+	busy_poll_create(&iproto_thread->busy_poll, loop());
 
 	char endpoint_name[ENDPOINT_NAME_MAX];
 	snprintf(endpoint_name, ENDPOINT_NAME_MAX, "net%u",
@@ -2656,6 +3603,7 @@ net_cord_f(va_list  ap)
 	 * connections.
 	 */
 	evio_service_detach(&iproto_thread->binary);
+	busy_poll_destroy(&iproto_thread->busy_poll);
 	return 0;
 }
 
@@ -2830,6 +3778,10 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->select_route[0] =
 		{ tx_process_select, &iproto_thread->net_pipe };
 	iproto_thread->select_route[1] = { net_send_msg, NULL };
+	iproto_thread->select_batch_route[0] =
+		{ tx_process_select_batch, &iproto_thread->net_pipe };
+	iproto_thread->select_batch_route[1] =
+		{ net_send_select_batch, NULL };
 	iproto_thread->process1_route[0] =
 		{ tx_process1, &iproto_thread->net_pipe };
 	iproto_thread->process1_route[1] = { net_send_msg, NULL };
@@ -2848,6 +3800,8 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->push_route[0] =
 		{ iproto_process_push, &iproto_thread->tx_pipe };
 	iproto_thread->push_route[1] = { tx_end_push, NULL };
+	iproto_thread->fetch_route[0] = { net_send_fetch, NULL };
+	iproto_thread->fetch_ack_route[0] = { tx_end_fetch, NULL };
 	/* IPROTO_OK */
 	iproto_thread->dml_route[0] = NULL;
 	/* IPROTO_SELECT */
@@ -2876,6 +3830,12 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->dml_route[12] = NULL;
 	/* IPROTO_PREPARE */
 	iproto_thread->dml_route[13] = iproto_thread->sql_route;
+	/* IPROTO_BEGIN, IPROTO_COMMIT, IPROTO_ROLLBACK */
+	iproto_thread->dml_route[14] = NULL;
+	iproto_thread->dml_route[15] = NULL;
+	iproto_thread->dml_route[16] = NULL;
+	/* IPROTO_DELETE_RANGE */
+	iproto_thread->dml_route[17] = iproto_thread->process1_route;
 	iproto_thread->connect_route[0] =
 		{ tx_process_connect, &iproto_thread->net_pipe };
 	iproto_thread->connect_route[1] = { net_send_greeting, NULL };
@@ -2893,13 +3853,20 @@ iproto_thread_init(struct iproto_thread *iproto_thread)
 	iproto_thread->tx.rmean = rmean_new(rmean_tx_strings, RMEAN_TX_LAST);
 	if (iproto_thread->tx.rmean == NULL)
 		goto fail;
+	if (latency_create(&iproto_thread->tx.queue_latency) != 0)
+		goto fail;
 	rlist_create(&iproto_thread->stopped_connections);
 	iproto_thread->tx.requests_in_progress = 0;
 	iproto_thread->requests_in_stream_queue = 0;
+	mempool_create(&iproto_thread->tuple_ref_pool,
+		       &iproto_thread->net_slabc,
+		       sizeof(struct iproto_tuple_ref));
 	return 0;
 fail:
 	if (iproto_thread->rmean != NULL)
 		rmean_delete(iproto_thread->rmean);
+	if (iproto_thread->tx.rmean != NULL)
+		rmean_delete(iproto_thread->tx.rmean);
 	slab_cache_destroy(&iproto_thread->net_slabc);
 	diag_set(OutOfMemory, sizeof(struct rmean),
 		 "rmean_new", "struct rmean");
@@ -2936,6 +3903,8 @@ iproto_init(int threads_count)
 				 net_cord_f, iproto_thread)) {
 			rmean_delete(iproto_thread->rmean);
 			rmean_delete(iproto_thread->tx.rmean);
+			latency_destroy(&iproto_thread->tx.queue_latency);
+			mempool_destroy(&iproto_thread->tuple_ref_pool);
 			slab_cache_destroy(&iproto_thread->net_slabc);
 			goto fail;
 		}
@@ -2979,6 +3948,10 @@ enum iproto_cfg_op {
 	 * Command code do get statistic from iproto thread
 	 */
 	IPROTO_CFG_STAT,
+	/** Command code to set busy polling timeout. */
+	IPROTO_CFG_BUSY_POLL,
+	/** Command code to set max messages of a connection. */
+	IPROTO_CFG_MSG_MAX_PER_CONNECTION,
 };
 
 /**
@@ -2998,6 +3971,8 @@ struct iproto_cfg_msg: public cbus_call_msg
 		struct evio_service *binary;
 		/** New iproto max message count. */
 		int iproto_msg_max;
+		/** New busy polling timeout. */
+		double busy_poll_timeout;
 	};
 	struct iproto_thread *iproto_thread;
 };
@@ -3025,6 +4000,9 @@ iproto_fill_stat(struct iproto_thread *iproto_thread,
 		mempool_count(&iproto_thread->iproto_msg_pool);
 	cfg_msg->stats->requests_in_stream_queue =
 		iproto_thread->requests_in_stream_queue;
+	cfg_msg->stats->busy_poll_time = iproto_thread->busy_poll.spin_time;
+	cfg_msg->stats->busy_poll_sleeps =
+		iproto_thread->busy_poll.sleep_count;
 }
 
 static int
@@ -3061,8 +4039,8 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 			}
 			evio_service_create(loop(), binary, "binary",
 					    iproto_on_accept, iproto_thread);
-			evio_service_attach(binary, cfg_msg->binary);
-			if (evio_service_listen(binary) != 0)
+			if (evio_service_attach(binary, cfg_msg->binary) != 0 ||
+			    evio_service_listen(binary) != 0)
 				diag_raise();
 			break;
 		case IPROTO_CFG_STOP:
@@ -3071,6 +4049,19 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 		case IPROTO_CFG_STAT:
 			iproto_fill_stat(iproto_thread, cfg_msg);
 			break;
+		case IPROTO_CFG_BUSY_POLL:
+			busy_poll_set_timeout(&iproto_thread->busy_poll,
+					      cfg_msg->busy_poll_timeout);
+			break;
+		case IPROTO_CFG_MSG_MAX_PER_CONNECTION:
+			/*
+			 * Connections stopped by the old limit
+			 * have messages in fly, so they are
+			 * resumed when the messages complete.
+			 */
+			iproto_msg_max_per_connection =
+				cfg_msg->iproto_msg_max;
+			break;
 		default:
 			unreachable();
 		}
@@ -3132,7 +4123,10 @@ iproto_listen(const struct uri_set *uri_set)
 	 * Please note, we bind sockets in main thread, and then
 	 * listen these sockets in all iproto threads! With this
 	 * implementation, we rely on the Linux kernel to distribute
-	 * incoming connections across iproto threads.
+	 * incoming connections across iproto threads. With the
+	 * 'reuseport' URI parameter every iproto thread binds its
+	 * own SO_REUSEPORT socket, and the kernel balances new
+	 * connections between them by the connection hash.
 	 */
 	if (evio_service_bind(&tx_binary, uri_set) != 0)
 		return -1;
@@ -3153,6 +4147,12 @@ iproto_stats_add(struct iproto_stats *total_stats,
 		thread_stats->requests_in_stream_queue;
 	total_stats->requests_in_progress +=
 		thread_stats->requests_in_progress;
+	total_stats->busy_poll_time += thread_stats->busy_poll_time;
+	total_stats->busy_poll_sleeps += thread_stats->busy_poll_sleeps;
+	total_stats->queue_time_p50 = MAX(total_stats->queue_time_p50,
+					  thread_stats->queue_time_p50);
+	total_stats->queue_time_p99 = MAX(total_stats->queue_time_p99,
+					  thread_stats->queue_time_p99);
 }
 
 void
@@ -3175,8 +4175,12 @@ iproto_thread_stats_get(struct iproto_stats *stats, int thread_id)
 	assert(thread_id >= 0 && thread_id < iproto_threads_count);
 	cfg_msg.stats = stats;
 	iproto_do_cfg_crit(&iproto_threads[thread_id], &cfg_msg);
-	stats->requests_in_progress =
-		iproto_threads[thread_id].tx.requests_in_progress;
+	struct iproto_thread *iproto_thread = &iproto_threads[thread_id];
+	stats->requests_in_progress = iproto_thread->tx.requests_in_progress;
+	stats->queue_time_p50 =
+		latency_get(&iproto_thread->tx.queue_latency, 50);
+	stats->queue_time_p99 =
+		latency_get(&iproto_thread->tx.queue_latency, 99);
 }
 
 void
@@ -3185,6 +4189,7 @@ iproto_reset_stat(void)
 	for (int i = 0; i < iproto_threads_count; i++) {
 		rmean_cleanup(iproto_threads[i].rmean);
 		rmean_cleanup(iproto_threads[i].tx.rmean);
+		latency_reset(&iproto_threads[i].tx.queue_latency);
 	}
 }
 
@@ -3206,6 +4211,32 @@ iproto_set_msg_max(int new_iproto_msg_max)
 	}
 }
 
+void
+iproto_set_msg_max_per_connection(int msg_max)
+{
+	struct iproto_cfg_msg cfg_msg;
+	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_MSG_MAX_PER_CONNECTION);
+	cfg_msg.iproto_msg_max = msg_max;
+	for (int i = 0; i < iproto_threads_count; i++)
+		iproto_do_cfg_crit(&iproto_threads[i], &cfg_msg);
+}
+
+void
+iproto_set_msg_max_per_user(int msg_max)
+{
+	tx_msg_max_per_user = msg_max;
+}
+
+void
+iproto_set_busy_poll(double timeout)
+{
+	struct iproto_cfg_msg cfg_msg;
+	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_BUSY_POLL);
+	cfg_msg.busy_poll_timeout = timeout;
+	for (int i = 0; i < iproto_threads_count; i++)
+		iproto_do_cfg_crit(&iproto_threads[i], &cfg_msg);
+}
+
 void
 iproto_free(void)
 {
@@ -3220,6 +4251,8 @@ iproto_free(void)
 		evio_service_detach(&iproto_threads[i].binary);
 		rmean_delete(iproto_threads[i].rmean);
 		rmean_delete(iproto_threads[i].tx.rmean);
+		latency_destroy(&iproto_threads[i].tx.queue_latency);
+		mempool_destroy(&iproto_threads[i].tuple_ref_pool);
 		slab_cache_destroy(&iproto_threads[i].net_slabc);
 	}
 	free(iproto_threads);
@@ -71,6 +71,17 @@ struct iproto_stats {
 	size_t requests_in_progress;
 	/** Count of requests currently pending in stream queue. */
 	size_t requests_in_stream_queue;
+	/** Time spent by busy polling in empty loop iterations. */
+	double busy_poll_time;
+	/** Number of times busy polling gave up and slept. */
+	int64_t busy_poll_sleeps;
+	/**
+	 * Median and 99th percentile of the time requests spend
+	 * in the queue before the tx thread starts processing
+	 * them, in seconds. For all threads, the worst of them.
+	 */
+	double queue_time_p50;
+	double queue_time_p99;
 };
 
 extern unsigned iproto_readahead;
@@ -131,6 +142,29 @@ iproto_listen(const struct uri_set *uri_set);
 void
 iproto_set_msg_max(int iproto_msg_max);
 
+/**
+ * Set the busy polling timeout of iproto threads, see
+ * busy_poll_set_timeout(). Zero disables busy polling.
+ */
+void
+iproto_set_busy_poll(double timeout);
+
+/**
+ * Set the max number of requests of one connection in flight.
+ * A connection that reaches the limit stops reading input until
+ * some of its requests complete. Zero means no limit.
+ */
+void
+iproto_set_msg_max_per_connection(int msg_max);
+
+/**
+ * Set the max number of requests of one user processed by the
+ * tx thread at the same time. Requests over the limit fail with
+ * ER_TOO_MANY_REQUESTS. Zero means no limit.
+ */
+void
+iproto_set_msg_max_per_user(int msg_max);
+
 void
 iproto_free(void);
 
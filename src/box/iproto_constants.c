@@ -152,6 +152,14 @@ const unsigned char iproto_key_type[IPROTO_KEY_MAX] =
 	/* 0x56 */	MP_DOUBLE, /* IPROTO_TIMEOUT */
 	/* 0x57 */	MP_STR, /* IPROTO_EVENT_KEY */
 	/* 0x58 */	MP_NIL, /* IPROTO_EVENT_DATA (can be any) */
+	/* 0x59 */	MP_ARRAY, /* IPROTO_KEY_END */
+	/* 0x5a */	MP_STR, /* IPROTO_FILE_NAME */
+	/* 0x5b */	MP_UINT, /* IPROTO_FILE_SIZE */
+	/* 0x5c */	MP_BIN, /* IPROTO_FILE_CHUNK */
+	/* 0x5d */	MP_UINT, /* IPROTO_FILE_CRC32 */
+	/* 0x5e */	MP_ARRAY, /* IPROTO_SPACE_FILTER */
+	/* 0x5f */	MP_UINT, /* IPROTO_FETCH_SIZE */
+	/* 0x60 */	MP_UINT, /* IPROTO_STMT_TYPE */
 	/* }}} */
 };
 
@@ -174,6 +182,7 @@ const char *iproto_type_strs[] =
 	"BEGIN",
 	"COMMIT",
 	"ROLLBACK",
+	"DELETE_RANGE",
 };
 
 #define bit(c) (1ULL<<IPROTO_##c)
@@ -195,6 +204,7 @@ const uint64_t iproto_body_key_map[IPROTO_TYPE_STAT_MAX] = {
 	0,                                                     /* BEGIN */
 	0,                                                     /* COMMIT */
 	0,                                                     /* ROLLBACK */
+	bit(SPACE_ID) | bit(KEY),                              /* DELETE_RANGE */
 };
 #undef bit
 
@@ -288,6 +298,14 @@ const char *iproto_key_strs[IPROTO_KEY_MAX] = {
 	"timeout",          /* 0x56 */
 	"event key",        /* 0x57 */
 	"event data",       /* 0x58 */
+	"key end",          /* 0x59 */
+	"file name",        /* 0x5a */
+	"file size",        /* 0x5b */
+	"file chunk",       /* 0x5c */
+	"file crc32",       /* 0x5d */
+	"space filter",     /* 0x5e */
+	"fetch size",       /* 0x5f */
+	"statement type",   /* 0x60 */
 };
 
 const char *vy_page_info_key_strs[VY_PAGE_INFO_KEY_MAX] = {
@@ -310,9 +328,17 @@ const char *vy_run_info_key_strs[VY_RUN_INFO_KEY_MAX] = {
 	"bloom filter legacy",
 	"bloom filter",
 	"stmt stat",
+	"blob ids",
+	"zstd dictionary",
+	"split block bloom filter",
 };
 
 const char *vy_row_index_key_strs[VY_ROW_INDEX_KEY_MAX] = {
 	NULL,
 	"row index",
 };
+
+const char *vy_blob_data_key_strs[VY_BLOB_DATA_KEY_MAX] = {
+	NULL,
+	"tuple",
+};
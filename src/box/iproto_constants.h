@@ -148,6 +148,32 @@ enum iproto_key {
 	/** Key name and data sent to a remote watcher. */
 	IPROTO_EVENT_KEY = 0x57,
 	IPROTO_EVENT_DATA = 0x58,
+	/**
+	 * Exclusive upper bound of a key range, sent along with
+	 * IPROTO_KEY in IPROTO_DELETE_RANGE.
+	 */
+	IPROTO_KEY_END = 0x59,
+	/**
+	 * Name of a checkpoint file sent in reply to
+	 * IPROTO_FETCH_CHECKPOINT, relative to the engine directory.
+	 */
+	IPROTO_FILE_NAME = 0x5a,
+	/** Size of a checkpoint file, in bytes. */
+	IPROTO_FILE_SIZE = 0x5b,
+	/** Chunk of checkpoint file contents. */
+	IPROTO_FILE_CHUNK = 0x5c,
+	/** CRC32 of checkpoint file contents. */
+	IPROTO_FILE_CRC32 = 0x5d,
+	/** Ids of user spaces to replicate, sent in SUBSCRIBE. */
+	IPROTO_SPACE_FILTER = 0x5e,
+	/**
+	 * Max number of tuples in a SELECT reply message. If set,
+	 * the result is sent in IPROTO_CHUNK messages followed by
+	 * the final reply, instead of one reply.
+	 */
+	IPROTO_FETCH_SIZE = 0x5f,
+	/** Type of a request prepared with IPROTO_BOX_PREPARE. */
+	IPROTO_STMT_TYPE = 0x60,
 	/*
 	 * Be careful to not extend iproto_key values over 0x7f.
 	 * iproto_keys are encoded in msgpack as positive fixnum, which ends at
@@ -228,6 +254,8 @@ enum iproto_type {
 	IPROTO_COMMIT = 15,
 	/* Rollback transaction */
 	IPROTO_ROLLBACK = 16,
+	/** Delete all tuples with keys in [IPROTO_KEY, IPROTO_KEY_END). */
+	IPROTO_DELETE_RANGE = 17,
 	/** The maximum typecode used for box.stat() */
 	IPROTO_TYPE_STAT_MAX,
 
@@ -282,6 +310,30 @@ enum iproto_type {
 	IPROTO_WATCH = 74,
 	IPROTO_UNWATCH = 75,
 	IPROTO_EVENT = 76,
+	/**
+	 * Fetch the files of the last checkpoint to bootstrap
+	 * a replica, see box_process_fetch_checkpoint().
+	 */
+	IPROTO_FETCH_CHECKPOINT = 77,
+	/**
+	 * The following three types are used to send a file in reply
+	 * to IPROTO_FETCH_CHECKPOINT: IPROTO_FILE carries the file
+	 * name and size, it's followed by IPROTO_FILE_DATA rows with
+	 * chunks of the file contents, and IPROTO_FILE_END carries
+	 * the checksum of the whole file.
+	 */
+	IPROTO_FILE = 78,
+	IPROTO_FILE_DATA = 79,
+	IPROTO_FILE_END = 80,
+	/**
+	 * Prepare a SELECT or DML request: the body contains
+	 * IPROTO_STMT_TYPE, the space, and the request parameters
+	 * that don't change between calls. The server replies with
+	 * IPROTO_STMT_ID, which can then be sent in the body of a
+	 * request of the same type instead of the bound parameters.
+	 * A body with IPROTO_STMT_ID only deallocates the statement.
+	 */
+	IPROTO_BOX_PREPARE = 81,
 
 	/** Vinyl run info stored in .index file */
 	VY_INDEX_RUN_INFO = 100,
@@ -289,6 +341,8 @@ enum iproto_type {
 	VY_INDEX_PAGE_INFO = 101,
 	/** Vinyl row index stored in .run file */
 	VY_RUN_ROW_INDEX = 102,
+	/** Vinyl statement payload stored in .blob file */
+	VY_BLOB_DATA = 103,
 
 	/** Non-final response type. */
 	IPROTO_CHUNK = 128,
@@ -337,12 +391,24 @@ iproto_type_name(uint16_t type)
 		return "CONFIRM";
 	case IPROTO_RAFT_ROLLBACK:
 		return "ROLLBACK";
+	case IPROTO_FETCH_CHECKPOINT:
+		return "FETCH_CHECKPOINT";
+	case IPROTO_FILE:
+		return "FILE";
+	case IPROTO_FILE_DATA:
+		return "FILE_DATA";
+	case IPROTO_FILE_END:
+		return "FILE_END";
+	case IPROTO_BOX_PREPARE:
+		return "BOX_PREPARE";
 	case VY_INDEX_RUN_INFO:
 		return "RUNINFO";
 	case VY_INDEX_PAGE_INFO:
 		return "PAGEINFO";
 	case VY_RUN_ROW_INDEX:
 		return "ROWINDEX";
+	case VY_BLOB_DATA:
+		return "BLOBDATA";
 	default:
 		return NULL;
 	}
@@ -366,7 +432,8 @@ static inline bool
 iproto_type_is_dml(uint16_t type)
 {
 	return (type >= IPROTO_SELECT && type <= IPROTO_DELETE) ||
-		type == IPROTO_UPSERT || type == IPROTO_NOP;
+		type == IPROTO_UPSERT || type == IPROTO_NOP ||
+		type == IPROTO_DELETE_RANGE;
 }
 
 /**
@@ -451,6 +518,12 @@ enum vy_run_info_key {
 	VY_RUN_INFO_BLOOM = 7,
 	/** Number of statements of each type (map). */
 	VY_RUN_INFO_STMT_STAT = 8,
+	/** Size of payloads referenced in each value log file (map). */
+	VY_RUN_INFO_BLOB_IDS = 9,
+	/** Zstd dictionary used for compressing pages. */
+	VY_RUN_INFO_ZDICT = 10,
+	/** Split block bloom filter for keys. */
+	VY_RUN_INFO_BLOOM_SPLIT_BLOCK = 11,
 	/** The last key in this enum + 1 */
 	VY_RUN_INFO_KEY_MAX
 };
@@ -526,6 +599,30 @@ vy_row_index_key_name(enum vy_row_index_key key)
 	return vy_row_index_key_strs[key];
 }
 
+/**
+ * Xrow keys for Vinyl value log rows.
+ * @sa struct vy_blob.
+ */
+enum vy_blob_data_key {
+	/** Statement tuple. */
+	VY_BLOB_DATA_TUPLE = 1,
+	/** The last key in this enum + 1 */
+	VY_BLOB_DATA_KEY_MAX
+};
+
+/**
+ * Return vy_blob_data key name by @a key code.
+ * @param key key
+ */
+static inline const char *
+vy_blob_data_key_name(enum vy_blob_data_key key)
+{
+	if (key <= 0 || key >= VY_BLOB_DATA_KEY_MAX)
+		return NULL;
+	extern const char *vy_blob_data_key_strs[];
+	return vy_blob_data_key_strs[key];
+}
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif
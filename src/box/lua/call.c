@@ -182,6 +182,36 @@ lbox_call_loadproc(struct lua_State *L)
 	return count;
 }
 
+struct encode_lua_ctx {
+	struct port_lua *port;
+	struct mpstream *stream;
+	/** If set, tuples are passed to this callback, see below. */
+	port_dump_tuple_f dump_tuple;
+	/** Argument of the tuple dump callback. */
+	void *dump_tuple_arg;
+};
+
+/**
+ * Encode a tuple returned by a Lua function. If a tuple dump
+ * callback is set, the stream is flushed and the tuple is passed
+ * to the callback, which writes it to the output buffer.
+ * Otherwise the tuple is copied to the stream.
+ */
+static void
+encode_lua_tuple(lua_State *L, struct encode_lua_ctx *ctx,
+		 struct tuple *tuple)
+{
+	if (ctx->dump_tuple == NULL) {
+		tuple_to_mpstream(tuple, ctx->stream);
+		return;
+	}
+	mpstream_flush(ctx->stream);
+	if (ctx->dump_tuple(tuple, ctx->dump_tuple_arg) != 0)
+		luaT_error(L);
+	/* The callback wrote past the reserved stream space. */
+	mpstream_reset(ctx->stream);
+}
+
 /*
  * Encode CALL_16 result.
  *
@@ -207,8 +237,9 @@ lbox_call_loadproc(struct lua_State *L)
  */
 static inline uint32_t
 luamp_encode_call_16(lua_State *L, struct luaL_serializer *cfg,
-		     struct mpstream *stream)
+		     struct encode_lua_ctx *ctx)
 {
+	struct mpstream *stream = ctx->stream;
 	int nrets = lua_gettop(L);
 	if (nrets == 0) {
 		return 0;
@@ -225,7 +256,7 @@ luamp_encode_call_16(lua_State *L, struct luaL_serializer *cfg,
 			if (field.type == MP_EXT &&
 			    (tuple = luaT_istuple(L, i)) != NULL) {
 				/* `return ..., box.tuple.new(...), ...` */
-				tuple_to_mpstream(tuple, stream);
+				encode_lua_tuple(L, ctx, tuple);
 			} else if (field.type != MP_ARRAY) {
 				/*
 				 * `return ..., scalar, ... =>
@@ -253,7 +284,7 @@ luamp_encode_call_16(lua_State *L, struct luaL_serializer *cfg,
 	struct tuple *tuple;
 	if (root.type == MP_EXT && (tuple = luaT_istuple(L, 1)) != NULL) {
 		/* `return box.tuple()` */
-		tuple_to_mpstream(tuple, stream);
+		encode_lua_tuple(L, ctx, tuple);
 		return 1;
 	} else if (root.type != MP_ARRAY) {
 		/*
@@ -281,7 +312,7 @@ luamp_encode_call_16(lua_State *L, struct luaL_serializer *cfg,
 		if (luaL_tofield(L, cfg, -1, &field) < 0)
 			return luaT_error(L);
 		if (field.type == MP_EXT && (tuple = luaT_istuple(L, -1))) {
-			tuple_to_mpstream(tuple, stream);
+			encode_lua_tuple(L, ctx, tuple);
 		} else if (field.type != MP_ARRAY) {
 			/* The first member of root table is not tuple/array */
 			if (t == 1) {
@@ -321,8 +352,6 @@ luamp_encode_call_16(lua_State *L, struct luaL_serializer *cfg,
 	return root.size;
 }
 
-static const struct port_vtab port_lua_vtab;
-
 void
 port_lua_create(struct port *port, struct lua_State *L)
 {
@@ -434,10 +463,44 @@ execute_lua_eval(lua_State *L)
 	return lua_gettop(L);
 }
 
-struct encode_lua_ctx {
-	struct port_lua *port;
-	struct mpstream *stream;
-};
+/**
+ * Encode a value returned by a Lua function like luamp_encode(),
+ * but pass tuples returned as is or in an array to the tuple
+ * dump callback. Deeper nested tuples are copied.
+ */
+static void
+encode_lua_call_value(lua_State *L, struct luaL_serializer *cfg,
+		      struct encode_lua_ctx *ctx, int index)
+{
+	lua_pushvalue(L, index);
+	int top = lua_gettop(L);
+	struct luaL_field field;
+	if (luaL_tofield(L, cfg, top, &field) < 0)
+		luaT_error(L);
+	struct tuple *tuple;
+	if (field.type == MP_EXT && (tuple = luaT_istuple(L, top)) != NULL) {
+		/* `return box.tuple.new(...)` */
+		encode_lua_tuple(L, ctx, tuple);
+	} else if (field.type == MP_ARRAY && cfg->encode_max_depth > 0) {
+		/* `return {box.tuple.new(...), ...}` */
+		uint32_t size = field.size;
+		mpstream_encode_array(ctx->stream, size);
+		for (uint32_t i = 1; i <= size; i++) {
+			lua_rawgeti(L, top, i);
+			if (luaL_tofield(L, cfg, top + 1, &field) < 0)
+				luaT_error(L);
+			if (field.type == MP_EXT &&
+			    (tuple = luaT_istuple(L, top + 1)) != NULL)
+				encode_lua_tuple(L, ctx, tuple);
+			else
+				luamp_encode_r(L, cfg, ctx->stream, &field, 1);
+			lua_pop(L, 1);
+		}
+	} else {
+		luamp_encode_r(L, cfg, ctx->stream, &field, 0);
+	}
+	lua_pop(L, 1);
+}
 
 /**
  * Encode call results to msgpack from Lua stack.
@@ -466,8 +529,12 @@ encode_lua_call(lua_State *L)
 	 */
 	struct luaL_serializer *cfg = get_call_serializer();
 	const int size = lua_gettop(L);
-	for (int i = 1; i <= size; ++i)
-		luamp_encode(L, cfg, ctx->stream, i);
+	for (int i = 1; i <= size; ++i) {
+		if (ctx->dump_tuple == NULL)
+			luamp_encode(L, cfg, ctx->stream, i);
+		else
+			encode_lua_call_value(L, cfg, ctx, i);
+	}
 	ctx->port->size = size;
 	mpstream_flush(ctx->stream);
 	return 0;
@@ -499,14 +566,15 @@ encode_lua_call_16(lua_State *L)
 	 * TODO: forbid explicit yield from __serialize or __index here
 	 */
 	struct luaL_serializer *cfg = get_call_serializer();
-	ctx->port->size = luamp_encode_call_16(L, cfg, ctx->stream);
+	ctx->port->size = luamp_encode_call_16(L, cfg, ctx);
 	mpstream_flush(ctx->stream);
 	return 0;
 }
 
 static inline int
 port_lua_do_dump(struct port *base, struct mpstream *stream,
-		 enum handlers handler)
+		 enum handlers handler, port_dump_tuple_f dump_tuple,
+		 void *dump_tuple_arg)
 {
 	struct port_lua *port = (struct port_lua *) base;
 	assert(port->vtab == &port_lua_vtab);
@@ -517,6 +585,8 @@ port_lua_do_dump(struct port *base, struct mpstream *stream,
 	struct encode_lua_ctx ctx;
 	ctx.port = port;
 	ctx.stream = stream;
+	ctx.dump_tuple = dump_tuple;
+	ctx.dump_tuple_arg = dump_tuple_arg;
 	lua_State *L = port->L;
 	/*
 	 * At the moment Lua stack holds only values to encode.
@@ -541,7 +611,8 @@ port_lua_dump(struct port *base, struct obuf *out)
 	struct mpstream stream;
 	mpstream_init(&stream, out, obuf_reserve_cb, obuf_alloc_cb,
 		      luamp_error, port->L);
-	return port_lua_do_dump(base, &stream, HANDLER_ENCODE_CALL);
+	return port_lua_do_dump(base, &stream, HANDLER_ENCODE_CALL,
+				NULL, NULL);
 }
 
 static int
@@ -551,7 +622,22 @@ port_lua_dump_16(struct port *base, struct obuf *out)
 	struct mpstream stream;
 	mpstream_init(&stream, out, obuf_reserve_cb, obuf_alloc_cb,
 		      luamp_error, port->L);
-	return port_lua_do_dump(base, &stream, HANDLER_ENCODE_CALL_16);
+	return port_lua_do_dump(base, &stream, HANDLER_ENCODE_CALL_16,
+				NULL, NULL);
+}
+
+int
+port_lua_dump_with_tuples(struct port *base, struct obuf *out, bool is_16,
+			  port_dump_tuple_f dump_tuple, void *arg)
+{
+	struct port_lua *port = (struct port_lua *)base;
+	struct mpstream stream;
+	mpstream_init(&stream, out, obuf_reserve_cb, obuf_alloc_cb,
+		      luamp_error, port->L);
+	return port_lua_do_dump(base, &stream,
+				is_16 ? HANDLER_ENCODE_CALL_16 :
+					HANDLER_ENCODE_CALL,
+				dump_tuple, arg);
 }
 
 static void
@@ -575,7 +661,8 @@ port_lua_get_msgpack(struct port *base, uint32_t *size)
 	mpstream_init(&stream, region, region_reserve_cb, region_alloc_cb,
 		      luamp_error, port->L);
 	mpstream_encode_array(&stream, lua_gettop(port->L));
-	int rc = port_lua_do_dump(base, &stream, HANDLER_ENCODE_CALL);
+	int rc = port_lua_do_dump(base, &stream, HANDLER_ENCODE_CALL,
+				  NULL, NULL);
 	if (rc < 0) {
 		region_truncate(region, region_svp);
 		return NULL;
@@ -608,7 +695,7 @@ port_lua_dump_plain(struct port *port, uint32_t *size);
 extern struct sql_value *
 port_lua_get_vdbemem(struct port *base, uint32_t *size);
 
-static const struct port_vtab port_lua_vtab = {
+const struct port_vtab port_lua_vtab = {
 	.dump_msgpack = port_lua_dump,
 	.dump_msgpack_16 = port_lua_dump_16,
 	.dump_lua = port_lua_dump_lua,
@@ -177,6 +177,22 @@ lbox_cfg_set_wal_cleanup_delay(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_wal_group_commit(struct lua_State *L)
+{
+	if (box_set_wal_group_commit() < 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_busy_poll_timeout(struct lua_State *L)
+{
+	if (box_set_busy_poll_timeout() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_read_only(struct lua_State *L)
 {
@@ -265,6 +281,30 @@ lbox_cfg_set_net_msg_max(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_net_msg_max_per_connection(struct lua_State *L)
+{
+	if (box_set_net_msg_max_per_connection() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_net_msg_max_per_user(struct lua_State *L)
+{
+	if (box_set_net_msg_max_per_user() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_net_stmt_cache_size(struct lua_State *L)
+{
+	if (box_set_net_stmt_cache_size() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_set_prepared_stmt_cache_size(struct lua_State *L)
 {
@@ -388,6 +428,22 @@ lbox_cfg_set_replication_skip_conflict(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_replication_bootstrap_files(struct lua_State *L)
+{
+	(void) L;
+	box_set_replication_bootstrap_files();
+	return 0;
+}
+
+static int
+lbox_cfg_set_replication_apply_parallelism(struct lua_State *L)
+{
+	if (box_set_replication_apply_parallelism() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_crash(struct lua_State *L)
 {
@@ -422,6 +478,8 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_checkpoint_wal_threshold", lbox_cfg_set_checkpoint_wal_threshold},
 		{"cfg_set_wal_queue_max_size", lbox_cfg_set_wal_queue_max_size},
 		{"cfg_set_wal_cleanup_delay", lbox_cfg_set_wal_cleanup_delay},
+		{"cfg_set_wal_group_commit", lbox_cfg_set_wal_group_commit},
+		{"cfg_set_busy_poll_timeout", lbox_cfg_set_busy_poll_timeout},
 		{"cfg_set_read_only", lbox_cfg_set_read_only},
 		{"cfg_set_memtx_memory", lbox_cfg_set_memtx_memory},
 		{"cfg_set_memtx_max_tuple_size", lbox_cfg_set_memtx_max_tuple_size},
@@ -439,8 +497,16 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_replication_synchro_timeout", lbox_cfg_set_replication_synchro_timeout},
 		{"cfg_set_replication_sync_timeout", lbox_cfg_set_replication_sync_timeout},
 		{"cfg_set_replication_skip_conflict", lbox_cfg_set_replication_skip_conflict},
+		{"cfg_set_replication_bootstrap_files", lbox_cfg_set_replication_bootstrap_files},
+		{"cfg_set_replication_apply_parallelism", lbox_cfg_set_replication_apply_parallelism},
 		{"cfg_set_replication_anon", lbox_cfg_set_replication_anon},
 		{"cfg_set_net_msg_max", lbox_cfg_set_net_msg_max},
+		{"cfg_set_net_msg_max_per_connection",
+		 lbox_cfg_set_net_msg_max_per_connection},
+		{"cfg_set_net_msg_max_per_user",
+		 lbox_cfg_set_net_msg_max_per_user},
+		{"cfg_set_net_stmt_cache_size",
+		 lbox_cfg_set_net_stmt_cache_size},
 		{"cfg_set_sql_cache_size", lbox_set_prepared_stmt_cache_size},
 		{"cfg_set_crash", lbox_cfg_set_crash},
 		{"cfg_set_txn_timeout", lbox_cfg_set_txn_timeout},
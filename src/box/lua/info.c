@@ -89,7 +89,7 @@ lbox_pushapplier(lua_State *L, struct applier *applier)
 {
 	lua_newtable(L);
 	/* Get applier state in lower case */
-	static char status[16];
+	static char status[32];
 	char *d = status;
 	const char *s = applier_state_strs[applier->state] + strlen("APPLIER_");
 	assert(strlen(s) < sizeof(status));
@@ -109,6 +109,16 @@ lbox_pushapplier(lua_State *L, struct applier *applier)
 			       applier->last_row_time);
 		lua_settable(L, -3);
 
+		/*
+		 * Average number of transactions applied
+		 * concurrently, see replication_apply_parallelism.
+		 */
+		lua_pushstring(L, "apply_parallelism");
+		lua_pushnumber(L, applier->apply_group_count == 0 ? 1 :
+			       (double)applier->apply_tx_count /
+			       applier->apply_group_count);
+		lua_settable(L, -3);
+
 		char name[APPLIER_SOURCE_MAXLEN];
 		int total = uri_format(name, sizeof(name), &applier->uri, false);
 		/*
@@ -637,13 +647,26 @@ lbox_info_synchro(struct lua_State *L)
 
 	/* Queue information. */
 	struct txn_limbo *queue = &txn_limbo;
-	lua_createtable(L, 0, 3);
+	lua_createtable(L, 0, 4);
 	lua_pushnumber(L, queue->len);
 	lua_setfield(L, -2, "len");
 	lua_pushnumber(L, queue->owner_id);
 	lua_setfield(L, -2, "owner");
 	lua_pushboolean(L, latch_is_locked(&queue->promote_latch));
 	lua_setfield(L, -2, "busy");
+	/* Time spent in the queue by confirmed transactions. */
+	lua_createtable(L, 0, 5);
+	lua_pushnumber(L, latency_get(&queue->latency, 50));
+	lua_setfield(L, -2, "p50");
+	lua_pushnumber(L, latency_get(&queue->latency, 75));
+	lua_setfield(L, -2, "p75");
+	lua_pushnumber(L, latency_get(&queue->latency, 90));
+	lua_setfield(L, -2, "p90");
+	lua_pushnumber(L, latency_get(&queue->latency, 95));
+	lua_setfield(L, -2, "p95");
+	lua_pushnumber(L, latency_get(&queue->latency, 99));
+	lua_setfield(L, -2, "p99");
+	lua_setfield(L, -2, "latency");
 	lua_setfield(L, -2, "queue");
 
 	return 1;
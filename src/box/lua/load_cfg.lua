@@ -80,6 +80,8 @@ local default_cfg = {
     wal_dir_rescan_delay= 2,
     wal_queue_max_size  = 16 * 1024 * 1024,
     wal_cleanup_delay   = 4 * 3600,
+    wal_group_commit_delay = 0,
+    wal_group_commit_min_batch = 16,
     force_recovery      = false,
     replication         = nil,
     instance_uuid       = nil,
@@ -106,13 +108,19 @@ local default_cfg = {
     replication_connect_timeout = 30,
     replication_connect_quorum = nil, -- connect all
     replication_skip_conflict = false,
+    replication_bootstrap_files = false,
     replication_anon      = false,
     replication_threads   = 1,
+    replication_apply_parallelism = 1,
     feedback_enabled      = true,
     feedback_crashinfo    = true,
     feedback_host         = "https://feedback.tarantool.io",
     feedback_interval     = 3600,
     net_msg_max           = 768,
+    net_msg_max_per_connection = 0,
+    net_msg_max_per_user  = 0,
+    net_stmt_cache_size   = 5 * 1024 * 1024,
+    busy_poll_timeout     = 0,
     sql_cache_size        = 5 * 1024 * 1024,
     txn_timeout           = 365 * 100 * 86400,
 }
@@ -191,6 +199,8 @@ local template_cfg = {
     wal_max_size        = 'number',
     wal_dir_rescan_delay= 'number',
     wal_cleanup_delay   = 'number',
+    wal_group_commit_delay = 'number',
+    wal_group_commit_min_batch = 'number',
     force_recovery      = 'boolean',
     replication         = 'string, number, table',
     instance_uuid       = 'string',
@@ -218,13 +228,19 @@ local template_cfg = {
     replication_connect_timeout = 'number',
     replication_connect_quorum = 'number',
     replication_skip_conflict = 'boolean',
+    replication_bootstrap_files = 'boolean',
     replication_anon      = 'boolean',
     replication_threads   = 'number',
+    replication_apply_parallelism = 'number',
     feedback_enabled      = ifdef_feedback('boolean'),
     feedback_crashinfo    = ifdef_feedback('boolean'),
     feedback_host         = ifdef_feedback('string'),
     feedback_interval     = ifdef_feedback('number'),
     net_msg_max           = 'number',
+    net_msg_max_per_connection = 'number',
+    net_msg_max_per_user  = 'number',
+    net_stmt_cache_size   = 'number',
+    busy_poll_timeout     = 'number',
     sql_cache_size        = 'number',
     txn_timeout           = 'number',
 }
@@ -316,6 +332,8 @@ local dynamic_cfg = {
     -- do nothing, affects new replicas, which query this value on start
     wal_dir_rescan_delay    = function() end,
     wal_cleanup_delay       = private.cfg_set_wal_cleanup_delay,
+    wal_group_commit_delay  = private.cfg_set_wal_group_commit,
+    wal_group_commit_min_batch = private.cfg_set_wal_group_commit,
     custom_proc_title       = function()
         require('title').update(box.cfg.custom_proc_title)
     end,
@@ -330,10 +348,18 @@ local dynamic_cfg = {
     replication_synchro_quorum = private.cfg_set_replication_synchro_quorum,
     replication_synchro_timeout = private.cfg_set_replication_synchro_timeout,
     replication_skip_conflict = private.cfg_set_replication_skip_conflict,
+    replication_bootstrap_files =
+        private.cfg_set_replication_bootstrap_files,
+    replication_apply_parallelism =
+        private.cfg_set_replication_apply_parallelism,
     replication_anon        = private.cfg_set_replication_anon,
     instance_uuid           = check_instance_uuid,
     replicaset_uuid         = check_replicaset_uuid,
     net_msg_max             = private.cfg_set_net_msg_max,
+    net_msg_max_per_connection = private.cfg_set_net_msg_max_per_connection,
+    net_msg_max_per_user    = private.cfg_set_net_msg_max_per_user,
+    net_stmt_cache_size     = private.cfg_set_net_stmt_cache_size,
+    busy_poll_timeout       = private.cfg_set_busy_poll_timeout,
     sql_cache_size          = private.cfg_set_sql_cache_size,
     txn_timeout             = private.cfg_set_txn_timeout,
 }
@@ -425,6 +451,8 @@ local dynamic_cfg_skip_at_load = {
     replication_synchro_quorum = true,
     replication_synchro_timeout = true,
     replication_skip_conflict = true,
+    replication_bootstrap_files = true,
+    replication_apply_parallelism = true,
     replication_anon        = true,
     wal_dir_rescan_delay    = true,
     custom_proc_title       = true,
@@ -432,6 +460,9 @@ local dynamic_cfg_skip_at_load = {
     instance_uuid           = true,
     replicaset_uuid         = true,
     net_msg_max             = true,
+    net_msg_max_per_connection = true,
+    net_msg_max_per_user    = true,
+    busy_poll_timeout       = true,
     readahead               = true,
 }
 
@@ -35,6 +35,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
@@ -58,7 +59,9 @@
 #include "coio.h"
 #include "fiber.h"
 #include "fiber_cond.h"
+#include "histogram.h"
 #include "iostream.h"
+#include "latency.h"
 #include "box/errcode.h"
 #include "lua/fiber.h"
 #include "lua/fiber_cond.h"
@@ -112,6 +115,10 @@ enum netbox_method {
 	NETBOX_COMMIT      = 18,
 	NETBOX_ROLLBACK    = 19,
 	NETBOX_INJECT      = 20,
+	NETBOX_BOX_PREPARE = 21,
+	NETBOX_BOX_UNPREPARE = 22,
+	NETBOX_BOX_EXECUTE = 23,
+	NETBOX_BOX_SELECT  = 24,
 	netbox_method_MAX
 };
 
@@ -264,6 +271,14 @@ struct netbox_transport {
 	 * by the user.
 	 */
 	int64_t inprogress_request_count;
+	/**
+	 * Latency counter updated with the response time of every
+	 * request or NULL. May be shared by several transports, e.g.
+	 * connections of a pool to the same endpoint.
+	 */
+	struct latency *latency;
+	/** Lua reference to the latency counter object. */
+	int latency_ref;
 };
 
 struct netbox_request {
@@ -328,10 +343,13 @@ struct netbox_request {
 	 * the response hasn't been received yet.
 	 */
 	struct error *error;
+	/** Time when the request was sent, used for latency accounting. */
+	double start_time;
 };
 
 static const char netbox_transport_typename[] = "net.box.transport";
 static const char netbox_request_typename[] = "net.box.request";
+static const char netbox_latency_typename[] = "net.box.latency";
 
 /**
  * We keep a reference to each C function that is frequently called with
@@ -499,6 +517,8 @@ netbox_transport_create(struct netbox_transport *transport)
 	transport->next_sync = 1;
 	transport->requests = mh_i64ptr_new();
 	transport->inprogress_request_count = 0;
+	transport->latency = NULL;
+	transport->latency_ref = LUA_NOREF;
 }
 
 static void
@@ -519,6 +539,7 @@ netbox_transport_destroy(struct netbox_transport *transport)
 	assert(mh_size(h) == 0);
 	mh_i64ptr_delete(h);
 	assert(transport->inprogress_request_count == 0);
+	luaL_unref(tarantool_L, LUA_REGISTRYINDEX, transport->latency_ref);
 }
 
 /**
@@ -782,17 +803,21 @@ static void
 netbox_encode_select(lua_State *L, int idx, struct mpstream *stream,
 		     uint64_t sync, uint64_t stream_id)
 {
-	/* Lua stack at idx: space_id, index_id, iterator, offset, limit, key */
+	/*
+	 * Lua stack at idx: space_id, index_id, iterator, offset, limit, key,
+	 * fetch_size (optional).
+	 */
 	size_t svp = netbox_begin_encode(stream, sync, IPROTO_SELECT,
 					 stream_id);
 
-	mpstream_encode_map(stream, 6);
-
 	uint32_t space_id = lua_tonumber(L, idx);
 	uint32_t index_id = lua_tonumber(L, idx + 1);
 	int iterator = lua_tointeger(L, idx + 2);
 	uint32_t offset = lua_tonumber(L, idx + 3);
 	uint32_t limit = lua_tonumber(L, idx + 4);
+	uint32_t fetch_size = lua_tonumber(L, idx + 6);
+
+	mpstream_encode_map(stream, fetch_size > 0 ? 7 : 6);
 
 	/* encode space_id */
 	mpstream_encode_uint(stream, IPROTO_SPACE_ID);
@@ -818,6 +843,12 @@ netbox_encode_select(lua_State *L, int idx, struct mpstream *stream,
 	mpstream_encode_uint(stream, IPROTO_KEY);
 	luamp_convert_key(L, cfg, stream, idx + 5);
 
+	/* encode fetch_size */
+	if (fetch_size > 0) {
+		mpstream_encode_uint(stream, IPROTO_FETCH_SIZE);
+		mpstream_encode_uint(stream, fetch_size);
+	}
+
 	netbox_end_encode(stream, svp);
 }
 
@@ -1188,6 +1219,89 @@ netbox_encode_unprepare(lua_State *L, int idx, struct mpstream *stream,
 	netbox_encode_prepare(L, idx, stream, sync, stream_id);
 }
 
+static void
+netbox_encode_box_prepare(lua_State *L, int idx, struct mpstream *stream,
+			  uint64_t sync, uint64_t stream_id)
+{
+	/*
+	 * Lua stack at idx: type, space_id, index_id, iterator, offset,
+	 * limit, ops (optional).
+	 */
+	size_t svp = netbox_begin_encode(stream, sync, IPROTO_BOX_PREPARE,
+					 stream_id);
+
+	uint32_t type = lua_tointeger(L, idx);
+	bool has_ops = !lua_isnoneornil(L, idx + 6);
+	mpstream_encode_map(stream, has_ops ? 8 : 6);
+
+	mpstream_encode_uint(stream, IPROTO_STMT_TYPE);
+	mpstream_encode_uint(stream, type);
+
+	mpstream_encode_uint(stream, IPROTO_SPACE_ID);
+	mpstream_encode_uint(stream, lua_tonumber(L, idx + 1));
+
+	mpstream_encode_uint(stream, IPROTO_INDEX_ID);
+	mpstream_encode_uint(stream, lua_tonumber(L, idx + 2));
+
+	mpstream_encode_uint(stream, IPROTO_ITERATOR);
+	mpstream_encode_uint(stream, lua_tointeger(L, idx + 3));
+
+	mpstream_encode_uint(stream, IPROTO_OFFSET);
+	mpstream_encode_uint(stream, lua_tonumber(L, idx + 4));
+
+	mpstream_encode_uint(stream, IPROTO_LIMIT);
+	mpstream_encode_uint(stream, lua_tonumber(L, idx + 5));
+
+	if (has_ops) {
+		mpstream_encode_uint(stream, IPROTO_INDEX_BASE);
+		mpstream_encode_uint(stream, 1);
+		/* UPDATE operations are sent in IPROTO_TUPLE. */
+		mpstream_encode_uint(stream, type == IPROTO_UPDATE ?
+					     IPROTO_TUPLE : IPROTO_OPS);
+		luamp_encode_tuple(L, cfg, stream, idx + 6);
+	}
+
+	netbox_end_encode(stream, svp);
+}
+
+static void
+netbox_encode_box_unprepare(lua_State *L, int idx, struct mpstream *stream,
+			    uint64_t sync, uint64_t stream_id)
+{
+	/* Lua stack at idx: stmt_id */
+	size_t svp = netbox_begin_encode(stream, sync, IPROTO_BOX_PREPARE,
+					 stream_id);
+	mpstream_encode_map(stream, 1);
+	mpstream_encode_uint(stream, IPROTO_STMT_ID);
+	mpstream_encode_uint(stream, lua_tointeger(L, idx));
+	netbox_end_encode(stream, svp);
+}
+
+static void
+netbox_encode_box_execute(lua_State *L, int idx, struct mpstream *stream,
+			  uint64_t sync, uint64_t stream_id)
+{
+	/* Lua stack at idx: type, stmt_id, key or tuple */
+	uint32_t type = lua_tointeger(L, idx);
+	size_t svp = netbox_begin_encode(stream, sync, type, stream_id);
+
+	mpstream_encode_map(stream, 2);
+
+	mpstream_encode_uint(stream, IPROTO_STMT_ID);
+	mpstream_encode_uint(stream, lua_tointeger(L, idx + 1));
+
+	if (type == IPROTO_INSERT || type == IPROTO_REPLACE ||
+	    type == IPROTO_UPSERT) {
+		mpstream_encode_uint(stream, IPROTO_TUPLE);
+		luamp_encode_tuple(L, cfg, stream, idx + 2);
+	} else {
+		mpstream_encode_uint(stream, IPROTO_KEY);
+		luamp_convert_key(L, cfg, stream, idx + 2);
+	}
+
+	netbox_end_encode(stream, svp);
+}
+
 static inline void
 netbox_encode_commit_or_rollback(lua_State *L, enum iproto_type type, int idx,
 				 struct mpstream *stream, uint64_t sync,
@@ -1278,6 +1392,10 @@ netbox_encode_method(struct lua_State *L, int idx, enum netbox_method method,
 		[NETBOX_COMMIT]         = netbox_encode_commit,
 		[NETBOX_ROLLBACK]       = netbox_encode_rollback,
 		[NETBOX_INJECT]		= netbox_encode_inject,
+		[NETBOX_BOX_PREPARE]	= netbox_encode_box_prepare,
+		[NETBOX_BOX_UNPREPARE]	= netbox_encode_box_unprepare,
+		[NETBOX_BOX_EXECUTE]	= netbox_encode_box_execute,
+		[NETBOX_BOX_SELECT]	= netbox_encode_box_execute,
 	};
 	struct mpstream stream;
 	mpstream_init(&stream, ibuf, ibuf_reserve_cb, ibuf_alloc_cb,
@@ -1667,6 +1785,32 @@ netbox_decode_prepare(struct lua_State *L, const char **data,
 	}
 }
 
+/**
+ * Decodes an IPROTO_BOX_PREPARE response body and pushes the id of
+ * the prepared statement to Lua stack.
+ */
+static void
+netbox_decode_box_prepare(struct lua_State *L, const char **data,
+			  const char *data_end, bool return_raw,
+			  struct tuple_format *format)
+{
+	(void)return_raw;
+	(void)format;
+	uint64_t stmt_id = 0;
+	assert(mp_typeof(**data) == MP_MAP);
+	uint32_t map_size = mp_decode_map(data);
+	for (uint32_t i = 0; i < map_size; ++i) {
+		uint32_t key = mp_decode_uint(data);
+		if (key == IPROTO_STMT_ID)
+			stmt_id = mp_decode_uint(data);
+		else
+			mp_next(data);
+	}
+	assert(*data == data_end);
+	(void)data_end;
+	luaL_pushuint64(L, stmt_id);
+}
+
 /**
  * Decodes a response body for the specified method and pushes the result to
  * Lua stack. If the return_raw flag is set, pushes a msgpack object instead of
@@ -1702,6 +1846,10 @@ netbox_decode_method(struct lua_State *L, enum netbox_method method,
 		[NETBOX_COMMIT]         = netbox_decode_nil,
 		[NETBOX_ROLLBACK]       = netbox_decode_nil,
 		[NETBOX_INJECT]		= netbox_decode_table,
+		[NETBOX_BOX_PREPARE]	= netbox_decode_box_prepare,
+		[NETBOX_BOX_UNPREPARE]	= netbox_decode_nil,
+		[NETBOX_BOX_EXECUTE]	= netbox_decode_tuple,
+		[NETBOX_BOX_SELECT]	= netbox_decode_select,
 	};
 	method_decoder[method](L, data, data_end, return_raw, format);
 }
@@ -2129,6 +2277,7 @@ luaT_netbox_transport_make_request(struct lua_State *L, int idx,
 	request->index_ref = LUA_NOREF;
 	request->result_ref = LUA_NOREF;
 	request->error = NULL;
+	request->start_time = ev_monotonic_now(loop());
 	netbox_request_register(request, transport);
 	return 0;
 }
@@ -2168,6 +2317,158 @@ luaT_netbox_transport_perform_request(struct lua_State *L)
 	return ret;
 }
 
+/** State of a batch of requests being written to the send buffer. */
+struct netbox_batch {
+	/** Transport the requests are sent over. */
+	struct netbox_transport *transport;
+	/** Array of request objects. */
+	struct netbox_request *requests;
+	/** Number of requests registered so far. */
+	int count;
+	/** The return_raw flag of all requests of the batch. */
+	bool return_raw;
+};
+
+/**
+ * Encodes and registers the requests of a batch, see perform_batch().
+ * Encoding may raise a Lua error so the function is called with
+ * lua_pcall(). Takes the batch (light userdata), the push handler,
+ * and the array of requests. Returns true on success, false if a
+ * request can't be performed, in which case diag is set.
+ */
+static int
+luaT_netbox_transport_encode_batch(struct lua_State *L)
+{
+	struct netbox_batch *batch = lua_touserdata(L, 1);
+	int count = lua_objlen(L, 3);
+	int top = lua_gettop(L);
+	for (int i = 0; i < count; i++) {
+		/* buffer, skip_header, return_raw, on_push, on_push_ctx */
+		lua_pushnil(L);
+		lua_pushboolean(L, false);
+		lua_pushboolean(L, batch->return_raw);
+		lua_pushvalue(L, 2);
+		lua_pushnil(L);
+		/* format, stream_id, method, args... */
+		lua_rawgeti(L, 3, i + 1);
+		int entry = lua_gettop(L);
+		lua_getfield(L, entry, "n");
+		int n = lua_tointeger(L, -1);
+		lua_pop(L, 1);
+		for (int j = 1; j <= n; j++)
+			lua_rawgeti(L, entry, j);
+		lua_remove(L, entry);
+		int rc = luaT_netbox_transport_make_request(
+				L, top + 1, batch->transport,
+				&batch->requests[i]);
+		lua_settop(L, top);
+		if (rc != 0) {
+			lua_pushboolean(L, false);
+			return 1;
+		}
+		batch->count++;
+	}
+	lua_pushboolean(L, true);
+	return 1;
+}
+
+/**
+ * Performs a batch of requests. Takes a timeout, the return_raw flag,
+ * a push handler, and an array of requests, each of which is a table
+ * {n = <number of values>, format, stream_id, method, args...}.
+ *
+ * All requests are written to the send buffer in one call so that
+ * they are sent to the server in one write, then the function waits
+ * for all responses, which are decoded by the worker fiber as they
+ * arrive. Returns an array of results, in the order of requests, and
+ * a table of errors indexed by request number or nil if all requests
+ * succeeded. If the batch can't be sent or times out, returns nil and
+ * the error. If any request of the batch can't be encoded, none of
+ * them is sent.
+ */
+static int
+luaT_netbox_transport_perform_batch(struct lua_State *L)
+{
+	struct netbox_transport *transport = luaT_check_netbox_transport(L, 1);
+	double timeout = (!lua_isnil(L, 2) ?
+			  lua_tonumber(L, 2) : TIMEOUT_INFINITY);
+	struct netbox_batch batch;
+	batch.transport = transport;
+	batch.count = 0;
+	batch.return_raw = lua_toboolean(L, 3);
+	int count = lua_objlen(L, 5);
+	/*
+	 * The request objects are owned by Lua so that they're freed
+	 * even if the function raises an error. The userdata is kept
+	 * on the stack until the function returns.
+	 */
+	batch.requests = lua_newuserdata(L, count * sizeof(*batch.requests));
+	size_t send_buf_used = ibuf_used(&transport->send_buf);
+	int64_t inprogress_request_count = transport->inprogress_request_count;
+	lua_pushcfunction(L, luaT_netbox_transport_encode_batch);
+	lua_pushlightuserdata(L, &batch);
+	lua_pushvalue(L, 4);
+	lua_pushvalue(L, 5);
+	int rc;
+	if (lua_pcall(L, 3, 1, 0) != 0)
+		rc = luaT_toerror(L);
+	else
+		rc = lua_toboolean(L, -1) ? 0 : -1;
+	lua_pop(L, 1);
+	int i;
+	if (rc != 0) {
+		/*
+		 * Drop the requests that have been written, but not
+		 * sent yet, as well as a partially encoded request,
+		 * so that nobody gets responses to them. The worker
+		 * can't have sent them, because encoding doesn't
+		 * yield.
+		 */
+		struct ibuf *send_buf = &transport->send_buf;
+		send_buf->wpos = send_buf->rpos + send_buf_used;
+		transport->inprogress_request_count = inprogress_request_count;
+		i = batch.count;
+		goto fail;
+	}
+	for (i = 0; i < count; i++) {
+		while (!netbox_request_is_ready(&batch.requests[i])) {
+			if (!netbox_request_wait(&batch.requests[i],
+						 &timeout)) {
+				diag_set(TimedOut);
+				i = count;
+				goto fail;
+			}
+		}
+	}
+	lua_createtable(L, count, 0);
+	int results = lua_gettop(L);
+	lua_pushnil(L);
+	int errors = lua_gettop(L);
+	for (i = 0; i < count; i++) {
+		struct netbox_request *request = &batch.requests[i];
+		if (request->error != NULL) {
+			if (lua_isnil(L, errors)) {
+				lua_newtable(L);
+				lua_replace(L, errors);
+			}
+			luaT_pusherror(L, request->error);
+			lua_rawseti(L, errors, i + 1);
+		} else {
+			lua_rawgeti(L, LUA_REGISTRYINDEX, request->result_ref);
+			lua_rawseti(L, results, i + 1);
+		}
+		netbox_request_destroy(request);
+	}
+	return 2;
+fail:
+	while (i-- > 0) {
+		netbox_request_unregister(&batch.requests[i]);
+		netbox_request_destroy(&batch.requests[i]);
+	}
+	luaL_testcancel(L);
+	return luaT_push_nil_and_error(L);
+}
+
 /**
  * Encodes a WATCH/UNWATCH request and writes it to the send buffer.
  * Takes the name of the notification key to acknowledge.
@@ -2319,6 +2620,11 @@ netbox_transport_dispatch_response(struct netbox_transport *transport,
 		/* Nobody is waiting for the response. */
 		return;
 	}
+	if (transport->latency != NULL &&
+	    (status == IPROTO_OK || iproto_type_is_error(status))) {
+		latency_collect(transport->latency,
+				ev_monotonic_now(loop()) - request->start_time);
+	}
 	if (iproto_type_is_error(status)) {
 		/* Handle errors. */
 		xrow_decode_error(hdr);
@@ -2340,8 +2646,13 @@ netbox_transport_dispatch_response(struct netbox_transport *transport,
 		memcpy(wpos, data, data_len);
 		lua_pushinteger(L, data_len);
 	} else {
-		/* Decode xrow.body[DATA] to Lua objects. */
-		if (status == IPROTO_OK) {
+		/*
+		 * Decode xrow.body[DATA] to Lua objects. Chunks of
+		 * a SELECT reply sent with IPROTO_FETCH_SIZE are
+		 * decoded as the reply.
+		 */
+		if (status == IPROTO_OK ||
+		    request->method == NETBOX_SELECT) {
 			netbox_decode_method(L, request->method, &data,
 					     data_end, request->return_raw,
 					     request->format);
@@ -2761,6 +3072,127 @@ luaT_netbox_transport_graceful_shutdown(struct lua_State *L)
 	return 0;
 }
 
+/**
+ * Sets the latency counter updated by the transport, see
+ * netbox_transport::latency. Takes a latency object or nil.
+ */
+static int
+luaT_netbox_transport_set_latency(struct lua_State *L)
+{
+	struct netbox_transport *transport = luaT_check_netbox_transport(L, 1);
+	luaL_unref(L, LUA_REGISTRYINDEX, transport->latency_ref);
+	transport->latency_ref = LUA_NOREF;
+	transport->latency = NULL;
+	if (!lua_isnil(L, 2)) {
+		transport->latency = luaL_checkudata(L, 2,
+						     netbox_latency_typename);
+		lua_pushvalue(L, 2);
+		transport->latency_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+	}
+	return 0;
+}
+
+/** Returns the number of requests waiting for a response. */
+static int
+luaT_netbox_transport_inprogress_request_count(struct lua_State *L)
+{
+	struct netbox_transport *transport = luaT_check_netbox_transport(L, 1);
+	lua_pushinteger(L, transport->inprogress_request_count);
+	return 1;
+}
+
+/**
+ * Picks a transport to send a request to from an array of transports.
+ * Returns the index of the transport with the least number of requests
+ * in progress among the transports that can accept requests or nothing
+ * if there's no such transport. The array is scanned starting at the
+ * index given in the second argument so that the caller can spread
+ * requests among equally loaded transports.
+ */
+static int
+luaT_netbox_pick_transport(struct lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	int count = lua_objlen(L, 1);
+	int start = lua_tointeger(L, 2);
+	int best = 0;
+	int64_t best_count = INT64_MAX;
+	for (int i = 0; i < count && best_count > 0; i++) {
+		int idx = (start + i - 1 + count) % count + 1;
+		lua_rawgeti(L, 1, idx);
+		struct netbox_transport *transport =
+			luaT_check_netbox_transport(L, -1);
+		lua_pop(L, 1);
+		if ((transport->state != NETBOX_ACTIVE &&
+		     transport->state != NETBOX_FETCH_SCHEMA) ||
+		    transport->is_closing)
+			continue;
+		if (transport->inprogress_request_count < best_count) {
+			best = idx;
+			best_count = transport->inprogress_request_count;
+		}
+	}
+	if (best == 0)
+		return 0;
+	lua_pushinteger(L, best);
+	return 1;
+}
+
+static inline struct latency *
+luaT_check_netbox_latency(struct lua_State *L, int idx)
+{
+	return luaL_checkudata(L, idx, netbox_latency_typename);
+}
+
+/** Creates a latency counter, see netbox_transport::latency. */
+static int
+luaT_netbox_new_latency(struct lua_State *L)
+{
+	struct latency *latency = lua_newuserdata(L, sizeof(*latency));
+	if (latency_create(latency) != 0) {
+		diag_set(OutOfMemory, sizeof(struct histogram),
+			 "histogram_new", "latency");
+		return luaT_error(L);
+	}
+	luaL_getmetatable(L, netbox_latency_typename);
+	lua_setmetatable(L, -2);
+	return 1;
+}
+
+static int
+luaT_netbox_latency_gc(struct lua_State *L)
+{
+	latency_destroy(luaT_check_netbox_latency(L, 1));
+	return 0;
+}
+
+/** Returns the given percentile of the collected latency, in seconds. */
+static int
+luaT_netbox_latency_get(struct lua_State *L)
+{
+	struct latency *latency = luaT_check_netbox_latency(L, 1);
+	int pct = luaL_checkinteger(L, 2);
+	lua_pushnumber(L, latency_get(latency, pct));
+	return 1;
+}
+
+/** Returns the number of collected observations. */
+static int
+luaT_netbox_latency_count(struct lua_State *L)
+{
+	struct latency *latency = luaT_check_netbox_latency(L, 1);
+	/* Subtract the zero observation added on reset. */
+	lua_pushinteger(L, latency->histogram->total - 1);
+	return 1;
+}
+
+static int
+luaT_netbox_latency_reset(struct lua_State *L)
+{
+	latency_reset(luaT_check_netbox_latency(L, 1));
+	return 0;
+}
+
 int
 luaopen_net_box(struct lua_State *L)
 {
@@ -2787,6 +3219,11 @@ luaopen_net_box(struct lua_State *L)
 			luaT_netbox_transport_perform_request },
 		{ "perform_async_request",
 			luaT_netbox_transport_perform_async_request },
+		{ "perform_batch",
+			luaT_netbox_transport_perform_batch },
+		{ "set_latency",    luaT_netbox_transport_set_latency },
+		{ "inprogress_request_count",
+			luaT_netbox_transport_inprogress_request_count },
 		{ "watch",          luaT_netbox_transport_watch },
 		{ "unwatch",        luaT_netbox_transport_unwatch },
 		{ NULL, NULL }
@@ -2809,8 +3246,19 @@ luaopen_net_box(struct lua_State *L)
 	};
 	luaL_register_type(L, netbox_request_typename, netbox_request_meta);
 
+	static const struct luaL_Reg netbox_latency_meta[] = {
+		{ "__gc",           luaT_netbox_latency_gc },
+		{ "get",            luaT_netbox_latency_get },
+		{ "count",          luaT_netbox_latency_count },
+		{ "reset",          luaT_netbox_latency_reset },
+		{ NULL, NULL }
+	};
+	luaL_register_type(L, netbox_latency_typename, netbox_latency_meta);
+
 	static const luaL_Reg net_box_lib[] = {
 		{ "new_transport",  luaT_netbox_new_transport },
+		{ "new_latency",    luaT_netbox_new_latency },
+		{ "pick_transport", luaT_netbox_pick_transport },
 		{ NULL, NULL}
 	};
 	/* luaL_register_module polutes _G */
@@ -46,6 +46,20 @@ local M_COMMIT      = 18
 local M_ROLLBACK    = 19
 -- Injects raw data into connection. Used by tests.
 local M_INJECT      = 20
+local M_BOX_PREPARE = 21
+local M_BOX_UNPREPARE = 22
+local M_BOX_EXECUTE = 23
+local M_BOX_SELECT  = 24
+
+-- Statement type name -> IPROTO request type, see index:prepare().
+local BOX_STMT_TYPES = {
+    select  = 1,
+    insert  = 2,
+    replace = 3,
+    update  = 4,
+    delete  = 5,
+    upsert  = 9,
+}
 
 -- IPROTO feature id -> name
 local IPROTO_FEATURE_NAMES = {
@@ -761,6 +775,9 @@ end
 function remote_methods:call(func_name, args, opts)
     check_remote_arg(self, 'call')
     check_call_args(args)
+    if opts ~= nil and opts.fetch_size ~= nil then
+        box.error(box.error.UNSUPPORTED, 'call', 'fetch_size')
+    end
     args = args or {}
     local res = self:_request(M_CALL_17, opts, nil, self._stream_id,
                               tostring(func_name), args)
@@ -780,6 +797,9 @@ end
 function remote_methods:eval(code, args, opts)
     check_remote_arg(self, 'eval')
     check_eval_args(args)
+    if opts ~= nil and opts.fetch_size ~= nil then
+        box.error(box.error.UNSUPPORTED, 'eval', 'fetch_size')
+    end
     args = args or {}
     local res = self:_request(M_EVAL, opts, nil, self._stream_id, code, args)
     if type(res) ~= 'table' or opts and opts.is_async then
@@ -820,6 +840,126 @@ function remote_methods:unprepare(query, parameters, sql_opts, netbox_opts)
                          query, parameters or {}, sql_opts or {})
 end
 
+--
+-- A batch of requests, see remote_methods:batch().
+--
+local batch_methods = {}
+local batch_mt = {
+    __index = batch_methods,
+    __tostring = function()
+        return 'net.box.batch'
+    end,
+}
+batch_mt.__serialize = batch_mt.__tostring
+
+-- Adds a request to the batch. The values are passed to the transport
+-- as is, see transport:perform_batch().
+local function batch_add(batch, format, method, ...)
+    local n = select('#', ...) + 3
+    table.insert(batch._requests, {n = n, format, batch._remote._stream_id,
+                                   method, ...})
+    return batch
+end
+
+local function batch_check_space(batch, space, method)
+    if type(batch) ~= 'table' then
+        local fmt = 'Use batch:%s(...) instead of batch.%s(...)'
+        box.error(E_PROC_LUA, string.format(fmt, method, method))
+    end
+    local s = batch._remote.space[space]
+    if s == nil then
+        box.error(box.error.NO_SUCH_SPACE, tostring(space))
+    end
+    return s
+end
+
+function batch_methods:select(space, key, opts)
+    local s = batch_check_space(self, space, 'select')
+    local index = s.index[opts and opts.index or 0]
+    if index == nil then
+        box.error(box.error.NO_SUCH_INDEX_NAME, tostring(opts.index), s.name)
+    end
+    local key_is_nil = (key == nil or
+                        (type(key) == 'table' and #key == 0))
+    local iterator, offset, limit = check_select_opts(opts, key_is_nil)
+    return batch_add(self, s._format_cdata, M_SELECT, s.id, index.id,
+                     iterator, offset, limit, key)
+end
+
+function batch_methods:insert(space, tuple)
+    local s = batch_check_space(self, space, 'insert')
+    return batch_add(self, s._format_cdata, M_INSERT, s.id, tuple)
+end
+
+function batch_methods:replace(space, tuple)
+    local s = batch_check_space(self, space, 'replace')
+    return batch_add(self, s._format_cdata, M_REPLACE, s.id, tuple)
+end
+
+function batch_methods:delete(space, key)
+    local s = batch_check_space(self, space, 'delete')
+    return batch_add(self, s._format_cdata, M_DELETE, s.id, 0, key)
+end
+
+function batch_methods:update(space, key, oplist)
+    local s = batch_check_space(self, space, 'update')
+    return batch_add(self, s._format_cdata, M_UPDATE, s.id, 0, key, oplist)
+end
+
+function batch_methods:upsert(space, tuple, oplist)
+    local s = batch_check_space(self, space, 'upsert')
+    return batch_add(self, nil, M_UPSERT, s.id, tuple, oplist)
+end
+
+function batch_methods:call(func_name, args)
+    check_call_args(args)
+    return batch_add(self, nil, M_CALL_17, tostring(func_name), args or {})
+end
+
+function batch_methods:eval(code, args)
+    check_eval_args(args)
+    return batch_add(self, nil, M_EVAL, code, args or {})
+end
+
+--
+-- Sends all requests added to the batch and waits for the responses.
+-- Returns an array of results, in the order the requests were added,
+-- and a table of errors indexed by request number, or nil if all
+-- requests succeeded. A result is the same as the one returned by
+-- future:result() for the request. Options:
+--  - timeout: time to wait for all responses.
+--  - return_raw: return msgpack objects instead of decoding results.
+-- The batch is emptied and may be reused.
+--
+function batch_methods:send(opts)
+    local remote = self._remote
+    local requests = self._requests
+    self._requests = {}
+    local timeout = opts and opts.timeout
+    local deadline = timeout and fiber_clock() + timeout
+    if remote.state ~= 'active' then
+        remote:wait_state('active', timeout)
+        timeout = deadline and max(0, deadline - fiber_clock())
+    end
+    local results, errors = remote._transport:perform_batch(
+        timeout, opts and opts.return_raw, on_push_sync_default, requests)
+    if results == nil then
+        box.error(errors)
+    end
+    return results, errors
+end
+
+--
+-- Creates a batch of requests. Requests added to the batch with
+-- batch:select(), batch:call(), etc. are encoded and written to the
+-- socket at once by batch:send(), which then waits for all responses.
+-- This saves a Lua/C round trip and a future object per request.
+--
+function remote_methods:batch()
+    check_remote_arg(self, 'batch')
+    return setmetatable({_remote = self, _requests = {}}, batch_mt)
+end
+
 function remote_methods:wait_state(state, timeout)
     check_remote_arg(self, 'wait_state')
     local deadline = fiber_clock() + (timeout or TIMEOUT_INFINITY)
@@ -949,6 +1089,36 @@ local function nothing_or_data(value)
     end
 end
 
+--
+-- A request prepared on the server, see index:prepare(). The
+-- statement belongs to the server session, so it's lost when the
+-- connection is closed or reconnects.
+--
+local stmt_methods = {}
+local stmt_mt = {
+    __index = stmt_methods,
+    __tostring = function()
+        return 'net.box.statement'
+    end,
+}
+
+function stmt_methods:execute(arg, opts)
+    if self.type == 'select' then
+        return (self._remote:_request(M_BOX_SELECT, opts, self._format,
+                                      self._stream_id, BOX_STMT_TYPES.select,
+                                      self.id, arg))
+    end
+    local format = self.type ~= 'upsert' and self._format or nil
+    return nothing_or_data(self._remote:_request(M_BOX_EXECUTE, opts, format,
+                                                 self._stream_id,
+                                                 BOX_STMT_TYPES[self.type],
+                                                 self.id, arg))
+end
+
+function stmt_methods:unprepare(opts)
+    self._remote:_request(M_BOX_UNPREPARE, opts, nil, nil, self.id)
+end
+
 space_metatable = function(remote)
     local methods = {}
 
@@ -991,6 +1161,11 @@ space_metatable = function(remote)
         return check_primary_index(self):get(key, opts)
     end
 
+    function methods:prepare(stmt_type, opts)
+        check_space_arg(self, 'prepare')
+        return check_primary_index(self):prepare(stmt_type, opts)
+    end
+
     function methods:format(format)
         if format == nil then
             return self._format
@@ -1010,9 +1185,45 @@ index_metatable = function(remote)
         local key_is_nil = (key == nil or
                             (type(key) == 'table' and #key == 0))
         local iterator, offset, limit = check_select_opts(opts, key_is_nil)
-        return (remote:_request(M_SELECT, opts, self.space._format_cdata,
-                                self._stream_id, self.space.id, self.id,
-                                iterator, offset, limit, key))
+        local fetch_size = opts and opts.fetch_size
+        if fetch_size ~= nil then
+            if type(fetch_size) ~= 'number' or fetch_size < 0 then
+                box.error(box.error.ILLEGAL_PARAMS,
+                          "fetch_size should be a non-negative number")
+            end
+            -- Chunks can't be returned in a buffer or as a single
+            -- msgpack object, and old servers don't support them.
+            if opts.buffer ~= nil or opts.return_raw or
+               (remote.peer_protocol_version or 0) < 4 then
+                fetch_size = nil
+            end
+        end
+        if fetch_size == nil or opts.is_async or opts.on_push ~= nil then
+            -- In the async mode, chunks are returned by future:pairs().
+            return (remote:_request(M_SELECT, opts, self.space._format_cdata,
+                                    self._stream_id, self.space.id, self.id,
+                                    iterator, offset, limit, key, fetch_size))
+        end
+        -- Collect chunks sent as pushes and append the final reply.
+        local chunks = {}
+        local chunk_opts = setmetatable({
+            on_push = table.insert, on_push_ctx = chunks,
+        }, {__index = opts})
+        local res = remote:_request(M_SELECT, chunk_opts,
+                                    self.space._format_cdata,
+                                    self._stream_id, self.space.id, self.id,
+                                    iterator, offset, limit, key, fetch_size)
+        if #chunks == 0 then
+            return res
+        end
+        local ret = {}
+        table.insert(chunks, res)
+        for _, chunk in ipairs(chunks) do
+            for _, tuple in ipairs(chunk) do
+                table.insert(ret, tuple)
+            end
+        end
+        return ret
     end
 
     function methods:get(key, opts)
@@ -1078,6 +1289,42 @@ index_metatable = function(remote)
                                                self.id, key, oplist))
     end
 
+    -- Prepares a request on the server. Returns a statement that
+    -- sends only the key (select, delete, update) or the tuple
+    -- (insert, replace, upsert) on execution. Select options and
+    -- update operations (opts.ops) are bound on preparation.
+    function methods:prepare(stmt_type, opts)
+        check_index_arg(self, 'prepare')
+        local type_code = BOX_STMT_TYPES[stmt_type]
+        if type_code == nil then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "unknown statement type '" .. tostring(stmt_type) ..
+                      "'")
+        end
+        local iterator, offset, limit = 0, 0, 0
+        if stmt_type == 'select' then
+            iterator, offset, limit = check_select_opts(opts, false)
+        end
+        local ops = opts and opts.ops
+        if (stmt_type == 'update' or stmt_type == 'upsert') and
+           type(ops) ~= 'table' then
+            box.error(box.error.ILLEGAL_PARAMS, "ops should be a table")
+        end
+        -- Statements can't be prepared in a stream, but can be
+        -- executed in it.
+        local id = remote:_request(M_BOX_PREPARE,
+                                   opts and {timeout = opts.timeout}, nil,
+                                   nil, type_code, self.space.id, self.id,
+                                   iterator, offset, limit, ops)
+        return setmetatable({
+            id = id,
+            type = stmt_type,
+            _remote = remote,
+            _format = self.space._format_cdata,
+            _stream_id = self._stream_id,
+        }, stmt_mt)
+    end
+
     return { __index = methods, __metatable = false }
 end
 
@@ -1106,6 +1353,10 @@ this_module = {
         commit      = M_COMMIT,
         rollback    = M_ROLLBACK,
         inject      = M_INJECT,
+        box_prepare = M_BOX_PREPARE,
+        box_unprepare = M_BOX_UNPREPARE,
+        box_execute = M_BOX_EXECUTE,
+        box_select  = M_BOX_SELECT,
     }
 }
 
@@ -1122,6 +1373,170 @@ function this_module.timeout(timeout, ...)
     }, {__index = this_module})
 end
 
+--
+-- Connection pool, see net.box.pool.new().
+--
+local pool_methods = {}
+local pool_mt = {
+    __index = pool_methods,
+    __tostring = function()
+        return 'net.box.pool'
+    end,
+}
+pool_mt.__serialize = pool_mt.__tostring
+
+local function check_pool_arg(pool, method)
+    if type(pool) ~= 'table' then
+        local fmt = 'Use pool:%s(...) instead of pool.%s(...)'
+        box.error(E_PROC_LUA, string.format(fmt, method, method))
+    end
+end
+
+--
+-- Creates a pool of connections to the given endpoints. Options are
+-- passed to net.box.connect() except for:
+--  - connections: number of connections per endpoint, 1 by default.
+-- By default, the pool doesn't wait for the connections to be
+-- established and reconnects them every second (reconnect_after = 1).
+--
+local function pool_new(uris, opts)
+    if type(uris) ~= 'table' or #uris == 0 then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "uris should be a non-empty array")
+    end
+    opts = table.copy(opts) or {}
+    local count = opts.connections or 1
+    if type(count) ~= 'number' or count < 1 then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "connections should be a positive number")
+    end
+    opts.connections = nil
+    if opts.reconnect_after == nil then
+        opts.reconnect_after = 1
+    end
+    if opts.wait_connected == nil then
+        opts.wait_connected = false
+    end
+    local pool = setmetatable({
+        _endpoints = {},
+        -- Connections of all endpoints and their transports, used for
+        -- picking a connection with internal.pick_transport().
+        _connections = {},
+        _transports = {},
+        _next = 0,
+    }, pool_mt)
+    for _, uri in ipairs(uris) do
+        local endpoint = {
+            uri = uri,
+            latency = internal.new_latency(),
+            connections = {},
+        }
+        for _ = 1, count do
+            local conn = connect(uri, opts)
+            conn._transport:set_latency(endpoint.latency)
+            table.insert(endpoint.connections, conn)
+            table.insert(pool._connections, conn)
+            table.insert(pool._transports, conn._transport)
+        end
+        table.insert(pool._endpoints, endpoint)
+    end
+    return pool
+end
+
+--
+-- Returns the connection that has the least number of requests in
+-- progress among connections that are ready to accept requests.
+-- Raises an error if there's no such connection.
+--
+function pool_methods:connection()
+    check_pool_arg(self, 'connection')
+    local transports = self._transports
+    self._next = self._next % #transports + 1
+    local i = internal.pick_transport(transports, self._next)
+    if i == nil then
+        box.error(box.error.NO_CONNECTION)
+    end
+    return self._connections[i]
+end
+
+function pool_methods:call(func_name, args, opts)
+    return self:connection():call(func_name, args, opts)
+end
+
+function pool_methods:eval(code, args, opts)
+    return self:connection():eval(code, args, opts)
+end
+
+--
+-- Waits until all connections of the pool are established. Returns
+-- true on success, false on timeout or if a connection failed.
+--
+function pool_methods:wait_connected(timeout)
+    check_pool_arg(self, 'wait_connected')
+    local deadline = fiber_clock() + (timeout or TIMEOUT_INFINITY)
+    for _, conn in ipairs(self._connections) do
+        if not conn:wait_connected(max(0, deadline - fiber_clock())) then
+            return false
+        end
+    end
+    return true
+end
+
+--
+-- Returns per-endpoint statistics: the number of connections that are
+-- ready to accept requests, the number of requests in progress, and
+-- the number of completed requests with their latency percentiles, in
+-- seconds.
+--
+function pool_methods:stat()
+    check_pool_arg(self, 'stat')
+    local ret = {}
+    for _, endpoint in ipairs(self._endpoints) do
+        local active = 0
+        local inprogress = 0
+        for _, conn in ipairs(endpoint.connections) do
+            if conn:is_connected() then
+                active = active + 1
+            end
+            inprogress = inprogress +
+                         conn._transport:inprogress_request_count()
+        end
+        local latency = endpoint.latency
+        table.insert(ret, {
+            uri = endpoint.uri,
+            connections = #endpoint.connections,
+            active = active,
+            inprogress = inprogress,
+            requests = latency:count(),
+            latency = {
+                p50 = latency:get(50),
+                p90 = latency:get(90),
+                p99 = latency:get(99),
+            },
+        })
+    end
+    return ret
+end
+
+-- Resets the latency statistics of all endpoints.
+function pool_methods:reset_stat()
+    check_pool_arg(self, 'reset_stat')
+    for _, endpoint in ipairs(self._endpoints) do
+        endpoint.latency:reset()
+    end
+end
+
+function pool_methods:close()
+    check_pool_arg(self, 'close')
+    for _, conn in ipairs(self._connections) do
+        conn:close()
+    end
+end
+
+this_module.pool = {
+    new = pool_new,
+}
+
 local function rollback()
     if rawget(box, 'rollback') ~= nil then
         -- roll back local transaction on error
@@ -1316,6 +1316,10 @@ local index_options = {
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    compaction_policy = 'string',
+    bloom_type = 'string',
+    compression_dict = 'boolean',
+    blob_threshold = 'number',
     func = 'number, string',
     hint = 'boolean',
 }
@@ -1463,6 +1467,10 @@ box.schema.index.create = function(space_id, name, options)
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            compaction_policy = options.compaction_policy,
+            bloom_type = options.bloom_type,
+            compression_dict = options.compression_dict,
+            blob_threshold = options.blob_threshold,
             func = options.func,
             hint = options.hint,
     }
@@ -2296,6 +2304,12 @@ base_index_mt.delete = function(index, key)
     return internal.delete(index.space_id, index.id, keify(key));
 end
 
+base_index_mt.delete_range = function(index, key, end_key)
+    check_index_arg(index, 'delete_range')
+    return internal.delete_range(index.space_id, index.id, keify(key),
+                                 keify(end_key))
+end
+
 base_index_mt.stat = function(index)
     return internal.stat(index.space_id, index.id);
 end
@@ -2404,6 +2418,10 @@ space_mt.delete = function(space, key)
     check_space_arg(space, 'delete')
     return check_primary_index(space):delete(key)
 end
+space_mt.delete_range = function(space, key, end_key)
+    check_space_arg(space, 'delete_range')
+    return check_primary_index(space):delete_range(key, end_key)
+end
 -- Assumes that spaceno has a TREE (NUM) primary key
 -- inserts a tuple after getting the next value of the
 -- primary key and returns it back to the user
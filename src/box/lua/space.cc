@@ -556,6 +556,29 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnumber(L, index_opts->bloom_fpr);
 			lua_setfield(L, -2, "bloom_fpr");
 
+			if (index_opts->compaction_policy !=
+			    VY_COMPACTION_POLICY_TIERED) {
+				lua_pushstring(L, vy_compaction_policy_strs[
+					index_opts->compaction_policy]);
+				lua_setfield(L, -2, "compaction_policy");
+			}
+
+			if (index_opts->bloom_type != BLOOM_CLASSIC) {
+				lua_pushstring(L, bloom_type_strs[
+					index_opts->bloom_type]);
+				lua_setfield(L, -2, "bloom_type");
+			}
+
+			if (index_opts->compression_dict) {
+				lua_pushboolean(L, true);
+				lua_setfield(L, -2, "compression_dict");
+			}
+
+			if (index_opts->blob_threshold > 0) {
+				lua_pushnumber(L, index_opts->blob_threshold);
+				lua_setfield(L, -2, "blob_threshold");
+			}
+
 			lua_settable(L, -3);
 		}
 		lua_setfield(L, -2, index_def->name);
@@ -42,6 +42,7 @@
 #include "box/iproto.h"
 #include "box/engine.h"
 #include "box/vinyl.h"
+#include "box/wal.h"
 #include "box/sql.h"
 #include "info/info.h"
 #include "lua/info.h"
@@ -67,6 +68,19 @@ inject_current_stat(struct lua_State *L, const char *name, size_t val)
 	lua_pop(L, 1);
 }
 
+/**
+ * Push a table of request queue time percentiles to a Lua stack.
+ */
+static void
+push_queue_time_stat(struct lua_State *L, struct iproto_stats *stats)
+{
+	lua_newtable(L);
+	lua_pushnumber(L, stats->queue_time_p50);
+	lua_setfield(L, -2, "p50");
+	lua_pushnumber(L, stats->queue_time_p99);
+	lua_setfield(L, -2, "p99");
+}
+
 static void
 inject_iproto_stats(struct lua_State *L, struct iproto_stats *stats)
 {
@@ -77,6 +91,8 @@ inject_iproto_stats(struct lua_State *L, struct iproto_stats *stats)
 			    stats->requests_in_progress);
 	inject_current_stat(L, "REQUESTS_IN_STREAM_QUEUE",
 			    stats->requests_in_stream_queue);
+	push_queue_time_stat(L, stats);
+	lua_setfield(L, -2, "QUEUE_TIME");
 }
 
 static void
@@ -153,6 +169,24 @@ lbox_stat_vinyl(struct lua_State *L)
 	return 1;
 }
 
+static int
+lbox_stat_wal(struct lua_State *L)
+{
+	struct info_handler h;
+	luaT_info_handler_create(&h, L);
+	wal_stat(&h);
+	return 1;
+}
+
+static int
+lbox_stat_busy_poll(struct lua_State *L)
+{
+	struct info_handler h;
+	luaT_info_handler_create(&h, L);
+	box_busy_poll_stat(&h);
+	return 1;
+}
+
 static int
 lbox_stat_reset(struct lua_State *L)
 {
@@ -174,10 +208,15 @@ static int
 lbox_stat_net_index(struct lua_State *L)
 {
 	const char *key = luaL_checkstring(L, -1);
+	struct iproto_stats stats;
+	if (strcmp(key, "QUEUE_TIME") == 0) {
+		iproto_stats_get(&stats);
+		push_queue_time_stat(L, &stats);
+		return 1;
+	}
 	if (iproto_rmean_foreach(seek_stat_item, L) == 0)
 		return 0;
 
-	struct iproto_stats stats;
 	iproto_stats_get(&stats);
 	if (strcmp(key, "CONNECTIONS") == 0) {
 		lua_pushstring(L, "current");
@@ -214,14 +253,18 @@ lbox_stat_net_index(struct lua_State *L)
  * - STREAMS: total, rps, current;
  * - REQUESTS: total, rps, current;
  * - REQUESTS_IN_PROGRESS: total, rps, current;
- * - REQUESTS_IN_STREAM_QUEUE: total, rps, current.
+ * - REQUESTS_IN_STREAM_QUEUE: total, rps, current;
+ * - REQUESTS_SHED: total, rps;
+ * - QUEUE_TIME: p50, p99.
  *
  * These fields have the following meaning:
  *
  * - total -- amount of events since start;
  * - rps -- amount of events per second, mean over last 5 seconds;
  * - current -- amount of resources currently hold (say, number of
- *   open connections).
+ *   open connections);
+ * - p50, p99 -- percentiles of the time requests wait before the tx
+ *   thread starts processing them, in seconds.
  */
 static int
 lbox_stat_net_call(struct lua_State *L)
@@ -303,6 +346,8 @@ box_lua_stat_init(struct lua_State *L)
 {
 	static const struct luaL_Reg statlib [] = {
 		{"vinyl", lbox_stat_vinyl},
+		{"wal", lbox_stat_wal},
+		{"busy_poll", lbox_stat_busy_poll},
 		{"reset", lbox_stat_reset},
 		{"sql", lbox_stat_sql},
 		{NULL, NULL}
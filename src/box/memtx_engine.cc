@@ -38,6 +38,7 @@
 #include "fiber.h"
 #include "errinj.h"
 #include "coio_file.h"
+#include "coio_task.h"
 #include "tuple.h"
 #include "txn.h"
 #include "memtx_tx.h"
@@ -999,6 +1000,55 @@ memtx_engine_backup(struct engine *engine, const struct vclock *vclock,
 	return cb(filename, cb_arg);
 }
 
+static ssize_t
+memtx_engine_copy_global_snapshot_f(va_list ap)
+{
+	const char *src = va_arg(ap, const char *);
+	const char *dst = va_arg(ap, const char *);
+
+	struct xlog_cursor cursor;
+	if (xlog_cursor_open(&cursor, src) != 0)
+		return -1;
+	struct xlog xlog;
+	if (xlog_create(&xlog, dst, 0, &cursor.meta, &xlog_opts_default) != 0) {
+		xlog_cursor_close(&cursor, false);
+		return -1;
+	}
+	int rc;
+	struct xrow_header row;
+	while ((rc = xlog_cursor_next(&cursor, &row, false)) == 0) {
+		if (row.group_id == GROUP_LOCAL)
+			continue;
+		/* Keep rows numbered without gaps, see checkpoint_write_row(). */
+		row.lsn = xlog.rows + xlog.tx_rows;
+		if (xlog_write_row(&xlog, &row) < 0) {
+			rc = -1;
+			break;
+		}
+		fiber_gc();
+	}
+	xlog_cursor_close(&cursor, false);
+	if (rc >= 0 && xlog_flush(&xlog) < 0)
+		rc = -1;
+	if (rc < 0 && unlink(xlog.filename) < 0)
+		say_syserror("failed to delete file '%s'", xlog.filename);
+	xlog_close(&xlog, false);
+	return rc < 0 ? -1 : 0;
+}
+
+int
+memtx_engine_copy_global_snapshot(struct memtx_engine *memtx,
+				  const struct vclock *vclock,
+				  const char *path)
+{
+	const char *filename = xdir_format_filename(&memtx->snap_dir,
+						    vclock_sum(vclock), NONE);
+	/* The name is stored in a static buffer, so copy it. */
+	char src[PATH_MAX];
+	strlcpy(src, filename, sizeof(src));
+	return coio_call(memtx_engine_copy_global_snapshot_f, src, path);
+}
+
 struct memtx_join_entry {
 	struct rlist in_ctx;
 	uint32_t space_id;
@@ -234,6 +234,18 @@ int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			      const struct vclock *vclock);
 
+/**
+ * Write a copy of the snapshot of the checkpoint with the given
+ * vclock to @a path, omitting rows of group-local spaces, which
+ * must not be sent to replicas. The file is created with the
+ * .inprogress suffix appended so that it is deleted on restart
+ * if left behind. The caller is supposed to delete it.
+ */
+int
+memtx_engine_copy_global_snapshot(struct memtx_engine *memtx,
+				  const struct vclock *vclock,
+				  const char *path);
+
 void
 memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit);
 
@@ -39,8 +39,10 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct tuple;
+struct obuf;
 
 extern const struct port_vtab port_c_vtab;
+extern const struct port_vtab port_lua_vtab;
 
 /** Port implementation used for storing raw data. */
 struct port_msgpack {
@@ -89,6 +91,24 @@ static_assert(sizeof(struct port_lua) <= sizeof(struct port),
 void
 port_lua_create(struct port *port, struct lua_State *L);
 
+/**
+ * Callback used to write a tuple to the output buffer instead of
+ * copying it, see port_lua_dump_with_tuples().
+ */
+typedef int
+(*port_dump_tuple_f)(struct tuple *tuple, void *arg);
+
+/**
+ * Dump a Lua port to the output buffer like port_dump_msgpack()
+ * or, if @a is_16 is set, like port_dump_msgpack_16(), but pass
+ * returned tuples to @a dump_tuple instead of copying them. Only
+ * tuples returned as is or in an array are passed, deeper nested
+ * ones are copied.
+ */
+int
+port_lua_dump_with_tuples(struct port *port, struct obuf *out, bool is_16,
+			  port_dump_tuple_f dump_tuple, void *arg);
+
 struct sql_value;
 
 /** Port implementation used with vdbe memory variables. */
@@ -41,6 +41,8 @@
 
 #include "coio.h"
 #include "coio_task.h"
+#include "coio_file.h"
+#include "crc32.h"
 #include "engine.h"
 #include "gc.h"
 #include "iostream.h"
@@ -54,10 +56,26 @@
 #include "xrow_io.h"
 #include "xstream.h"
 #include "wal.h"
+#include "wal_mem.h"
 #include "txn_limbo.h"
 #include "raft.h"
+#include "schema_def.h"
 
+#include <fcntl.h>
+#include <limits.h>
 #include <stdlib.h>
+#include <msgpuck.h>
+#include <sys/stat.h>
+
+enum {
+	/**
+	 * Max size of rows accumulated in the send batch
+	 * before writing them to the socket.
+	 */
+	RELAY_SEND_BATCH_SIZE = 256 * 1024,
+	/** Max number of iovecs in the send batch. */
+	RELAY_SEND_BATCH_IOVMAX = IOV_MAX,
+};
 
 /**
  * Cbus message to send status updates from relay to tx thread.
@@ -120,6 +138,42 @@ struct relay {
 	struct replica *replica;
 	/** WAL event watcher. */
 	struct wal_watcher wal_watcher;
+	/**
+	 * Set if the relay streams rows from the WAL memory
+	 * buffer rather than from xlog files.
+	 */
+	bool is_wal_mem;
+	/** Position of the next record to read from the buffer. */
+	uint64_t wal_mem_pos;
+	/** Records read from the WAL memory buffer. */
+	struct ibuf wal_mem_buf;
+	/**
+	 * Set if rows are accumulated in the send batch instead
+	 * of being written to the socket one by one. Only used
+	 * when rows are streamed from the WAL memory buffer,
+	 * because then row bodies stay valid until the batch
+	 * is flushed.
+	 */
+	bool is_send_batching;
+	/** Number of iovecs in the send batch. */
+	int send_iovcnt;
+	/** Size of data in the send batch. */
+	size_t send_size;
+	/** Encoded rows pending to be written to the socket. */
+	struct iovec send_iov[RELAY_SEND_BATCH_IOVMAX];
+	/**
+	 * Buffer accumulating encoded initial join rows, which are
+	 * written to the socket in chunks of RELAY_SEND_BATCH_SIZE
+	 * rather than one by one. Rows are copied, because their
+	 * bodies may be freed right after xstream_write(). The
+	 * buffer is malloc'ed, because rows may be sent from an
+	 * engine thread, see memtx_engine_join().
+	 */
+	char *join_buf;
+	/** Size of the initial join buffer. */
+	size_t join_buf_size;
+	/** Size of data stored in the initial join buffer. */
+	size_t join_buf_used;
 	/** Relay reader cond. */
 	struct fiber_cond reader_cond;
 	/** Relay diagnostics. */
@@ -135,6 +189,14 @@ struct relay {
 	 * is passed by the replica on subscribe.
 	 */
 	uint32_t id_filter;
+	/**
+	 * Sorted ids of user spaces whose rows should be relayed,
+	 * passed by the replica on subscribe. Rows of other user
+	 * spaces are sent as NOPs. System spaces aren't filtered.
+	 */
+	uint32_t *space_filter;
+	/** Number of ids in the space filter, 0 if it's not set. */
+	uint32_t space_filter_size;
 	/**
 	 * Local vclock at the moment of subscribe, used to check
 	 * dataset on the other side and send missing data rows if any.
@@ -237,8 +299,12 @@ relay_txn_lag(const struct relay *relay)
 static void
 relay_send(struct relay *relay, struct xrow_header *packet);
 static void
+relay_send_flush(struct relay *relay);
+static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row);
 static void
+relay_send_initial_join_flush(struct relay *relay);
+static void
 relay_send_row(struct xstream *stream, struct xrow_header *row);
 
 struct relay *
@@ -376,6 +442,9 @@ relay_stop(struct relay *relay)
 	 */
 	relay->txn_lag = 0;
 	relay->tx.txn_lag = 0;
+	free(relay->space_filter);
+	relay->space_filter = NULL;
+	relay->space_filter_size = 0;
 }
 
 void
@@ -385,6 +454,8 @@ relay_delete(struct relay *relay)
 		relay_stop(relay);
 	fiber_cond_destroy(&relay->reader_cond);
 	diag_destroy(&relay->diag);
+	free(relay->join_buf);
+	free(relay->space_filter);
 	TRASH(relay);
 	free(relay);
 }
@@ -475,6 +546,7 @@ relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
 
 	/* Send read view to the replica. */
 	engine_join_xc(&ctx, &relay->stream);
+	relay_send_initial_join_flush(relay);
 }
 
 int
@@ -533,6 +605,51 @@ relay_final_join(struct iostream *io, uint64_t sync,
 	});
 }
 
+void
+relay_send_file(struct iostream *io, uint64_t sync, const char *path,
+		const char *name)
+{
+	int fd = coio_file_open(path, O_RDONLY, 0);
+	if (fd < 0) {
+		diag_set(SystemError, "failed to open file '%s'", path);
+		diag_raise();
+	}
+	auto fd_guard = make_scoped_guard([=] { coio_file_close(fd); });
+	struct stat st;
+	if (coio_fstat(fd, &st) < 0) {
+		diag_set(SystemError, "failed to stat file '%s'", path);
+		diag_raise();
+	}
+	uint64_t size = st.st_size;
+
+	struct xrow_header row;
+	xrow_encode_file_xc(&row, name, size);
+	row.sync = sync;
+	coio_write_xrow(io, &row);
+
+	size_t buf_size = MIN(size, (uint64_t)RELAY_FILE_CHUNK_SIZE);
+	char *buf = (char *)xmalloc(MAX(buf_size, (size_t)1));
+	auto buf_guard = make_scoped_guard([=] { free(buf); });
+	uint32_t crc32 = 0;
+	for (uint64_t offset = 0; offset < size; offset += buf_size) {
+		buf_size = MIN(size - offset, (uint64_t)RELAY_FILE_CHUNK_SIZE);
+		if (coio_preadn(fd, buf, buf_size, offset) < 0) {
+			diag_set(SystemError, "failed to read file '%s'", path);
+			diag_raise();
+		}
+		crc32 = crc32_calc(crc32, buf, buf_size);
+		size_t region_svp = region_used(&fiber()->gc);
+		xrow_encode_file_data_xc(&row, buf, buf_size);
+		row.sync = sync;
+		coio_write_xrow(io, &row);
+		region_truncate(&fiber()->gc, region_svp);
+	}
+
+	xrow_encode_file_end_xc(&row, crc32);
+	row.sync = sync;
+	coio_write_xrow(io, &row);
+}
+
 /**
  * The message which updated tx thread with a new vclock has returned back
  * to the relay.
@@ -653,6 +770,112 @@ relay_set_error(struct relay *relay, struct error *e)
 		diag_set_error(&relay->diag, e);
 }
 
+/**
+ * Send rows stored in the WAL memory buffer since the last read.
+ * Returns false if the relay lags behind the buffer and has to
+ * read xlog files.
+ */
+static bool
+relay_send_wal_mem(struct relay *relay)
+{
+	struct ibuf *buf = &relay->wal_mem_buf;
+	ibuf_reset(buf);
+	int rc = wal_mem_read(wal_mem(), &relay->wal_mem_pos, buf);
+	if (rc > 0)
+		return false;
+	if (rc < 0)
+		diag_raise();
+	struct xstream *stream = &relay->stream;
+	/*
+	 * Row bodies point to the buffer, which stays intact until
+	 * we return, so the rows can be written to the socket in
+	 * batches without copying.
+	 */
+	relay->is_send_batching = true;
+	auto batch_guard = make_scoped_guard([=] {
+		relay->is_send_batching = false;
+		relay->send_iovcnt = 0;
+		relay->send_size = 0;
+	});
+	const char *pos = buf->rpos;
+	while (pos < buf->wpos) {
+		struct wal_mem_record record;
+		wal_mem_record_decode(&record, &pos);
+		const char *end = pos + record.size;
+		if (record.type == WAL_MEM_ROTATE) {
+			/*
+			 * Let the garbage collector know that the relay
+			 * is done with the previous xlog file as if it
+			 * was read till EOF.
+			 */
+			trigger_run_xc(&relay->r->on_close_log, NULL);
+			continue;
+		}
+		assert(record.type == WAL_MEM_ROW);
+		struct vclock *vclock = &relay->r->vclock;
+		if (record.lsn <= vclock_get(vclock, record.replica_id)) {
+			/* Already sent, skip. */
+			pos = end;
+			continue;
+		}
+		struct xrow_header row;
+		xrow_header_decode_xc(&row, &pos, end, true);
+		vclock_follow_xrow(vclock, &row);
+		if (xstream_write(stream, &row) != 0)
+			diag_raise();
+		if (++stream->row_count % WAL_ROWS_PER_YIELD == 0) {
+			relay_send_flush(relay);
+			xstream_yield(stream);
+		}
+	}
+	relay_send_flush(relay);
+	return true;
+}
+
+/**
+ * Send new rows written to the WAL. Rows are streamed from
+ * the WAL memory buffer if the relay has caught up with it,
+ * otherwise they are read from xlog files until the relay
+ * catches up.
+ */
+static void
+relay_send_wal(struct relay *relay, bool scan_dir)
+{
+	struct wal_mem *mem = wal_mem();
+	while (true) {
+		if (relay->is_wal_mem) {
+			if (relay_send_wal_mem(relay))
+				return;
+			/*
+			 * The relay fell behind the buffer. The recovery
+			 * cursor was closed when we switched to the buffer
+			 * so reopen it at the current vclock.
+			 */
+			relay->is_wal_mem = false;
+			struct recovery *r = recovery_new(wal_dir(), false,
+							  &relay->r->vclock);
+			rlist_swap(&relay->r->on_close_log, &r->on_close_log);
+			recovery_delete(relay->r);
+			relay->r = r;
+			scan_dir = true;
+		}
+		recover_remaining_wals(relay->r, &relay->stream, NULL,
+				       scan_dir);
+		if (mem == NULL || wal_mem_seek(mem, &relay->r->vclock,
+						&relay->wal_mem_pos) != 0)
+			return;
+		relay->is_wal_mem = true;
+		/*
+		 * Don't keep the current xlog file open while
+		 * streaming from the buffer. Rotation records in
+		 * the buffer run the on_close_log triggers, so
+		 * don't run them here.
+		 */
+		if (xlog_cursor_is_open(&relay->r->cursor))
+			xlog_cursor_close(&relay->r->cursor, false);
+	}
+}
+
 static void
 relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 {
@@ -670,8 +893,7 @@ relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 		return;
 	}
 	try {
-		recover_remaining_wals(relay->r, &relay->stream, NULL,
-				       (events & WAL_EVENT_ROTATE) != 0);
+		relay_send_wal(relay, (events & WAL_EVENT_ROTATE) != 0);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
 		fiber_cancel(fiber());
@@ -852,6 +1074,8 @@ relay_subscribe_f(va_list ap)
 		trigger_add(&relay->r->on_close_log, &on_close_log);
 
 	/* Setup WAL watcher for sending new rows to the replica. */
+	relay->is_wal_mem = false;
+	ibuf_create(&relay->wal_mem_buf, &cord()->slabc, 1024);
 	wal_set_watcher(&relay->wal_watcher, relay->endpoint.name,
 			relay_process_wal_event, cbus_process);
 
@@ -931,6 +1155,7 @@ relay_subscribe_f(va_list ap)
 	 */
 	trigger_clear(&on_close_log);
 	wal_clear_watcher(&relay->wal_watcher, cbus_process);
+	ibuf_destroy(&relay->wal_mem_buf);
 
 	/* Join ack reader fiber. */
 	fiber_cancel(reader);
@@ -955,11 +1180,74 @@ relay_subscribe_f(va_list ap)
 	return -1;
 }
 
+static int
+relay_space_id_cmp(const void *a, const void *b)
+{
+	uint32_t id_a = *(const uint32_t *)a;
+	uint32_t id_b = *(const uint32_t *)b;
+	return id_a < id_b ? -1 : id_a > id_b;
+}
+
+/** Set the space filter of a relay from a SUBSCRIBE request. */
+static void
+relay_set_space_filter(struct relay *relay, const uint32_t *space_filter,
+		       uint32_t space_filter_size)
+{
+	assert(relay->space_filter == NULL);
+	if (space_filter_size == 0)
+		return;
+	size_t size = space_filter_size * sizeof(*space_filter);
+	relay->space_filter = (uint32_t *)xmalloc(size);
+	memcpy(relay->space_filter, space_filter, size);
+	relay->space_filter_size = space_filter_size;
+	qsort(relay->space_filter, space_filter_size,
+	      sizeof(*space_filter), relay_space_id_cmp);
+}
+
+/**
+ * Check if a row modifies a user space that isn't in the space
+ * filter of a relay, i.e. must be sent to the replica as a NOP.
+ */
+static bool
+relay_space_is_filtered(struct relay *relay, struct xrow_header *packet)
+{
+	if (relay->space_filter_size == 0 || packet->bodycnt == 0 ||
+	    packet->type == IPROTO_NOP || !iproto_type_is_dml(packet->type))
+		return false;
+	const char *data = (const char *)packet->body[0].iov_base;
+	if (mp_typeof(*data) != MP_MAP)
+		return false;
+	uint32_t map_size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*data) != MP_UINT) {
+			mp_next(&data); /* key */
+			mp_next(&data); /* value */
+			continue;
+		}
+		if (mp_decode_uint(&data) != IPROTO_SPACE_ID) {
+			mp_next(&data); /* value */
+			continue;
+		}
+		if (mp_typeof(*data) != MP_UINT)
+			return false;
+		uint64_t space_id = mp_decode_uint(&data);
+		if (space_id > BOX_SYSTEM_ID_MIN &&
+		    space_id < BOX_SYSTEM_ID_MAX)
+			return false;
+		uint32_t id = space_id;
+		return bsearch(&id, relay->space_filter,
+			       relay->space_filter_size, sizeof(id),
+			       relay_space_id_cmp) == NULL;
+	}
+	return false;
+}
+
 /** Replication acceptor fiber handler. */
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		struct vclock *replica_clock, uint32_t replica_version_id,
-		uint32_t replica_id_filter)
+		uint32_t replica_id_filter, const uint32_t *space_filter,
+		uint32_t space_filter_size)
 {
 	assert(replica->anon || replica->id != REPLICA_ID_NIL);
 	struct relay *relay = replica->relay;
@@ -996,6 +1284,7 @@ relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 	relay->version_id = replica_version_id;
 
 	relay->id_filter = replica_id_filter;
+	relay_set_space_filter(relay, space_filter, space_filter_size);
 
 	int rc = cord_costart(&relay->cord, "subscribe",
 			      relay_subscribe_f, relay);
@@ -1005,13 +1294,41 @@ relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		diag_raise();
 }
 
+/** Write rows accumulated in the send batch to the socket. */
 static void
-relay_send(struct relay *relay, struct xrow_header *packet)
+relay_send_flush(struct relay *relay)
 {
+	if (relay->send_iovcnt == 0)
+		return;
 	ERROR_INJECT_YIELD(ERRINJ_RELAY_SEND_DELAY);
+	ssize_t rc = coio_writev(relay->io, relay->send_iov,
+				 relay->send_iovcnt, relay->send_size);
+	relay->send_iovcnt = 0;
+	relay->send_size = 0;
+	if (rc < 0)
+		diag_raise();
+	/* Free encoded row headers. */
+	fiber_gc();
+}
 
+static void
+relay_send(struct relay *relay, struct xrow_header *packet)
+{
 	packet->sync = relay->sync;
 	relay->last_row_time = ev_monotonic_now(loop());
+	if (relay->is_send_batching) {
+		if (relay->send_iovcnt + XROW_IOVMAX > RELAY_SEND_BATCH_IOVMAX)
+			relay_send_flush(relay);
+		struct iovec *iov = relay->send_iov + relay->send_iovcnt;
+		int iovcnt = xrow_to_iovec_xc(packet, iov);
+		relay->send_iovcnt += iovcnt;
+		for (int i = 0; i < iovcnt; i++)
+			relay->send_size += iov[i].iov_len;
+		if (relay->send_size >= RELAY_SEND_BATCH_SIZE)
+			relay_send_flush(relay);
+		return;
+	}
+	ERROR_INJECT_YIELD(ERRINJ_RELAY_SEND_DELAY);
 	coio_write_xrow(relay->io, packet);
 	fiber_gc();
 
@@ -1020,6 +1337,21 @@ relay_send(struct relay *relay, struct xrow_header *packet)
 		fiber_sleep(inj->dparam);
 }
 
+/** Write the rows accumulated in the initial join buffer to the socket. */
+static void
+relay_send_initial_join_flush(struct relay *relay)
+{
+	if (relay->join_buf_used == 0)
+		return;
+	ERROR_INJECT_YIELD(ERRINJ_RELAY_SEND_DELAY);
+	struct iovec iov;
+	iov.iov_base = relay->join_buf;
+	iov.iov_len = relay->join_buf_used;
+	relay->join_buf_used = 0;
+	if (coio_writev(relay->io, &iov, 1, iov.iov_len) < 0)
+		diag_raise();
+}
+
 static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row)
 {
@@ -1028,8 +1360,41 @@ relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row)
 	 * Ignore replica local requests as we don't need to promote
 	 * vclock while sending a snapshot.
 	 */
-	if (row->group_id != GROUP_LOCAL)
-		relay_send(relay, row);
+	if (row->group_id == GROUP_LOCAL)
+		return;
+	row->sync = relay->sync;
+	relay->last_row_time = ev_monotonic_now(loop());
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_to_iovec_xc(row, iov);
+	size_t size = 0;
+	for (int i = 0; i < iovcnt; i++)
+		size += iov[i].iov_len;
+	if (relay->join_buf_used + size > relay->join_buf_size) {
+		size_t new_size = MAX(relay->join_buf_size * 2,
+				      (size_t)RELAY_SEND_BATCH_SIZE);
+		while (new_size < relay->join_buf_used + size)
+			new_size *= 2;
+		char *buf = (char *)realloc(relay->join_buf, new_size);
+		if (buf == NULL)
+			tnt_raise(OutOfMemory, new_size, "realloc", "join_buf");
+		relay->join_buf = buf;
+		relay->join_buf_size = new_size;
+	}
+	for (int i = 0; i < iovcnt; i++) {
+		memcpy(relay->join_buf + relay->join_buf_used,
+		       iov[i].iov_base, iov[i].iov_len);
+		relay->join_buf_used += iov[i].iov_len;
+	}
+	/* Free the encoded row header. */
+	fiber_gc();
+	if (relay->join_buf_used >= RELAY_SEND_BATCH_SIZE)
+		relay_send_initial_join_flush(relay);
+
+	struct errinj *inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
+	if (inj != NULL && inj->dparam > 0) {
+		relay_send_initial_join_flush(relay);
+		fiber_sleep(inj->dparam);
+	}
 }
 
 /**
@@ -1066,7 +1431,8 @@ relay_restart_recovery(struct relay *relay)
 	rlist_swap(&relay->r->on_close_log, &r->on_close_log);
 	recovery_delete(relay->r);
 	relay->r = r;
-	recover_remaining_wals(relay->r, &relay->stream, NULL, true);
+	relay->is_wal_mem = false;
+	relay_send_wal(relay, true);
 }
 
 /**
@@ -1148,6 +1514,14 @@ relay_send_row(struct xstream *stream, struct xrow_header *packet)
 		packet->group_id = GROUP_DEFAULT;
 		packet->bodycnt = 0;
 	}
+	/*
+	 * Rows of the spaces the replica isn't interested in
+	 * are sent as NOPs for the same reason.
+	 */
+	if (relay_space_is_filtered(relay, packet)) {
+		packet->type = IPROTO_NOP;
+		packet->bodycnt = 0;
+	}
 	assert(iproto_type_is_dml(packet->type) ||
 	       iproto_type_is_synchro_request(packet->type));
 	/* Check if the rows from the instance are filtered. */
@@ -133,14 +133,38 @@ void
 relay_final_join(struct iostream *io, uint64_t sync,
 		 struct vclock *start_vclock, struct vclock *stop_vclock);
 
+enum {
+	/** Max size of a file chunk sent by relay_send_file(). */
+	RELAY_FILE_CHUNK_SIZE = 1024 * 1024,
+};
+
+/**
+ * Send a checkpoint file to the replica: IPROTO_FILE with
+ * the file name and size, IPROTO_FILE_DATA rows with the file
+ * contents, and IPROTO_FILE_END with the file checksum.
+ * The file is read from the tx thread with coio.
+ *
+ * @param io        client connection
+ * @param sync      sync from incoming FETCH_CHECKPOINT request
+ * @param path      path to the file
+ * @param name      file name to send to the replica
+ */
+void
+relay_send_file(struct iostream *io, uint64_t sync, const char *path,
+		const char *name);
+
 /**
  * Subscribe a replica to updates.
  *
+ * If @a space_filter_size is not 0, rows of user spaces whose
+ * ids are not in @a space_filter are sent as NOPs.
+ *
  * @return none.
  */
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		struct vclock *replica_vclock, uint32_t replica_version_id,
-		uint32_t replica_id_filter);
+		uint32_t replica_id_filter, const uint32_t *space_filter,
+		uint32_t space_filter_size);
 
 #endif /* TARANTOOL_REPLICATION_RELAY_H_INCLUDED */
@@ -55,8 +55,10 @@ int replication_synchro_quorum = 1;
 double replication_synchro_timeout = 5.0; /* seconds */
 double replication_sync_timeout = 300.0; /* seconds */
 bool replication_skip_conflict = false;
+bool replication_bootstrap_files = false;
 bool replication_anon = false;
 int replication_threads = 1;
+int replication_apply_parallelism = 1;
 
 struct replicaset replicaset;
 
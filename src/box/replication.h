@@ -100,6 +100,9 @@ static const int REPLICATION_CONNECT_QUORUM_ALL = INT_MAX;
 
 enum { REPLICATION_THREADS_MAX = 1000 };
 
+/** Max number of transactions an applier may apply concurrently. */
+enum { REPLICATION_APPLY_PARALLELISM_MAX = 1000 };
+
 /**
  * Network timeout. Determines how often master and slave exchange
  * heartbeat messages. Set by box.cfg.replication_timeout.
@@ -151,6 +154,13 @@ extern double replication_sync_timeout;
  */
 extern bool replication_skip_conflict;
 
+/**
+ * If set, a new replica bootstraps by downloading the files of
+ * the last checkpoint of the master instead of joining it row by
+ * row, see applier_fetch_checkpoint().
+ */
+extern bool replication_bootstrap_files;
+
 /**
  * Whether this replica will be anonymous or not, e.g. be preset
  * in _cluster table and have a non-zero id.
@@ -160,6 +170,12 @@ extern bool replication_anon;
 /** How many threads to use for decoding incoming replication stream. */
 extern int replication_threads;
 
+/**
+ * Max number of non-conflicting transactions received from
+ * a master that an applier may apply concurrently.
+ */
+extern int replication_apply_parallelism;
+
 /**
  * Wait for the given period of time before trying to reconnect
  * to a master.
@@ -38,8 +38,10 @@
 #include "error.h"
 #include "tt_static.h"
 #include "sql_stmt_cache.h"
+#include "box_stmt.h"
 #include "watcher.h"
 #include "on_shutdown.h"
+#include "gc.h"
 
 const char *session_type_strs[] = {
 	"background",
@@ -263,6 +265,9 @@ session_create(enum session_type type)
 	session->sql_flags = default_flags;
 	session->sql_default_engine = SQL_STORAGE_ENGINE_MEMTX;
 	session->sql_stmts = NULL;
+	session->box_stmts = NULL;
+	session->box_stmt_id_max = 0;
+	session->checkpoint_gc = NULL;
 	session->watchers = NULL;
 	rlist_create(&session->in_shutdown_list);
 
@@ -375,6 +380,9 @@ session_destroy(struct session *session)
 	mh_i64ptr_remove(session_registry, &node, NULL);
 	credentials_destroy(&session->credentials);
 	sql_session_stmt_hash_erase(session->sql_stmts);
+	box_stmt_hash_erase(session->box_stmts);
+	if (session->checkpoint_gc != NULL)
+		gc_consumer_unregister(session->checkpoint_gc);
 	mempool_free(&session_pool, session);
 }
 
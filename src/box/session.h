@@ -44,6 +44,7 @@ extern "C" {
 
 struct port;
 struct session_vtab;
+struct gc_consumer;
 
 void
 session_init(void);
@@ -124,6 +125,19 @@ struct session {
 	 * This map is allocated on demand.
 	 */
 	struct mh_i32ptr_t *sql_stmts;
+	/**
+	 * Box statements prepared in current session
+	 * (id -> struct box_stmt). Allocated on demand.
+	 */
+	struct mh_i32ptr_t *box_stmts;
+	/** Id of the last box statement prepared in the session. */
+	uint32_t box_stmt_id_max;
+	/**
+	 * Garbage collector consumer that pins the WAL written after
+	 * the checkpoint sent to the replica connected to the session
+	 * until it registers, see box_process_fetch_checkpoint().
+	 */
+	struct gc_consumer *checkpoint_gc;
 	/** Session user id and global grants */
 	struct credentials credentials;
 	/** Trigger for fiber on_stop to cleanup created on-demand session */
@@ -677,6 +677,19 @@ space_execute_dml(struct space *space, struct txn *txn,
 	}
 	if (unlikely((!rlist_empty(&space->before_replace) &&
 		      space->run_triggers) || need_foreign_key_check)) {
+		if (request->type == IPROTO_DELETE_RANGE) {
+			/*
+			 * A range delete doesn't look up the tuples
+			 * it deletes so there's nothing to pass to
+			 * the triggers or to check foreign keys for.
+			 */
+			diag_set(ClientError, ER_UNSUPPORTED,
+				 need_foreign_key_check ?
+				 "A space referenced by a foreign key" :
+				 "A space with before_replace triggers",
+				 "delete_range");
+			return -1;
+		}
 		/*
 		 * Call BEFORE triggers if any before dispatching
 		 * the request. Note, it may change the request
@@ -718,6 +731,12 @@ space_execute_dml(struct space *space, struct txn *txn,
 		if (space->vtab->execute_upsert(space, txn, request) != 0)
 			return -1;
 		break;
+	case IPROTO_DELETE_RANGE:
+		*result = NULL;
+		if (space->vtab->execute_delete_range(space, txn,
+						      request) != 0)
+			return -1;
+		break;
 	default:
 		*result = NULL;
 	}
@@ -800,6 +819,17 @@ generic_space_bsize(struct space *space)
 	return 0;
 }
 
+int
+generic_space_execute_delete_range(struct space *space, struct txn *txn,
+				   struct request *request)
+{
+	(void)txn;
+	(void)request;
+	diag_set(ClientError, ER_UNSUPPORTED, space->engine->name,
+		 "delete_range");
+	return -1;
+}
+
 int
 generic_space_ephemeral_replace(struct space *space, const char *tuple,
 				const char *tuple_end)
@@ -150,7 +150,8 @@ tuple_bloom_builder_add_key(struct tuple_bloom_builder *builder,
 }
 
 struct tuple_bloom *
-tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
+tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr,
+		enum bloom_type type)
 {
 	uint32_t part_count = builder->part_count;
 	size_t size = sizeof(struct tuple_bloom) +
@@ -162,6 +163,7 @@ tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
 	}
 
 	bloom->is_legacy = false;
+	bloom->type = type;
 	bloom->part_count = 0;
 
 	for (uint32_t i = 0; i < part_count; i++) {
@@ -179,7 +181,8 @@ tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
 		for (uint32_t j = 0; j < i; j++)
 			part_fpr /= bloom_fpr(&bloom->parts[j], count);
 		part_fpr = MIN(part_fpr, 0.5);
-		if (bloom_create(&bloom->parts[i], count, part_fpr) != 0) {
+		if (bloom_create(&bloom->parts[i], count,
+				 part_fpr, type) != 0) {
 			diag_set(OutOfMemory, 0, "bloom_create",
 				 "tuple bloom part");
 			tuple_bloom_delete(bloom);
@@ -257,6 +260,64 @@ tuple_bloom_maybe_has_key(const struct tuple_bloom *bloom,
 	return true;
 }
 
+void
+tuple_bloom_hash(struct tuple *tuple, struct key_def *key_def,
+		 int multikey_idx, uint32_t *hashes)
+{
+	assert(!key_def->is_multikey || multikey_idx != MULTIKEY_NONE);
+
+	uint32_t h = HASH_SEED;
+	uint32_t carry = 0;
+	uint32_t total_size = 0;
+
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		total_size += tuple_hash_key_part(&h, &carry, tuple,
+						  &key_def->parts[i],
+						  multikey_idx);
+		hashes[i] = PMurHash32_Result(h, carry, total_size);
+	}
+}
+
+void
+tuple_bloom_hash_key(const char *key, uint32_t part_count,
+		     struct key_def *key_def, uint32_t *hashes)
+{
+	assert(part_count <= key_def->part_count);
+
+	uint32_t h = HASH_SEED;
+	uint32_t carry = 0;
+	uint32_t total_size = 0;
+
+	for (uint32_t i = 0; i < part_count; i++) {
+		total_size += tuple_hash_field(&h, &carry, &key,
+					       key_def->parts[i].coll);
+		hashes[i] = PMurHash32_Result(h, carry, total_size);
+	}
+}
+
+void
+tuple_bloom_prefetch(const struct tuple_bloom *bloom,
+		     const uint32_t *hashes, uint32_t part_count)
+{
+	assert(!bloom->is_legacy);
+	assert(part_count <= bloom->part_count);
+	for (uint32_t i = 0; i < part_count; i++)
+		bloom_prefetch(&bloom->parts[i], hashes[i]);
+}
+
+bool
+tuple_bloom_maybe_has_hashes(const struct tuple_bloom *bloom,
+			     const uint32_t *hashes, uint32_t part_count)
+{
+	assert(!bloom->is_legacy);
+	assert(part_count <= bloom->part_count);
+	for (uint32_t i = 0; i < part_count; i++) {
+		if (!bloom_maybe_has(&bloom->parts[i], hashes[i]))
+			return false;
+	}
+	return true;
+}
+
 static size_t
 tuple_bloom_sizeof_part(const struct bloom *part)
 {
@@ -280,9 +341,11 @@ tuple_bloom_encode_part(const struct bloom *part, char *buf)
 }
 
 static int
-tuple_bloom_decode_part(struct bloom *part, const char **data)
+tuple_bloom_decode_part(struct bloom *part, enum bloom_type type,
+			const char **data)
 {
 	memset(part, 0, sizeof(*part));
+	part->type = type;
 	if (mp_decode_array(data) != 3)
 		unreachable();
 	part->table_size = mp_decode_uint(data);
@@ -318,7 +381,7 @@ tuple_bloom_encode(const struct tuple_bloom *bloom, char *buf)
 }
 
 struct tuple_bloom *
-tuple_bloom_decode(const char **data)
+tuple_bloom_decode(const char **data, enum bloom_type type)
 {
 	uint32_t part_count = mp_decode_array(data);
 	struct tuple_bloom *bloom = malloc(sizeof(*bloom) +
@@ -331,10 +394,12 @@ tuple_bloom_decode(const char **data)
 	}
 
 	bloom->is_legacy = false;
+	bloom->type = type;
 	bloom->part_count = 0;
 
 	for (uint32_t i = 0; i < part_count; i++) {
-		if (tuple_bloom_decode_part(&bloom->parts[i], data) != 0) {
+		if (tuple_bloom_decode_part(&bloom->parts[i], type,
+					    data) != 0) {
 			tuple_bloom_delete(bloom);
 			return NULL;
 		}
@@ -355,6 +420,7 @@ tuple_bloom_decode_legacy(const char **data)
 	}
 
 	bloom->is_legacy = true;
+	bloom->type = BLOOM_CLASSIC;
 	bloom->part_count = 1;
 
 	if (mp_decode_array(data) != 4)
@@ -362,6 +428,7 @@ tuple_bloom_decode_legacy(const char **data)
 	if (mp_decode_uint(data) != 0) /* version */
 		unreachable();
 
+	bloom->parts[0].type = BLOOM_CLASSIC;
 	bloom->parts[0].table_size = mp_decode_uint(data);
 	bloom->parts[0].hash_count = mp_decode_uint(data);
 
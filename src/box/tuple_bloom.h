@@ -58,6 +58,8 @@ struct tuple_bloom {
 	 * (see tuple_bloom_decode_legacy).
 	 */
 	bool is_legacy;
+	/** Type of the bloom filters. */
+	enum bloom_type type;
 	/** Number of key parts. */
 	uint32_t part_count;
 	/** Array of bloom filters, one per each partial key. */
@@ -154,10 +156,12 @@ tuple_bloom_builder_add_key(struct tuple_bloom_builder *builder,
  * Create a new tuple bloom filter.
  * @param builder - bloom filter builder
  * @param fpr - desired false positive rate
+ * @param type - type of the bloom filters
  * @return bloom filter on success or NULL on OOM
  */
 struct tuple_bloom *
-tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr);
+tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr,
+		enum bloom_type type);
 
 /**
  * Delete a tuple bloom filter.
@@ -193,6 +197,56 @@ tuple_bloom_maybe_has_key(const struct tuple_bloom *bloom,
 			  const char *key, uint32_t part_count,
 			  struct key_def *key_def);
 
+/**
+ * Calculate hashes of all partial keys of a tuple, e.g. for
+ * tuple (1, 2, 3) hashes of (1), (1, 2), and (1, 2, 3).
+ * Used for checking the same tuple against many bloom filters,
+ * see tuple_bloom_maybe_has_hashes().
+ * @param tuple - tuple to hash
+ * @param key_def - key definition
+ * @param multikey_idx - multikey index hint
+ * @param[out] hashes - array of key_def->part_count hashes
+ */
+void
+tuple_bloom_hash(struct tuple *tuple, struct key_def *key_def,
+		 int multikey_idx, uint32_t *hashes);
+
+/**
+ * Calculate hashes of all partial keys of a key.
+ * See tuple_bloom_hash() for more details.
+ * @param key - key to hash
+ * @param part_count - number of parts in the key
+ * @param key_def - key definition
+ * @param[out] hashes - array of part_count hashes
+ */
+void
+tuple_bloom_hash_key(const char *key, uint32_t part_count,
+		     struct key_def *key_def, uint32_t *hashes);
+
+/**
+ * Prefetch the parts of a tuple bloom filter that are going to
+ * be accessed by tuple_bloom_maybe_has_hashes().
+ * @param bloom - bloom filter, must not be legacy
+ * @param hashes - hashes of partial keys
+ * @param part_count - number of hashes
+ */
+void
+tuple_bloom_prefetch(const struct tuple_bloom *bloom,
+		     const uint32_t *hashes, uint32_t part_count);
+
+/**
+ * Check if a tuple or key with the given partial key hashes
+ * was stored in a tuple bloom filter.
+ * @param bloom - bloom filter, must not be legacy
+ * @param hashes - hashes of partial keys, see tuple_bloom_hash()
+ * @param part_count - number of hashes
+ * @return true if the tuple may have been stored in the bloom,
+ *  false if the tuple is definitely not in the bloom
+ */
+bool
+tuple_bloom_maybe_has_hashes(const struct tuple_bloom *bloom,
+			     const uint32_t *hashes, uint32_t part_count);
+
 /**
  * Return the size of a tuple bloom filter when encoded.
  * @param bloom - bloom filter
@@ -214,10 +268,12 @@ tuple_bloom_encode(const struct tuple_bloom *bloom, char *buf);
  * Decode a tuple bloom filter from MsgPack.
  * @param data - pointer to buffer storing encoded bloom filter;
  *  on success it is advanced by the number of decoded bytes
+ * @param type - type of the bloom filters, it isn't encoded
+ *  and must be stored separately
  * @return the decoded bloom on success or NULL on OOM
  */
 struct tuple_bloom *
-tuple_bloom_decode(const char **data);
+tuple_bloom_decode(const char **data, enum bloom_type type);
 
 /**
  * Decode a legacy bloom filter from MsgPack.
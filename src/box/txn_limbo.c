@@ -49,8 +49,13 @@ txn_limbo_create(struct txn_limbo *limbo)
 	limbo->promote_greatest_term = 0;
 	latch_create(&limbo->promote_latch);
 	limbo->confirmed_lsn = 0;
+	limbo->pending_confirm_lsn = 0;
+	limbo->confirm_fiber = NULL;
+	fiber_cond_create(&limbo->confirm_cond);
 	limbo->rollback_count = 0;
 	limbo->is_in_rollback = false;
+	if (latency_create(&limbo->latency) != 0)
+		panic("failed to allocate limbo latency histogram");
 }
 
 bool
@@ -120,6 +125,7 @@ txn_limbo_append(struct txn_limbo *limbo, uint32_t id, struct txn *txn)
 	e->txn = txn;
 	e->lsn = -1;
 	e->ack_count = 0;
+	e->insertion_time = fiber_clock();
 	e->is_commit = false;
 	e->is_rollback = false;
 	rlist_add_tail_entry(&limbo->queue, e, in_queue);
@@ -364,8 +370,11 @@ fail:
 }
 
 /**
- * Write a confirmation entry to WAL. After it's written all the
- * transactions waiting for confirmation may be finished.
+ * Schedule writing of a confirmation entry to WAL. After it's
+ * written all the transactions waiting for confirmation may be
+ * finished. The entry is written by the confirm fiber, which
+ * coalesces confirmations collected while it's busy writing the
+ * previous one.
  */
 static void
 txn_limbo_write_confirm(struct txn_limbo *limbo, int64_t lsn)
@@ -373,7 +382,28 @@ txn_limbo_write_confirm(struct txn_limbo *limbo, int64_t lsn)
 	assert(lsn > limbo->confirmed_lsn);
 	assert(!limbo->is_in_rollback);
 	limbo->confirmed_lsn = lsn;
-	txn_limbo_write_synchro(limbo, IPROTO_RAFT_CONFIRM, lsn, 0);
+	limbo->pending_confirm_lsn = lsn;
+	fiber_cond_signal(&limbo->confirm_cond);
+}
+
+static void
+txn_limbo_read_confirm(struct txn_limbo *limbo, int64_t lsn);
+
+static int
+txn_limbo_confirm_f(va_list ap)
+{
+	struct txn_limbo *limbo = va_arg(ap, struct txn_limbo *);
+	while (!fiber_is_cancelled()) {
+		int64_t lsn = limbo->pending_confirm_lsn;
+		if (lsn == 0) {
+			fiber_cond_wait(&limbo->confirm_cond);
+			continue;
+		}
+		limbo->pending_confirm_lsn = 0;
+		txn_limbo_write_synchro(limbo, IPROTO_RAFT_CONFIRM, lsn, 0);
+		txn_limbo_read_confirm(limbo, lsn);
+	}
+	return 0;
 }
 
 /** Confirm all the entries <= @a lsn. */
@@ -429,6 +459,8 @@ txn_limbo_read_confirm(struct txn_limbo *limbo, int64_t lsn)
 			continue;
 		}
 		e->is_commit = true;
+		latency_collect(&limbo->latency,
+				fiber_clock() - e->insertion_time);
 		txn_limbo_remove(limbo, e);
 		txn_clear_flags(e->txn, TXN_WAIT_SYNC | TXN_WAIT_ACK);
 		/*
@@ -491,6 +523,8 @@ void
 txn_limbo_write_promote(struct txn_limbo *limbo, int64_t lsn, uint64_t term)
 {
 	limbo->confirmed_lsn = lsn;
+	/* PROMOTE confirms everything a pending CONFIRM would. */
+	limbo->pending_confirm_lsn = 0;
 	limbo->is_in_rollback = true;
 	/*
 	 * We make sure that promote is only written once everything this
@@ -517,12 +551,14 @@ txn_limbo_read_promote(struct txn_limbo *limbo, uint32_t replica_id,
 	limbo->owner_id = replica_id;
 	box_update_ro_summary();
 	limbo->confirmed_lsn = 0;
+	limbo->pending_confirm_lsn = 0;
 }
 
 void
 txn_limbo_write_demote(struct txn_limbo *limbo, int64_t lsn, uint64_t term)
 {
 	limbo->confirmed_lsn = lsn;
+	limbo->pending_confirm_lsn = 0;
 	limbo->is_in_rollback = true;
 	struct txn_limbo_entry *e = txn_limbo_last_synchro_entry(limbo);
 	assert(e == NULL || e->lsn <= lsn);
@@ -596,7 +632,6 @@ txn_limbo_ack(struct txn_limbo *limbo, uint32_t replica_id, int64_t lsn)
 	if (confirm_lsn == -1 || confirm_lsn <= limbo->confirmed_lsn)
 		return;
 	txn_limbo_write_confirm(limbo, confirm_lsn);
-	txn_limbo_read_confirm(limbo, confirm_lsn);
 }
 
 /**
@@ -816,10 +851,8 @@ txn_limbo_on_parameters_change(struct txn_limbo *limbo)
 			assert(confirm_lsn > 0);
 		}
 	}
-	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback) {
+	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback)
 		txn_limbo_write_confirm(limbo, confirm_lsn);
-		txn_limbo_read_confirm(limbo, confirm_lsn);
-	}
 	/*
 	 * Wakeup all the others - timed out will rollback. Also
 	 * there can be non-transactional waiters, such as CONFIRM
@@ -834,4 +867,9 @@ void
 txn_limbo_init(void)
 {
 	txn_limbo_create(&txn_limbo);
+	txn_limbo.confirm_fiber = fiber_new("txn_limbo_confirm",
+					    txn_limbo_confirm_f);
+	if (txn_limbo.confirm_fiber == NULL)
+		panic("failed to start the limbo confirm fiber");
+	fiber_start(txn_limbo.confirm_fiber, &txn_limbo);
 }
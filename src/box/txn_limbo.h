@@ -32,6 +32,7 @@
 #include "small/rlist.h"
 #include "vclock/vclock.h"
 #include "latch.h"
+#include "latency.h"
 
 #include <stdint.h>
 
@@ -39,6 +40,7 @@
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+struct fiber;
 struct txn;
 struct synchro_request;
 
@@ -61,6 +63,8 @@ struct txn_limbo_entry {
 	 * confirmed receipt of the transaction.
 	 */
 	int ack_count;
+	/** Time when the entry was added to the limbo, see fiber_clock(). */
+	double insertion_time;
 	/**
 	 * Result flags. Only one of them can be true. But both
 	 * can be false if the transaction is still waiting for
@@ -160,6 +164,29 @@ struct txn_limbo {
 	 * illegal.
 	 */
 	int64_t confirmed_lsn;
+	/**
+	 * LSN gathered quorum, whose CONFIRM hasn't been started to be
+	 * written to WAL yet, or 0. Acks are only collected here, and the
+	 * CONFIRM is written by the confirm fiber. Quorums reached while
+	 * the fiber is writing a CONFIRM are coalesced into one CONFIRM
+	 * for the biggest LSN written right after the current one, so
+	 * there is at most one CONFIRM in progress regardless of the
+	 * number of synchronous transactions and acks.
+	 */
+	int64_t pending_confirm_lsn;
+	/** Fiber writing CONFIRM requests, see pending_confirm_lsn. */
+	struct fiber *confirm_fiber;
+	/**
+	 * Condition the confirm fiber waits on for new quorums. The fiber
+	 * must not be woken up directly, because it may be waiting for a
+	 * WAL write to complete.
+	 */
+	struct fiber_cond confirm_cond;
+	/**
+	 * Time synchronous transactions spend in the limbo before they
+	 * are confirmed.
+	 */
+	struct latency latency;
 	/**
 	 * Total number of performed rollbacks. It used as a guard
 	 * to do some actions assuming all limbo transactions will
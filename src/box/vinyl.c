@@ -456,6 +456,12 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	info_append_int(h, "dumps_per_compaction",
 			vy_lsm_dumps_per_compaction(lsm));
 
+	info_table_begin(h, "amplification");
+	info_append_double(h, "read", vy_lsm_read_amplification(lsm));
+	info_append_double(h, "write", vy_lsm_write_amplification(lsm));
+	info_append_double(h, "space", vy_lsm_space_amplification(lsm));
+	info_table_end(h); /* amplification */
+
 	info_end(h);
 }
 
@@ -1792,6 +1798,54 @@ vy_delete(struct vy_env *env, struct vy_tx *tx, struct txn_stmt *stmt,
 	return rc;
 }
 
+/**
+ * Execute DELETE_RANGE in a vinyl space.
+ * @param env     Vinyl environment.
+ * @param tx      Current transaction.
+ * @param space   Vinyl space.
+ * @param request Request with the range boundaries.
+ *
+ * @retval  0 Success
+ * @retval -1 Memory error OR the index is not found OR invalid key.
+ */
+static int
+vy_delete_range(struct vy_env *env, struct vy_tx *tx, struct space *space,
+		struct request *request)
+{
+	if (request->index_id != 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Secondary index",
+			 "delete_range");
+		return -1;
+	}
+	struct vy_lsm *pk = vy_lsm_find(space, 0);
+	if (pk == NULL)
+		return -1;
+	if (vy_is_committed(env, pk))
+		return 0;
+	const char *key = request->key;
+	uint32_t part_count = mp_decode_array(&key);
+	if (key_validate(pk->base.def, ITER_GE, key, part_count) != 0)
+		return -1;
+	key = request->end_key;
+	part_count = mp_decode_array(&key);
+	if (key_validate(pk->base.def, ITER_LT, key, part_count) != 0)
+		return -1;
+	struct tuple *stmt = vy_stmt_new_delete_range(pk->env->key_format,
+						      request->key,
+						      request->key_end,
+						      request->end_key,
+						      request->end_key_end);
+	if (stmt == NULL)
+		return -1;
+	/*
+	 * Tuples deleted by the range tombstone are deleted from
+	 * secondary indexes on compaction, see vy_write_iterator.
+	 */
+	int rc = vy_tx_delete_range(tx, pk, stmt, space->index_count > 1);
+	tuple_unref(stmt);
+	return rc;
+}
+
 /**
  * We do not allow changes of the primary key during update.
  *
@@ -2408,6 +2462,15 @@ vinyl_space_execute_upsert(struct space *space, struct txn *txn,
 	return vy_upsert(env, tx, stmt, space, request);
 }
 
+static int
+vinyl_space_execute_delete_range(struct space *space, struct txn *txn,
+				 struct request *request)
+{
+	struct vy_env *env = vy_env(space->engine);
+	struct vy_tx *tx = txn->engine_tx;
+	return vy_delete_range(env, tx, space, request);
+}
+
 static int
 vinyl_engine_begin(struct engine *engine, struct txn *txn)
 {
@@ -3092,6 +3155,22 @@ vy_gc_run(struct vy_env *env,
 				lsm_info->index_id, run_info->id) != 0)
 		return;
 
+	/*
+	 * A value log file shares the id with the run it was
+	 * written for. If the file wasn't logged, the task that
+	 * wrote it failed, so delete it along with the run.
+	 */
+	struct vy_blob_recovery_info *blob_info;
+	bool blob_logged = false;
+	rlist_foreach_entry(blob_info, &lsm_info->blobs, in_lsm) {
+		if (blob_info->id == run_info->id)
+			blob_logged = true;
+	}
+	if (!blob_logged &&
+	    vy_blob_remove_file(env->path, lsm_info->space_id,
+				lsm_info->index_id, run_info->id) != 0)
+		return;
+
 	/* Forget the run on success. */
 	vy_log_tx_begin();
 	vy_log_forget_run(run_info->id);
@@ -3104,6 +3183,23 @@ vy_gc_run(struct vy_env *env,
 	vy_log_tx_try_commit();
 }
 
+/**
+ * Given a record encoding information about a value log file,
+ * try to delete the file and forget it on success.
+ */
+static void
+vy_gc_blob(struct vy_env *env,
+	   struct vy_lsm_recovery_info *lsm_info,
+	   struct vy_blob_recovery_info *blob_info)
+{
+	if (vy_blob_remove_file(env->path, lsm_info->space_id,
+				lsm_info->index_id, blob_info->id) != 0)
+		return;
+	vy_log_tx_begin();
+	vy_log_forget_blob(blob_info->id);
+	vy_log_tx_try_commit();
+}
+
 /**
  * Given a dropped or not fully built LSM tree, delete all its
  * ranges and slices and mark all its runs as dropped. Forget
@@ -3137,8 +3233,17 @@ vy_gc_lsm(struct vy_lsm_recovery_info *lsm_info)
 			vy_log_drop_run(run_info->id, run_info->gc_lsn);
 		}
 	}
+	struct vy_blob_recovery_info *blob_info;
+	rlist_foreach_entry(blob_info, &lsm_info->blobs, in_lsm) {
+		if (!blob_info->is_dropped) {
+			blob_info->is_dropped = true;
+			blob_info->gc_lsn = lsm_info->drop_lsn;
+			vy_log_drop_blob(blob_info->id, blob_info->gc_lsn);
+		}
+	}
 	if (rlist_empty(&lsm_info->ranges) &&
-	    rlist_empty(&lsm_info->runs))
+	    rlist_empty(&lsm_info->runs) &&
+	    rlist_empty(&lsm_info->blobs))
 		vy_log_forget_lsm(lsm_info->id);
 	vy_log_tx_try_commit();
 }
@@ -3175,6 +3280,19 @@ vy_gc(struct vy_env *env, struct vy_recovery *recovery,
 			if (loops % VY_YIELD_LOOPS == 0)
 				fiber_sleep(0);
 		}
+
+		struct vy_blob_recovery_info *blob_info;
+		rlist_foreach_entry(blob_info, &lsm_info->blobs, in_lsm) {
+			if ((blob_info->is_dropped &&
+			     blob_info->gc_lsn < gc_lsn &&
+			     (gc_mask & VY_GC_DROPPED) != 0) ||
+			    (lsm_info->create_lsn < 0 &&
+			     (gc_mask & VY_GC_INCOMPLETE) != 0)) {
+				vy_gc_blob(env, lsm_info, blob_info);
+			}
+			if (loops % VY_YIELD_LOOPS == 0)
+				fiber_sleep(0);
+		}
 	}
 }
 
@@ -3201,8 +3319,8 @@ vinyl_engine_collect_garbage(struct engine *engine, const struct vclock *vclock)
 /* {{{ Backup */
 
 static int
-vinyl_engine_backup(struct engine *engine, const struct vclock *vclock,
-		    engine_backup_cb cb, void *cb_arg)
+vinyl_engine_backup_impl(struct engine *engine, const struct vclock *vclock,
+			 bool skip_local, engine_backup_cb cb, void *cb_arg)
 {
 	struct vy_env *env = vy_env(engine);
 
@@ -3229,6 +3347,8 @@ vinyl_engine_backup(struct engine *engine, const struct vclock *vclock,
 			/* Dropped or not yet built LSM tree. */
 			continue;
 		}
+		if (skip_local && lsm_info->group_id == GROUP_LOCAL)
+			continue;
 		struct vy_run_recovery_info *run_info;
 		rlist_foreach_entry(run_info, &lsm_info->runs, in_lsm) {
 			if (run_info->is_dropped || run_info->is_incomplete)
@@ -3250,12 +3370,49 @@ vinyl_engine_backup(struct engine *engine, const struct vclock *vclock,
 			if (loops % VY_YIELD_LOOPS == 0)
 				fiber_sleep(0);
 		}
+		struct vy_blob_recovery_info *blob_info;
+		rlist_foreach_entry(blob_info, &lsm_info->blobs, in_lsm) {
+			if (blob_info->is_dropped)
+				continue;
+			char path[PATH_MAX];
+			vy_blob_snprint_path(path, sizeof(path), env->path,
+					     lsm_info->space_id,
+					     lsm_info->index_id,
+					     blob_info->id);
+			rc = cb(path, cb_arg);
+			if (rc != 0)
+				goto out;
+			if (loops % VY_YIELD_LOOPS == 0)
+				fiber_sleep(0);
+		}
 	}
 out:
 	vy_recovery_delete(recovery);
 	return rc;
 }
 
+static int
+vinyl_engine_backup(struct engine *engine, const struct vclock *vclock,
+		    engine_backup_cb cb, void *cb_arg)
+{
+	return vinyl_engine_backup_impl(engine, vclock, false, cb, cb_arg);
+}
+
+int
+vinyl_engine_backup_global(struct engine *engine, const struct vclock *vclock,
+			   engine_backup_cb cb, void *cb_arg)
+{
+	return vinyl_engine_backup_impl(engine, vclock, true, cb, cb_arg);
+}
+
+int
+vinyl_engine_write_global_vylog(struct engine *engine,
+				const struct vclock *vclock, const char *path)
+{
+	(void)engine;
+	return vy_log_backup_global(vclock, path);
+}
+
 /* }}} Backup */
 
 /**
@@ -4577,6 +4734,7 @@ static const struct space_vtab vinyl_space_vtab = {
 	/* .execute_delete = */ vinyl_space_execute_delete,
 	/* .execute_update = */ vinyl_space_execute_update,
 	/* .execute_upsert = */ vinyl_space_execute_upsert,
+	/* .execute_delete_range = */ vinyl_space_execute_delete_range,
 	/* .ephemeral_replace = */ generic_space_ephemeral_replace,
 	/* .ephemeral_delete = */ generic_space_ephemeral_delete,
 	/* .ephemeral_rowid_next = */ generic_space_ephemeral_rowid_next,
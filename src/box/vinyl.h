@@ -34,6 +34,8 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "engine.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* defined(__cplusplus) */
@@ -88,6 +90,25 @@ vinyl_engine_set_too_long_threshold(struct engine *engine,
 void
 vinyl_engine_set_snap_io_rate_limit(struct engine *engine, double limit);
 
+/**
+ * Like engine_backup(), but skip run and blob files of group-local
+ * spaces, which must not be sent to replicas. The metadata log is
+ * reported as is: use vinyl_engine_write_global_vylog() to get its
+ * copy without the local LSM trees.
+ */
+int
+vinyl_engine_backup_global(struct engine *engine, const struct vclock *vclock,
+			   engine_backup_cb cb, void *cb_arg);
+
+/**
+ * Write the metadata log of the checkpoint with the given vclock
+ * omitting group-local LSM trees to @a path, see
+ * vy_log_backup_global().
+ */
+int
+vinyl_engine_write_global_vylog(struct engine *engine,
+				const struct vclock *vclock, const char *path);
+
 #ifdef __cplusplus
 } /* extern "C" */
 
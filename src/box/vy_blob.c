@@ -0,0 +1,443 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "vy_blob.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "coio_file.h"
+#include "diag.h"
+#include "errcode.h"
+#include "fio.h"
+#include "iproto_constants.h"
+#include "msgpuck.h"
+#include "replication.h"
+#include "say.h"
+#include "trivia/util.h"
+#include "tuple_format.h"
+#include "vy_stmt.h"
+#include "xrow.h"
+
+/** xlog meta type for .blob files */
+#define XLOG_META_TYPE_BLOB "BLOB"
+
+/* sync value log files every 16 MB */
+#define VY_BLOB_SYNC_INTERVAL (1 << 24)
+
+size_t
+vy_blob_ref_sizeof(const struct vy_blob_ref *ref)
+{
+	return mp_sizeof_array(4) + mp_sizeof_uint(ref->blob_id) +
+	       mp_sizeof_uint(ref->offset) + mp_sizeof_uint(ref->size) +
+	       mp_sizeof_uint(ref->unpacked_size);
+}
+
+char *
+vy_blob_ref_encode(const struct vy_blob_ref *ref, char *data)
+{
+	data = mp_encode_array(data, 4);
+	data = mp_encode_uint(data, ref->blob_id);
+	data = mp_encode_uint(data, ref->offset);
+	data = mp_encode_uint(data, ref->size);
+	data = mp_encode_uint(data, ref->unpacked_size);
+	return data;
+}
+
+int
+vy_blob_ref_decode(const char **data, struct vy_blob_ref *ref)
+{
+	if (mp_typeof(**data) != MP_ARRAY || mp_decode_array(data) != 4)
+		goto error;
+	uint64_t fields[4];
+	for (int i = 0; i < 4; i++) {
+		if (mp_typeof(**data) != MP_UINT)
+			goto error;
+		fields[i] = mp_decode_uint(data);
+	}
+	if (fields[2] > UINT32_MAX || fields[3] > UINT32_MAX)
+		goto error;
+	ref->blob_id = fields[0];
+	ref->offset = fields[1];
+	ref->size = fields[2];
+	ref->unpacked_size = fields[3];
+	return 0;
+error:
+	diag_set(ClientError, ER_INVALID_RUN_FILE,
+		 "Can't decode value log reference");
+	return -1;
+}
+
+static struct vy_blob *
+vy_blob_new(int64_t id, int fd, uint64_t size)
+{
+	struct vy_blob *blob = malloc(sizeof(*blob));
+	if (blob == NULL) {
+		diag_set(OutOfMemory, sizeof(*blob), "malloc",
+			 "struct vy_blob");
+		return NULL;
+	}
+	blob->id = id;
+	blob->fd = fd;
+	blob->size = size;
+	blob->live_size = 0;
+	blob->needs_gc = false;
+	blob->refs = 1;
+	rlist_create(&blob->in_lsm);
+	return blob;
+}
+
+struct vy_blob *
+vy_blob_open(const char *dir, uint32_t space_id, uint32_t iid,
+	     int64_t blob_id)
+{
+	char path[PATH_MAX];
+	vy_blob_snprint_path(path, sizeof(path), dir, space_id, iid, blob_id);
+
+	struct xlog_cursor cursor;
+	if (xlog_cursor_open(&cursor, path) != 0)
+		goto fail;
+	struct xlog_meta *meta = &cursor.meta;
+	if (strcmp(meta->filetype, XLOG_META_TYPE_BLOB) != 0) {
+		diag_set(ClientError, ER_INVALID_XLOG_TYPE,
+			 XLOG_META_TYPE_BLOB, meta->filetype);
+		xlog_cursor_close(&cursor, false);
+		goto fail;
+	}
+	int fd = cursor.fd;
+	xlog_cursor_close(&cursor, true);
+
+	struct stat st;
+	if (fstat(fd, &st) < 0) {
+		diag_set(SystemError, "failed to stat file '%s'", path);
+		close(fd);
+		goto fail;
+	}
+	struct vy_blob *blob = vy_blob_new(blob_id, fd, st.st_size);
+	if (blob == NULL) {
+		close(fd);
+		goto fail;
+	}
+	return blob;
+fail:
+	diag_log();
+	say_error("failed to load `%s'", path);
+	return NULL;
+}
+
+void
+vy_blob_delete(struct vy_blob *blob)
+{
+	assert(blob->refs == 0);
+	if (blob->fd >= 0 && close(blob->fd) < 0)
+		say_syserror("close failed");
+	TRASH(blob);
+	free(blob);
+}
+
+int
+vy_blob_read(struct vy_blob *blob, const struct vy_blob_ref *ref,
+	     ZSTD_DStream *zdctx, char **buf,
+	     const char **data, const char **data_end)
+{
+	/*
+	 * Allocate a single buffer for the raw tx block and
+	 * the decoded rows.
+	 */
+	size_t size = (size_t)ref->size + ref->unpacked_size;
+	char *raw = malloc(size);
+	if (raw == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "blob");
+		return -1;
+	}
+	char *rows = raw + ref->size;
+	char *rows_end = rows + ref->unpacked_size;
+	ssize_t readen = fio_pread(blob->fd, raw, ref->size, ref->offset);
+	if (readen < 0) {
+		diag_set(SystemError, "failed to read from file");
+		goto error;
+	}
+	if (readen != (ssize_t)ref->size) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 "Unexpected end of file");
+		goto error;
+	}
+	if (xlog_tx_decode(raw, raw + ref->size, rows, rows_end,
+			   zdctx, NULL) != 0)
+		goto error;
+
+	struct xrow_header xrow;
+	const char *pos = rows;
+	if (xrow_header_decode(&xrow, &pos, rows_end, true) != 0)
+		goto error;
+	if (xrow.type != VY_BLOB_DATA || xrow.bodycnt != 1) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Wrong blob type (expected %d, got %u)",
+				    VY_BLOB_DATA, (unsigned)xrow.type));
+		goto error;
+	}
+	pos = xrow.body->iov_base;
+	*data = NULL;
+	if (mp_typeof(*pos) != MP_MAP)
+		goto error_decode;
+	uint32_t map_size = mp_decode_map(&pos);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*pos) != MP_UINT)
+			goto error_decode;
+		uint64_t key = mp_decode_uint(&pos);
+		switch (key) {
+		case VY_BLOB_DATA_TUPLE:
+			if (mp_typeof(*pos) != MP_ARRAY)
+				goto error_decode;
+			*data = pos;
+			mp_next(&pos);
+			*data_end = pos;
+			break;
+		default:
+			mp_next(&pos); /* unknown key, ignore */
+			break;
+		}
+	}
+	if (*data == NULL)
+		goto error_decode;
+	*buf = raw;
+	return 0;
+error_decode:
+	diag_set(ClientError, ER_INVALID_RUN_FILE, "Can't decode blob");
+error:
+	free(raw);
+	diag_log();
+	say_error("error reading %020lld.blob@%llu:%u", (long long)blob->id,
+		  (unsigned long long)ref->offset, (unsigned)ref->size);
+	return -1;
+}
+
+int
+vy_blob_remove_file(const char *dir, uint32_t space_id, uint32_t iid,
+		    int64_t blob_id)
+{
+	int ret = 0;
+	char path[PATH_MAX];
+	int len = vy_blob_snprint_path(path, sizeof(path), dir,
+				       space_id, iid, blob_id);
+	for (int i = 0; i < 2; i++) {
+		if (i > 0) {
+			/* Remove the file left after a failed write. */
+			snprintf(path + len, sizeof(path) - len, "%s",
+				 inprogress_suffix);
+		}
+		if (coio_unlink(path) < 0) {
+			if (errno != ENOENT) {
+				say_syserror("error while removing %s", path);
+				ret = -1;
+			}
+		} else
+			say_info("removed %s", path);
+	}
+	return ret;
+}
+
+void
+vy_blob_writer_create(struct vy_blob_writer *writer, const char *dirpath,
+		      uint32_t space_id, uint32_t iid, int64_t blob_id,
+		      uint64_t rate_limit)
+{
+	writer->dirpath = dirpath;
+	writer->space_id = space_id;
+	writer->iid = iid;
+	writer->id = blob_id;
+	writer->rate_limit = rate_limit;
+	xlog_clear(&writer->xlog);
+}
+
+static int
+vy_blob_writer_create_xlog(struct vy_blob_writer *writer)
+{
+	assert(!xlog_is_open(&writer->xlog));
+	char path[PATH_MAX];
+	vy_blob_snprint_path(path, sizeof(path), writer->dirpath,
+			     writer->space_id, writer->iid, writer->id);
+	say_info("writing `%s'", path);
+	struct xlog_meta meta;
+	xlog_meta_create(&meta, XLOG_META_TYPE_BLOB, &INSTANCE_UUID,
+			 NULL, NULL);
+	struct xlog_opts opts = xlog_opts_default;
+	opts.rate_limit = writer->rate_limit;
+	opts.sync_interval = VY_BLOB_SYNC_INTERVAL;
+	return xlog_create(&writer->xlog, path, 0, &meta, &opts);
+}
+
+int
+vy_blob_writer_append(struct vy_blob_writer *writer, const char *data,
+		      const char *data_end, struct vy_blob_ref *ref)
+{
+	if (!xlog_is_open(&writer->xlog) &&
+	    vy_blob_writer_create_xlog(writer) != 0)
+		return -1;
+
+	char header[16];
+	char *pos = mp_encode_map(header, 1);
+	pos = mp_encode_uint(pos, VY_BLOB_DATA_TUPLE);
+	assert(pos <= header + sizeof(header));
+
+	struct xrow_header xrow;
+	memset(&xrow, 0, sizeof(xrow));
+	xrow.type = VY_BLOB_DATA;
+	xrow.bodycnt = 2;
+	xrow.body[0].iov_base = header;
+	xrow.body[0].iov_len = pos - header;
+	xrow.body[1].iov_base = (char *)data;
+	xrow.body[1].iov_len = data_end - data;
+
+	/*
+	 * Each payload is written in its own tx block so that
+	 * it can be read and decompressed without the others.
+	 */
+	uint64_t offset = writer->xlog.offset;
+	xlog_tx_begin(&writer->xlog);
+	ssize_t row_size = xlog_write_row(&writer->xlog, &xrow);
+	if (row_size < 0) {
+		xlog_tx_rollback(&writer->xlog);
+		return -1;
+	}
+	ssize_t written = xlog_tx_commit(&writer->xlog);
+	if (written == 0)
+		written = xlog_flush(&writer->xlog);
+	if (written < 0)
+		return -1;
+	ref->blob_id = writer->id;
+	ref->offset = offset;
+	ref->size = written;
+	ref->unpacked_size = row_size;
+	return 0;
+}
+
+int
+vy_blob_writer_commit(struct vy_blob_writer *writer, struct vy_blob **result)
+{
+	*result = NULL;
+	if (!xlog_is_open(&writer->xlog))
+		return 0; /* nothing written */
+	if (xlog_sync(&writer->xlog) < 0 ||
+	    xlog_rename(&writer->xlog) < 0)
+		goto fail;
+	struct vy_blob *blob = vy_blob_new(writer->id, writer->xlog.fd,
+					   writer->xlog.offset);
+	if (blob == NULL)
+		goto fail;
+	xlog_close(&writer->xlog, true);
+	*result = blob;
+	return 0;
+fail:
+	xlog_close(&writer->xlog, false);
+	return -1;
+}
+
+void
+vy_blob_writer_abort(struct vy_blob_writer *writer)
+{
+	if (xlog_is_open(&writer->xlog))
+		xlog_close(&writer->xlog, false);
+}
+
+struct vy_blob_reader *
+vy_blob_reader_new(struct tuple_format *format, struct rlist *blobs)
+{
+	int count = 0;
+	struct vy_blob *blob;
+	rlist_foreach_entry(blob, blobs, in_lsm)
+		count++;
+	size_t size = sizeof(struct vy_blob_reader) +
+		      count * (sizeof(struct vy_blob *) + sizeof(bool));
+	struct vy_blob_reader *reader = malloc(size);
+	if (reader == NULL) {
+		diag_set(OutOfMemory, size, "malloc",
+			 "struct vy_blob_reader");
+		return NULL;
+	}
+	reader->format = format;
+	tuple_format_ref(format);
+	reader->blobs = (struct vy_blob **)(reader + 1);
+	reader->is_gc = (bool *)(reader->blobs + count);
+	reader->blob_count = count;
+	reader->zdctx = NULL;
+	int i = 0;
+	rlist_foreach_entry(blob, blobs, in_lsm) {
+		reader->blobs[i] = vy_blob_ref(blob);
+		reader->is_gc[i] = blob->needs_gc;
+		i++;
+	}
+	return reader;
+}
+
+void
+vy_blob_reader_delete(struct vy_blob_reader *reader)
+{
+	for (int i = 0; i < reader->blob_count; i++)
+		vy_blob_unref(reader->blobs[i]);
+	if (reader->zdctx != NULL)
+		ZSTD_freeDStream(reader->zdctx);
+	tuple_format_unref(reader->format);
+	free(reader);
+}
+
+struct vy_blob *
+vy_blob_reader_lookup(struct vy_blob_reader *reader, int64_t blob_id,
+		      bool *is_gc)
+{
+	for (int i = 0; i < reader->blob_count; i++) {
+		if (reader->blobs[i]->id == blob_id) {
+			if (is_gc != NULL)
+				*is_gc = reader->is_gc[i];
+			return reader->blobs[i];
+		}
+	}
+	return NULL;
+}
+
+int
+vy_blob_reader_resolve(struct vy_blob_reader *reader, struct vy_entry entry,
+		       struct vy_entry *result)
+{
+	assert((vy_stmt_flags(entry.stmt) & VY_STMT_BLOB_REF) != 0);
+	struct vy_blob_ref ref;
+	if (vy_stmt_blob_ref(entry.stmt, &ref) != 0)
+		return -1;
+	struct vy_blob *blob = vy_blob_reader_lookup(reader, ref.blob_id,
+						     NULL);
+	if (blob == NULL) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Blob %lld not found",
+				    (long long)ref.blob_id));
+		return -1;
+	}
+	if (reader->zdctx == NULL) {
+		reader->zdctx = ZSTD_createDStream();
+		if (reader->zdctx == NULL) {
+			diag_set(OutOfMemory, sizeof(reader->zdctx),
+				 "malloc", "zstd context");
+			return -1;
+		}
+	}
+	char *buf;
+	const char *data, *data_end;
+	if (vy_blob_read(blob, &ref, reader->zdctx,
+			 &buf, &data, &data_end) != 0)
+		return -1;
+	result->stmt = vy_stmt_new_from_blob(reader->format, entry.stmt,
+					     data, data_end);
+	free(buf);
+	if (result->stmt == NULL)
+		return -1;
+	/*
+	 * The hint of a full key is the same no matter whether
+	 * it's computed from a key or a tuple.
+	 */
+	result->hint = entry.hint;
+	return 0;
+}
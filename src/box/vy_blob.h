@@ -0,0 +1,248 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <small/rlist.h>
+
+#include "vy_entry.h"
+#include "xlog.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct tuple_format;
+
+/**
+ * Value log file (*.blob).
+ *
+ * Payloads of big REPLACE and INSERT statements of a primary index
+ * are written to a value log file on dump and compaction, while
+ * runs store only keys and references to the value log, see
+ * VY_STMT_BLOB_REF. Compaction copies references as is so a payload
+ * is written to disk only once, unless the file it's stored in is
+ * garbage collected, see vy_blob::needs_gc.
+ *
+ * A value log file is created by the task that writes a run and
+ * shares the id with the run, but it may outlive the run, because
+ * runs created by compaction may still refer to it. A value log
+ * file is dropped when no run of the LSM tree refers to it.
+ */
+struct vy_blob {
+	/** Unique ID of this file. */
+	int64_t id;
+	/** File descriptor. */
+	int fd;
+	/** Size of the file. */
+	uint64_t size;
+	/**
+	 * Size of payloads referenced by runs of the LSM tree.
+	 * Note, it may overestimate the real value, because a run
+	 * that has been compacted partially (some of its slices)
+	 * is accounted as a whole.
+	 */
+	uint64_t live_size;
+	/**
+	 * Set if the file is mostly garbage so compaction must
+	 * move payloads stored in it to a new value log file.
+	 */
+	bool needs_gc;
+	/**
+	 * Reference counter. A file is referenced by the LSM tree,
+	 * by each run that refers to it, and by each write task
+	 * that may need to read it. Must only be modified in tx.
+	 */
+	int refs;
+	/** Link in vy_lsm::blobs. */
+	struct rlist in_lsm;
+};
+
+/** Reference to a payload stored in a value log file. */
+struct vy_blob_ref {
+	/** ID of the value log file. */
+	int64_t blob_id;
+	/** Offset of the tx block storing the payload in the file. */
+	uint64_t offset;
+	/** Size of the tx block in the file. */
+	uint32_t size;
+	/** Size of the tx block rows, i.e. unpacked. */
+	uint32_t unpacked_size;
+};
+
+/** Return the size of a value log reference encoded in MsgPack. */
+size_t
+vy_blob_ref_sizeof(const struct vy_blob_ref *ref);
+
+/** Encode a value log reference in MsgPack. */
+char *
+vy_blob_ref_encode(const struct vy_blob_ref *ref, char *data);
+
+/**
+ * Decode a value log reference from MsgPack.
+ * Returns 0 on success, -1 if the reference is malformed.
+ */
+int
+vy_blob_ref_decode(const char **data, struct vy_blob_ref *ref);
+
+static inline int
+vy_blob_snprint_path(char *buf, int size, const char *dir,
+		     uint32_t space_id, uint32_t iid, int64_t blob_id)
+{
+	return snprintf(buf, size, "%s/%u/%u/%020lld.blob",
+			dir, (unsigned)space_id, (unsigned)iid,
+			(long long)blob_id);
+}
+
+/**
+ * Open a value log file for reading.
+ * Returns NULL and sets diag on error.
+ */
+struct vy_blob *
+vy_blob_open(const char *dir, uint32_t space_id, uint32_t iid,
+	     int64_t blob_id);
+
+/** Free a value log file. Must only be called by vy_blob_unref(). */
+void
+vy_blob_delete(struct vy_blob *blob);
+
+static inline struct vy_blob *
+vy_blob_ref(struct vy_blob *blob)
+{
+	assert(blob->refs > 0);
+	blob->refs++;
+	return blob;
+}
+
+static inline void
+vy_blob_unref(struct vy_blob *blob)
+{
+	assert(blob->refs > 0);
+	if (--blob->refs == 0)
+		vy_blob_delete(blob);
+}
+
+/**
+ * Read a payload from a value log file. On success, the payload
+ * MsgPack is returned in [@data, @data_end) and @buf is set to
+ * a buffer that must be freed by the caller with free().
+ *
+ * The function may be called from any thread.
+ */
+int
+vy_blob_read(struct vy_blob *blob, const struct vy_blob_ref *ref,
+	     ZSTD_DStream *zdctx, char **buf,
+	     const char **data, const char **data_end);
+
+/**
+ * Remove a value log file. Return 0 on success, -1 if unlink()
+ * failed.
+ */
+int
+vy_blob_remove_file(const char *dir, uint32_t space_id, uint32_t iid,
+		    int64_t blob_id);
+
+/** Writes payloads to a new value log file. */
+struct vy_blob_writer {
+	/** Path to the vinyl directory. */
+	const char *dirpath;
+	/** Identifier of a space owning the file. */
+	uint32_t space_id;
+	/** Identifier of an index owning the file. */
+	uint32_t iid;
+	/** ID of the value log file. */
+	int64_t id;
+	/** Write rate limit, in bytes per second. */
+	uint64_t rate_limit;
+	/** Xlog to write data, opened on demand. */
+	struct xlog xlog;
+};
+
+void
+vy_blob_writer_create(struct vy_blob_writer *writer, const char *dirpath,
+		      uint32_t space_id, uint32_t iid, int64_t blob_id,
+		      uint64_t rate_limit);
+
+/**
+ * Write a payload to a value log file and return a reference
+ * to it in @ref. Returns 0 on success, -1 on error.
+ */
+int
+vy_blob_writer_append(struct vy_blob_writer *writer, const char *data,
+		      const char *data_end, struct vy_blob_ref *ref);
+
+/**
+ * Sync the written value log file and open it for reading.
+ * The new file is returned in @blob, which is set to NULL if
+ * nothing was written. The writer is destroyed.
+ * Returns 0 on success, -1 on error.
+ */
+int
+vy_blob_writer_commit(struct vy_blob_writer *writer, struct vy_blob **blob);
+
+/**
+ * Abort writing a value log file. The file is deleted by garbage
+ * collection of the run it was written for. The writer is destroyed.
+ */
+void
+vy_blob_writer_abort(struct vy_blob_writer *writer);
+
+/**
+ * Loads payloads from value log files in a worker thread,
+ * see vy_write_iterator and vy_run_writer.
+ */
+struct vy_blob_reader {
+	/** Format of statements loaded from value log files. */
+	struct tuple_format *format;
+	/** Value log files of the LSM tree (referenced). */
+	struct vy_blob **blobs;
+	/**
+	 * For each file in @blobs, set if it's garbage collected.
+	 * A copy of vy_blob::needs_gc, which is modified in tx.
+	 */
+	bool *is_gc;
+	/** Number of entries in @blobs and @is_gc. */
+	int blob_count;
+	/** Decompression context, created on demand. */
+	ZSTD_DStream *zdctx;
+};
+
+/**
+ * Create a reader of the value log files linked in the given list
+ * by vy_blob::in_lsm. Must be called in tx.
+ * Returns NULL and sets diag on error.
+ */
+struct vy_blob_reader *
+vy_blob_reader_new(struct tuple_format *format, struct rlist *blobs);
+
+/** Free a reader. Must be called in tx. */
+void
+vy_blob_reader_delete(struct vy_blob_reader *reader);
+
+/**
+ * Look up a value log file by id. Returns NULL if not found.
+ * If @is_gc is not NULL, it's set if the file is garbage collected.
+ */
+struct vy_blob *
+vy_blob_reader_lookup(struct vy_blob_reader *reader, int64_t blob_id,
+		      bool *is_gc);
+
+/**
+ * Given a statement referring to a value log file, load its payload
+ * and return the full statement in @result (the caller must unref it).
+ * Returns 0 on success, -1 on error.
+ */
+int
+vy_blob_reader_resolve(struct vy_blob_reader *reader, struct vy_entry entry,
+		       struct vy_entry *result);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
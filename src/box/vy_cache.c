@@ -503,6 +503,46 @@ vy_cache_on_write(struct vy_cache *cache, struct vy_entry entry,
 	}
 }
 
+void
+vy_cache_on_write_range(struct vy_cache *cache, struct tuple *range)
+{
+	assert(vy_stmt_type(range) == IPROTO_DELETE_RANGE);
+	vy_cache_gc(cache->env);
+	struct vy_cache_tree *tree = &cache->cache_tree;
+	struct key_def *cmp_def = cache->cmp_def;
+	/* The begin key is stored as the tombstone data. */
+	struct vy_entry begin;
+	begin.stmt = range;
+	begin.hint = vy_stmt_hint(range, cmp_def);
+	cache->version++;
+
+	struct vy_cache_tree_iterator itr;
+	itr = vy_cache_tree_lower_bound(tree, begin, NULL);
+	struct vy_cache_tree_iterator prev = itr;
+	vy_cache_tree_iterator_prev(tree, &prev);
+	struct vy_cache_node **prev_node =
+		vy_cache_tree_iterator_get_elem(tree, &prev);
+	if (prev_node != NULL) {
+		(*prev_node)->flags &= ~VY_CACHE_RIGHT_LINKED;
+		(*prev_node)->right_boundary_level = cmp_def->part_count;
+	}
+	struct vy_cache_node **node;
+	while ((node = vy_cache_tree_iterator_get_elem(tree, &itr)) != NULL &&
+	       vy_stmt_range_covers(range, (*node)->entry.stmt, cmp_def)) {
+		struct vy_cache_node *to_delete = *node;
+		vy_stmt_counter_acct_tuple(&cache->stat.invalidate,
+					   to_delete->entry.stmt);
+		vy_cache_tree_delete(tree, to_delete);
+		vy_cache_node_delete(cache->env, to_delete);
+		/* Deletion invalidates tree iterators. */
+		itr = vy_cache_tree_lower_bound(tree, begin, NULL);
+	}
+	if (node != NULL) {
+		(*node)->flags &= ~VY_CACHE_LEFT_LINKED;
+		(*node)->left_boundary_level = cmp_def->part_count;
+	}
+}
+
 /**
  * Get a stmt by current position
  */
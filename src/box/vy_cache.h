@@ -223,6 +223,14 @@ void
 vy_cache_on_write(struct vy_cache *cache, struct vy_entry entry,
 		  struct vy_entry *deleted);
 
+/**
+ * Invalidate cached values deleted by a range tombstone.
+ * @param cache - pointer to tuple cache.
+ * @param range - DELETE_RANGE statement.
+ */
+void
+vy_cache_on_write_range(struct vy_cache *cache, struct tuple *range);
+
 
 /**
  * Cache iterator
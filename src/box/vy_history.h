@@ -138,6 +138,13 @@ vy_history_splice(struct vy_history *dst, struct vy_history *src)
 int
 vy_history_append_stmt(struct vy_history *history, struct vy_entry entry);
 
+/**
+ * Remove statements older than @lsn from the given history,
+ * e.g. because they were deleted by a range tombstone.
+ */
+void
+vy_history_cut(struct vy_history *history, int64_t lsn);
+
 /**
  * Release all statements stored in the given history and
  * reinitialize the history list.
@@ -86,6 +86,9 @@ enum vy_log_key {
 	VY_LOG_KEY_DROP_LSN		= 14,
 	VY_LOG_KEY_GROUP_ID		= 15,
 	VY_LOG_KEY_DUMP_COUNT		= 16,
+	VY_LOG_KEY_BLOB_ID		= 17,
+	VY_LOG_KEY_TOMBSTONE_ID		= 18,
+	VY_LOG_KEY_TOMBSTONE_LSN	= 19,
 };
 
 /** vy_log_key -> human readable name. */
@@ -107,6 +110,9 @@ static const char *vy_log_key_name[] = {
 	[VY_LOG_KEY_DROP_LSN]		= "drop_lsn",
 	[VY_LOG_KEY_GROUP_ID]		= "group_id",
 	[VY_LOG_KEY_DUMP_COUNT]		= "dump_count",
+	[VY_LOG_KEY_BLOB_ID]		= "blob_id",
+	[VY_LOG_KEY_TOMBSTONE_ID]	= "tombstone_id",
+	[VY_LOG_KEY_TOMBSTONE_LSN]	= "tombstone_lsn",
 };
 
 /** vy_log_type -> human readable name. */
@@ -129,6 +135,11 @@ static const char *vy_log_type_name[] = {
 	[VY_LOG_PREPARE_LSM]		= "prepare_lsm",
 	[VY_LOG_REBOOTSTRAP]		= "rebootstrap",
 	[VY_LOG_ABORT_REBOOTSTRAP]	= "abort_rebootstrap",
+	[VY_LOG_CREATE_BLOB]		= "create_blob",
+	[VY_LOG_DROP_BLOB]		= "drop_blob",
+	[VY_LOG_FORGET_BLOB]		= "forget_blob",
+	[VY_LOG_INSERT_TOMBSTONE]	= "insert_tombstone",
+	[VY_LOG_DELETE_TOMBSTONE]	= "delete_tombstone",
 };
 
 /** Batch of vylog records that must be written in one go. */
@@ -314,6 +325,18 @@ vy_log_record_snprint(char *buf, int size, const struct vy_log_record *record)
 		SNPRINT(total, snprintf, buf, size, "%s=%"PRIu32", ",
 			vy_log_key_name[VY_LOG_KEY_DUMP_COUNT],
 			record->dump_count);
+	if (record->blob_id > 0)
+		SNPRINT(total, snprintf, buf, size, "%s=%"PRIi64", ",
+			vy_log_key_name[VY_LOG_KEY_BLOB_ID],
+			record->blob_id);
+	if (record->tombstone_id > 0)
+		SNPRINT(total, snprintf, buf, size, "%s=%"PRIi64", ",
+			vy_log_key_name[VY_LOG_KEY_TOMBSTONE_ID],
+			record->tombstone_id);
+	if (record->tombstone_lsn > 0)
+		SNPRINT(total, snprintf, buf, size, "%s=%"PRIi64", ",
+			vy_log_key_name[VY_LOG_KEY_TOMBSTONE_LSN],
+			record->tombstone_lsn);
 	SNPRINT(total, snprintf, buf, size, "}");
 	return total;
 }
@@ -445,6 +468,21 @@ vy_log_record_encode(const struct vy_log_record *record,
 		size += mp_sizeof_uint(record->dump_count);
 		n_keys++;
 	}
+	if (record->blob_id > 0) {
+		size += mp_sizeof_uint(VY_LOG_KEY_BLOB_ID);
+		size += mp_sizeof_uint(record->blob_id);
+		n_keys++;
+	}
+	if (record->tombstone_id > 0) {
+		size += mp_sizeof_uint(VY_LOG_KEY_TOMBSTONE_ID);
+		size += mp_sizeof_uint(record->tombstone_id);
+		n_keys++;
+	}
+	if (record->tombstone_lsn > 0) {
+		size += mp_sizeof_uint(VY_LOG_KEY_TOMBSTONE_LSN);
+		size += mp_sizeof_uint(record->tombstone_lsn);
+		n_keys++;
+	}
 	size += mp_sizeof_map(n_keys);
 
 	/*
@@ -531,6 +569,18 @@ vy_log_record_encode(const struct vy_log_record *record,
 		pos = mp_encode_uint(pos, VY_LOG_KEY_DUMP_COUNT);
 		pos = mp_encode_uint(pos, record->dump_count);
 	}
+	if (record->blob_id > 0) {
+		pos = mp_encode_uint(pos, VY_LOG_KEY_BLOB_ID);
+		pos = mp_encode_uint(pos, record->blob_id);
+	}
+	if (record->tombstone_id > 0) {
+		pos = mp_encode_uint(pos, VY_LOG_KEY_TOMBSTONE_ID);
+		pos = mp_encode_uint(pos, record->tombstone_id);
+	}
+	if (record->tombstone_lsn > 0) {
+		pos = mp_encode_uint(pos, VY_LOG_KEY_TOMBSTONE_LSN);
+		pos = mp_encode_uint(pos, record->tombstone_lsn);
+	}
 	assert(pos == tuple + size);
 
 	/*
@@ -663,6 +713,15 @@ vy_log_record_decode(struct vy_log_record *record,
 		case VY_LOG_KEY_DUMP_COUNT:
 			record->dump_count = mp_decode_uint(&pos);
 			break;
+		case VY_LOG_KEY_BLOB_ID:
+			record->blob_id = mp_decode_uint(&pos);
+			break;
+		case VY_LOG_KEY_TOMBSTONE_ID:
+			record->tombstone_id = mp_decode_uint(&pos);
+			break;
+		case VY_LOG_KEY_TOMBSTONE_LSN:
+			record->tombstone_lsn = mp_decode_uint(&pos);
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -1460,6 +1519,29 @@ vy_recovery_lookup_run(struct vy_recovery *recovery, int64_t run_id)
 	return mh_i64ptr_node(h, k)->val;
 }
 
+/** Lookup a value log file in vy_recovery::blob_hash map. */
+static struct vy_blob_recovery_info *
+vy_recovery_lookup_blob(struct vy_recovery *recovery, int64_t blob_id)
+{
+	struct mh_i64ptr_t *h = recovery->blob_hash;
+	mh_int_t k = mh_i64ptr_find(h, blob_id, NULL);
+	if (k == mh_end(h))
+		return NULL;
+	return mh_i64ptr_node(h, k)->val;
+}
+
+/** Lookup a range tombstone in vy_recovery::tombstone_hash map. */
+static struct vy_tombstone_recovery_info *
+vy_recovery_lookup_tombstone(struct vy_recovery *recovery,
+			     int64_t tombstone_id)
+{
+	struct mh_i64ptr_t *h = recovery->tombstone_hash;
+	mh_int_t k = mh_i64ptr_find(h, tombstone_id, NULL);
+	if (k == mh_end(h))
+		return NULL;
+	return mh_i64ptr_node(h, k)->val;
+}
+
 /** Lookup a vinyl slice in vy_recovery::slice_hash map. */
 static struct vy_slice_recovery_info *
 vy_recovery_lookup_slice(struct vy_recovery *recovery, int64_t slice_id)
@@ -1558,6 +1640,8 @@ vy_recovery_do_create_lsm(struct vy_recovery *recovery, int64_t id,
 	lsm->prepared = NULL;
 	rlist_create(&lsm->ranges);
 	rlist_create(&lsm->runs);
+	rlist_create(&lsm->blobs);
+	rlist_create(&lsm->tombstones);
 	/*
 	 * Keep newer LSM trees closer to the tail of the list
 	 * so that on log rotation we create/drop past incarnations
@@ -1730,7 +1814,8 @@ vy_recovery_forget_lsm(struct vy_recovery *recovery, int64_t id)
 		return -1;
 	}
 	struct vy_lsm_recovery_info *lsm = mh_i64ptr_node(h, k)->val;
-	if (!rlist_empty(&lsm->ranges) || !rlist_empty(&lsm->runs)) {
+	if (!rlist_empty(&lsm->ranges) || !rlist_empty(&lsm->runs) ||
+	    !rlist_empty(&lsm->blobs)) {
 		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
 			 tt_sprintf("Forgotten LSM tree %lld has ranges/runs",
 				    (long long)id));
@@ -1738,6 +1823,19 @@ vy_recovery_forget_lsm(struct vy_recovery *recovery, int64_t id)
 	}
 	mh_i64ptr_del(h, k, NULL);
 	rlist_del_entry(lsm, in_recovery);
+	/*
+	 * Range tombstones don't have files so they aren't
+	 * deleted explicitly when the LSM tree is dropped.
+	 */
+	struct vy_tombstone_recovery_info *tombstone, *next_tombstone;
+	rlist_foreach_entry_safe(tombstone, &lsm->tombstones, in_lsm,
+				 next_tombstone) {
+		h = recovery->tombstone_hash;
+		k = mh_i64ptr_find(h, tombstone->id, NULL);
+		assert(k != mh_end(h));
+		mh_i64ptr_del(h, k, NULL);
+		free(tombstone);
+	}
 	free(lsm->key_parts);
 	free(lsm);
 	return 0;
@@ -1925,6 +2023,199 @@ vy_recovery_forget_run(struct vy_recovery *recovery, int64_t run_id)
 	return 0;
 }
 
+/**
+ * Handle a VY_LOG_CREATE_BLOB log record.
+ * This function allocates a value log file with ID @blob_id and
+ * adds it to the list of value log files of the LSM tree with ID
+ * @lsm_id. Return 0 on success, -1 if the file already exists,
+ * LSM tree not found, or OOM.
+ */
+static int
+vy_recovery_create_blob(struct vy_recovery *recovery, int64_t lsm_id,
+			int64_t blob_id)
+{
+	struct vy_lsm_recovery_info *lsm;
+	lsm = vy_recovery_lookup_lsm(recovery, lsm_id);
+	if (lsm == NULL) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Blob %lld created for unregistered "
+				    "LSM tree %lld", (long long)blob_id,
+				    (long long)lsm_id));
+		return -1;
+	}
+	if (vy_recovery_lookup_blob(recovery, blob_id) != NULL) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Duplicate blob id %lld",
+				    (long long)blob_id));
+		return -1;
+	}
+	struct vy_blob_recovery_info *blob = malloc(sizeof(*blob));
+	if (blob == NULL) {
+		diag_set(OutOfMemory, sizeof(*blob),
+			 "malloc", "struct vy_blob_recovery_info");
+		return -1;
+	}
+	struct mh_i64ptr_t *h = recovery->blob_hash;
+	struct mh_i64ptr_node_t node = { blob_id, blob };
+	struct mh_i64ptr_node_t *old_node = NULL;
+	mh_i64ptr_put(h, &node, &old_node, NULL);
+	assert(old_node == NULL);
+	blob->id = blob_id;
+	blob->gc_lsn = -1;
+	blob->is_dropped = false;
+	rlist_add_tail_entry(&lsm->blobs, blob, in_lsm);
+	if (recovery->max_id < blob_id)
+		recovery->max_id = blob_id;
+	return 0;
+}
+
+/**
+ * Handle a VY_LOG_DROP_BLOB log record.
+ * This function marks the value log file with ID @blob_id as
+ * deleted. Like a run, the file is not removed from the recovery
+ * context until it is "forgotten".
+ * Return 0 on success, -1 if the file not found or already deleted.
+ */
+static int
+vy_recovery_drop_blob(struct vy_recovery *recovery, int64_t blob_id,
+		      int64_t gc_lsn)
+{
+	struct vy_blob_recovery_info *blob;
+	blob = vy_recovery_lookup_blob(recovery, blob_id);
+	if (blob == NULL) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Blob %lld deleted but not registered",
+				    (long long)blob_id));
+		return -1;
+	}
+	if (blob->is_dropped) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Blob %lld deleted twice",
+				    (long long)blob_id));
+		return -1;
+	}
+	blob->is_dropped = true;
+	blob->gc_lsn = gc_lsn;
+	return 0;
+}
+
+/**
+ * Handle a VY_LOG_FORGET_BLOB log record.
+ * This function frees the value log file with ID @blob_id.
+ * Return 0 on success, -1 if the file not found.
+ */
+static int
+vy_recovery_forget_blob(struct vy_recovery *recovery, int64_t blob_id)
+{
+	struct mh_i64ptr_t *h = recovery->blob_hash;
+	mh_int_t k = mh_i64ptr_find(h, blob_id, NULL);
+	if (k == mh_end(h)) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Blob %lld forgotten but not registered",
+				    (long long)blob_id));
+		return -1;
+	}
+	struct vy_blob_recovery_info *blob = mh_i64ptr_node(h, k)->val;
+	mh_i64ptr_del(h, k, NULL);
+	rlist_del_entry(blob, in_lsm);
+	free(blob);
+	return 0;
+}
+
+/**
+ * Handle a VY_LOG_INSERT_TOMBSTONE log record.
+ * This function allocates a new range tombstone with ID
+ * @tombstone_id, inserts it to the hash, and adds it to the
+ * list of tombstones of the LSM tree with ID @lsm_id.
+ * Return 0 on success, -1 on failure (ID collision or OOM).
+ */
+static int
+vy_recovery_insert_tombstone(struct vy_recovery *recovery, int64_t lsm_id,
+			     int64_t tombstone_id, int64_t tombstone_lsn,
+			     const char *begin, const char *end)
+{
+	if (vy_recovery_lookup_tombstone(recovery, tombstone_id) != NULL) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Duplicate tombstone id %lld",
+				    (long long)tombstone_id));
+		return -1;
+	}
+	struct vy_lsm_recovery_info *lsm;
+	lsm = vy_recovery_lookup_lsm(recovery, lsm_id);
+	if (lsm == NULL) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Tombstone %lld created for unregistered "
+				    "LSM tree %lld", (long long)tombstone_id,
+				    (long long)lsm_id));
+		return -1;
+	}
+
+	size_t size = sizeof(struct vy_tombstone_recovery_info);
+	const char *data;
+	data = begin;
+	if (data != NULL)
+		mp_next(&data);
+	size_t begin_size = data - begin;
+	size += begin_size;
+	data = end;
+	if (data != NULL)
+		mp_next(&data);
+	size_t end_size = data - end;
+	size += end_size;
+
+	struct vy_tombstone_recovery_info *tombstone = malloc(size);
+	if (tombstone == NULL) {
+		diag_set(OutOfMemory, size,
+			 "malloc", "struct vy_tombstone_recovery_info");
+		return -1;
+	}
+	struct mh_i64ptr_t *h = recovery->tombstone_hash;
+	struct mh_i64ptr_node_t node = { tombstone_id, tombstone };
+	mh_i64ptr_put(h, &node, NULL, NULL);
+	tombstone->id = tombstone_id;
+	tombstone->lsn = tombstone_lsn;
+	if (begin != NULL) {
+		tombstone->begin = (void *)tombstone + sizeof(*tombstone);
+		memcpy(tombstone->begin, begin, begin_size);
+	} else
+		tombstone->begin = NULL;
+	if (end != NULL) {
+		tombstone->end = (void *)tombstone + sizeof(*tombstone) +
+				 begin_size;
+		memcpy(tombstone->end, end, end_size);
+	} else
+		tombstone->end = NULL;
+	rlist_add_tail_entry(&lsm->tombstones, tombstone, in_lsm);
+	if (recovery->max_id < tombstone_id)
+		recovery->max_id = tombstone_id;
+	return 0;
+}
+
+/**
+ * Handle a VY_LOG_DELETE_TOMBSTONE log record.
+ * This function frees the range tombstone with ID @tombstone_id.
+ * Return 0 on success, -1 if the tombstone not found.
+ */
+static int
+vy_recovery_delete_tombstone(struct vy_recovery *recovery,
+			     int64_t tombstone_id)
+{
+	struct mh_i64ptr_t *h = recovery->tombstone_hash;
+	mh_int_t k = mh_i64ptr_find(h, tombstone_id, NULL);
+	if (k == mh_end(h)) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Tombstone %lld deleted but not registered",
+				    (long long)tombstone_id));
+		return -1;
+	}
+	struct vy_tombstone_recovery_info *tombstone;
+	tombstone = mh_i64ptr_node(h, k)->val;
+	mh_i64ptr_del(h, k, NULL);
+	rlist_del_entry(tombstone, in_lsm);
+	free(tombstone);
+	return 0;
+}
+
 /**
  * Handle a VY_LOG_INSERT_RANGE log record.
  * This function allocates a new vinyl range with ID @range_id,
@@ -2252,6 +2543,27 @@ vy_recovery_process_record(struct vy_recovery *recovery,
 	case VY_LOG_ABORT_REBOOTSTRAP:
 		vy_recovery_abort_rebootstrap(recovery);
 		break;
+	case VY_LOG_CREATE_BLOB:
+		rc = vy_recovery_create_blob(recovery, record->lsm_id,
+					     record->blob_id);
+		break;
+	case VY_LOG_DROP_BLOB:
+		rc = vy_recovery_drop_blob(recovery, record->blob_id,
+					   record->gc_lsn);
+		break;
+	case VY_LOG_FORGET_BLOB:
+		rc = vy_recovery_forget_blob(recovery, record->blob_id);
+		break;
+	case VY_LOG_INSERT_TOMBSTONE:
+		rc = vy_recovery_insert_tombstone(recovery, record->lsm_id,
+						  record->tombstone_id,
+						  record->tombstone_lsn,
+						  record->begin, record->end);
+		break;
+	case VY_LOG_DELETE_TOMBSTONE:
+		rc = vy_recovery_delete_tombstone(recovery,
+						  record->tombstone_id);
+		break;
 	default:
 		unreachable();
 	}
@@ -2368,6 +2680,8 @@ vy_recovery_new_f(va_list ap)
 	recovery->range_hash = NULL;
 	recovery->run_hash = NULL;
 	recovery->slice_hash = NULL;
+	recovery->blob_hash = NULL;
+	recovery->tombstone_hash = NULL;
 	recovery->max_id = -1;
 	recovery->in_rebootstrap = false;
 
@@ -2376,6 +2690,8 @@ vy_recovery_new_f(va_list ap)
 	recovery->range_hash = mh_i64ptr_new();
 	recovery->run_hash = mh_i64ptr_new();
 	recovery->slice_hash = mh_i64ptr_new();
+	recovery->blob_hash = mh_i64ptr_new();
+	recovery->tombstone_hash = mh_i64ptr_new();
 
 	/*
 	 * We don't create a log file if there are no objects to
@@ -2487,6 +2803,8 @@ vy_recovery_delete(struct vy_recovery *recovery)
 	struct vy_range_recovery_info *range, *next_range;
 	struct vy_slice_recovery_info *slice, *next_slice;
 	struct vy_run_recovery_info *run, *next_run;
+	struct vy_blob_recovery_info *blob, *next_blob;
+	struct vy_tombstone_recovery_info *tombstone, *next_tombstone;
 
 	rlist_foreach_entry_safe(lsm, &recovery->lsms, in_recovery, next_lsm) {
 		rlist_foreach_entry_safe(range, &lsm->ranges,
@@ -2498,6 +2816,11 @@ vy_recovery_delete(struct vy_recovery *recovery)
 		}
 		rlist_foreach_entry_safe(run, &lsm->runs, in_lsm, next_run)
 			free(run);
+		rlist_foreach_entry_safe(blob, &lsm->blobs, in_lsm, next_blob)
+			free(blob);
+		rlist_foreach_entry_safe(tombstone, &lsm->tombstones,
+					 in_lsm, next_tombstone)
+			free(tombstone);
 		free(lsm->key_parts);
 		free(lsm);
 	}
@@ -2511,6 +2834,10 @@ vy_recovery_delete(struct vy_recovery *recovery)
 		mh_i64ptr_delete(recovery->run_hash);
 	if (recovery->slice_hash != NULL)
 		mh_i64ptr_delete(recovery->slice_hash);
+	if (recovery->blob_hash != NULL)
+		mh_i64ptr_delete(recovery->blob_hash);
+	if (recovery->tombstone_hash != NULL)
+		mh_i64ptr_delete(recovery->tombstone_hash);
 	TRASH(recovery);
 	free(recovery);
 }
@@ -2536,6 +2863,8 @@ vy_log_append_lsm(struct xlog *xlog, struct vy_lsm_recovery_info *lsm)
 	struct vy_range_recovery_info *range;
 	struct vy_slice_recovery_info *slice;
 	struct vy_run_recovery_info *run;
+	struct vy_blob_recovery_info *blob;
+	struct vy_tombstone_recovery_info *tombstone;
 	struct vy_log_record record;
 
 	vy_log_record_init(&record);
@@ -2578,6 +2907,37 @@ vy_log_append_lsm(struct xlog *xlog, struct vy_lsm_recovery_info *lsm)
 			return -1;
 	}
 
+	rlist_foreach_entry(blob, &lsm->blobs, in_lsm) {
+		vy_log_record_init(&record);
+		record.type = VY_LOG_CREATE_BLOB;
+		record.lsm_id = lsm->id;
+		record.blob_id = blob->id;
+		if (vy_log_append_record(xlog, &record) != 0)
+			return -1;
+
+		if (!blob->is_dropped)
+			continue;
+
+		vy_log_record_init(&record);
+		record.type = VY_LOG_DROP_BLOB;
+		record.blob_id = blob->id;
+		record.gc_lsn = blob->gc_lsn;
+		if (vy_log_append_record(xlog, &record) != 0)
+			return -1;
+	}
+
+	rlist_foreach_entry(tombstone, &lsm->tombstones, in_lsm) {
+		vy_log_record_init(&record);
+		record.type = VY_LOG_INSERT_TOMBSTONE;
+		record.lsm_id = lsm->id;
+		record.tombstone_id = tombstone->id;
+		record.tombstone_lsn = tombstone->lsn;
+		record.begin = tombstone->begin;
+		record.end = tombstone->end;
+		if (vy_log_append_record(xlog, &record) != 0)
+			return -1;
+	}
+
 	rlist_foreach_entry(range, &lsm->ranges, in_lsm) {
 		vy_log_record_init(&record);
 		record.type = VY_LOG_INSERT_RANGE;
@@ -2677,3 +3037,62 @@ err_write_xlog:
 err_create_xlog:
 	return -1;
 }
+
+static ssize_t
+vy_log_backup_global_f(va_list ap)
+{
+	struct vy_recovery *recovery = va_arg(ap, struct vy_recovery *);
+	const struct vclock *vclock = va_arg(ap, const struct vclock *);
+	const char *path = va_arg(ap, const char *);
+
+	struct xlog_meta meta;
+	xlog_meta_create(&meta, vy_log.dir.filetype, vy_log.dir.instance_uuid,
+			 vclock, NULL);
+	struct xlog xlog;
+	if (xlog_create(&xlog, path, 0, &meta, &xlog_opts_default) != 0)
+		return -1;
+
+	struct vy_log_record record;
+	struct vy_lsm_recovery_info *lsm;
+	rlist_foreach_entry(lsm, &recovery->lsms, in_recovery) {
+		if (lsm->group_id == GROUP_LOCAL)
+			continue;
+		if (vy_log_append_lsm(&xlog, lsm) != 0)
+			goto err;
+	}
+	/* Mark the end of the snapshot, see vy_log_create(). */
+	vy_log_record_init(&record);
+	record.type = VY_LOG_SNAPSHOT;
+	if (vy_log_append_record(&xlog, &record) != 0 ||
+	    xlog_flush(&xlog) < 0)
+		goto err;
+	xlog_close(&xlog, false);
+	return 0;
+err:
+	if (unlink(xlog.filename) < 0)
+		say_syserror("failed to delete file '%s'", xlog.filename);
+	xlog_close(&xlog, false);
+	return -1;
+}
+
+int
+vy_log_backup_global(const struct vclock *vclock, const char *path)
+{
+	/*
+	 * Stamp the copy with the vclock of the file it replaces so
+	 * that the recovering instance rotates it as a backup.
+	 */
+	const struct vclock *prev = vy_log_prev_checkpoint(vclock);
+	if (prev == NULL) {
+		diag_set(ClientError, ER_MISSING_SNAPSHOT);
+		return -1;
+	}
+	struct vy_recovery *recovery;
+	recovery = vy_recovery_new(vclock_sum(vclock),
+				   VY_RECOVERY_LOAD_CHECKPOINT);
+	if (recovery == NULL)
+		return -1;
+	int rc = coio_call(vy_log_backup_global_f, recovery, prev, path);
+	vy_recovery_delete(recovery);
+	return rc;
+}
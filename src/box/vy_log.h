@@ -217,6 +217,55 @@ enum vy_log_record_type {
 	 * See also VY_LOG_REBOOTSTRAP.
 	 */
 	VY_LOG_ABORT_REBOOTSTRAP	= 17,
+	/**
+	 * Commit a value log file creation.
+	 * Requires vy_log_record::lsm_id, blob_id.
+	 *
+	 * A value log file stores payloads of large statements
+	 * written to the primary index runs. It is created by
+	 * the same dump or compaction task that creates the run
+	 * with the same ID, so this record is written in the same
+	 * transaction as VY_LOG_CREATE_RUN. If the task fails, the
+	 * file is removed along with the incomplete run.
+	 */
+	VY_LOG_CREATE_BLOB		= 18,
+	/**
+	 * Drop a value log file.
+	 * Requires vy_log_record::blob_id, gc_lsn.
+	 *
+	 * Written when no run refers to the file anymore. Similarly
+	 * to VY_LOG_DROP_RUN, this only marks the file as deleted.
+	 */
+	VY_LOG_DROP_BLOB		= 19,
+	/**
+	 * Forget a value log file.
+	 * Requires vy_log_record::blob_id.
+	 *
+	 * Written after a dropped value log file has been removed.
+	 */
+	VY_LOG_FORGET_BLOB		= 20,
+	/**
+	 * Insert a range tombstone into an LSM tree.
+	 * Requires vy_log_record::lsm_id, tombstone_id, tombstone_lsn.
+	 * Optional vy_log_record::begin, end.
+	 *
+	 * A range tombstone deletes all statements with keys in
+	 * [begin, end) and LSN less than tombstone_lsn from the
+	 * primary index of a space, see vy_stmt_new_delete_range().
+	 * Range tombstones are stored in vylog rather than in runs,
+	 * because they aren't tied to a particular key. The record
+	 * is written along with VY_LOG_DUMP_LSM when the in-memory
+	 * tree storing the tombstone is dumped.
+	 */
+	VY_LOG_INSERT_TOMBSTONE		= 21,
+	/**
+	 * Delete a range tombstone.
+	 * Requires vy_log_record::tombstone_id.
+	 *
+	 * Written when all statements deleted by the tombstone
+	 * have been purged by compaction.
+	 */
+	VY_LOG_DELETE_TOMBSTONE		= 22,
 
 	vy_log_record_type_MAX
 };
@@ -243,14 +292,20 @@ struct vy_log_record {
 	int64_t run_id;
 	/** Unique ID of the run slice. */
 	int64_t slice_id;
+	/** Unique ID of the value log file. */
+	int64_t blob_id;
+	/** Unique ID of the range tombstone. */
+	int64_t tombstone_id;
+	/** LSN of the range tombstone. */
+	int64_t tombstone_lsn;
 	/**
-	 * Msgpack key for start of the range/slice.
-	 * NULL if the range/slice starts from -inf.
+	 * Msgpack key for start of the range/slice/tombstone.
+	 * NULL if the range/slice/tombstone starts from -inf.
 	 */
 	const char *begin;
 	/**
-	 * Msgpack key for end of the range/slice.
-	 * NULL if the range/slice ends with +inf.
+	 * Msgpack key for end of the range/slice/tombstone.
+	 * NULL if the range/slice/tombstone ends with +inf.
 	 */
 	const char *end;
 	/** Ordinal index number in the space. */
@@ -304,6 +359,10 @@ struct vy_recovery {
 	struct mh_i64ptr_t *run_hash;
 	/** ID -> vy_slice_recovery_info. */
 	struct mh_i64ptr_t *slice_hash;
+	/** ID -> vy_blob_recovery_info. */
+	struct mh_i64ptr_t *blob_hash;
+	/** ID -> vy_tombstone_recovery_info. */
+	struct mh_i64ptr_t *tombstone_hash;
 	/**
 	 * Maximal vinyl object ID, according to the metadata log,
 	 * or -1 in case no vinyl objects were recovered.
@@ -360,6 +419,16 @@ struct vy_lsm_recovery_info {
 	 * vy_run_recovery_info::in_lsm.
 	 */
 	struct rlist runs;
+	/**
+	 * List of all value log files created for the LSM tree,
+	 * linked by vy_blob_recovery_info::in_lsm.
+	 */
+	struct rlist blobs;
+	/**
+	 * List of all range tombstones of the LSM tree,
+	 * linked by vy_tombstone_recovery_info::in_lsm.
+	 */
+	struct rlist tombstones;
 	/**
 	 * Pointer to an LSM tree that is going to replace
 	 * this one after successful ALTER.
@@ -421,6 +490,35 @@ struct vy_run_recovery_info {
 	void *data;
 };
 
+/** Value log file info stored in a recovery context. */
+struct vy_blob_recovery_info {
+	/** Link in vy_lsm_recovery_info::blobs. */
+	struct rlist in_lsm;
+	/** ID of the value log file. */
+	int64_t id;
+	/**
+	 * For deleted files: LSN of the last checkpoint
+	 * that uses this file.
+	 */
+	int64_t gc_lsn;
+	/** True if the file was dropped (VY_LOG_DROP_BLOB). */
+	bool is_dropped;
+};
+
+/** Range tombstone info stored in a recovery context. */
+struct vy_tombstone_recovery_info {
+	/** Link in vy_lsm_recovery_info::tombstones. */
+	struct rlist in_lsm;
+	/** ID of the tombstone. */
+	int64_t id;
+	/** LSN of the tombstone. */
+	int64_t lsn;
+	/** Start of the deleted range, NULL if -inf. */
+	char *begin;
+	/** End of the deleted range, NULL if +inf. */
+	char *end;
+};
+
 /** Slice info stored in a recovery context. */
 struct vy_slice_recovery_info {
 	/** Link in vy_range_recovery_info::slices. */
@@ -487,6 +585,19 @@ vy_log_signature(void);
 const char *
 vy_log_backup_path(const struct vclock *vclock);
 
+/**
+ * Write the state of the metadata log at checkpoint @vclock to
+ * a new file @path, omitting group-local LSM trees, which must
+ * not be sent to replicas. The file can be used in place of the
+ * one returned by vy_log_backup_path(). It is created with the
+ * .inprogress suffix appended so that it is deleted on restart
+ * if left behind.
+ *
+ * Returns 0 on success, -1 on failure.
+ */
+int
+vy_log_backup_global(const struct vclock *vclock, const char *path);
+
 /** Allocate a unique ID for a vinyl object. */
 int64_t
 vy_log_next_id(void);
@@ -762,6 +873,69 @@ vy_log_forget_run(int64_t run_id)
 	vy_log_write(&record);
 }
 
+/** Helper to log a value log file creation. */
+static inline void
+vy_log_create_blob(int64_t lsm_id, int64_t blob_id)
+{
+	struct vy_log_record record;
+	vy_log_record_init(&record);
+	record.type = VY_LOG_CREATE_BLOB;
+	record.lsm_id = lsm_id;
+	record.blob_id = blob_id;
+	vy_log_write(&record);
+}
+
+/** Helper to log a value log file deletion. */
+static inline void
+vy_log_drop_blob(int64_t blob_id, int64_t gc_lsn)
+{
+	struct vy_log_record record;
+	vy_log_record_init(&record);
+	record.type = VY_LOG_DROP_BLOB;
+	record.blob_id = blob_id;
+	record.gc_lsn = gc_lsn;
+	vy_log_write(&record);
+}
+
+/** Helper to log a value log file cleanup. */
+static inline void
+vy_log_forget_blob(int64_t blob_id)
+{
+	struct vy_log_record record;
+	vy_log_record_init(&record);
+	record.type = VY_LOG_FORGET_BLOB;
+	record.blob_id = blob_id;
+	vy_log_write(&record);
+}
+
+/** Helper to log a range tombstone insertion. */
+static inline void
+vy_log_insert_tombstone(int64_t lsm_id, int64_t tombstone_id,
+			int64_t tombstone_lsn, const char *begin,
+			const char *end)
+{
+	struct vy_log_record record;
+	vy_log_record_init(&record);
+	record.type = VY_LOG_INSERT_TOMBSTONE;
+	record.lsm_id = lsm_id;
+	record.tombstone_id = tombstone_id;
+	record.tombstone_lsn = tombstone_lsn;
+	record.begin = begin;
+	record.end = end;
+	vy_log_write(&record);
+}
+
+/** Helper to log a range tombstone deletion. */
+static inline void
+vy_log_delete_tombstone(int64_t tombstone_id)
+{
+	struct vy_log_record record;
+	vy_log_record_init(&record);
+	record.type = VY_LOG_DELETE_TOMBSTONE;
+	record.tombstone_id = tombstone_id;
+	vy_log_write(&record);
+}
+
 /** Helper to log creation of a run slice. */
 static inline void
 vy_log_insert_slice(int64_t range_id, int64_t run_id, int64_t slice_id,
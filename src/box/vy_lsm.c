@@ -196,6 +196,7 @@ vy_lsm_new(struct vy_lsm_env *lsm_env, struct vy_cache_env *cache_env,
 	vy_range_tree_new(&lsm->range_tree);
 	vy_range_heap_create(&lsm->range_heap);
 	rlist_create(&lsm->runs);
+	rlist_create(&lsm->blobs);
 	lsm->pk = pk;
 	if (pk != NULL)
 		vy_lsm_ref(pk);
@@ -271,8 +272,18 @@ vy_lsm_delete(struct vy_lsm *lsm)
 	rlist_foreach_entry_safe(run, &lsm->runs, in_lsm, next_run)
 		vy_lsm_remove_run(lsm, run);
 
+	struct vy_blob *blob, *next_blob;
+	rlist_foreach_entry_safe(blob, &lsm->blobs, in_lsm, next_blob)
+		vy_lsm_remove_blob(lsm, blob);
+
+	for (int i = 0; i < lsm->tombstone_count; i++)
+		tuple_unref(lsm->tombstones[i].stmt);
+	free(lsm->tombstones);
+
 	vy_range_tree_iter(&lsm->range_tree, NULL, vy_range_tree_free_cb, NULL);
 	vy_range_heap_destroy(&lsm->range_heap);
+	if (lsm->zdict != NULL)
+		vy_zdict_unref(lsm->zdict);
 	tuple_format_unref(lsm->disk_format);
 	key_def_delete(lsm->cmp_def);
 	key_def_delete(lsm->key_def);
@@ -377,8 +388,29 @@ vy_lsm_recover_run(struct vy_lsm *lsm, struct vy_run_recovery_info *run_info,
 		vy_run_unref(run);
 		return NULL;
 	}
+	if (vy_lsm_bind_run_blobs(lsm, run) != 0) {
+		vy_run_unref(run);
+		return NULL;
+	}
 	vy_lsm_add_run(lsm, run);
 
+	/*
+	 * Runs compressed with the same dictionary share it to
+	 * save memory. The dictionary of the last recovered run
+	 * is used for compressing new runs.
+	 */
+	struct vy_zdict *zdict = run->info.zdict;
+	if (zdict != NULL) {
+		if (lsm->zdict != NULL && vy_zdict_equal(lsm->zdict, zdict)) {
+			run->info.zdict = vy_zdict_ref(lsm->zdict);
+			vy_zdict_unref(zdict);
+		} else {
+			if (lsm->zdict != NULL)
+				vy_zdict_unref(lsm->zdict);
+			lsm->zdict = vy_zdict_ref(zdict);
+		}
+	}
+
 	/*
 	 * The same run can be referenced by more than one slice
 	 * so we cache recovered runs in run_info to avoid loading
@@ -607,6 +639,50 @@ vy_lsm_recover(struct vy_lsm *lsm, struct vy_recovery *recovery,
 	 */
 	lsm->dump_lsn = lsm_info->dump_lsn;
 
+	/*
+	 * Value log files must be opened before runs, because
+	 * runs refer to them.
+	 */
+	struct vy_blob_recovery_info *blob_info;
+	rlist_foreach_entry(blob_info, &lsm_info->blobs, in_lsm) {
+		if (blob_info->is_dropped)
+			continue;
+		struct vy_blob *blob = vy_blob_open(lsm->env->path,
+						    lsm->space_id,
+						    lsm->index_id,
+						    blob_info->id);
+		if (blob == NULL)
+			return -1;
+		vy_lsm_add_blob(lsm, blob);
+		vy_blob_unref(blob);
+	}
+
+	struct vy_tombstone_recovery_info *tombstone_info;
+	rlist_foreach_entry(tombstone_info, &lsm_info->tombstones, in_lsm) {
+		/* Empty keys stand for infinity, see vy_log_record. */
+		static const char empty_key[] = { (char)0x90 };
+		const char *begin = tombstone_info->begin;
+		const char *end = tombstone_info->end;
+		if (begin == NULL)
+			begin = empty_key;
+		if (end == NULL)
+			end = empty_key;
+		const char *begin_end = begin;
+		mp_next(&begin_end);
+		const char *end_end = end;
+		mp_next(&end_end);
+		struct tuple *stmt = vy_stmt_new_delete_range(
+				lsm->env->key_format, begin, begin_end,
+				end, end_end);
+		if (stmt == NULL)
+			return -1;
+		vy_stmt_set_lsn(stmt, tombstone_info->lsn);
+		int rc = vy_lsm_add_tombstone(lsm, tombstone_info->id, stmt);
+		tuple_unref(stmt);
+		if (rc != 0)
+			return -1;
+	}
+
 	int rc = 0;
 	struct vy_range_recovery_info *range_info;
 	rlist_foreach_entry(range_info, &lsm_info->ranges, in_lsm) {
@@ -738,6 +814,229 @@ vy_lsm_range_size(struct vy_lsm *lsm)
 	return range_size;
 }
 
+void
+vy_lsm_add_blob(struct vy_lsm *lsm, struct vy_blob *blob)
+{
+	assert(lsm->index_id == 0);
+	assert(rlist_empty(&blob->in_lsm));
+	rlist_add_entry(&lsm->blobs, vy_blob_ref(blob), in_lsm);
+	/* Data size is consistent with space.bsize. */
+	lsm->env->disk_data_size += blob->size;
+}
+
+void
+vy_lsm_remove_blob(struct vy_lsm *lsm, struct vy_blob *blob)
+{
+	assert(!rlist_empty(&blob->in_lsm));
+	rlist_del_entry(blob, in_lsm);
+	lsm->env->disk_data_size -= blob->size;
+	vy_blob_unref(blob);
+}
+
+int
+vy_lsm_bind_run_blobs(struct vy_lsm *lsm, struct vy_run *run)
+{
+	for (int i = 0; i < run->info.blob_count; i++) {
+		struct vy_run_blob *entry = &run->info.blobs[i];
+		if (entry->blob != NULL)
+			continue;
+		struct vy_blob *blob;
+		rlist_foreach_entry(blob, &lsm->blobs, in_lsm) {
+			if (blob->id == entry->id) {
+				entry->blob = vy_blob_ref(blob);
+				break;
+			}
+		}
+		if (entry->blob == NULL) {
+			diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+				 tt_sprintf("Blob %lld not found for run %lld",
+					    (long long)entry->id,
+					    (long long)run->id));
+			return -1;
+		}
+	}
+	return 0;
+}
+
+void
+vy_lsm_drop_unused_blobs(struct vy_lsm *lsm)
+{
+	bool needs_gc = false;
+	struct vy_blob *blob, *next_blob;
+	rlist_foreach_entry_safe(blob, &lsm->blobs, in_lsm, next_blob) {
+		if (blob->live_size == 0) {
+			/*
+			 * Don't bother failing if we failed to log
+			 * the file drop: the record stays in the log
+			 * buffer and will be flushed along with the
+			 * next transaction.
+			 */
+			vy_log_tx_begin();
+			vy_log_drop_blob(blob->id, VY_LOG_GC_LSN_CURRENT);
+			vy_log_tx_try_commit();
+			vy_lsm_remove_blob(lsm, blob);
+		} else if (!blob->needs_gc && blob->live_size * 2 < blob->size) {
+			/*
+			 * More than half of the file is garbage.
+			 * Make compaction move live payloads to
+			 * new files.
+			 */
+			blob->needs_gc = true;
+			needs_gc = true;
+		}
+	}
+	if (needs_gc) {
+		say_info("%s: forcing compaction to collect value log "
+			 "garbage", vy_lsm_name(lsm));
+		vy_lsm_force_compaction(lsm);
+	}
+}
+
+int
+vy_lsm_add_tombstone(struct vy_lsm *lsm, int64_t id, struct tuple *stmt)
+{
+	assert(lsm->index_id == 0);
+	assert(vy_stmt_type(stmt) == IPROTO_DELETE_RANGE);
+	assert(vy_stmt_is_refable(stmt));
+	if (lsm->tombstone_count == lsm->tombstone_capacity) {
+		int capacity = MAX(lsm->tombstone_capacity * 2, 8);
+		size_t size = capacity * sizeof(*lsm->tombstones);
+		struct vy_lsm_tombstone *tombstones =
+			realloc(lsm->tombstones, size);
+		if (tombstones == NULL) {
+			diag_set(OutOfMemory, size, "realloc",
+				 "range tombstones");
+			return -1;
+		}
+		lsm->tombstones = tombstones;
+		lsm->tombstone_capacity = capacity;
+	}
+	struct vy_lsm_tombstone *tombstone =
+		&lsm->tombstones[lsm->tombstone_count++];
+	tombstone->id = id;
+	tombstone->stmt = stmt;
+	tuple_ref(stmt);
+	return 0;
+}
+
+bool
+vy_lsm_has_range_deletes(struct vy_lsm *lsm)
+{
+	if (lsm->tombstone_count > 0 || lsm->mem->range_delete_count > 0)
+		return true;
+	struct vy_mem *mem;
+	rlist_foreach_entry(mem, &lsm->sealed, in_sealed) {
+		if (mem->range_delete_count > 0)
+			return true;
+	}
+	return false;
+}
+
+int64_t
+vy_lsm_range_delete_lsn(struct vy_lsm *lsm, struct tuple *stmt,
+			int64_t vlsn)
+{
+	struct key_def *cmp_def = lsm->cmp_def;
+	int64_t lsn = vy_stmt_range_delete_lsn(lsm->mem->range_deletes,
+					       lsm->mem->range_delete_count,
+					       stmt, vlsn, cmp_def);
+	struct vy_mem *mem;
+	rlist_foreach_entry(mem, &lsm->sealed, in_sealed) {
+		lsn = MAX(lsn, vy_stmt_range_delete_lsn(
+				mem->range_deletes, mem->range_delete_count,
+				stmt, vlsn, cmp_def));
+	}
+	for (int i = 0; i < lsm->tombstone_count; i++) {
+		struct tuple *range = lsm->tombstones[i].stmt;
+		int64_t range_lsn = vy_stmt_lsn(range);
+		if (range_lsn > vlsn || range_lsn <= lsn)
+			continue;
+		if (vy_stmt_range_covers(range, stmt, cmp_def))
+			lsn = range_lsn;
+	}
+	return lsn;
+}
+
+/**
+ * Return true if a range of an LSM tree may store keys deleted
+ * by the given range tombstone. Partial keys are compared by
+ * prefix so the check is conservative.
+ */
+static bool
+vy_range_intersects_tombstone(struct vy_range *range, struct tuple *tombstone,
+			      struct key_def *cmp_def)
+{
+	if (range->end.stmt != NULL &&
+	    vy_stmt_compare_with_raw_key(range->end.stmt, HINT_NONE,
+					 tuple_data(tombstone), HINT_NONE,
+					 cmp_def) < 0)
+		return false;
+	const char *end = vy_stmt_range_end(tombstone);
+	const char *tmp = end;
+	if (range->begin.stmt != NULL && mp_decode_array(&tmp) > 0 &&
+	    vy_stmt_compare_with_raw_key(range->begin.stmt, HINT_NONE,
+					 end, HINT_NONE, cmp_def) >= 0)
+		return false;
+	return true;
+}
+
+/**
+ * Return true if a range tombstone may still delete statements
+ * stored on disk, i.e. there's a run that intersects the deleted
+ * range, stores statements older than the tombstone, and wasn't
+ * created by a compaction that applied the tombstone.
+ */
+static bool
+vy_lsm_tombstone_is_used(struct vy_lsm *lsm, struct tuple *tombstone)
+{
+	int64_t lsn = vy_stmt_lsn(tombstone);
+	struct vy_range *range;
+	for (range = vy_range_tree_first(&lsm->range_tree); range != NULL;
+	     range = vy_range_tree_next(&lsm->range_tree, range)) {
+		if (!vy_range_intersects_tombstone(range, tombstone,
+						   lsm->cmp_def))
+			continue;
+		struct vy_slice *slice;
+		rlist_foreach_entry(slice, &range->slices, in_range) {
+			struct vy_run *run = slice->run;
+			if (run->info.min_lsn < lsn &&
+			    run->range_delete_lsn < lsn)
+				return true;
+		}
+	}
+	return false;
+}
+
+void
+vy_lsm_drop_unused_tombstones(struct vy_lsm *lsm)
+{
+	int i = 0;
+	while (i < lsm->tombstone_count) {
+		struct vy_lsm_tombstone *tombstone = &lsm->tombstones[i];
+		if (vy_lsm_tombstone_is_used(lsm, tombstone->stmt)) {
+			i++;
+			continue;
+		}
+		/*
+		 * Don't bother failing if we failed to log the
+		 * tombstone deletion: the record stays in the log
+		 * buffer and will be flushed along with the next
+		 * transaction.
+		 */
+		vy_log_tx_begin();
+		vy_log_delete_tombstone(tombstone->id);
+		vy_log_tx_try_commit();
+		tuple_unref(tombstone->stmt);
+		*tombstone = lsm->tombstones[--lsm->tombstone_count];
+		/*
+		 * A reader may have fetched statements deleted by
+		 * the tombstone from a run that has just been
+		 * compacted so make it restart.
+		 */
+		lsm->mem_list_version++;
+	}
+}
+
 void
 vy_lsm_add_run(struct vy_lsm *lsm, struct vy_run *run)
 {
@@ -764,6 +1063,12 @@ vy_lsm_add_run(struct vy_lsm *lsm, struct vy_run *run)
 	env->disk_index_size += bloom_size + page_index_size;
 	if (lsm->index_id > 0)
 		env->disk_index_size += run->count.bytes;
+
+	for (int i = 0; i < run->info.blob_count; i++) {
+		struct vy_run_blob *entry = &run->info.blobs[i];
+		assert(entry->blob != NULL);
+		entry->blob->live_size += entry->size;
+	}
 }
 
 void
@@ -793,6 +1098,12 @@ vy_lsm_remove_run(struct vy_lsm *lsm, struct vy_run *run)
 	env->disk_index_size -= bloom_size + page_index_size;
 	if (lsm->index_id > 0)
 		env->disk_index_size -= run->count.bytes;
+
+	for (int i = 0; i < run->info.blob_count; i++) {
+		struct vy_run_blob *entry = &run->info.blobs[i];
+		assert(entry->blob->live_size >= entry->size);
+		entry->blob->live_size -= entry->size;
+	}
 }
 
 void
@@ -933,10 +1244,14 @@ vy_lsm_set(struct vy_lsm *lsm, struct vy_mem *mem,
 		diag_set(ClientError, ER_TRANSACTION_CONFLICT);
 		return -1;
 	}
-	if (vy_stmt_type(*region_stmt) != IPROTO_UPSERT)
-		return vy_mem_insert(mem, entry);
-	else
+	switch (vy_stmt_type(*region_stmt)) {
+	case IPROTO_UPSERT:
 		return vy_mem_insert_upsert(mem, entry);
+	case IPROTO_DELETE_RANGE:
+		return vy_mem_insert_range_delete(mem, entry.stmt);
+	default:
+		return vy_mem_insert(mem, entry);
+	}
 }
 
 /**
@@ -1019,7 +1334,7 @@ vy_lsm_commit_upsert(struct vy_lsm *lsm, struct vy_mem *mem,
 	 */
 	if (n_upserts == 0 &&
 	    lsm->stat.memory.count.rows == lsm->mem->count.rows &&
-	    lsm->run_count == 0) {
+	    lsm->run_count == 0 && !vy_lsm_has_range_deletes(lsm)) {
 		older = vy_mem_older_lsn(mem, entry);
 		assert(older.stmt == NULL ||
 		       vy_stmt_type(older.stmt) != IPROTO_UPSERT);
@@ -1079,6 +1394,13 @@ void
 vy_lsm_commit_stmt(struct vy_lsm *lsm, struct vy_mem *mem,
 		   struct vy_entry entry)
 {
+	if (vy_stmt_type(entry.stmt) == IPROTO_DELETE_RANGE) {
+		vy_mem_commit_range_delete(mem, entry.stmt);
+		lsm->stat.memory.count.rows++;
+		vy_cache_on_write_range(&lsm->cache, entry.stmt);
+		return;
+	}
+
 	vy_mem_commit_stmt(mem, entry);
 
 	lsm->stat.memory.count.rows++;
@@ -1096,6 +1418,12 @@ void
 vy_lsm_rollback_stmt(struct vy_lsm *lsm, struct vy_mem *mem,
 		     struct vy_entry entry)
 {
+	if (vy_stmt_type(entry.stmt) == IPROTO_DELETE_RANGE) {
+		vy_mem_rollback_range_delete(mem, entry.stmt);
+		vy_cache_on_write_range(&lsm->cache, entry.stmt);
+		return;
+	}
+
 	vy_mem_rollback_stmt(mem, entry);
 
 	/* Invalidate cache element. */
@@ -59,6 +59,8 @@ struct vy_mem;
 struct vy_mem_env;
 struct vy_recovery;
 struct vy_run;
+struct vy_zdict;
+struct vy_blob;
 struct vy_run_env;
 
 typedef void
@@ -178,6 +180,14 @@ vy_lsm_env_destroy(struct vy_lsm_env *env);
  *   parts concatenated together construe the tuple of the
  *   secondary key, i.e. the tuple stored. This is key_def.
  */
+/** Range tombstone dumped to disk. */
+struct vy_lsm_tombstone {
+	/** Unique ID of the tombstone, used in vylog. */
+	int64_t id;
+	/** DELETE_RANGE statement (referenced). */
+	struct tuple *stmt;
+};
+
 struct vy_lsm {
 	struct index base;
 	/** Common LSM tree environment. */
@@ -257,6 +267,23 @@ struct vy_lsm {
 	struct rlist runs;
 	/** Number of entries in all ranges. */
 	int run_count;
+	/**
+	 * List of value log files of this LSM tree, linked by
+	 * vy_blob->in_lsm, see index_opts::blob_threshold.
+	 */
+	struct rlist blobs;
+	/**
+	 * Range tombstones that have been dumped to disk, see
+	 * vy_stmt_new_delete_range(). Tombstones that haven't been
+	 * dumped yet are stored in vy_mem::range_deletes. Since
+	 * range deletes are rare, they are stored in a plain array
+	 * and looked up with linear search.
+	 */
+	struct vy_lsm_tombstone *tombstones;
+	/** Number of entries in the tombstones array. */
+	int tombstone_count;
+	/** Capacity of the tombstones array. */
+	int tombstone_capacity;
 	/**
 	 * Histogram accounting how many ranges of the LSM tree
 	 * have a particular number of runs.
@@ -266,6 +293,16 @@ struct vy_lsm {
 	size_t bloom_size;
 	/** Size of memory used for page index. */
 	size_t page_index_size;
+	/**
+	 * Dictionary used for compressing pages of new runs or
+	 * NULL if there's none, see index_opts::compression_dict.
+	 */
+	struct vy_zdict *zdict;
+	/**
+	 * Number of dumps completed since the dictionary was
+	 * trained. Used to retrain the dictionary periodically.
+	 */
+	int zdict_dump_count;
 	/**
 	 * Incremented for each change of the mem list,
 	 * to invalidate iterators.
@@ -381,6 +418,46 @@ vy_lsm_dumps_per_compaction(struct vy_lsm *lsm)
 	return lsm->sum_dumps_per_compaction / lsm->range_count;
 }
 
+/**
+ * Return the average number of runs a lookup has to check
+ * in a range of this LSM tree (read amplification).
+ */
+static inline double
+vy_lsm_read_amplification(struct vy_lsm *lsm)
+{
+	return (double)lsm->run_count / lsm->range_count;
+}
+
+/**
+ * Return the ratio of the number of bytes written to disk by
+ * dump and compaction to the number of bytes dumped from memory
+ * (write amplification). Returns 0 if nothing has been dumped
+ * since the statistics were reset.
+ */
+static inline double
+vy_lsm_write_amplification(struct vy_lsm *lsm)
+{
+	int64_t input = lsm->stat.disk.dump.input.bytes;
+	if (input == 0)
+		return 0;
+	return (double)(lsm->stat.disk.dump.output.bytes +
+			lsm->stat.disk.compaction.output.bytes) / input;
+}
+
+/**
+ * Return the ratio of the size of all runs of this LSM tree
+ * to the size of the runs stored at the last level (space
+ * amplification). Returns 0 if the LSM tree has no runs.
+ */
+static inline double
+vy_lsm_space_amplification(struct vy_lsm *lsm)
+{
+	int64_t last_level = lsm->stat.disk.last_level_count.bytes;
+	if (last_level == 0)
+		return 0;
+	return (double)lsm->stat.disk.count.bytes / last_level;
+}
+
 /**
  * Increment the reference counter of an LSM tree.
  * An LSM tree cannot be deleted if its reference
@@ -478,6 +555,70 @@ vy_lsm_add_run(struct vy_lsm *lsm, struct vy_run *run);
 void
 vy_lsm_remove_run(struct vy_lsm *lsm, struct vy_run *run);
 
+/**
+ * Add a value log file to the list of value log files of an LSM
+ * tree. The LSM tree takes a reference to the file.
+ */
+void
+vy_lsm_add_blob(struct vy_lsm *lsm, struct vy_blob *blob);
+
+/**
+ * Remove a value log file from the list of value log files of
+ * an LSM tree and drop the reference taken by vy_lsm_add_blob().
+ */
+void
+vy_lsm_remove_blob(struct vy_lsm *lsm, struct vy_blob *blob);
+
+/**
+ * Look up the value log files a run refers to among the value log
+ * files of an LSM tree and store references to them in the run info.
+ * Must be called before adding the run to the LSM tree.
+ * Returns 0 on success, -1 if a value log file is missing.
+ */
+int
+vy_lsm_bind_run_blobs(struct vy_lsm *lsm, struct vy_run *run);
+
+/**
+ * Drop value log files that aren't referenced by any run of an
+ * LSM tree and schedule garbage collection of value log files
+ * that are mostly unused. Called after runs are removed from the
+ * LSM tree by compaction.
+ */
+void
+vy_lsm_drop_unused_blobs(struct vy_lsm *lsm);
+
+/**
+ * Add a dumped range tombstone to an LSM tree. The LSM tree
+ * takes a reference to the statement.
+ * Returns 0 on success, -1 on memory allocation error.
+ */
+int
+vy_lsm_add_tombstone(struct vy_lsm *lsm, int64_t id, struct tuple *stmt);
+
+/**
+ * Return true if an LSM tree has range tombstones, either
+ * in memory or on disk.
+ */
+bool
+vy_lsm_has_range_deletes(struct vy_lsm *lsm);
+
+/**
+ * Return the max LSN of a range tombstone of an LSM tree that
+ * covers the key of the given statement and is visible from the
+ * read view with the given LSN, or -1 if there's no such tombstone.
+ */
+int64_t
+vy_lsm_range_delete_lsn(struct vy_lsm *lsm, struct tuple *stmt,
+			int64_t vlsn);
+
+/**
+ * Drop range tombstones that don't delete anything anymore,
+ * because all runs storing keys they cover were created after
+ * them. Called after a dump or compaction task completes.
+ */
+void
+vy_lsm_drop_unused_tombstones(struct vy_lsm *lsm);
+
 /**
  * Add a range to both the range tree and the range heap
  * of an LSM tree.
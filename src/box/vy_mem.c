@@ -31,6 +31,7 @@
 #include "vy_mem.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <trivia/util.h>
 #include <small/lsregion.h>
@@ -126,6 +127,7 @@ void
 vy_mem_delete(struct vy_mem *index)
 {
 	index->env->tree_extent_size -= index->tree_extent_size;
+	free(index->range_deletes);
 	tuple_format_unref(index->format);
 	fiber_cond_destroy(&index->pin_cond);
 	TRASH(index);
@@ -271,6 +273,63 @@ vy_mem_rollback_stmt(struct vy_mem *mem, struct vy_entry entry)
 	mem->version++;
 }
 
+int
+vy_mem_insert_range_delete(struct vy_mem *mem, struct tuple *stmt)
+{
+	assert(vy_stmt_type(stmt) == IPROTO_DELETE_RANGE);
+	/* The statement must be from a lsregion. */
+	assert(!vy_stmt_is_refable(stmt));
+	if (mem->range_delete_count == mem->range_delete_capacity) {
+		int capacity = MAX(mem->range_delete_capacity * 2, 8);
+		size_t size = capacity * sizeof(*mem->range_deletes);
+		struct tuple **range_deletes = realloc(mem->range_deletes,
+						       size);
+		if (range_deletes == NULL) {
+			diag_set(OutOfMemory, size, "realloc",
+				 "range tombstones");
+			return -1;
+		}
+		mem->range_deletes = range_deletes;
+		mem->range_delete_capacity = capacity;
+	}
+	mem->range_deletes[mem->range_delete_count++] = stmt;
+	mem->count.rows++;
+	mem->count.bytes += tuple_size(stmt);
+	/*
+	 * All iterators must be restored to skip the deleted
+	 * statements.
+	 */
+	mem->version++;
+	return 0;
+}
+
+void
+vy_mem_commit_range_delete(struct vy_mem *mem, struct tuple *stmt)
+{
+	assert(!vy_stmt_is_refable(stmt));
+	mem->dump_lsn = MAX(mem->dump_lsn, vy_stmt_lsn(stmt));
+	mem->version++;
+}
+
+void
+vy_mem_rollback_range_delete(struct vy_mem *mem, struct tuple *stmt)
+{
+	assert(!vy_stmt_is_refable(stmt));
+	for (int i = mem->range_delete_count - 1; i >= 0; i--) {
+		if (mem->range_deletes[i] != stmt)
+			continue;
+		memmove(&mem->range_deletes[i], &mem->range_deletes[i + 1],
+			(mem->range_delete_count - i - 1) *
+			sizeof(*mem->range_deletes));
+		mem->range_delete_count--;
+		/* We can't free memory in case of rollback. */
+		mem->count.rows--;
+		mem->version++;
+		return;
+	}
+	unreachable();
+}
+
 /* }}} vy_mem */
 
 /* {{{ vy_mem_iterator support functions */
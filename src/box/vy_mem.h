@@ -179,6 +179,18 @@ struct vy_mem {
 	 * disk. See vy_deferred_delete_on_replace() for more details.
 	 */
 	int64_t dump_lsn;
+	/**
+	 * Range tombstones inserted into this in-memory tree,
+	 * see vy_stmt_new_delete_range(). Allocated with lsregion
+	 * like statements stored in the tree. Since range deletes
+	 * are rare, they are stored in a plain array and looked
+	 * up with linear search.
+	 */
+	struct tuple **range_deletes;
+	/** Number of entries in the range_deletes array. */
+	int range_delete_count;
+	/** Capacity of the range_deletes array. */
+	int range_delete_capacity;
 	/**
 	 * Key definition for this index, extended with primary
 	 * key parts.
@@ -301,6 +313,36 @@ vy_mem_insert(struct vy_mem *mem, struct vy_entry entry);
 int
 vy_mem_insert_upsert(struct vy_mem *mem, struct vy_entry entry);
 
+/**
+ * Insert a range tombstone into the in-memory level.
+ * @param mem        vy_mem.
+ * @param stmt       DELETE_RANGE statement allocated with lsregion.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+vy_mem_insert_range_delete(struct vy_mem *mem, struct tuple *stmt);
+
+/**
+ * Confirm insertion of a range tombstone into the in-memory level.
+ */
+void
+vy_mem_commit_range_delete(struct vy_mem *mem, struct tuple *stmt);
+
+/**
+ * Remove a range tombstone from the in-memory level.
+ */
+void
+vy_mem_rollback_range_delete(struct vy_mem *mem, struct tuple *stmt);
+
+/** Return true if the in-memory level doesn't store anything. */
+static inline bool
+vy_mem_is_empty(struct vy_mem *mem)
+{
+	return mem->tree.size == 0 && mem->range_delete_count == 0;
+}
+
 /**
  * Confirm insertion of a statement into the in-memory level.
  * @param mem        vy_mem.
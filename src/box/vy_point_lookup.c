@@ -38,6 +38,7 @@
 #include <small/rlist.h>
 
 #include "fiber.h"
+#include "tuple_bloom.h"
 
 #include "vy_lsm.h"
 #include "vy_stmt.h"
@@ -127,15 +128,34 @@ vy_point_lookup_scan_mems(struct vy_lsm *lsm, const struct vy_read_view **rv,
 	return 0;
 }
 
+/**
+ * Return true if a bloom filter can be checked with hashes
+ * calculated by vy_bloom_hash().
+ */
+static inline bool
+vy_point_lookup_can_check_bloom(const struct tuple_bloom *bloom)
+{
+	return bloom != NULL && !bloom->is_legacy;
+}
+
 /**
  * Scan one particular slice.
  * Add found statements to the history list up to terminal statement.
+ * @hashes are the key hashes calculated by vy_bloom_hash().
  */
 static int
 vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
 			   const struct vy_read_view **rv, struct vy_entry key,
+			   const uint32_t *hashes, uint32_t hash_count,
 			   struct vy_history *history)
 {
+	struct tuple_bloom *bloom = slice->run->info.bloom;
+	bool bloom_checked = vy_point_lookup_can_check_bloom(bloom);
+	if (bloom_checked &&
+	    !tuple_bloom_maybe_has_hashes(bloom, hashes, hash_count)) {
+		lsm->stat.disk.iterator.bloom_hit++;
+		return 0;
+	}
 	/*
 	 * The format of the statement must be exactly the space
 	 * format with the same identifier to fully match the
@@ -145,6 +165,7 @@ vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
 	vy_run_iterator_open(&run_itr, &lsm->stat.disk.iterator, slice,
 			     ITER_EQ, key, rv, lsm->cmp_def, lsm->key_def,
 			     lsm->disk_format);
+	run_itr.bloom_checked = bloom_checked;
 	struct vy_history slice_history;
 	vy_history_create(&slice_history, &lsm->env->history_node_pool);
 	int rc = vy_run_iterator_next(&run_itr, &slice_history);
@@ -158,6 +179,11 @@ vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
  * Add found statements to the history list up to terminal statement.
  * All slices are pinned before first slice scan, so it's guaranteed
  * that complete history from runs will be extracted.
+ *
+ * Bloom filters of all slices are checked in a batch before
+ * scanning: the key is hashed only once and memory accesses
+ * to bloom filters of different runs are overlapped thanks to
+ * prefetching.
  */
 static int
 vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
@@ -175,6 +201,13 @@ vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
 		diag_set(OutOfMemory, size, "region_alloc_array", "slices");
 		return -1;
 	}
+	uint32_t *hashes = region_alloc_array(&fiber()->gc, typeof(hashes[0]),
+					      lsm->key_def->part_count, &size);
+	if (hashes == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "hashes");
+		return -1;
+	}
+	uint32_t hash_count = vy_bloom_hash(key, lsm->key_def, hashes);
 	int i = 0;
 	struct vy_slice *slice;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
@@ -182,11 +215,17 @@ vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
 		slices[i++] = slice;
 	}
 	assert(i == slice_count);
+	for (i = 0; i < slice_count; i++) {
+		struct tuple_bloom *bloom = slices[i]->run->info.bloom;
+		if (vy_point_lookup_can_check_bloom(bloom))
+			tuple_bloom_prefetch(bloom, hashes, hash_count);
+	}
 	int rc = 0;
 	for (i = 0; i < slice_count; i++) {
 		if (rc == 0 && !vy_history_is_terminal(history))
-			rc = vy_point_lookup_scan_slice(lsm, slices[i],
-							rv, key, history);
+			rc = vy_point_lookup_scan_slice(lsm, slices[i], rv, key,
+							hashes, hash_count,
+							history);
 		vy_slice_unpin(slices[i]);
 	}
 	return rc;
@@ -214,9 +253,20 @@ vy_point_lookup(struct vy_lsm *lsm, struct vy_tx *tx,
 	if (rc != 0 || vy_history_is_terminal(&history))
 		goto done;
 
-	rc = vy_point_lookup_scan_cache(lsm, rv, key, &history);
-	if (rc != 0 || vy_history_is_terminal(&history))
+	/*
+	 * The cache may store a statement deleted by a range tombstone
+	 * written by the transaction itself or committed to a read view
+	 * newer than this one so don't use it if the key is covered.
+	 */
+	int64_t range_delete_lsn = vy_tx_range_delete_lsn(tx, lsm, (*rv)->vlsn,
+							  key.stmt);
+	if (range_delete_lsn == INT64_MAX)
 		goto done;
+	if (range_delete_lsn < 0) {
+		rc = vy_point_lookup_scan_cache(lsm, rv, key, &history);
+		if (rc != 0 || vy_history_is_terminal(&history))
+			goto done;
+	}
 
 restart:
 	rc = vy_point_lookup_scan_mems(lsm, rv, key, &mem_history);
@@ -279,6 +329,17 @@ restart:
 	}
 
 done:
+	/*
+	 * Drop statements deleted by range tombstones. Note, a new
+	 * tombstone could have been committed while we were reading
+	 * disk so we have to look them up again.
+	 */
+	if (rc == 0) {
+		range_delete_lsn = vy_tx_range_delete_lsn(tx, lsm, (*rv)->vlsn,
+							  key.stmt);
+		vy_history_cut(&mem_history, range_delete_lsn);
+		vy_history_cut(&disk_history, range_delete_lsn);
+	}
 	vy_history_splice(&history, &mem_history);
 	vy_history_splice(&history, &disk_history);
 
@@ -306,6 +367,16 @@ vy_point_lookup_mem(struct vy_lsm *lsm, const struct vy_read_view **rv,
 	struct vy_history history;
 	vy_history_create(&history, &lsm->env->history_node_pool);
 
+	/*
+	 * If the key is covered by a range tombstone, statements
+	 * stored on disk may be deleted, too. Don't bother looking
+	 * it up in memory then.
+	 */
+	if (vy_tx_range_delete_lsn(NULL, lsm, (*rv)->vlsn, key.stmt) >= 0) {
+		*ret = vy_entry_none();
+		return 0;
+	}
+
 	rc = vy_point_lookup_scan_cache(lsm, rv, key, &history);
 	if (rc != 0 || vy_history_is_terminal(&history))
 		goto done;
@@ -280,6 +280,13 @@ vy_range_remove_slice(struct vy_range *range, struct vy_slice *slice)
  * compaction is relatively cheap, because of the level size
  * ratio.
  *
+ * With the leveled compaction policy, each level may store at most
+ * one run, i.e. as soon as a run is pushed down to a level that is
+ * already occupied, the two runs are merged along with all runs from
+ * the upper levels. This bounds the number of runs a lookup has to
+ * check by the number of levels at the cost of higher write
+ * amplification.
+ *
  * Given a range, this function computes the maximal level that needs
  * to be compacted and sets @compaction_priority to the number of runs
  * in this level and all preceding levels.
@@ -400,8 +407,16 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		 * value of rand() from the slice creation time.
 		 */
 		uint32_t max_run_count = opts->run_count_per_level;
-		if (slice->seed < RAND_MAX / 10)
+		if (opts->compaction_policy == VY_COMPACTION_POLICY_LEVELED) {
+			/*
+			 * Randomization is disabled for the leveled
+			 * policy, because it would break the bound
+			 * on the number of runs per level.
+			 */
+			max_run_count = 1;
+		} else if (slice->seed < RAND_MAX / 10) {
 			max_run_count++;
+		}
 		if (level_run_count > max_run_count) {
 			/*
 			 * The number of runs at the current level
@@ -748,11 +748,14 @@ vy_read_iterator_next_range(struct vy_read_iterator *itr)
 
 /**
  * Get a resultant statement for the current key.
+ * If all statements of the current key were deleted by a range
+ * tombstone, @ret is set to none while @deleted is set to the
+ * newest of them so that the caller can skip the key.
  * Returns 0 on success, -1 on error.
  */
 static NODISCARD int
 vy_read_iterator_apply_history(struct vy_read_iterator *itr,
-			       struct vy_entry *ret)
+			       struct vy_entry *ret, struct vy_entry *deleted)
 {
 	struct vy_lsm *lsm = itr->lsm;
 	struct vy_history history;
@@ -767,6 +770,30 @@ vy_read_iterator_apply_history(struct vy_read_iterator *itr,
 		}
 	}
 
+	*deleted = vy_entry_none();
+	struct vy_entry newest = vy_history_last_stmt(&history);
+	if (newest.stmt != NULL) {
+		int64_t range_delete_lsn = vy_tx_range_delete_lsn(
+				itr->tx, lsm, (**itr->read_view).vlsn,
+				newest.stmt);
+		if (vy_stmt_lsn(newest.stmt) < range_delete_lsn) {
+			*ret = vy_entry_none();
+			if (vy_stmt_is_refable(newest.stmt)) {
+				tuple_ref(newest.stmt);
+			} else {
+				newest.stmt = vy_stmt_dup(newest.stmt);
+				if (newest.stmt == NULL) {
+					vy_history_cleanup(&history);
+					return -1;
+				}
+			}
+			*deleted = newest;
+			vy_history_cleanup(&history);
+			return 0;
+		}
+		vy_history_cut(&history, range_delete_lsn);
+	}
+
 	int upserts_applied = 0;
 	int rc = vy_history_apply(&history, lsm->cmp_def,
 				  true, &upserts_applied, ret);
@@ -808,12 +835,31 @@ vy_read_iterator_next(struct vy_read_iterator *itr, struct vy_entry *result)
 {
 	assert(itr->tx == NULL || itr->tx->state == VINYL_TX_READY);
 
-	struct vy_entry entry;
+	struct vy_entry entry, deleted;
 next_key:
 	if (vy_read_iterator_advance(itr) != 0)
 		return -1;
-	if (vy_read_iterator_apply_history(itr, &entry) != 0)
+	if (vy_read_iterator_apply_history(itr, &entry, &deleted) != 0)
 		return -1;
+	if (deleted.stmt != NULL) {
+		/*
+		 * The key was deleted by a range tombstone. Skip it
+		 * like a DELETE. The tombstone may be written by this
+		 * transaction and hence the key may still be present
+		 * in the cache so break the cache chain.
+		 */
+		if (vy_read_iterator_track_read(itr, deleted) != 0) {
+			tuple_unref(deleted.stmt);
+			return -1;
+		}
+		if (itr->last.stmt != NULL)
+			tuple_unref(itr->last.stmt);
+		itr->last = deleted;
+		if (itr->last_cached.stmt != NULL)
+			tuple_unref(itr->last_cached.stmt);
+		itr->last_cached = vy_entry_none();
+		goto next_key;
+	}
 	if (vy_read_iterator_track_read(itr, entry) != 0)
 		return -1;
 
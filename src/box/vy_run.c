@@ -31,6 +31,7 @@
 #include "vy_run.h"
 
 #include <zstd.h>
+#include <zdict.h>
 
 #include "fiber.h"
 #include "fiber_cond.h"
@@ -74,6 +75,17 @@ const char *vy_file_suffix[] = {
 /* sync run and index files very 16 MB */
 #define VY_RUN_SYNC_INTERVAL (1 << 24)
 
+enum {
+	/** Max size of a compression dictionary. */
+	VY_ZDICT_SIZE_MAX = 16 * 1024,
+	/** Max total size of samples used for training a dictionary. */
+	VY_ZDICT_SAMPLES_SIZE_MAX = 1024 * 1024,
+	/** Samples bigger than this are truncated. */
+	VY_ZDICT_SAMPLE_SIZE_MAX = 4096,
+	/** Min number of samples required to train a dictionary. */
+	VY_ZDICT_SAMPLE_COUNT_MIN = 16,
+};
+
 /**
  * We read runs in background threads so as not to stall tx.
  * This structure represents such a thread.
@@ -283,6 +295,7 @@ vy_run_new(struct vy_run_env *env, int64_t id)
 	run->env = env;
 	run->id = id;
 	run->dump_lsn = -1;
+	run->range_delete_lsn = -1;
 	run->fd = -1;
 	run->refs = 1;
 	rlist_create(&run->in_lsm);
@@ -290,6 +303,142 @@ vy_run_new(struct vy_run_env *env, int64_t id)
 	return run;
 }
 
+/* {{{ vy_zdict */
+
+struct vy_zdict *
+vy_zdict_new(const char *data, size_t size)
+{
+	struct vy_zdict *zdict = malloc(sizeof(*zdict));
+	if (zdict == NULL) {
+		diag_set(OutOfMemory, sizeof(*zdict), "malloc",
+			 "struct vy_zdict");
+		return NULL;
+	}
+	zdict->data = malloc(size);
+	if (zdict->data == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "zstd dictionary");
+		free(zdict);
+		return NULL;
+	}
+	memcpy(zdict->data, data, size);
+	zdict->size = size;
+	zdict->ddict = ZSTD_createDDict_byReference(zdict->data, size);
+	if (zdict->ddict == NULL) {
+		diag_set(OutOfMemory, size, "ZSTD_createDDict",
+			 "zstd dictionary");
+		free(zdict->data);
+		free(zdict);
+		return NULL;
+	}
+	zdict->id = ZSTD_getDictID_fromDDict(zdict->ddict);
+	zdict->cdict = NULL;
+	zdict->refs = 1;
+	return zdict;
+}
+
+void
+vy_zdict_delete(struct vy_zdict *zdict)
+{
+	assert(zdict->refs == 0);
+	ZSTD_freeCDict(zdict->cdict);
+	ZSTD_freeDDict(zdict->ddict);
+	free(zdict->data);
+	TRASH(zdict);
+	free(zdict);
+}
+
+int
+vy_zdict_create_cdict(struct vy_zdict *zdict)
+{
+	if (zdict->cdict != NULL)
+		return 0;
+	zdict->cdict = ZSTD_createCDict_byReference(
+		zdict->data, zdict->size, XLOG_ZSTD_COMPRESSION_LEVEL);
+	if (zdict->cdict == NULL) {
+		diag_set(OutOfMemory, zdict->size, "ZSTD_createCDict",
+			 "zstd dictionary");
+		return -1;
+	}
+	return 0;
+}
+
+bool
+vy_zdict_equal(const struct vy_zdict *a, const struct vy_zdict *b)
+{
+	return a->id == b->id && a->size == b->size &&
+	       memcmp(a->data, b->data, a->size) == 0;
+}
+
+void
+vy_zdict_sampler_create(struct vy_zdict_sampler *sampler)
+{
+	ibuf_create(&sampler->data, &cord()->slabc, VY_ZDICT_SAMPLES_SIZE_MAX);
+	ibuf_create(&sampler->sizes, &cord()->slabc, 1024 * sizeof(size_t));
+}
+
+void
+vy_zdict_sampler_destroy(struct vy_zdict_sampler *sampler)
+{
+	ibuf_destroy(&sampler->data);
+	ibuf_destroy(&sampler->sizes);
+}
+
+/**
+ * Add a sample unless the total size of collected samples
+ * reached the limit. Returns 0 on success, -1 on OOM.
+ */
+static int
+vy_zdict_sampler_add(struct vy_zdict_sampler *sampler,
+		     const char *data, size_t size)
+{
+	size = MIN(size, (size_t)VY_ZDICT_SAMPLE_SIZE_MAX);
+	if (ibuf_used(&sampler->data) + size > VY_ZDICT_SAMPLES_SIZE_MAX)
+		return 0;
+	size_t *sample_size = ibuf_alloc(&sampler->sizes, sizeof(size_t));
+	char *sample = ibuf_alloc(&sampler->data, size);
+	if (sample_size == NULL || sample == NULL) {
+		diag_set(OutOfMemory, size, "ibuf", "zstd dictionary sample");
+		return -1;
+	}
+	*sample_size = size;
+	memcpy(sample, data, size);
+	return 0;
+}
+
+struct vy_zdict *
+vy_zdict_sampler_train(struct vy_zdict_sampler *sampler)
+{
+	unsigned count = ibuf_used(&sampler->sizes) / sizeof(size_t);
+	if (count < VY_ZDICT_SAMPLE_COUNT_MIN) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 "not enough samples to train a dictionary");
+		return NULL;
+	}
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	char *buf = region_alloc(region, VY_ZDICT_SIZE_MAX);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, VY_ZDICT_SIZE_MAX, "region",
+			 "zstd dictionary");
+		return NULL;
+	}
+	struct vy_zdict *zdict = NULL;
+	size_t size = ZDICT_trainFromBuffer(buf, VY_ZDICT_SIZE_MAX,
+					    sampler->data.rpos,
+					    (size_t *)sampler->sizes.rpos,
+					    count);
+	if (ZDICT_isError(size)) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 ZDICT_getErrorName(size));
+	} else {
+		zdict = vy_zdict_new(buf, size);
+	}
+	region_truncate(region, region_svp);
+	return zdict;
+}
+
+/* }}} vy_zdict */
+
 static void
 vy_run_clear(struct vy_run *run)
 {
@@ -306,6 +455,17 @@ vy_run_clear(struct vy_run *run)
 		tuple_bloom_delete(run->info.bloom);
 		run->info.bloom = NULL;
 	}
+	if (run->info.zdict != NULL) {
+		vy_zdict_unref(run->info.zdict);
+		run->info.zdict = NULL;
+	}
+	for (int i = 0; i < run->info.blob_count; i++) {
+		if (run->info.blobs[i].blob != NULL)
+			vy_blob_unref(run->info.blobs[i].blob);
+	}
+	free(run->info.blobs);
+	run->info.blobs = NULL;
+	run->info.blob_count = 0;
 	free(run->info.min_key);
 	run->info.min_key = NULL;
 	free(run->info.max_key);
@@ -623,6 +783,63 @@ vy_stmt_stat_decode(struct vy_stmt_stat *stat, const char **data)
 	}
 }
 
+/**
+ * Account a payload stored in a value log file to a run.
+ * Returns 0 on success, -1 on OOM.
+ */
+static int
+vy_run_info_acct_blob(struct vy_run_info *run_info, int64_t blob_id,
+		      uint64_t size)
+{
+	for (int i = 0; i < run_info->blob_count; i++) {
+		if (run_info->blobs[i].id == blob_id) {
+			run_info->blobs[i].size += size;
+			return 0;
+		}
+	}
+	size_t alloc_size = (run_info->blob_count + 1) *
+			    sizeof(*run_info->blobs);
+	struct vy_run_blob *blobs = realloc(run_info->blobs, alloc_size);
+	if (blobs == NULL) {
+		diag_set(OutOfMemory, alloc_size, "realloc",
+			 "struct vy_run_blob");
+		return -1;
+	}
+	struct vy_run_blob *entry = &blobs[run_info->blob_count++];
+	entry->id = blob_id;
+	entry->size = size;
+	entry->blob = NULL;
+	run_info->blobs = blobs;
+	return 0;
+}
+
+/**
+ * Decode the map of value log files a run refers to.
+ */
+static int
+vy_run_info_decode_blobs(struct vy_run_info *run_info, const char **pos,
+			 const char *filename)
+{
+	if (mp_typeof(**pos) != MP_MAP)
+		goto error;
+	uint32_t count = mp_decode_map(pos);
+	for (uint32_t i = 0; i < count; i++) {
+		if (mp_typeof(**pos) != MP_UINT)
+			goto error;
+		int64_t id = mp_decode_uint(pos);
+		if (mp_typeof(**pos) != MP_UINT)
+			goto error;
+		uint64_t size = mp_decode_uint(pos);
+		if (vy_run_info_acct_blob(run_info, id, size) != 0)
+			return -1;
+	}
+	return 0;
+error:
+	diag_set(ClientError, ER_INVALID_INDEX_FILE, filename,
+		 "Can't decode run info: invalid blob ids");
+	return -1;
+}
+
 /**
  * Decode the run metadata from xrow.
  *
@@ -646,6 +863,7 @@ vy_run_info_decode(struct vy_run_info *run_info,
 	uint32_t map_size = mp_decode_map(&pos);
 	uint32_t map_item;
 	const char *tmp;
+	uint32_t len;
 	/* decode run values */
 	for (map_item = 0; map_item < map_size; ++map_item) {
 		uint32_t key = mp_decode_uint(&pos);
@@ -680,13 +898,31 @@ vy_run_info_decode(struct vy_run_info *run_info,
 				return -1;
 			break;
 		case VY_RUN_INFO_BLOOM:
-			run_info->bloom = tuple_bloom_decode(&pos);
+			run_info->bloom = tuple_bloom_decode(&pos,
+							     BLOOM_CLASSIC);
+			if (run_info->bloom == NULL)
+				return -1;
+			break;
+		case VY_RUN_INFO_BLOOM_SPLIT_BLOCK:
+			run_info->bloom = tuple_bloom_decode(&pos,
+							     BLOOM_SPLIT_BLOCK);
 			if (run_info->bloom == NULL)
 				return -1;
 			break;
 		case VY_RUN_INFO_STMT_STAT:
 			vy_stmt_stat_decode(&run_info->stmt_stat, &pos);
 			break;
+		case VY_RUN_INFO_ZDICT:
+			tmp = mp_decode_bin(&pos, &len);
+			run_info->zdict = vy_zdict_new(tmp, len);
+			if (run_info->zdict == NULL)
+				return -1;
+			break;
+		case VY_RUN_INFO_BLOB_IDS:
+			if (vy_run_info_decode_blobs(run_info, &pos,
+						     filename) != 0)
+				return -1;
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -925,7 +1161,10 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 	const char *data_end = data + readen;
 	char *rows = page->data;
 	char *rows_end = rows + page_info->unpacked_size;
-	if (xlog_tx_decode(data, data_end, rows, rows_end, zdctx) != 0)
+	const ZSTD_DDict *zddict = run->info.zdict != NULL ?
+				  run->info.zdict->ddict : NULL;
+	if (xlog_tx_decode(data, data_end, rows, rows_end,
+			   zdctx, zddict) != 0)
 		goto error;
 
 	struct xrow_header xrow;
@@ -1352,7 +1591,8 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 	/* Check the bloom filter on the first iteration. */
 	bool check_bloom = (itr->iterator_type == ITER_EQ &&
 			    itr->curr.stmt == NULL && bloom != NULL);
-	if (check_bloom && !vy_bloom_maybe_has(bloom, itr->key, itr->key_def)) {
+	if (check_bloom && !itr->bloom_checked &&
+	    !vy_bloom_maybe_has(bloom, itr->key, itr->key_def)) {
 		vy_run_iterator_stop(itr);
 		itr->stat->bloom_hit++;
 		return 0;
@@ -1484,6 +1724,7 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->curr_page = NULL;
 	itr->prev_page = NULL;
 	itr->search_started = false;
+	itr->bloom_checked = false;
 
 	/*
 	 * Make sure the format we use to create tuples won't
@@ -1581,6 +1822,88 @@ next:
 	return 0;
 }
 
+/** Task that loads a payload from a value log file. */
+struct vy_blob_read_task {
+	/** parent */
+	struct cbus_call_msg base;
+	/** vinyl run environment */
+	struct vy_run_env *env;
+	/** value log file to read from */
+	struct vy_blob *blob;
+	/** reference to the payload */
+	struct vy_blob_ref ref;
+	/** [out] buffer storing the payload */
+	char *buf;
+	/** [out] payload */
+	const char *data;
+	const char *data_end;
+};
+
+/**
+ * Value log read task callback.
+ */
+static int
+vy_blob_read_cb(struct cbus_call_msg *base)
+{
+	struct vy_blob_read_task *task = (struct vy_blob_read_task *)base;
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(task->env);
+	if (zdctx == NULL)
+		return -1;
+	return vy_blob_read(task->blob, &task->ref, zdctx, &task->buf,
+			    &task->data, &task->data_end);
+}
+
+/**
+ * Append a statement to a read history. If the statement refers
+ * to a value log file, load the payload in a reader thread and
+ * append the full statement instead.
+ */
+static NODISCARD int
+vy_run_iterator_append_stmt(struct vy_run_iterator *itr,
+			    struct vy_history *history, struct vy_entry entry)
+{
+	if ((vy_stmt_flags(entry.stmt) & VY_STMT_BLOB_REF) == 0)
+		return vy_history_append_stmt(history, entry);
+
+	struct vy_run *run = itr->slice->run;
+	struct vy_blob_read_task task;
+	memset(&task, 0, sizeof(task));
+	task.env = run->env;
+	if (vy_stmt_blob_ref(entry.stmt, &task.ref) != 0)
+		return -1;
+	for (int i = 0; i < run->info.blob_count; i++) {
+		if (run->info.blobs[i].id == task.ref.blob_id)
+			task.blob = run->info.blobs[i].blob;
+	}
+	if (task.blob == NULL) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Blob %lld not found",
+				    (long long)task.ref.blob_id));
+		return -1;
+	}
+	/*
+	 * The value log file is referenced by the run, which
+	 * is pinned by the caller while we are reading it.
+	 */
+	int rc = vy_run_env_coio_call(run->env, &task.base, vy_blob_read_cb);
+	if (rc != 0) {
+		free(task.buf);
+		return -1;
+	}
+	struct vy_entry full;
+	full.hint = entry.hint;
+	full.stmt = vy_stmt_new_from_blob(itr->format, entry.stmt,
+					  task.data, task.data_end);
+	free(task.buf);
+	if (full.stmt == NULL)
+		return -1;
+	itr->stat->read.bytes += task.ref.unpacked_size;
+	itr->stat->read.bytes_compressed += task.ref.size;
+	rc = vy_history_append_stmt(history, full);
+	tuple_unref(full.stmt);
+	return rc;
+}
+
 NODISCARD int
 vy_run_iterator_next(struct vy_run_iterator *itr,
 		     struct vy_history *history)
@@ -1590,7 +1913,7 @@ vy_run_iterator_next(struct vy_run_iterator *itr,
 	if (vy_run_iterator_next_key(itr, &entry) != 0)
 		return -1;
 	while (entry.stmt != NULL) {
-		if (vy_history_append_stmt(history, entry) != 0)
+		if (vy_run_iterator_append_stmt(itr, history, entry) != 0)
 			return -1;
 		if (vy_history_is_terminal(history))
 			break;
@@ -1622,7 +1945,7 @@ vy_run_iterator_skip(struct vy_run_iterator *itr, struct vy_entry last,
 		return -1;
 
 	while (entry.stmt != NULL) {
-		if (vy_history_append_stmt(history, entry) != 0)
+		if (vy_run_iterator_append_stmt(itr, history, entry) != 0)
 			return -1;
 		if (vy_history_is_terminal(history))
 			break;
@@ -1991,6 +2314,10 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	uint32_t key_count = 6;
 	if (run_info->bloom != NULL)
 		key_count++;
+	if (run_info->zdict != NULL)
+		key_count++;
+	if (run_info->blob_count > 0)
+		key_count++;
 
 	size_t size = mp_sizeof_map(key_count);
 	size += mp_sizeof_uint(VY_RUN_INFO_MIN_KEY) + min_key_size;
@@ -2006,6 +2333,17 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 			tuple_bloom_size(run_info->bloom);
 	size += mp_sizeof_uint(VY_RUN_INFO_STMT_STAT) +
 		vy_stmt_stat_sizeof(&run_info->stmt_stat);
+	if (run_info->zdict != NULL)
+		size += mp_sizeof_uint(VY_RUN_INFO_ZDICT) +
+			mp_sizeof_bin(run_info->zdict->size);
+	if (run_info->blob_count > 0) {
+		size += mp_sizeof_uint(VY_RUN_INFO_BLOB_IDS) +
+			mp_sizeof_map(run_info->blob_count);
+		for (int i = 0; i < run_info->blob_count; i++) {
+			size += mp_sizeof_uint(run_info->blobs[i].id) +
+				mp_sizeof_uint(run_info->blobs[i].size);
+		}
+	}
 
 	char *pos = region_alloc(&fiber()->gc, size);
 	if (pos == NULL) {
@@ -2029,11 +2367,32 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	pos = mp_encode_uint(pos, VY_RUN_INFO_PAGE_COUNT);
 	pos = mp_encode_uint(pos, run_info->page_count);
 	if (run_info->bloom != NULL) {
-		pos = mp_encode_uint(pos, VY_RUN_INFO_BLOOM);
+		/*
+		 * Split block bloom filters are stored under a separate
+		 * key so that older versions, which don't know about
+		 * them, simply ignore them.
+		 */
+		pos = mp_encode_uint(pos,
+				     run_info->bloom->type == BLOOM_SPLIT_BLOCK ?
+				     VY_RUN_INFO_BLOOM_SPLIT_BLOCK :
+				     VY_RUN_INFO_BLOOM);
 		pos = tuple_bloom_encode(run_info->bloom, pos);
 	}
 	pos = mp_encode_uint(pos, VY_RUN_INFO_STMT_STAT);
 	pos = vy_stmt_stat_encode(&run_info->stmt_stat, pos);
+	if (run_info->zdict != NULL) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_ZDICT);
+		pos = mp_encode_bin(pos, run_info->zdict->data,
+				    run_info->zdict->size);
+	}
+	if (run_info->blob_count > 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_BLOB_IDS);
+		pos = mp_encode_map(pos, run_info->blob_count);
+		for (int i = 0; i < run_info->blob_count; i++) {
+			pos = mp_encode_uint(pos, run_info->blobs[i].id);
+			pos = mp_encode_uint(pos, run_info->blobs[i].size);
+		}
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 	xrow->type = VY_INDEX_RUN_INFO;
@@ -2113,7 +2472,8 @@ int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression)
+		     uint64_t page_size, double bloom_fpr,
+		     enum bloom_type bloom_type, bool no_compression)
 {
 	memset(writer, 0, sizeof(*writer));
 	writer->run = run;
@@ -2124,6 +2484,7 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 	writer->key_def = key_def;
 	writer->page_size = page_size;
 	writer->bloom_fpr = bloom_fpr;
+	writer->bloom_type = bloom_type;
 	writer->no_compression = no_compression;
 	if (bloom_fpr < 1) {
 		writer->bloom = tuple_bloom_builder_new(key_def->part_count);
@@ -2131,6 +2492,8 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 			return -1;
 	}
 	xlog_clear(&writer->data_xlog);
+	vy_blob_writer_create(&writer->blob_writer, dirpath, space_id, iid,
+			      run->id, run->env->snap_io_rate_limit);
 	ibuf_create(&writer->row_index_buf, &cord()->slabc,
 		    4096 * sizeof(uint32_t));
 	run->info.min_lsn = INT64_MAX;
@@ -2161,6 +2524,11 @@ vy_run_writer_create_xlog(struct vy_run_writer *writer)
 	opts.rate_limit = writer->run->env->snap_io_rate_limit;
 	opts.sync_interval = VY_RUN_SYNC_INTERVAL;
 	opts.no_compression = writer->no_compression;
+	struct vy_zdict *zdict = writer->run->info.zdict;
+	if (!writer->no_compression && zdict != NULL) {
+		assert(zdict->cdict != NULL);
+		opts.zdict = zdict->cdict;
+	}
 	if (xlog_create(&writer->data_xlog, path, 0, &meta, &opts) != 0)
 		return -1;
 	return 0;
@@ -2218,6 +2586,14 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 	if (writer->bloom != NULL &&
 	    vy_bloom_builder_add(writer->bloom, entry, writer->key_def) != 0)
 		return -1;
+	if (writer->zdict_sampler != NULL &&
+	    (vy_stmt_flags(entry.stmt) & VY_STMT_BLOB_REF) == 0) {
+		uint32_t size;
+		const char *data = tuple_data_range(entry.stmt, &size);
+		if (vy_zdict_sampler_add(writer->zdict_sampler,
+					 data, size) != 0)
+			return -1;
+	}
 	if (writer->last.stmt != NULL)
 		vy_stmt_unref_if_possible(writer->last.stmt);
 	writer->last = entry;
@@ -2279,11 +2655,74 @@ vy_run_writer_end_page(struct vy_run_writer *writer)
 	return 0;
 }
 
+/**
+ * Move the payload of a statement to the value log file if it's big
+ * enough or load it back from a garbage collected value log file.
+ * Returns the statement to write in @a result. If it differs from
+ * @a entry, it must be unreferenced by the caller, even on error.
+ */
+static int
+vy_run_writer_prepare_blob(struct vy_run_writer *writer, struct vy_entry entry,
+			   struct vy_entry *result)
+{
+	*result = entry;
+	if (writer->iid != 0)
+		return 0;
+	struct tuple *orig_stmt = entry.stmt;
+	struct vy_blob_ref ref;
+	if ((vy_stmt_flags(entry.stmt) & VY_STMT_BLOB_REF) != 0) {
+		if (vy_stmt_blob_ref(entry.stmt, &ref) != 0)
+			return -1;
+		bool is_gc = false;
+		if (writer->blob_reader == NULL ||
+		    vy_blob_reader_lookup(writer->blob_reader, ref.blob_id,
+					  &is_gc) == NULL) {
+			diag_set(ClientError, ER_INVALID_RUN_FILE,
+				 tt_sprintf("Blob %lld not found",
+					    (long long)ref.blob_id));
+			return -1;
+		}
+		if (!is_gc) {
+			/* Copy the reference as is. */
+			return vy_run_info_acct_blob(&writer->run->info,
+						     ref.blob_id, ref.size);
+		}
+		if (vy_blob_reader_resolve(writer->blob_reader, entry,
+					   result) != 0)
+			return -1;
+		entry = *result;
+	}
+	enum iproto_type type = vy_stmt_type(entry.stmt);
+	if ((type != IPROTO_REPLACE && type != IPROTO_INSERT) ||
+	    writer->blob_threshold == 0 ||
+	    tuple_bsize(entry.stmt) < writer->blob_threshold)
+		return 0;
+	uint32_t size;
+	const char *data = tuple_data_range(entry.stmt, &size);
+	if (vy_blob_writer_append(&writer->blob_writer, data, data + size,
+				  &ref) != 0)
+		return -1;
+	if (vy_run_info_acct_blob(&writer->run->info,
+				  ref.blob_id, ref.size) != 0)
+		return -1;
+	struct tuple *ref_stmt = vy_stmt_new_blob_ref(entry.stmt,
+						      writer->cmp_def, &ref);
+	if (ref_stmt == NULL)
+		return -1;
+	if (entry.stmt != orig_stmt)
+		tuple_unref(entry.stmt);
+	result->stmt = ref_stmt;
+	return 0;
+}
+
 int
 vy_run_writer_append_stmt(struct vy_run_writer *writer, struct vy_entry entry)
 {
 	int rc = -1;
 	size_t region_svp = region_used(&fiber()->gc);
+	struct vy_entry orig_entry = entry;
+	if (vy_run_writer_prepare_blob(writer, orig_entry, &entry) != 0)
+		goto out;
 	if (!xlog_is_open(&writer->data_xlog) &&
 	    vy_run_writer_create_xlog(writer) != 0)
 		goto out;
@@ -2297,6 +2736,8 @@ vy_run_writer_append_stmt(struct vy_run_writer *writer, struct vy_entry entry)
 		goto out;
 	rc = 0;
 out:
+	if (entry.stmt != orig_entry.stmt)
+		tuple_unref(entry.stmt);
 	region_truncate(&fiber()->gc, region_svp);
 	return rc;
 }
@@ -2316,6 +2757,7 @@ vy_run_writer_destroy(struct vy_run_writer *writer, bool reuse_fd)
 		xlog_close(&writer->data_xlog, reuse_fd);
 	if (writer->bloom != NULL)
 		tuple_bloom_builder_delete(writer->bloom);
+	vy_blob_writer_abort(&writer->blob_writer);
 	ibuf_destroy(&writer->row_index_buf);
 }
 
@@ -2356,6 +2798,24 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 		goto out;
 	});
 
+	/*
+	 * The value log file must be durable before the run
+	 * that refers to it.
+	 */
+	struct vy_blob *blob;
+	if (vy_blob_writer_commit(&writer->blob_writer, &blob) != 0)
+		goto out;
+	if (blob != NULL) {
+		struct vy_run_blob *entry = NULL;
+		for (int i = 0; i < run->info.blob_count; i++) {
+			if (run->info.blobs[i].id == blob->id)
+				entry = &run->info.blobs[i];
+		}
+		assert(entry != NULL);
+		assert(entry->blob == NULL);
+		entry->blob = blob;
+	}
+
 	/* Sync data and link the file to the final name. */
 	if (xlog_sync(&writer->data_xlog) < 0 ||
 	    xlog_rename(&writer->data_xlog) < 0)
@@ -2363,7 +2823,8 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 
 	if (writer->bloom != NULL) {
 		run->info.bloom = tuple_bloom_new(writer->bloom,
-						  writer->bloom_fpr);
+						  writer->bloom_fpr,
+						  writer->bloom_type);
 		if (run->info.bloom == NULL)
 			goto out;
 	}
@@ -2385,6 +2846,68 @@ vy_run_writer_abort(struct vy_run_writer *writer)
 	vy_run_writer_destroy(writer, false);
 }
 
+/**
+ * Load the compression dictionary of a run from its index file.
+ * Only the run info is decoded so that the dictionary can be
+ * loaded even if the page index is broken. Sets @a zdict to NULL
+ * if the run was written without a dictionary.
+ */
+static int
+vy_run_load_zdict(const char *dir, uint32_t space_id, uint32_t iid,
+		  int64_t run_id, struct vy_zdict **zdict)
+{
+	*zdict = NULL;
+	char path[PATH_MAX];
+	vy_run_snprint_path(path, sizeof(path), dir,
+			    space_id, iid, run_id, VY_FILE_INDEX);
+	struct xlog_cursor cursor;
+	if (xlog_cursor_open(&cursor, path))
+		return -1;
+
+	int rc = -1;
+	if (strcmp(cursor.meta.filetype, XLOG_META_TYPE_INDEX) != 0) {
+		diag_set(ClientError, ER_INVALID_XLOG_TYPE,
+			 XLOG_META_TYPE_INDEX, cursor.meta.filetype);
+		goto out;
+	}
+	struct xrow_header xrow;
+	rc = xlog_cursor_next_tx(&cursor);
+	if (rc == 0)
+		rc = xlog_cursor_next_row(&cursor, &xrow);
+	if (rc != 0) {
+		if (rc > 0)
+			diag_set(ClientError, ER_INVALID_INDEX_FILE,
+				 path, "Unexpected end of file");
+		rc = -1;
+		goto out;
+	}
+	if (xrow.type != VY_INDEX_RUN_INFO) {
+		diag_set(ClientError, ER_INVALID_INDEX_FILE, path,
+			 tt_sprintf("Wrong xrow type (expected %d, got %u)",
+				    VY_INDEX_RUN_INFO, (unsigned)xrow.type));
+		rc = -1;
+		goto out;
+	}
+	const char *pos = xrow.body->iov_base;
+	uint32_t map_size = mp_decode_map(&pos);
+	for (uint32_t i = 0; i < map_size; i++) {
+		uint32_t key = mp_decode_uint(&pos);
+		if (key != VY_RUN_INFO_ZDICT) {
+			mp_next(&pos);
+			continue;
+		}
+		uint32_t len;
+		const char *data = mp_decode_bin(&pos, &len);
+		*zdict = vy_zdict_new(data, len);
+		if (*zdict == NULL)
+			rc = -1;
+		break;
+	}
+out:
+	xlog_cursor_close(&cursor, false);
+	return rc;
+}
+
 int
 vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		     uint32_t space_id, uint32_t iid,
@@ -2392,6 +2915,7 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 		     struct tuple_format *format, const struct index_opts *opts)
 {
 	assert(run->info.bloom == NULL);
+	assert(run->info.zdict == NULL);
 	assert(run->page_info == NULL);
 	struct region *region = &fiber()->gc;
 	size_t mem_used = region_used(region);
@@ -2405,6 +2929,20 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 	if (xlog_cursor_open(&cursor, path))
 		return -1;
 
+	/*
+	 * The compression dictionary is stored only in the index
+	 * file while pages compressed with it can't be decoded
+	 * without it, so try to load it from there.
+	 */
+	if (vy_run_load_zdict(dir, space_id, iid, run->id,
+			      &run->info.zdict) != 0) {
+		diag_log();
+		say_warn("failed to load compression dictionary for `%s', "
+			 "assuming it was written without one", path);
+	} else if (run->info.zdict != NULL) {
+		cursor.zddict = run->info.zdict->ddict;
+	}
+
 	int rc = 0;
 	uint32_t page_info_capacity = 0;
 
@@ -2445,6 +2983,16 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 			struct tuple *tuple = vy_stmt_decode(&xrow, format);
 			if (tuple == NULL)
 				goto close_err;
+			if ((vy_stmt_flags(tuple) & VY_STMT_BLOB_REF) != 0) {
+				struct vy_blob_ref ref;
+				if (vy_stmt_blob_ref(tuple, &ref) != 0 ||
+				    vy_run_info_acct_blob(&run->info,
+							  ref.blob_id,
+							  ref.size) != 0) {
+					tuple_unref(tuple);
+					goto close_err;
+				}
+			}
 			if (bloom_builder != NULL) {
 				struct vy_entry entry = {tuple, HINT_NONE};
 				if (vy_bloom_builder_add(bloom_builder, entry,
@@ -2511,7 +3059,8 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 
 	if (bloom_builder != NULL) {
 		run->info.bloom = tuple_bloom_new(bloom_builder,
-						  opts->bloom_fpr);
+						  opts->bloom_fpr,
+						  opts->bloom_type);
 		if (run->info.bloom == NULL)
 			goto close_err;
 		tuple_bloom_builder_delete(bloom_builder);
@@ -42,6 +42,7 @@
 #include "vy_stat.h"
 #include "index_def.h"
 #include "xlog.h"
+#include "vy_blob.h"
 
 #include "small/mempool.h"
 
@@ -51,6 +52,8 @@ extern "C" {
 
 struct vy_history;
 struct vy_run_reader;
+struct vy_blob;
+struct vy_blob_reader;
 
 /** Part of vinyl environment for run read/write */
 struct vy_run_env {
@@ -76,6 +79,113 @@ struct vy_run_env {
 	bool initial_join;
 };
 
+/** Value log file referenced by a run. */
+struct vy_run_blob {
+	/** ID of the value log file. */
+	int64_t id;
+	/** Size of payloads the run refers to in the file. */
+	uint64_t size;
+	/**
+	 * The value log file (referenced) or NULL if the run
+	 * hasn't been bound to its LSM tree yet.
+	 */
+	struct vy_blob *blob;
+};
+
+/**
+ * Zstd dictionary used for compressing run pages.
+ *
+ * A dictionary is trained on statements written by a dump
+ * and then used for compressing runs created by compaction.
+ * It's stored in the index file of each run compressed with
+ * it. The dictionary is shared by the runs and the LSM tree,
+ * see vy_lsm::zdict, and reference counted.
+ */
+struct vy_zdict {
+	/** Dictionary content. */
+	char *data;
+	/** Size of the dictionary content. */
+	size_t size;
+	/** Dictionary ID, as stored in compressed frames. */
+	uint32_t id;
+	/** Reference counter. */
+	int refs;
+	/** Digested dictionary used for decompression. */
+	ZSTD_DDict *ddict;
+	/**
+	 * Digested dictionary used for compression. Created
+	 * on demand, because it's only needed by the dictionary
+	 * the LSM tree uses for new runs while it takes much more
+	 * memory than the decompression dictionary.
+	 */
+	ZSTD_CDict *cdict;
+};
+
+/**
+ * Create a dictionary from raw content.
+ * Returns NULL and sets diag on error.
+ */
+struct vy_zdict *
+vy_zdict_new(const char *data, size_t size);
+
+/** Free a dictionary. Must only be called by vy_zdict_unref(). */
+void
+vy_zdict_delete(struct vy_zdict *zdict);
+
+static inline struct vy_zdict *
+vy_zdict_ref(struct vy_zdict *zdict)
+{
+	assert(zdict->refs > 0);
+	zdict->refs++;
+	return zdict;
+}
+
+static inline void
+vy_zdict_unref(struct vy_zdict *zdict)
+{
+	assert(zdict->refs > 0);
+	if (--zdict->refs == 0)
+		vy_zdict_delete(zdict);
+}
+
+/**
+ * Create the compression dictionary if it hasn't been
+ * created yet. Returns 0 on success, -1 on OOM.
+ */
+int
+vy_zdict_create_cdict(struct vy_zdict *zdict);
+
+/**
+ * Return true if two dictionaries have the same content.
+ */
+bool
+vy_zdict_equal(const struct vy_zdict *a, const struct vy_zdict *b);
+
+/**
+ * Collects statements written to a run for training
+ * a dictionary, see vy_run_writer::zdict_sampler.
+ */
+struct vy_zdict_sampler {
+	/** Concatenated samples. */
+	struct ibuf data;
+	/** Array of sample sizes (size_t). */
+	struct ibuf sizes;
+};
+
+void
+vy_zdict_sampler_create(struct vy_zdict_sampler *sampler);
+
+void
+vy_zdict_sampler_destroy(struct vy_zdict_sampler *sampler);
+
+/**
+ * Train a dictionary on collected samples.
+ * Returns NULL and sets diag on error, including the case when
+ * there's not enough samples to train a dictionary.
+ */
+struct vy_zdict *
+vy_zdict_sampler_train(struct vy_zdict_sampler *sampler);
+
 /**
  * Run metadata. Is a written to a file as a single chunk.
  */
@@ -94,6 +204,18 @@ struct vy_run_info {
 	struct tuple_bloom *bloom;
 	/** Statement statistics. */
 	struct vy_stmt_stat stmt_stat;
+	/**
+	 * Dictionary used for compressing run pages or NULL
+	 * if the run pages were compressed without a dictionary.
+	 */
+	struct vy_zdict *zdict;
+	/**
+	 * Value log files the run refers to, see VY_STMT_BLOB_REF.
+	 * Only primary index runs may refer to value log files.
+	 */
+	struct vy_run_blob *blobs;
+	/** Number of entries in @blobs. */
+	int blob_count;
 };
 
 /**
@@ -151,6 +273,12 @@ struct vy_run {
 	 * it last time.
 	 */
 	uint32_t dump_count;
+	/**
+	 * Max LSN of range tombstones applied by the compaction that
+	 * created this run or -1. The run doesn't store statements
+	 * deleted by such tombstones. Not persistent.
+	 */
+	int64_t range_delete_lsn;
 	/**
 	 * Run reference counter, the run is deleted once it hits 0.
 	 * A new run is created with the reference counter set to 1.
@@ -175,6 +303,20 @@ struct vy_run {
 	struct rlist in_lsm;
 };
 
+/**
+ * Return the value log file written along with a run or NULL
+ * if the run doesn't have one.
+ */
+static inline struct vy_blob *
+vy_run_new_blob(struct vy_run *run)
+{
+	for (int i = 0; i < run->info.blob_count; i++) {
+		if (run->info.blobs[i].id == run->id)
+			return run->info.blobs[i].blob;
+	}
+	return NULL;
+}
+
 /**
  * Slice of a run, used to organize runs in ranges.
  */
@@ -286,6 +428,11 @@ struct vy_run_iterator {
 	struct vy_page *prev_page;
 	/** Is false until first .._get or .._next_.. method is called */
 	bool search_started;
+	/**
+	 * Set if the caller has already checked the key against
+	 * the run bloom filter, see vy_point_lookup_scan_slices().
+	 */
+	bool bloom_checked;
 };
 
 /**
@@ -390,6 +537,11 @@ vy_run_recover(struct vy_run *run, const char *dir,
 
 /**
  * Rebuild run index
+ *
+ * The compression dictionary is loaded from the run info stored
+ * in the old index file. If it can't be read, pages compressed
+ * with a dictionary can't be decoded and the rebuild fails.
+ *
  * @param run - run to rebuild index for
  * @param dir - path to the vinyl directory
  * @param space_id - space id
@@ -623,8 +775,30 @@ struct vy_run_writer {
 	struct xlog data_xlog;
 	/** Bloom filter false positive rate. */
 	double bloom_fpr;
+	/** Bloom filter type. */
+	enum bloom_type bloom_type;
 	/** Bloom filter. */
 	struct tuple_bloom_builder *bloom;
+	/**
+	 * If set, written statements are collected for training
+	 * a compression dictionary.
+	 */
+	struct vy_zdict_sampler *zdict_sampler;
+	/**
+	 * Payloads of REPLACE and INSERT statements that are equal
+	 * to or bigger than this size are written to a value log
+	 * file, see vy_blob. 0 disables the value log. Only used
+	 * for primary index runs.
+	 */
+	uint64_t blob_threshold;
+	/**
+	 * Reader of the value log files of the LSM tree. Used for
+	 * loading payloads stored in garbage collected files so
+	 * that they can be moved to the new file. May be NULL.
+	 */
+	struct vy_blob_reader *blob_reader;
+	/** Writer of the value log file created for the run. */
+	struct vy_blob_writer blob_writer;
 	/** Buffer of a current page row offsets. */
 	struct ibuf row_index_buf;
 	/**
@@ -639,7 +813,8 @@ int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression);
+		     uint64_t page_size, double bloom_fpr,
+		     enum bloom_type bloom_type, bool no_compression);
 
 /**
  * Write a specified statement into a run.
@@ -64,6 +64,12 @@
 #define VY_SCHEDULER_TIMEOUT_MIN	1
 #define VY_SCHEDULER_TIMEOUT_MAX	60
 
+/**
+ * Number of dumps after which the compression dictionary
+ * of an LSM tree is retrained, see index_opts::compression_dict.
+ */
+enum { VY_ZDICT_TRAIN_INTERVAL = 16 };
+
 static int vy_worker_f(va_list);
 static int vy_scheduler_f(va_list);
 static void vy_task_execute_f(struct cmsg *);
@@ -204,7 +210,29 @@ struct vy_task {
 	 * from another thread.
 	 */
 	double bloom_fpr;
+	enum bloom_type bloom_type;
 	int64_t page_size;
+	/** See index_opts::blob_threshold. */
+	int64_t blob_threshold;
+	/**
+	 * Reader of the value log files of the LSM tree used by
+	 * primary index compaction or NULL.
+	 */
+	struct vy_blob_reader *blob_reader;
+	/**
+	 * Set if statements written by this task should be used
+	 * for training a compression dictionary for the LSM tree.
+	 */
+	bool train_zdict;
+	/** Dictionary trained by this task, see @train_zdict. */
+	struct vy_zdict *zdict;
+	/**
+	 * Range tombstones applied by primary index compaction,
+	 * copied from vy_lsm::tombstones (referenced).
+	 */
+	struct tuple **range_deletes;
+	/** Number of entries in @range_deletes. */
+	int range_delete_count;
 	/**
 	 * Deferred DELETE handler passed to the write iterator.
 	 * It sends deferred DELETE statements generated during
@@ -273,6 +301,13 @@ vy_task_delete(struct vy_task *task)
 	assert(task->deferred_delete_in_progress == 0);
 	key_def_delete(task->cmp_def);
 	key_def_delete(task->key_def);
+	if (task->zdict != NULL)
+		vy_zdict_unref(task->zdict);
+	if (task->blob_reader != NULL)
+		vy_blob_reader_delete(task->blob_reader);
+	for (int i = 0; i < task->range_delete_count; i++)
+		tuple_unref(task->range_deletes[i]);
+	free(task->range_deletes);
 	vy_lsm_unref(task->lsm);
 	diag_destroy(&task->diag);
 	free(task);
@@ -1075,9 +1110,17 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 				 lsm->space_id, lsm->index_id,
 				 task->cmp_def, task->key_def,
 				 task->page_size, task->bloom_fpr,
-				 no_compression) != 0)
+				 task->bloom_type, no_compression) != 0)
 		goto fail;
 
+	struct vy_zdict_sampler zdict_sampler;
+	if (task->train_zdict) {
+		vy_zdict_sampler_create(&zdict_sampler);
+		writer.zdict_sampler = &zdict_sampler;
+	}
+	writer.blob_threshold = task->blob_threshold;
+	writer.blob_reader = task->blob_reader;
+
 	if (wi->iface->start(wi) != 0)
 		goto fail_abort_writer;
 	int rc;
@@ -1108,10 +1151,27 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 	if (rc != 0)
 		goto fail_abort_writer;
 
+	if (task->train_zdict) {
+		/*
+		 * The dictionary is optional so don't fail
+		 * the task if we failed to train it.
+		 */
+		task->zdict = vy_zdict_sampler_train(&zdict_sampler);
+		if (task->zdict == NULL) {
+			struct error *e = diag_last_error(diag_get());
+			say_verbose("%s: failed to train compression "
+				    "dictionary: %s", vy_lsm_name(lsm),
+				    e->errmsg);
+			diag_clear(diag_get());
+		}
+		vy_zdict_sampler_destroy(&zdict_sampler);
+	}
 	return 0;
 
 fail_abort_writer:
 	vy_run_writer_abort(&writer);
+	if (task->train_zdict)
+		vy_zdict_sampler_destroy(&zdict_sampler);
 fail:
 	return -1;
 }
@@ -1128,6 +1188,61 @@ vy_task_dump_execute(struct vy_task *task)
 	return vy_task_write_run(task, true);
 }
 
+/**
+ * Copy range tombstones stored in in-memory trees that are being
+ * dumped to the LSM tree. They must be logged on dump completion,
+ * see vy_task_dump_log_tombstones().
+ */
+static int
+vy_task_dump_add_tombstones(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_mem *mem;
+	rlist_foreach_entry(mem, &lsm->sealed, in_sealed) {
+		if (mem->generation > scheduler->dump_generation)
+			continue;
+		for (int i = 0; i < mem->range_delete_count; i++) {
+			struct tuple *stmt = vy_stmt_dup(mem->range_deletes[i]);
+			if (stmt == NULL)
+				return -1;
+			int rc = vy_lsm_add_tombstone(lsm, vy_log_next_id(),
+						      stmt);
+			tuple_unref(stmt);
+			if (rc != 0)
+				return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Log range tombstones added to the LSM tree starting from
+ * the given position in the current vylog transaction.
+ */
+static void
+vy_task_dump_log_tombstones(struct vy_lsm *lsm, int start)
+{
+	for (int i = start; i < lsm->tombstone_count; i++) {
+		struct vy_lsm_tombstone *tombstone = &lsm->tombstones[i];
+		struct tuple *stmt = tombstone->stmt;
+		vy_log_insert_tombstone(lsm->id, tombstone->id,
+					vy_stmt_lsn(stmt), tuple_data(stmt),
+					vy_stmt_range_end(stmt));
+	}
+}
+
+/**
+ * Remove range tombstones added to the LSM tree by
+ * vy_task_dump_add_tombstones() on failure.
+ */
+static void
+vy_task_dump_rollback_tombstones(struct vy_lsm *lsm, int count)
+{
+	while (lsm->tombstone_count > count)
+		tuple_unref(lsm->tombstones[--lsm->tombstone_count].stmt);
+}
+
 static int
 vy_task_dump_complete(struct vy_task *task)
 {
@@ -1141,6 +1256,7 @@ vy_task_dump_complete(struct vy_task *task)
 	struct vy_mem *mem, *next_mem;
 	struct vy_slice **new_slices, *slice;
 	struct vy_range *range, *begin_range, *end_range;
+	int tombstone_count = lsm->tombstone_count;
 	int i;
 
 	assert(lsm->is_dumping);
@@ -1152,7 +1268,10 @@ vy_task_dump_complete(struct vy_task *task)
 		 * inserting slices into ranges. However, we need
 		 * to log LSM tree dump anyway.
 		 */
+		if (vy_task_dump_add_tombstones(task) != 0)
+			goto fail;
 		vy_log_tx_begin();
+		vy_task_dump_log_tombstones(lsm, tombstone_count);
 		vy_log_dump_lsm(lsm->id, dump_lsn);
 		if (vy_log_tx_commit() < 0)
 			goto fail;
@@ -1193,7 +1312,13 @@ vy_task_dump_complete(struct vy_task *task)
 	/*
 	 * Log change in metadata.
 	 */
+	struct vy_blob *new_blob = vy_run_new_blob(new_run);
+	if (vy_task_dump_add_tombstones(task) != 0)
+		goto fail_free_slices;
 	vy_log_tx_begin();
+	vy_task_dump_log_tombstones(lsm, tombstone_count);
+	if (new_blob != NULL)
+		vy_log_create_blob(lsm->id, new_blob->id);
 	vy_log_create_run(lsm->id, new_run->id, dump_lsn, new_run->dump_count);
 	for (range = begin_range, i = 0; range != end_range;
 	     range = vy_range_tree_next(&lsm->range_tree, range), i++) {
@@ -1208,6 +1333,8 @@ vy_task_dump_complete(struct vy_task *task)
 		goto fail_free_slices;
 
 	/* Account the new run. */
+	if (new_blob != NULL)
+		vy_lsm_add_blob(lsm, new_blob);
 	vy_lsm_add_run(lsm, new_run);
 	/* Drop the reference held by the task. */
 	vy_run_unref(new_run);
@@ -1247,6 +1374,17 @@ delete_mems:
 	}
 	lsm->dump_lsn = MAX(lsm->dump_lsn, dump_lsn);
 	vy_lsm_acct_dump(lsm, dump_time, &dump_input, &dump_output);
+	vy_lsm_drop_unused_tombstones(lsm);
+	if (task->zdict != NULL) {
+		/* Use the new dictionary for compressing new runs. */
+		if (lsm->zdict != NULL)
+			vy_zdict_unref(lsm->zdict);
+		lsm->zdict = task->zdict;
+		task->zdict = NULL;
+		lsm->zdict_dump_count = 0;
+	} else {
+		lsm->zdict_dump_count++;
+	}
 	/*
 	 * Indexes of the same space share a memory level so we
 	 * account dump input only when the primary index is dumped.
@@ -1281,6 +1419,7 @@ fail_free_slices:
 	}
 	free(new_slices);
 fail:
+	vy_task_dump_rollback_tombstones(lsm, tombstone_count);
 	return -1;
 }
 
@@ -1353,7 +1492,7 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		if (mem->generation > scheduler->dump_generation)
 			continue;
 		vy_mem_wait_pinned(mem);
-		if (mem->tree.size == 0) {
+		if (vy_mem_is_empty(mem)) {
 			/*
 			 * The tree is empty so we can delete it
 			 * right away, without involving a worker.
@@ -1391,7 +1530,8 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	struct vy_stmt_stream *wi;
 	bool is_last_level = (lsm->run_count == 0);
 	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
-				   is_last_level, scheduler->read_views, NULL);
+				   is_last_level, scheduler->read_views,
+				   NULL, NULL);
 	if (wi == NULL)
 		goto err_wi;
 	rlist_foreach_entry(mem, &lsm->sealed, in_sealed) {
@@ -1404,7 +1544,13 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	task->new_run = new_run;
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
+	task->bloom_type = lsm->opts.bloom_type;
 	task->page_size = lsm->opts.page_size;
+	task->train_zdict = lsm->opts.compression_dict &&
+			    (lsm->zdict == NULL ||
+			     lsm->zdict_dump_count >= VY_ZDICT_TRAIN_INTERVAL);
+	if (lsm->index_id == 0)
+		task->blob_threshold = lsm->opts.blob_threshold;
 
 	lsm->is_dumping = true;
 	vy_scheduler_update_lsm(scheduler, lsm);
@@ -1487,6 +1633,16 @@ vy_task_compaction_complete(struct vy_task *task)
 			return -1;
 	}
 
+	/*
+	 * The new run may refer to value log files written by
+	 * older runs, look them up.
+	 */
+	if (vy_lsm_bind_run_blobs(lsm, new_run) != 0) {
+		if (new_slice != NULL)
+			vy_slice_delete(new_slice);
+		return -1;
+	}
+
 	/*
 	 * Build the list of runs that became unused
 	 * as a result of compaction.
@@ -1517,7 +1673,10 @@ vy_task_compaction_complete(struct vy_task *task)
 	}
 	rlist_foreach_entry(run, &unused_runs, in_unused)
 		vy_log_drop_run(run->id, VY_LOG_GC_LSN_CURRENT);
+	struct vy_blob *new_blob = vy_run_new_blob(new_run);
 	if (new_slice != NULL) {
+		if (new_blob != NULL)
+			vy_log_create_blob(lsm->id, new_blob->id);
 		vy_log_create_run(lsm->id, new_run->id, new_run->dump_lsn,
 				  new_run->dump_count);
 		vy_log_insert_slice(range->id, new_run->id, new_slice->id,
@@ -1552,6 +1711,13 @@ vy_task_compaction_complete(struct vy_task *task)
 	 * otherwise discard it.
 	 */
 	if (new_slice != NULL) {
+		if (new_blob != NULL)
+			vy_lsm_add_blob(lsm, new_blob);
+		for (int i = 0; i < task->range_delete_count; i++) {
+			new_run->range_delete_lsn = MAX(
+				new_run->range_delete_lsn,
+				vy_stmt_lsn(task->range_deletes[i]));
+		}
 		vy_lsm_add_run(lsm, new_run);
 		/* Drop the reference held by the task. */
 		vy_run_unref(new_run);
@@ -1600,6 +1766,8 @@ vy_task_compaction_complete(struct vy_task *task)
 		vy_slice_wait_pinned(slice);
 		vy_slice_delete(slice);
 	}
+	vy_lsm_drop_unused_blobs(lsm);
+	vy_lsm_drop_unused_tombstones(lsm);
 out:
 	/* The iterator has been cleaned up in worker. */
 	task->wi->iface->close(task->wi);
@@ -1664,14 +1832,56 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	if (new_run == NULL)
 		goto err_run;
 
+	if (lsm->opts.compression_dict && lsm->zdict != NULL) {
+		if (vy_zdict_create_cdict(lsm->zdict) != 0)
+			goto err_wi;
+		new_run->info.zdict = vy_zdict_ref(lsm->zdict);
+	}
+
+	if (!rlist_empty(&lsm->blobs)) {
+		task->blob_reader = vy_blob_reader_new(lsm->disk_format,
+						       &lsm->blobs);
+		if (task->blob_reader == NULL)
+			goto err_wi;
+	}
+
+	if (lsm->tombstone_count > 0) {
+		assert(lsm->index_id == 0);
+		size_t size = lsm->tombstone_count *
+			      sizeof(*task->range_deletes);
+		task->range_deletes = malloc(size);
+		if (task->range_deletes == NULL) {
+			diag_set(OutOfMemory, size, "malloc",
+				 "range tombstones");
+			goto err_wi;
+		}
+		for (int i = 0; i < lsm->tombstone_count; i++) {
+			struct tuple *stmt = lsm->tombstones[i].stmt;
+			tuple_ref(stmt);
+			task->range_deletes[task->range_delete_count++] = stmt;
+		}
+	}
+
 	struct vy_stmt_stream *wi;
 	bool is_last_level = (range->compaction_priority == range->slice_count);
 	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
 				   is_last_level, scheduler->read_views,
 				   lsm->index_id > 0 ? NULL :
-				   &task->deferred_delete_handler);
+				   &task->deferred_delete_handler,
+				   task->blob_reader);
 	if (wi == NULL)
 		goto err_wi;
+	if (task->range_delete_count > 0) {
+		/*
+		 * Statements deleted by range tombstones must be
+		 * deleted from secondary indexes, too.
+		 */
+		struct space *space = space_by_id(lsm->space_id);
+		bool is_deferred = space != NULL && space->index_count > 1;
+		vy_write_iterator_set_range_deletes(wi, task->range_deletes,
+						    task->range_delete_count,
+						    is_deferred);
+	}
 
 	struct vy_slice *slice;
 	int32_t dump_count = 0;
@@ -1711,7 +1921,10 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	task->new_run = new_run;
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
+	task->bloom_type = lsm->opts.bloom_type;
 	task->page_size = lsm->opts.page_size;
+	if (lsm->index_id == 0)
+		task->blob_threshold = lsm->opts.blob_threshold;
 
 	/*
 	 * Remove the range we are going to compact from the heap
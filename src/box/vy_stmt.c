@@ -45,6 +45,7 @@
 #include "tuple_format.h"
 #include "xrow.h"
 #include "fiber.h"
+#include "vy_blob.h"
 
 /**
  * Statement metadata keys.
@@ -52,6 +53,8 @@
 enum vy_stmt_meta_key {
 	/** Statement flags. */
 	VY_STMT_FLAGS = 0x01,
+	/** Value log reference, see VY_STMT_BLOB_REF. */
+	VY_STMT_BLOB = 0x02,
 };
 
 /**
@@ -70,6 +73,12 @@ vy_stmt_persistent_flags(struct tuple *stmt, bool is_primary)
 	 */
 	mask &= ~VY_STMT_UPDATE;
 
+	/*
+	 * A value log reference is stored in the statement
+	 * metadata, see vy_stmt_meta_encode().
+	 */
+	mask &= ~VY_STMT_BLOB_REF;
+
 	if (!is_primary) {
 		/*
 		 * Do not store VY_STMT_DEFERRED_DELETE flag in
@@ -390,6 +399,144 @@ vy_stmt_new_delete(struct tuple_format *format, const char *tuple_begin,
 				    NULL, 0, IPROTO_DELETE);
 }
 
+struct tuple *
+vy_stmt_new_delete_range(struct tuple_format *format,
+			 const char *begin, const char *begin_end,
+			 const char *end, const char *end_end)
+{
+	assert(vy_stmt_is_key_format(format));
+	mp_tuple_assert(end, end_end);
+	struct iovec iov;
+	iov.iov_base = (void *)end;
+	iov.iov_len = end_end - end;
+	return vy_stmt_new_with_ops(format, begin, begin_end, &iov, 1,
+				    IPROTO_DELETE_RANGE);
+}
+
+bool
+vy_stmt_range_covers(struct tuple *range, struct tuple *stmt,
+		     struct key_def *cmp_def)
+{
+	assert(vy_stmt_type(range) == IPROTO_DELETE_RANGE);
+	/*
+	 * Partial keys are compared by prefix so we can't use
+	 * hints here.
+	 */
+	if (vy_stmt_compare_with_raw_key(stmt, HINT_NONE, tuple_data(range),
+					 HINT_NONE, cmp_def) < 0)
+		return false;
+	const char *end = vy_stmt_range_end(range);
+	const char *tmp = end;
+	if (mp_decode_array(&tmp) == 0)
+		return true;
+	return vy_stmt_compare_with_raw_key(stmt, HINT_NONE, end,
+					    HINT_NONE, cmp_def) < 0;
+}
+
+int64_t
+vy_stmt_range_delete_lsn(struct tuple **ranges, int count,
+			 struct tuple *stmt, int64_t vlsn,
+			 struct key_def *cmp_def)
+{
+	int64_t lsn = -1;
+	for (int i = 0; i < count; i++) {
+		int64_t range_lsn = vy_stmt_lsn(ranges[i]);
+		if (range_lsn > vlsn || range_lsn <= lsn)
+			continue;
+		if (vy_stmt_range_covers(ranges[i], stmt, cmp_def))
+			lsn = range_lsn;
+	}
+	return lsn;
+}
+
+struct tuple *
+vy_stmt_new_range_delete_key(struct tuple *range, struct tuple *stmt,
+			     struct key_def *cmp_def)
+{
+	struct vy_stmt_env *env = tuple_format(stmt)->engine;
+	struct tuple *res;
+	if (vy_stmt_is_key(stmt)) {
+		/*
+		 * Note, a statement referring to a value log file
+		 * stores the reference after the key.
+		 */
+		const char *key = tuple_data(stmt);
+		const char *key_end = key;
+		mp_next(&key_end);
+		res = vy_stmt_new_delete(env->key_format, key, key_end);
+	} else {
+		struct region *region = &fiber()->gc;
+		size_t region_svp = region_used(region);
+		uint32_t key_size;
+		const char *key = tuple_extract_key(stmt, cmp_def,
+						    MULTIKEY_NONE, &key_size);
+		if (key == NULL)
+			return NULL;
+		res = vy_stmt_new_delete(env->key_format, key, key + key_size);
+		region_truncate(region, region_svp);
+	}
+	if (res == NULL)
+		return NULL;
+	vy_stmt_set_lsn(res, vy_stmt_lsn(range));
+	return res;
+}
+
+struct tuple *
+vy_stmt_new_blob_ref(struct tuple *stmt, struct key_def *cmp_def,
+		     const struct vy_blob_ref *ref)
+{
+	enum iproto_type type = vy_stmt_type(stmt);
+	assert(type == IPROTO_REPLACE || type == IPROTO_INSERT);
+	assert(!vy_stmt_is_key(stmt));
+	struct vy_stmt_env *env = tuple_format(stmt)->engine;
+	uint32_t key_size;
+	const char *key = tuple_extract_key(stmt, cmp_def, MULTIKEY_NONE,
+					    &key_size);
+	if (key == NULL)
+		return NULL;
+	size_t ref_size = vy_blob_ref_sizeof(ref);
+	char *ref_buf = region_alloc(&fiber()->gc, ref_size);
+	if (ref_buf == NULL) {
+		diag_set(OutOfMemory, ref_size, "region", "blob ref");
+		return NULL;
+	}
+	struct iovec iov;
+	iov.iov_base = ref_buf;
+	iov.iov_len = vy_blob_ref_encode(ref, ref_buf) - ref_buf;
+	struct tuple *res = vy_stmt_new_with_ops(env->key_format, key,
+						 key + key_size, &iov, 1,
+						 type);
+	if (res == NULL)
+		return NULL;
+	vy_stmt_set_lsn(res, vy_stmt_lsn(stmt));
+	vy_stmt_set_flags(res, vy_stmt_flags(stmt) | VY_STMT_BLOB_REF);
+	return res;
+}
+
+int
+vy_stmt_blob_ref(struct tuple *stmt, struct vy_blob_ref *ref)
+{
+	assert((vy_stmt_flags(stmt) & VY_STMT_BLOB_REF) != 0);
+	const char *data = tuple_data(stmt);
+	mp_next(&data);
+	return vy_blob_ref_decode(&data, ref);
+}
+
+struct tuple *
+vy_stmt_new_from_blob(struct tuple_format *format, struct tuple *ref_stmt,
+		      const char *data, const char *data_end)
+{
+	assert((vy_stmt_flags(ref_stmt) & VY_STMT_BLOB_REF) != 0);
+	struct tuple *res = vy_stmt_new_with_ops(format, data, data_end,
+						 NULL, 0,
+						 vy_stmt_type(ref_stmt));
+	if (res == NULL)
+		return NULL;
+	vy_stmt_set_lsn(res, vy_stmt_lsn(ref_stmt));
+	vy_stmt_set_flags(res, vy_stmt_flags(ref_stmt) & ~VY_STMT_BLOB_REF);
+	return res;
+}
+
 struct tuple *
 vy_stmt_replace_from_upsert(struct tuple *upsert)
 {
@@ -569,6 +716,24 @@ vy_bloom_maybe_has(const struct tuple_bloom *bloom,
 	}
 }
 
+uint32_t
+vy_bloom_hash(struct vy_entry entry, struct key_def *key_def,
+	      uint32_t *hashes)
+{
+	struct tuple *stmt = entry.stmt;
+	if (vy_stmt_is_key(stmt)) {
+		const char *data = tuple_data(stmt);
+		uint32_t part_count = mp_decode_array(&data);
+		tuple_bloom_hash_key(data, part_count, key_def, hashes);
+		return part_count;
+	} else {
+		tuple_bloom_hash(stmt, key_def,
+				 vy_entry_multikey_idx(entry, key_def),
+				 hashes);
+		return key_def->part_count;
+	}
+}
+
 /**
  * Encode the given statement meta data in a request.
  * Returns 0 on success, -1 on memory allocation error.
@@ -578,17 +743,34 @@ vy_stmt_meta_encode(struct tuple *stmt, struct request *request,
 		    bool is_primary)
 {
 	uint8_t flags = vy_stmt_persistent_flags(stmt, is_primary);
-	if (flags == 0)
+	/* Value log reference stored after the key, if any. */
+	const char *ref = NULL, *ref_end = NULL;
+	if ((vy_stmt_flags(stmt) & VY_STMT_BLOB_REF) != 0) {
+		assert(is_primary);
+		uint32_t bsize;
+		ref = tuple_data_range(stmt, &bsize);
+		ref_end = ref + bsize;
+		mp_next(&ref);
+	}
+	if (flags == 0 && ref == NULL)
 		return 0; /* nothing to encode */
 
-	size_t len = mp_sizeof_map(1) * 2 * mp_sizeof_uint(UINT64_MAX);
+	size_t len = mp_sizeof_map(2) + 3 * mp_sizeof_uint(UINT64_MAX) +
+		     (ref_end - ref);
 	char *buf = region_alloc(&fiber()->gc, len);
 	if (buf == NULL)
 		return -1;
 	char *pos = buf;
-	pos = mp_encode_map(pos, 1);
-	pos = mp_encode_uint(pos, VY_STMT_FLAGS);
-	pos = mp_encode_uint(pos, flags);
+	pos = mp_encode_map(pos, (flags != 0) + (ref != NULL));
+	if (flags != 0) {
+		pos = mp_encode_uint(pos, VY_STMT_FLAGS);
+		pos = mp_encode_uint(pos, flags);
+	}
+	if (ref != NULL) {
+		pos = mp_encode_uint(pos, VY_STMT_BLOB);
+		memcpy(pos, ref, ref_end - ref);
+		pos += ref_end - ref;
+	}
 	assert(pos <= buf + len);
 
 	request->tuple_meta = buf;
@@ -596,6 +778,36 @@ vy_stmt_meta_encode(struct tuple *stmt, struct request *request,
 	return 0;
 }
 
+/**
+ * Look up a value log reference in statement meta data.
+ * Returns 0 and sets @a ref and @a ref_end to the reference or
+ * NULL if there's none, -1 if the reference is malformed.
+ */
+static int
+vy_stmt_meta_find_blob(struct request *request, const char **ref,
+		       const char **ref_end)
+{
+	*ref = *ref_end = NULL;
+	const char *data = request->tuple_meta;
+	if (data == NULL)
+		return 0;
+	uint32_t size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < size; i++) {
+		uint64_t key = mp_decode_uint(&data);
+		if (key != VY_STMT_BLOB) {
+			mp_next(&data);
+			continue;
+		}
+		*ref = data;
+		struct vy_blob_ref unused;
+		if (vy_blob_ref_decode(&data, &unused) != 0)
+			return -1;
+		*ref_end = data;
+		break;
+	}
+	return 0;
+}
+
 /**
  * Decode statement meta data from a request.
  */
@@ -651,6 +863,11 @@ vy_stmt_encode_primary(struct tuple *value, struct key_def *key_def,
 	case IPROTO_REPLACE:
 		request.tuple = tuple_data_range(value, &size);
 		request.tuple_end = request.tuple + size;
+		if ((vy_stmt_flags(value) & VY_STMT_BLOB_REF) != 0) {
+			/* The value log reference goes to metadata. */
+			request.tuple_end = request.tuple;
+			mp_next(&request.tuple_end);
+		}
 		break;
 	case IPROTO_UPSERT:
 		request.tuple = vy_upsert_data_range(value, &size);
@@ -717,6 +934,7 @@ vy_stmt_decode(struct xrow_header *xrow, struct tuple_format *format)
 		return NULL;
 	struct tuple *stmt = NULL;
 	struct iovec ops;
+	const char *ref, *ref_end;
 	switch (request.type) {
 	case IPROTO_DELETE:
 		/* Always use key format for DELETE statements. */
@@ -726,6 +944,27 @@ vy_stmt_decode(struct xrow_header *xrow, struct tuple_format *format)
 		break;
 	case IPROTO_INSERT:
 	case IPROTO_REPLACE:
+		if (vy_stmt_meta_find_blob(&request, &ref, &ref_end) != 0)
+			return NULL;
+		if (ref != NULL) {
+			/*
+			 * The payload is stored in a value log file.
+			 * Store the reference after the key.
+			 */
+			ops.iov_base = (char *)ref;
+			ops.iov_len = ref_end - ref;
+			stmt = vy_stmt_new_with_ops(env->key_format,
+						    request.tuple,
+						    request.tuple_end,
+						    &ops, 1, request.type);
+			if (stmt == NULL)
+				return NULL;
+			vy_stmt_meta_decode(&request, stmt);
+			vy_stmt_set_flags(stmt, vy_stmt_flags(stmt) |
+					  VY_STMT_BLOB_REF);
+			vy_stmt_set_lsn(stmt, xrow->lsn);
+			return stmt;
+		}
 		stmt = vy_stmt_new_with_ops(format, request.tuple,
 					    request.tuple_end,
 					    NULL, 0, request.type);
@@ -774,6 +1013,17 @@ vy_stmt_snprint(char *buf, int size, struct tuple *stmt)
 		SNPRINT(total, mp_snprint, buf, size,
 			vy_stmt_upsert_ops(stmt, &mp_size));
 	}
+	if (vy_stmt_type(stmt) == IPROTO_DELETE_RANGE) {
+		SNPRINT(total, snprintf, buf, size, ", end=");
+		SNPRINT(total, mp_snprint, buf, size,
+			vy_stmt_range_end(stmt));
+	}
+	if ((vy_stmt_flags(stmt) & VY_STMT_BLOB_REF) != 0) {
+		const char *ref = tuple_data(stmt);
+		mp_next(&ref);
+		SNPRINT(total, snprintf, buf, size, ", blob=");
+		SNPRINT(total, mp_snprint, buf, size, ref);
+	}
 	SNPRINT(total, snprintf, buf, size, ", lsn=%lld)",
 		(long long) vy_stmt_lsn(stmt));
 	return total;
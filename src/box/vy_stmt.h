@@ -54,6 +54,7 @@ struct tuple_dictionary;
 struct tuple_bloom;
 struct tuple_bloom_builder;
 struct iovec;
+struct vy_blob_ref;
 
 #define MAX_LSN (INT64_MAX / 2)
 
@@ -134,11 +135,25 @@ enum {
 	 * compaction. It is never written to disk.
 	 */
 	VY_STMT_UPDATE			= 1 << 2,
+	/**
+	 * This flag is set for REPLACE and INSERT statements loaded
+	 * from a primary index run that store only the key while the
+	 * tuple payload is stored in a value log file, see vy_blob.
+	 * Such a statement has the key format and the reference to
+	 * the payload is stored right after the key in the statement
+	 * data, see vy_stmt_blob_ref(). It must be resolved to the
+	 * full tuple with vy_stmt_new_from_blob() before it is
+	 * returned to the user or used to apply an UPSERT.
+	 *
+	 * The flag is never written to disk as is: the reference
+	 * is encoded in the statement metadata instead.
+	 */
+	VY_STMT_BLOB_REF		= 1 << 3,
 	/**
 	 * Bit mask of all statement flags.
 	 */
 	VY_STMT_FLAGS_ALL = (VY_STMT_DEFERRED_DELETE | VY_STMT_SKIP_READ |
-			     VY_STMT_UPDATE),
+			     VY_STMT_UPDATE | VY_STMT_BLOB_REF),
 };
 
 /**
@@ -525,6 +540,68 @@ struct tuple *
 vy_stmt_new_delete(struct tuple_format *format, const char *tuple_begin,
 		   const char *tuple_end);
 
+/**
+ * Create a range tombstone that deletes all keys in the range
+ * [begin, end) of a primary index. An empty begin key stands for
+ * minus infinity while an empty end key stands for plus infinity.
+ * A partial key bounds all keys with the same prefix, like the
+ * key of a GE (begin) or LT (end) iterator does.
+ *
+ * The statement has the key format: the begin key is stored as
+ * the statement data and the end key follows it, see
+ * vy_stmt_range_end().
+ *
+ * @retval NULL     Memory allocation error.
+ * @retval not NULL Success.
+ */
+struct tuple *
+vy_stmt_new_delete_range(struct tuple_format *format,
+			 const char *begin, const char *begin_end,
+			 const char *end, const char *end_end);
+
+/** Return the end key of a range tombstone. */
+static inline const char *
+vy_stmt_range_end(struct tuple *stmt)
+{
+	assert(vy_stmt_type(stmt) == IPROTO_DELETE_RANGE);
+	const char *end = tuple_data(stmt);
+	mp_next(&end);
+	return end;
+}
+
+/**
+ * Return true if the key of the given statement falls in the
+ * range deleted by the given range tombstone.
+ */
+bool
+vy_stmt_range_covers(struct tuple *range, struct tuple *stmt,
+		     struct key_def *cmp_def);
+
+/**
+ * Return the max LSN of a range tombstone that covers the key
+ * of the given statement and is visible from the read view with
+ * the given LSN, or -1 if there's no such tombstone.
+ *
+ * @param ranges Range tombstones of a primary index.
+ * @param count Number of entries in @a ranges.
+ */
+int64_t
+vy_stmt_range_delete_lsn(struct tuple **ranges, int count,
+			 struct tuple *stmt, int64_t vlsn,
+			 struct key_def *cmp_def);
+
+/**
+ * Create a DELETE statement for the key of @a stmt covered by
+ * the range tombstone @a range. The new statement has the key
+ * format and the LSN of the tombstone.
+ *
+ * @retval NULL     Memory allocation error.
+ * @retval not NULL Success.
+ */
+struct tuple *
+vy_stmt_new_range_delete_key(struct tuple *range, struct tuple *stmt,
+			     struct key_def *cmp_def);
+
  /**
  * Create the UPSERT statement from raw MessagePack data.
  * @param tuple_begin MessagePack data that contain an array of fields WITH the
@@ -556,6 +633,48 @@ vy_stmt_new_upsert(struct tuple_format *format,
 struct tuple *
 vy_stmt_replace_from_upsert(struct tuple *upsert);
 
+/**
+ * Create a statement that refers to a payload stored in a value
+ * log file. The new statement has the key format and the same
+ * type, LSN, and flags as @a stmt, plus VY_STMT_BLOB_REF.
+ *
+ * @param stmt REPLACE or INSERT statement of a primary index.
+ * @param cmp_def Key definition of the primary index.
+ * @param ref Reference to the payload of @a stmt.
+ *
+ * @retval not NULL Success.
+ * @retval     NULL Memory error.
+ */
+struct tuple *
+vy_stmt_new_blob_ref(struct tuple *stmt, struct key_def *cmp_def,
+		     const struct vy_blob_ref *ref);
+
+/**
+ * Get the value log reference stored in a statement that has
+ * the VY_STMT_BLOB_REF flag.
+ *
+ * @retval  0 Success.
+ * @retval -1 The reference is malformed.
+ */
+int
+vy_stmt_blob_ref(struct tuple *stmt, struct vy_blob_ref *ref);
+
+/**
+ * Create a full statement from a statement referring to a value
+ * log file and the payload loaded from the file. The new statement
+ * has the same type, LSN, and flags, except VY_STMT_BLOB_REF.
+ *
+ * @param format Format of the primary index.
+ * @param ref_stmt Statement with the VY_STMT_BLOB_REF flag.
+ * @param data, data_end Payload loaded from the value log file.
+ *
+ * @retval not NULL Success.
+ * @retval     NULL Memory error.
+ */
+struct tuple *
+vy_stmt_new_from_blob(struct tuple_format *format, struct tuple *ref_stmt,
+		      const char *data, const char *data_end);
+
 /**
  * Extract MessagePack data from the REPLACE/UPSERT statement.
  * @param stmt An UPSERT or REPLACE statement.
@@ -643,6 +762,18 @@ bool
 vy_bloom_maybe_has(const struct tuple_bloom *bloom,
 		   struct vy_entry entry, struct key_def *key_def);
 
+/**
+ * Calculate hashes of all partial keys of a statement.
+ * See tuple_bloom_hash() for more details.
+ * @param entry - statement to hash
+ * @param key_def - key definition
+ * @param[out] hashes - array of at least key_def->part_count hashes
+ * @return number of calculated hashes
+ */
+uint32_t
+vy_bloom_hash(struct vy_entry entry, struct key_def *key_def,
+	      uint32_t *hashes);
+
 /**
  * Encode vy_stmt for a primary key as xrow_header
  *
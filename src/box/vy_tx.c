@@ -324,6 +324,7 @@ vy_tx_create(struct vy_tx_manager *xm, struct vy_tx *tx)
 	write_set_new(&tx->write_set);
 	tx->write_set_version = 0;
 	tx->write_size = 0;
+	tx->range_delete_count = 0;
 	tx->xm = xm;
 	tx->state = VINYL_TX_READY;
 	tx->is_applier_session = false;
@@ -363,7 +364,7 @@ vy_tx_abort(struct vy_tx *tx)
 static bool
 vy_tx_is_ro(struct vy_tx *tx)
 {
-	return write_set_empty(&tx->write_set);
+	return write_set_empty(&tx->write_set) && tx->range_delete_count == 0;
 }
 
 /** Return true if the transaction is in read view. */
@@ -401,6 +402,69 @@ vy_tx_send_to_read_view(struct vy_tx *tx, struct txv *v)
 	return 0;
 }
 
+/**
+ * Return true if a read interval may contain keys deleted by
+ * the given range tombstone. Boundaries of read intervals may be
+ * partial keys so the check is conservative.
+ */
+static bool
+vy_read_interval_intersects_range(struct vy_read_interval *interval,
+				  struct tuple *range, struct key_def *cmp_def)
+{
+	const char *begin = tuple_data(range);
+	const char *end = vy_stmt_range_end(range);
+	const char *tmp = end;
+	if (mp_decode_array(&tmp) > 0 &&
+	    vy_stmt_compare_with_raw_key(interval->left.stmt, HINT_NONE,
+					 end, HINT_NONE, cmp_def) > 0)
+		return false;
+	tmp = begin;
+	if (mp_decode_array(&tmp) > 0 &&
+	    vy_stmt_compare_with_raw_key(interval->right.stmt, HINT_NONE,
+					 begin, HINT_NONE, cmp_def) < 0)
+		return false;
+	return true;
+}
+
+/**
+ * Send to read view all transactions that are reading keys
+ * deleted by range tombstone @v written by transaction @tx.
+ * If @abort is set, abort them instead.
+ */
+static int
+vy_tx_send_range_to_read_view(struct vy_tx *tx, struct txv *v, bool abort)
+{
+	struct vy_lsm *lsm = v->lsm;
+	struct vy_read_interval *interval;
+	for (interval = vy_lsm_read_set_first(&lsm->read_set);
+	     interval != NULL;
+	     interval = vy_lsm_read_set_next(&lsm->read_set, interval)) {
+		struct vy_tx *reader = interval->tx;
+		/* Don't abort self. */
+		if (reader == tx)
+			continue;
+		/* Abort only active TXs */
+		if (reader->state != VINYL_TX_READY)
+			continue;
+		if (!vy_read_interval_intersects_range(interval,
+						       v->entry.stmt,
+						       lsm->cmp_def))
+			continue;
+		if (abort) {
+			vy_tx_abort(reader);
+			continue;
+		}
+		/* already in (earlier) read view */
+		if (vy_tx_is_in_read_view(reader))
+			continue;
+		struct vy_read_view *rv = vy_tx_manager_read_view(tx->xm);
+		if (rv == NULL)
+			return -1;
+		reader->read_view = rv;
+	}
+	return 0;
+}
+
 /**
  * Abort all transaction that are reading key @v modified
  * by transaction @tx.
@@ -522,6 +586,9 @@ vy_tx_write(struct vy_lsm *lsm, struct vy_mem *mem,
 			 * not critical to apply the optimization.
 			 */
 		}
+	} else if (vy_stmt_type(entry.stmt) == IPROTO_DELETE_RANGE) {
+		/* Invalidate all cache elements in the range. */
+		vy_cache_on_write_range(&lsm->cache, entry.stmt);
 	} else {
 		/* Invalidate cache element. */
 		vy_cache_on_write(&lsm->cache, entry, NULL);
@@ -696,6 +763,14 @@ vy_tx_prepare(struct vy_tx *tx)
 		if (vy_tx_send_to_read_view(tx, v))
 			return -1;
 	}
+	if (tx->range_delete_count > 0) {
+		stailq_foreach_entry(v, &tx->log, next_in_log) {
+			if (vy_stmt_type(v->entry.stmt) ==
+			    IPROTO_DELETE_RANGE &&
+			    vy_tx_send_range_to_read_view(tx, v, false) != 0)
+				return -1;
+		}
+	}
 
 	/*
 	 * Flush transactional changes to the LSM tree.
@@ -780,7 +855,9 @@ vy_tx_prepare(struct vy_tx *tx)
 
 		/* In secondary indexes only REPLACE/DELETE can be written. */
 		vy_stmt_set_lsn(v->entry.stmt, MAX_LSN + tx->psn);
+		struct tuple *range_delete = NULL;
 		struct tuple **region_stmt =
+			(type == IPROTO_DELETE_RANGE) ? &range_delete :
 			(type == IPROTO_DELETE) ? &delete : &repsert;
 		if (vy_tx_write(lsm, v->mem, v->entry, region_stmt) != 0)
 			return -1;
@@ -874,6 +951,12 @@ vy_tx_rollback_after_prepare(struct vy_tx *tx)
 	while ((v = write_set_inext(&it)) != NULL) {
 		vy_tx_abort_readers(tx, v);
 	}
+	if (tx->range_delete_count > 0) {
+		stailq_foreach_entry(v, &tx->log, next_in_log) {
+			if (vy_stmt_type(v->entry.stmt) == IPROTO_DELETE_RANGE)
+				vy_tx_send_range_to_read_view(tx, v, true);
+		}
+	}
 }
 
 void
@@ -927,6 +1010,14 @@ vy_tx_rollback_statement(struct vy_tx *tx, void *svp)
 	stailq_reverse(&tail);
 	struct txv *v, *tmp;
 	stailq_foreach_entry_safe(v, tmp, &tail, next_in_log) {
+		if (vy_stmt_type(v->entry.stmt) == IPROTO_DELETE_RANGE) {
+			/* Range tombstones aren't stored in the write set. */
+			assert(tx->range_delete_count > 0);
+			tx->range_delete_count--;
+			tx->write_set_version++;
+			txv_delete(v);
+			continue;
+		}
 		write_set_remove(&tx->write_set, v);
 		if (v->overwritten != NULL) {
 			/* Restore overwritten statement. */
@@ -1160,6 +1251,108 @@ vy_tx_set(struct vy_tx *tx, struct vy_lsm *lsm, struct tuple *stmt)
 	return 0;
 }
 
+/**
+ * Return true if the given write set entry must be overwritten
+ * with a DELETE by the given range tombstone written by the same
+ * transaction.
+ */
+static bool
+vy_tx_range_delete_overwrites(struct txv *v, struct vy_lsm *lsm,
+			      struct tuple *range)
+{
+	return v->lsm == lsm &&
+	       vy_stmt_type(v->entry.stmt) != IPROTO_DELETE &&
+	       vy_stmt_range_covers(range, v->entry.stmt, lsm->cmp_def);
+}
+
+int
+vy_tx_delete_range(struct vy_tx *tx, struct vy_lsm *lsm, struct tuple *stmt,
+		   bool is_deferred)
+{
+	assert(lsm->index_id == 0);
+	assert(vy_stmt_type(stmt) == IPROTO_DELETE_RANGE);
+	/* See the comment in vy_tx_set_entry(). */
+	vy_stmt_set_lsn(stmt, INT64_MAX);
+	struct vy_entry entry;
+	entry.stmt = stmt;
+	entry.hint = HINT_NONE;
+	struct txv *v = txv_new(tx, lsm, entry);
+	if (v == NULL)
+		return -1;
+	stailq_add_tail_entry(&tx->log, v, next_in_log);
+	tx->range_delete_count++;
+	tx->write_set_version++;
+	tx->write_size += tuple_size(stmt);
+	/*
+	 * Overwrite statements written by this transaction to the
+	 * deleted range with DELETEs. Collect them first, because
+	 * vy_tx_set_entry() modifies the write set we iterate over.
+	 */
+	int covered_count = 0;
+	struct write_set_iterator it;
+	write_set_ifirst(&tx->write_set, &it);
+	while ((v = write_set_inext(&it)) != NULL) {
+		if (vy_tx_range_delete_overwrites(v, lsm, stmt))
+			covered_count++;
+	}
+	if (covered_count == 0)
+		return 0;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t size;
+	struct tuple **covered = region_alloc_array(region, typeof(*covered),
+						    covered_count, &size);
+	if (covered == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "covered");
+		return -1;
+	}
+	int i = 0;
+	write_set_ifirst(&tx->write_set, &it);
+	while ((v = write_set_inext(&it)) != NULL) {
+		if (vy_tx_range_delete_overwrites(v, lsm, stmt))
+			covered[i++] = v->entry.stmt;
+	}
+	assert(i == covered_count);
+	int rc = 0;
+	for (i = 0; i < covered_count; i++) {
+		struct tuple *delete = vy_stmt_new_range_delete_key(
+				stmt, covered[i], lsm->cmp_def);
+		if (delete == NULL) {
+			rc = -1;
+			break;
+		}
+		if (is_deferred)
+			vy_stmt_set_flags(delete, VY_STMT_DEFERRED_DELETE);
+		entry.stmt = delete;
+		entry.hint = vy_stmt_hint(delete, lsm->cmp_def);
+		rc = vy_tx_set_entry(tx, lsm, entry);
+		tuple_unref(delete);
+		if (rc != 0)
+			break;
+	}
+	region_truncate(region, region_svp);
+	return rc;
+}
+
+int64_t
+vy_tx_range_delete_lsn(struct vy_tx *tx, struct vy_lsm *lsm, int64_t vlsn,
+		       struct tuple *stmt)
+{
+	if (tx != NULL && tx->range_delete_count > 0) {
+		struct txv *v;
+		stailq_foreach_entry(v, &tx->log, next_in_log) {
+			if (v->lsm == lsm &&
+			    vy_stmt_type(v->entry.stmt) == IPROTO_DELETE_RANGE &&
+			    vy_stmt_range_covers(v->entry.stmt, stmt,
+						 lsm->cmp_def))
+				return INT64_MAX;
+		}
+	}
+	if (!vy_lsm_has_range_deletes(lsm))
+		return -1;
+	return vy_lsm_range_delete_lsn(lsm, stmt, vlsn);
+}
+
 void
 vy_tx_manager_abort_writers_for_ddl(struct vy_tx_manager *xm,
 				    struct space *space, bool *need_wal_sync)
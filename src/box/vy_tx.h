@@ -172,6 +172,12 @@ struct vy_tx {
 	 * the write set.
 	 */
 	size_t write_size;
+	/**
+	 * Number of range tombstones written by the transaction.
+	 * Range tombstones are stored only in the transaction log,
+	 * not in the write set, see vy_tx_delete_range().
+	 */
+	int range_delete_count;
 	/** Current state of the transaction.*/
 	enum tx_state state;
 	/** Set if the transaction was started by an applier. */
@@ -421,6 +427,38 @@ vy_tx_track_point(struct vy_tx *tx, struct vy_lsm *lsm, struct vy_entry entry);
 int
 vy_tx_set(struct vy_tx *tx, struct vy_lsm *lsm, struct tuple *stmt);
 
+/**
+ * Insert a range tombstone into a transaction. Statements written
+ * by the transaction to the primary index that fall in the deleted
+ * range are overwritten with DELETEs.
+ * @param tx           Transaction.
+ * @param lsm          Primary index LSM tree.
+ * @param stmt         Range tombstone, see vy_stmt_new_delete_range().
+ * @param is_deferred  Set if deletion of tuples from secondary
+ *                     indexes must be deferred.
+ *
+ * @retval  0 Success
+ * @retval -1 Memory allocation error.
+ */
+int
+vy_tx_delete_range(struct vy_tx *tx, struct vy_lsm *lsm, struct tuple *stmt,
+		   bool is_deferred);
+
+/**
+ * Return the LSN of the newest range tombstone that covers the key
+ * of the given statement and is visible from the given read view.
+ * A tombstone written by the transaction itself deletes all keys
+ * that weren't written by the transaction after it so INT64_MAX is
+ * returned in this case. Returns -1 if the key isn't covered.
+ * @param tx           Transaction or NULL.
+ * @param lsm          LSM tree.
+ * @param vlsn         LSN of the read view.
+ * @param stmt         Statement.
+ */
+int64_t
+vy_tx_range_delete_lsn(struct vy_tx *tx, struct vy_lsm *lsm, int64_t vlsn,
+		       struct tuple *stmt);
+
 /**
  * Iterator over the write set of a transaction.
  */
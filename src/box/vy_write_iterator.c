@@ -183,12 +183,29 @@ struct vy_write_iterator {
 	bool is_primary;
 	/** Deferred DELETE handler. */
 	struct vy_deferred_delete_handler *deferred_delete_handler;
+	/**
+	 * Reader used for loading payloads of statements stored
+	 * in value log files, see VY_STMT_BLOB_REF. May be NULL.
+	 */
+	struct vy_blob_reader *blob_reader;
 	/**
 	 * Last scanned REPLACE or DELETE statement that was
 	 * inserted into the primary index without deletion
 	 * of the old tuple from secondary indexes.
 	 */
 	struct vy_entry deferred_delete;
+	/**
+	 * Range tombstones applied by this iterator, see
+	 * vy_write_iterator_set_range_deletes().
+	 */
+	struct tuple **range_deletes;
+	/** Number of entries in @range_deletes. */
+	int range_delete_count;
+	/**
+	 * Set if DELETE statements generated for keys covered by
+	 * range tombstones must be marked with VY_STMT_DEFERRED_DELETE.
+	 */
+	bool range_delete_is_deferred;
 	/** Length of the @read_views. */
 	int rv_count;
 	/**
@@ -345,7 +362,8 @@ static const struct vy_stmt_stream_iface vy_slice_stream_iface;
 struct vy_stmt_stream *
 vy_write_iterator_new(struct key_def *cmp_def, bool is_primary,
 		      bool is_last_level, struct rlist *read_views,
-		      struct vy_deferred_delete_handler *handler)
+		      struct vy_deferred_delete_handler *handler,
+		      struct vy_blob_reader *blob_reader)
 {
 	/*
 	 * Deferred DELETE statements can only be produced by
@@ -389,11 +407,25 @@ vy_write_iterator_new(struct key_def *cmp_def, bool is_primary,
 	stream->is_primary = is_primary;
 	stream->is_last_level = is_last_level;
 	stream->deferred_delete_handler = handler;
+	stream->blob_reader = blob_reader;
 	stream->deferred_delete = vy_entry_none();
 	stream->last = vy_entry_none();
 	return &stream->base;
 }
 
+void
+vy_write_iterator_set_range_deletes(struct vy_stmt_stream *vstream,
+				    struct tuple **ranges, int count,
+				    bool is_deferred)
+{
+	struct vy_write_iterator *stream = (struct vy_write_iterator *)vstream;
+	assert(stream->is_primary);
+	assert(!is_deferred || stream->deferred_delete_handler != NULL);
+	stream->range_deletes = ranges;
+	stream->range_delete_count = count;
+	stream->range_delete_is_deferred = is_deferred;
+}
+
 /**
  * Start the search. Must be called after *new* methods and
  * before *next* method.
@@ -598,6 +630,34 @@ vy_write_iterator_pop_read_view_stmt(struct vy_write_iterator *stream)
 	return stream->last;
 }
 
+/**
+ * If the given statement refers to a value log file, load its
+ * payload and return the full statement, otherwise return the
+ * statement itself. In any case, the returned statement is
+ * referenced and must be unreferenced by the caller.
+ *
+ * @retval  0 Success.
+ * @retval -1 Read or memory error.
+ */
+static int
+vy_write_iterator_load_blob(struct vy_write_iterator *stream,
+			    struct vy_entry entry, struct vy_entry *result)
+{
+	if (entry.stmt == NULL ||
+	    (vy_stmt_flags(entry.stmt) & VY_STMT_BLOB_REF) == 0) {
+		*result = entry;
+		if (entry.stmt != NULL)
+			vy_stmt_ref_if_possible(entry.stmt);
+		return 0;
+	}
+	if (stream->blob_reader == NULL) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 "Unexpected value log reference");
+		return -1;
+	}
+	return vy_blob_reader_resolve(stream->blob_reader, entry, result);
+}
+
 /**
  * Generate a DELETE statement for the given tuple if its
  * deletion from secondary indexes was deferred.
@@ -628,10 +688,18 @@ vy_write_iterator_deferred_delete(struct vy_write_iterator *stream,
 	if (stream->deferred_delete.stmt != NULL) {
 		struct vy_deferred_delete_handler *handler =
 				stream->deferred_delete_handler;
-		if (handler != NULL && vy_stmt_type(stmt) != IPROTO_DELETE &&
-		    handler->iface->process(handler, stmt,
-					    stream->deferred_delete.stmt) != 0)
-			return -1;
+		if (handler != NULL && vy_stmt_type(stmt) != IPROTO_DELETE) {
+			/* A DELETE is generated from the full tuple. */
+			struct vy_entry old;
+			if (vy_write_iterator_load_blob(stream, entry,
+							&old) != 0)
+				return -1;
+			int rc = handler->iface->process(handler, old.stmt,
+					stream->deferred_delete.stmt);
+			vy_stmt_unref_if_possible(old.stmt);
+			if (rc != 0)
+				return -1;
+		}
 		vy_stmt_unref_if_possible(stream->deferred_delete.stmt);
 		stream->deferred_delete = vy_entry_none();
 	}
@@ -650,6 +718,45 @@ vy_write_iterator_deferred_delete(struct vy_write_iterator *stream,
 	return 0;
 }
 
+/**
+ * If the given statement is covered by a range tombstone newer
+ * than the statement and older than @a vlsn, return a DELETE
+ * statement for its key with the LSN of the newest such tombstone
+ * in @a result. Otherwise set @a result to vy_entry_none().
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+static int
+vy_write_iterator_range_delete(struct vy_write_iterator *stream,
+			       struct vy_entry entry, int64_t vlsn,
+			       struct vy_entry *result)
+{
+	*result = vy_entry_none();
+	int64_t lsn = vy_stmt_lsn(entry.stmt);
+	struct tuple *range = NULL;
+	for (int i = 0; i < stream->range_delete_count; i++) {
+		struct tuple *stmt = stream->range_deletes[i];
+		int64_t range_lsn = vy_stmt_lsn(stmt);
+		if (range_lsn <= lsn || range_lsn > vlsn ||
+		    (range != NULL && range_lsn <= vy_stmt_lsn(range)))
+			continue;
+		if (vy_stmt_range_covers(stmt, entry.stmt, stream->cmp_def))
+			range = stmt;
+	}
+	if (range == NULL)
+		return 0;
+	struct tuple *stmt = vy_stmt_new_range_delete_key(range, entry.stmt,
+							  stream->cmp_def);
+	if (stmt == NULL)
+		return -1;
+	if (stream->range_delete_is_deferred)
+		vy_stmt_set_flags(stmt, VY_STMT_DEFERRED_DELETE);
+	result->stmt = stmt;
+	result->hint = vy_stmt_hint(stmt, stream->cmp_def);
+	return 0;
+}
+
 /**
  * Build the history of the current key.
  * Apply optimizations 1 and 2 (@sa vy_write_iterator.h).
@@ -708,12 +815,32 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 	int current_rv_i = 0;
 	int64_t current_rv_lsn = vy_write_iterator_get_vlsn(stream, 0);
 	int64_t merge_until_lsn = vy_write_iterator_get_vlsn(stream, 1);
+	/*
+	 * A statement covered by a range tombstone is preceded by
+	 * a DELETE with the LSN of the tombstone in the history.
+	 * This is the max LSN of a tombstone that may be applied
+	 * to the current source statement.
+	 */
+	int64_t range_delete_vlsn = INT64_MAX;
+	struct vy_entry range_delete = vy_entry_none();
 
 	while (true) {
-		*is_first_insert = vy_stmt_type(src->entry.stmt) == IPROTO_INSERT;
+		if (stream->range_delete_count > 0) {
+			rc = vy_write_iterator_range_delete(stream, src->entry,
+							    range_delete_vlsn,
+							    &range_delete);
+			if (rc != 0)
+				break;
+		}
+		struct vy_entry entry = src->entry;
+		if (range_delete.stmt != NULL) {
+			entry = range_delete;
+			range_delete_vlsn = vy_stmt_lsn(entry.stmt) - 1;
+		}
+		*is_first_insert = vy_stmt_type(entry.stmt) == IPROTO_INSERT;
 
 		if (!stream->is_primary &&
-		    (vy_stmt_flags(src->entry.stmt) & VY_STMT_UPDATE) != 0) {
+		    (vy_stmt_flags(entry.stmt) & VY_STMT_UPDATE) != 0) {
 			/*
 			 * If a REPLACE stored in a secondary index was
 			 * generated by an update operation, it can be
@@ -734,12 +861,12 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 		 */
 		if (stream->is_primary) {
 			rc = vy_write_iterator_deferred_delete(stream,
-							       src->entry);
+							       entry);
 			if (rc != 0)
 				break;
 		}
 
-		if (vy_stmt_lsn(src->entry.stmt) > current_rv_lsn) {
+		if (vy_stmt_lsn(entry.stmt) > current_rv_lsn) {
 			/*
 			 * Skip statements invisible to the current read
 			 * view but older than the previous read view,
@@ -747,10 +874,10 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 			 */
 			goto next_lsn;
 		}
-		while (vy_stmt_lsn(src->entry.stmt) <= merge_until_lsn) {
+		while (vy_stmt_lsn(entry.stmt) <= merge_until_lsn) {
 			/*
 			 * Skip read views which see the same
-			 * version of the key, until src->entry is
+			 * version of the key, until entry is
 			 * between merge_until_lsn and
 			 * current_rv_lsn.
 			 */
@@ -766,13 +893,13 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 		 * @sa vy_write_iterator for details about this
 		 * and other optimizations.
 		 */
-		if (vy_stmt_type(src->entry.stmt) == IPROTO_DELETE &&
+		if (vy_stmt_type(entry.stmt) == IPROTO_DELETE &&
 		    stream->is_last_level && merge_until_lsn < 0) {
 			current_rv_lsn = -1; /* Force skip */
 			goto next_lsn;
 		}
 
-		rc = vy_write_iterator_push_rv(stream, src->entry,
+		rc = vy_write_iterator_push_rv(stream, entry,
 					       current_rv_i);
 		if (rc != 0)
 			break;
@@ -782,9 +909,9 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 		 * Optimization 2: skip statements overwritten
 		 * by a REPLACE or DELETE.
 		 */
-		if (vy_stmt_type(src->entry.stmt) == IPROTO_REPLACE ||
-		    vy_stmt_type(src->entry.stmt) == IPROTO_INSERT ||
-		    vy_stmt_type(src->entry.stmt) == IPROTO_DELETE) {
+		if (vy_stmt_type(entry.stmt) == IPROTO_REPLACE ||
+		    vy_stmt_type(entry.stmt) == IPROTO_INSERT ||
+		    vy_stmt_type(entry.stmt) == IPROTO_DELETE) {
 			current_rv_i++;
 			current_rv_lsn = merge_until_lsn;
 			merge_until_lsn =
@@ -792,6 +919,12 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 							   current_rv_i + 1);
 		}
 next_lsn:
+		if (range_delete.stmt != NULL) {
+			/* Now process the covered source statement. */
+			vy_stmt_unref_if_possible(range_delete.stmt);
+			range_delete = vy_entry_none();
+			continue;
+		}
 		rc = vy_write_iterator_merge_step(stream);
 		if (rc != 0)
 			break;
@@ -801,6 +934,8 @@ next_lsn:
 		if (src->is_end_of_key)
 			break;
 	}
+	if (range_delete.stmt != NULL)
+		vy_stmt_unref_if_possible(range_delete.stmt);
 
 	/*
 	 * No point in keeping the last VY_STMT_DEFERRED_DELETE
@@ -875,9 +1010,13 @@ vy_read_view_merge(struct vy_write_iterator *stream, struct vy_entry prev,
 	     vy_stmt_type(prev.stmt) != IPROTO_UPSERT))) {
 		assert(!stream->is_last_level || prev.stmt == NULL ||
 		       vy_stmt_type(prev.stmt) != IPROTO_UPSERT);
-		struct vy_entry applied;
-		applied = vy_entry_apply_upsert(h->entry, prev,
+		struct vy_entry base, applied;
+		if (vy_write_iterator_load_blob(stream, prev, &base) != 0)
+			return -1;
+		applied = vy_entry_apply_upsert(h->entry, base,
 						stream->cmp_def, false);
+		if (base.stmt != NULL)
+			vy_stmt_unref_if_possible(base.stmt);
 		if (applied.stmt == NULL)
 			return -1;
 		vy_stmt_unref_if_possible(h->entry.stmt);
@@ -890,9 +1029,13 @@ vy_read_view_merge(struct vy_write_iterator *stream, struct vy_entry prev,
 		assert(h->entry.stmt != NULL &&
 		       vy_stmt_type(h->entry.stmt) == IPROTO_UPSERT);
 		assert(result->entry.stmt != NULL);
-		struct vy_entry applied;
-		applied = vy_entry_apply_upsert(h->entry, result->entry,
+		struct vy_entry base, applied;
+		if (vy_write_iterator_load_blob(stream, result->entry,
+						&base) != 0)
+			return -1;
+		applied = vy_entry_apply_upsert(h->entry, base,
 						stream->cmp_def, false);
+		vy_stmt_unref_if_possible(base.stmt);
 		if (applied.stmt == NULL)
 			return -1;
 		vy_stmt_unref_if_possible(result->entry.stmt);
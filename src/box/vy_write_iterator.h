@@ -194,6 +194,7 @@
 
 struct vy_write_iterator;
 struct vy_deferred_delete_handler;
+struct vy_blob_reader;
 struct key_def;
 struct tuple_format;
 struct tuple;
@@ -245,12 +246,31 @@ struct vy_deferred_delete_handler {
  * @param handler - Deferred DELETE handler or NULL if no deferred DELETEs is
  * expected. Only relevant to primary index compaction. For secondary indexes
  * this argument must be set to NULL.
+ * @param blob_reader - Reader of value log files of the LSM tree or NULL
+ * if the sources can't refer to value log files (e.g. dump).
  * @return the iterator or NULL on error (diag is set).
  */
 struct vy_stmt_stream *
 vy_write_iterator_new(struct key_def *cmp_def, bool is_primary,
 		      bool is_last_level, struct rlist *read_views,
-		      struct vy_deferred_delete_handler *handler);
+		      struct vy_deferred_delete_handler *handler,
+		      struct vy_blob_reader *blob_reader);
+
+/**
+ * Make the iterator apply the given range tombstones to the
+ * sources: a statement covered by a tombstone is overwritten
+ * with a DELETE having the LSN of the tombstone. Only relevant
+ * to primary index compaction. The array must stay valid until
+ * the iterator is closed.
+ *
+ * If @a is_deferred is set, the generated DELETEs are marked with
+ * VY_STMT_DEFERRED_DELETE so that the overwritten tuples are
+ * deleted from secondary indexes by the deferred DELETE handler.
+ */
+void
+vy_write_iterator_set_range_deletes(struct vy_stmt_stream *stream,
+				    struct tuple **ranges, int count,
+				    bool is_deferred);
 
 /**
  * Add a mem as a source to the iterator.
@@ -42,6 +42,10 @@
 #include "cbus.h"
 #include "coio_task.h"
 #include "replication.h"
+#include "wal_mem.h"
+#include "histogram.h"
+#include "latency.h"
+#include "info/info.h"
 
 enum {
 	/**
@@ -107,6 +111,30 @@ struct wal_writer
 	 * rolled back too.
 	 */
 	struct journal_entry *last_entry;
+	/**
+	 * Group commit: max time a new batch is held in tx
+	 * waiting for more entries before it's passed to the
+	 * WAL thread, in seconds. 0 disables group commit.
+	 */
+	double group_commit_delay;
+	/**
+	 * Group commit: a held batch is passed to the WAL thread
+	 * as soon as it has this many entries.
+	 */
+	int group_commit_min_batch;
+	/**
+	 * Moving average of batch write time. A batch is never
+	 * held longer than that: waiting for more than a single
+	 * write takes wouldn't make batches much bigger, because
+	 * entries queue up while the WAL thread is busy anyway.
+	 */
+	double avg_write_time;
+	/** Timer passing the held batch to the WAL thread. */
+	struct ev_timer group_commit_timer;
+	/** Number of entries per written batch. */
+	struct histogram *batch_hist;
+	/** Time it takes to write a batch, including fsync. */
+	struct latency write_latency;
 	/* ----------------- wal ------------------- */
 	/** A setting from instance configuration - wal_max_size */
 	int64_t wal_max_size;
@@ -170,6 +198,13 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/**
+	 * Rows recently written to the WAL, shared with relays
+	 * so that they don't have to re-read xlog files.
+	 */
+	struct wal_mem mem;
+	/** Set if the memory buffer was created successfully. */
+	bool has_mem;
 };
 
 struct wal_msg {
@@ -185,6 +220,10 @@ struct wal_msg {
 	struct stailq rollback;
 	/** vclock after the batch processed. */
 	struct vclock vclock;
+	/** Number of entries in the batch. */
+	int n_entries;
+	/** Time it took to write the batch, in seconds. */
+	double write_time;
 };
 
 /**
@@ -210,6 +249,13 @@ wal_dir(void)
 	return wal_writer_singleton.wal_dir.dirname;
 }
 
+struct wal_mem *
+wal_mem(void)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	return writer->has_mem ? &writer->mem : NULL;
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg);
 
@@ -229,6 +275,8 @@ wal_msg_create(struct wal_msg *batch)
 	stailq_create(&batch->commit);
 	stailq_create(&batch->rollback);
 	vclock_create(&batch->vclock);
+	batch->n_entries = 0;
+	batch->write_time = 0;
 }
 
 static struct wal_msg *
@@ -373,6 +421,10 @@ tx_complete_batch(struct cmsg *msg)
 	}
 	/* Update the tx vclock to the latest written by wal. */
 	vclock_copy(&replicaset.vclock, &batch->vclock);
+	histogram_collect(writer->batch_hist, batch->n_entries);
+	latency_collect(&writer->write_latency, batch->write_time);
+	writer->avg_write_time = 0.9 * writer->avg_write_time +
+				 0.1 * batch->write_time;
 	tx_schedule_queue(&batch->commit);
 	mempool_free(&writer->msg_pool, container_of(msg, struct wal_msg, base));
 }
@@ -406,6 +458,17 @@ tx_notify_checkpoint(struct cmsg *msg)
 	free(msg);
 }
 
+/** Pass the batch held for group commit to the WAL thread. */
+static void
+wal_group_commit_timer_cb(struct ev_loop *loop, struct ev_timer *timer,
+			  int events)
+{
+	(void)loop;
+	(void)events;
+	struct wal_writer *writer = (struct wal_writer *)timer->data;
+	cpipe_flush_input(&writer->wal_pipe);
+}
+
 /**
  * Initialize WAL writer context. Even though it's a singleton,
  * encapsulate the details just in case we may use
@@ -431,8 +494,19 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	opts.sync_is_async = true;
 	xdir_create(&writer->wal_dir, wal_dirname, XLOG, instance_uuid, &opts);
 	xlog_clear(&writer->current_wal);
-	if (wal_mode == WAL_FSYNC)
+	if (wal_mode == WAL_FSYNC) {
+		/*
+		 * With O_DSYNC a write waits only for the data and
+		 * the metadata needed to read it back, i.e. the file
+		 * size, like with fdatasync(). O_SYNC would also wait
+		 * for timestamps to be written.
+		 */
+#ifdef O_DSYNC
+		writer->wal_dir.open_wflags |= O_DSYNC;
+#else
 		writer->wal_dir.open_wflags |= O_SYNC;
+#endif
+	}
 
 	stailq_create(&writer->rollback);
 	writer->is_in_rollback = false;
@@ -448,14 +522,47 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	writer->on_garbage_collection = on_garbage_collection;
 	writer->on_checkpoint_threshold = on_checkpoint_threshold;
 
+	writer->group_commit_delay = 0;
+	writer->group_commit_min_batch = 0;
+	writer->avg_write_time = 0;
+	ev_timer_init(&writer->group_commit_timer,
+		      wal_group_commit_timer_cb, 0, 0);
+	writer->group_commit_timer.data = writer;
+
+	static const int64_t batch_buckets[] = {
+		1, 2, 3, 4, 5, 10, 20, 50, 100, 200, 500, 1000,
+	};
+	writer->batch_hist = histogram_new(batch_buckets,
+					   lengthof(batch_buckets));
+	if (writer->batch_hist == NULL ||
+	    latency_create(&writer->write_latency) != 0)
+		panic("failed to allocate WAL statistics");
+
 	mempool_create(&writer->msg_pool, &cord()->slabc,
 		       sizeof(struct wal_msg));
+
+	/*
+	 * Relays can live without the memory buffer by reading
+	 * xlog files, so don't fail if it can't be allocated.
+	 */
+	writer->has_mem = false;
+	if (wal_mode != WAL_NONE) {
+		if (wal_mem_create(&writer->mem, WAL_MEM_CAPACITY) == 0)
+			writer->has_mem = true;
+		else
+			diag_log();
+	}
 }
 
 /** Destroy a WAL writer structure. */
 static void
 wal_writer_destroy(struct wal_writer *writer)
 {
+	ev_timer_stop(loop(), &writer->group_commit_timer);
+	histogram_delete(writer->batch_hist);
+	latency_destroy(&writer->write_latency);
+	if (writer->has_mem)
+		wal_mem_destroy(&writer->mem);
 	xdir_destroy(&writer->wal_dir);
 }
 
@@ -561,6 +668,8 @@ wal_enable(void)
 
 	/* Initialize the writer vclock from the recovery state. */
 	vclock_copy(&writer->vclock, &replicaset.vclock);
+	if (writer->has_mem)
+		wal_mem_reset(&writer->mem, &writer->vclock);
 
 	/*
 	 * Scan the WAL directory to build an index of all
@@ -777,6 +886,54 @@ wal_set_queue_max_size(int64_t size)
 	journal_queue_set_max_size(size);
 }
 
+void
+wal_set_group_commit(double delay, int min_batch)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	writer->group_commit_delay = delay;
+	writer->group_commit_min_batch = min_batch;
+	/* Don't hold the current batch if group commit is off. */
+	if (delay == 0) {
+		ev_timer_stop(loop(), &writer->group_commit_timer);
+		cpipe_flush_input(&writer->wal_pipe);
+	}
+}
+
+void
+wal_stat(struct info_handler *h)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	char buf[1024];
+	info_begin(h);
+	info_append_int(h, "batches", writer->batch_hist->total);
+	histogram_snprint(buf, sizeof(buf), writer->batch_hist);
+	info_append_str(h, "batch_histogram", buf);
+	info_table_begin(h, "batch_size");
+	info_append_int(h, "p50",
+			histogram_percentile(writer->batch_hist, 50));
+	info_append_int(h, "p90",
+			histogram_percentile(writer->batch_hist, 90));
+	info_append_int(h, "p99",
+			histogram_percentile(writer->batch_hist, 99));
+	info_table_end(h); /* batch_size */
+	histogram_snprint(buf, sizeof(buf), writer->write_latency.histogram);
+	info_append_str(h, "write_histogram", buf);
+	info_table_begin(h, "write_latency");
+	info_append_double(h, "p50", latency_get(&writer->write_latency, 50));
+	info_append_double(h, "p90", latency_get(&writer->write_latency, 90));
+	info_append_double(h, "p99", latency_get(&writer->write_latency, 99));
+	info_table_end(h); /* write_latency */
+	info_end(h);
+}
+
+void
+wal_reset_stat(void)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	histogram_reset(writer->batch_hist);
+	latency_reset(&writer->write_latency);
+}
+
 struct wal_gc_msg
 {
 	struct cbus_call_msg base;
@@ -871,6 +1028,8 @@ wal_opt_rotate(struct wal_writer *writer)
 	 */
 	xdir_add_vclock(&writer->wal_dir, &writer->vclock);
 
+	if (writer->has_mem)
+		wal_mem_write_rotate(&writer->mem);
 	wal_notify_watchers(writer, WAL_EVENT_ROTATE);
 	return 0;
 }
@@ -1031,6 +1190,25 @@ wal_assign_lsn(struct vclock *vclock_diff, struct vclock *base,
 		(*row)->tsn = tsn;
 }
 
+/**
+ * Append rows of committed journal entries to the WAL memory
+ * buffer. On error the buffer is reset past the rows so that
+ * relays read them from files.
+ */
+static void
+wal_mem_write_committed(struct wal_mem *mem, struct stailq *commit)
+{
+	struct journal_entry *entry;
+	stailq_foreach_entry(entry, commit, fifo) {
+		if (wal_mem_write(mem, entry->rows, entry->n_rows) != 0) {
+			diag_log();
+			diag_clear(diag_get());
+			wal_mem_reset(mem, &wal_writer_singleton.vclock);
+			return;
+		}
+	}
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg)
 {
@@ -1059,6 +1237,8 @@ wal_write_to_disk(struct cmsg *msg)
 		ERROR_INJECT_SLEEP(ERRINJ_WAL_DELAY);
 	});
 
+	double start_time = ev_monotonic_time();
+
 	if (writer->is_in_rollback) {
 		/* We're rolling back a failed write. */
 		err_code = JOURNAL_ENTRY_ERR_CASCADE;
@@ -1165,6 +1345,7 @@ done:
 	 * back to tx.
 	 */
 	vclock_copy(&wal_msg->vclock, &writer->vclock);
+	wal_msg->write_time = ev_monotonic_time() - start_time;
 	/*
 	 * We need to start rollback from the first request
 	 * following the last committed request. If
@@ -1186,6 +1367,8 @@ done:
 	} else {
 		assert(err_code == JOURNAL_ENTRY_ERR_UNKNOWN);
 	}
+	if (writer->has_mem)
+		wal_mem_write_committed(&writer->mem, &wal_msg->commit);
 	fiber_gc();
 	wal_notify_watchers(writer, WAL_EVENT_WRITE);
 	ERROR_INJECT_SLEEP(ERRINJ_RELAY_FASTER_THAN_TX);
@@ -1239,6 +1422,35 @@ wal_writer_f(va_list ap)
 	return 0;
 }
 
+/**
+ * Check if a batch should be held in tx waiting for more entries
+ * instead of being passed to the WAL thread right away, and arm
+ * the group commit timer for a new batch.
+ *
+ * Without group commit every batch costs a write (and fsync with
+ * wal_mode = 'fsync'), so under low concurrency each commit pays
+ * for it alone. Holding a batch for a bounded time trades commit
+ * latency for fewer writes.
+ */
+static bool
+wal_group_commit_hold(struct wal_writer *writer, struct wal_msg *batch)
+{
+	if (writer->group_commit_delay == 0 ||
+	    batch->n_entries >= writer->group_commit_min_batch ||
+	    writer->wal_pipe.n_input >= writer->wal_pipe.max_input) {
+		ev_timer_stop(loop(), &writer->group_commit_timer);
+		return false;
+	}
+	if (batch->n_entries == 1) {
+		double delay = MIN(writer->group_commit_delay,
+				   writer->avg_write_time);
+		ev_timer_stop(loop(), &writer->group_commit_timer);
+		ev_timer_set(&writer->group_commit_timer, delay, 0);
+		ev_timer_start(loop(), &writer->group_commit_timer);
+	}
+	return true;
+}
+
 /**
  * WAL writer main entry point: queue a single request
  * to be written to disk.
@@ -1288,7 +1500,7 @@ wal_write_async(struct journal *journal, struct journal_entry *entry)
 		 * thread right away.
 		 */
 		stailq_add_tail_entry(&batch->commit, entry, fifo);
-		cpipe_push(&writer->wal_pipe, &batch->base);
+		cpipe_push_input(&writer->wal_pipe, &batch->base);
 	}
 	/*
 	 * Remember last entry sent to WAL. In case of rollback
@@ -1297,10 +1509,13 @@ wal_write_async(struct journal *journal, struct journal_entry *entry)
 	 */
 	writer->last_entry = entry;
 	batch->approx_len += entry->approx_len;
+	batch->n_entries++;
 	writer->wal_pipe.n_input += entry->n_rows * XROW_IOVMAX;
 #ifndef NDEBUG
 	++errinj(ERRINJ_WAL_WRITE_COUNT, ERRINJ_INT)->iparam;
 #endif
+	if (wal_group_commit_hold(writer, batch))
+		return 0;
 	cpipe_flush_input(&writer->wal_pipe);
 	return 0;
 
@@ -40,6 +40,7 @@
 struct fiber;
 struct wal_writer;
 struct tt_uuid;
+struct info_handler;
 
 enum wal_mode {
 	/**
@@ -124,6 +125,16 @@ wal_free(void);
 const char *
 wal_dir(void);
 
+struct wal_mem;
+
+/**
+ * Return the buffer of rows recently written to the WAL or NULL
+ * if there's no such buffer, e.g. if the WAL is disabled. Safe to
+ * use from multiple threads.
+ */
+struct wal_mem *
+wal_mem(void);
+
 struct wal_watcher_msg {
 	struct cmsg cmsg;
 	struct wal_watcher *watcher;
@@ -263,6 +274,23 @@ wal_set_checkpoint_threshold(int64_t threshold);
 void
 wal_set_queue_max_size(int64_t size);
 
+/**
+ * Configure group commit: a new batch of WAL entries is held
+ * in tx for up to @a delay seconds, but no longer than a batch
+ * write takes on average, unless it accumulates @a min_batch
+ * entries. 0 @a delay disables group commit.
+ */
+void
+wal_set_group_commit(double delay, int min_batch);
+
+/** Append WAL batch size and write latency statistics. */
+void
+wal_stat(struct info_handler *h);
+
+/** Reset WAL statistics. */
+void
+wal_reset_stat(void);
+
 /**
  * Remove WAL files that are not needed by consumers reading
  * rows at @vclock or newer.
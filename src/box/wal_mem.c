@@ -0,0 +1,231 @@
+/*
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "wal_mem.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <small/ibuf.h>
+#include <sys/uio.h>
+
+#include "diag.h"
+#include "fiber.h"
+#include "trivia/util.h"
+#include "tt_pthread.h"
+#include "xrow.h"
+
+int
+wal_mem_create(struct wal_mem *mem, size_t capacity)
+{
+	assert(capacity > sizeof(struct wal_mem_record));
+	mem->data = malloc(capacity);
+	if (mem->data == NULL) {
+		diag_set(OutOfMemory, capacity, "malloc", "wal_mem");
+		return -1;
+	}
+	mem->capacity = capacity;
+	mem->begin = mem->end = 0;
+	vclock_create(&mem->begin_vclock);
+	tt_pthread_mutex_init(&mem->mutex, NULL);
+	return 0;
+}
+
+void
+wal_mem_destroy(struct wal_mem *mem)
+{
+	tt_pthread_mutex_destroy(&mem->mutex);
+	free(mem->data);
+}
+
+void
+wal_mem_reset(struct wal_mem *mem, const struct vclock *vclock)
+{
+	tt_pthread_mutex_lock(&mem->mutex);
+	mem->begin = mem->end;
+	vclock_copy(&mem->begin_vclock, vclock);
+	tt_pthread_mutex_unlock(&mem->mutex);
+}
+
+/** Copy @a size bytes to the ring at the given logical position. */
+static void
+wal_mem_copy_in(struct wal_mem *mem, uint64_t pos,
+		const void *src, size_t size)
+{
+	size_t offset = pos % mem->capacity;
+	size_t head = MIN(size, mem->capacity - offset);
+	memcpy(mem->data + offset, src, head);
+	memcpy(mem->data, (const char *)src + head, size - head);
+}
+
+/** Copy @a size bytes from the ring at the given logical position. */
+static void
+wal_mem_copy_out(struct wal_mem *mem, uint64_t pos, void *dst, size_t size)
+{
+	size_t offset = pos % mem->capacity;
+	size_t head = MIN(size, mem->capacity - offset);
+	memcpy(dst, mem->data + offset, head);
+	memcpy((char *)dst + head, mem->data, size - head);
+}
+
+/**
+ * Evict the oldest record from the buffer and account
+ * its row in the buffer begin vclock.
+ */
+static void
+wal_mem_evict(struct wal_mem *mem)
+{
+	assert(mem->begin < mem->end);
+	struct wal_mem_record record;
+	wal_mem_copy_out(mem, mem->begin, &record, sizeof(record));
+	if (record.type == WAL_MEM_ROW &&
+	    record.lsn > vclock_get(&mem->begin_vclock, record.replica_id))
+		vclock_reset(&mem->begin_vclock, record.replica_id, record.lsn);
+	mem->begin += sizeof(record) + record.size;
+}
+
+/**
+ * Append a record to the buffer. The row is given as
+ * an array of iovecs. Must be called under the mutex.
+ */
+static void
+wal_mem_append(struct wal_mem *mem, const struct wal_mem_record *record,
+	       const struct iovec *iov, int iovcnt)
+{
+	size_t size = sizeof(*record) + record->size;
+	if (size > mem->capacity) {
+		/*
+		 * The row doesn't fit in the buffer at all.
+		 * Drop everything and move the begin vclock
+		 * past it so that readers fall back on files.
+		 */
+		while (mem->begin < mem->end)
+			wal_mem_evict(mem);
+		if (record->type == WAL_MEM_ROW)
+			vclock_reset(&mem->begin_vclock, record->replica_id,
+				     record->lsn);
+		return;
+	}
+	while (mem->end + size - mem->begin > mem->capacity)
+		wal_mem_evict(mem);
+	uint64_t pos = mem->end;
+	wal_mem_copy_in(mem, pos, record, sizeof(*record));
+	pos += sizeof(*record);
+	for (int i = 0; i < iovcnt; i++) {
+		wal_mem_copy_in(mem, pos, iov[i].iov_base, iov[i].iov_len);
+		pos += iov[i].iov_len;
+	}
+	mem->end = pos;
+}
+
+int
+wal_mem_write(struct wal_mem *mem, struct xrow_header **rows, int row_count)
+{
+	struct iovec iov[XROW_IOVMAX];
+	tt_pthread_mutex_lock(&mem->mutex);
+	for (int i = 0; i < row_count; i++) {
+		struct xrow_header *row = rows[i];
+		int iovcnt = xrow_header_encode(row, 0, iov, 0);
+		if (iovcnt < 0) {
+			tt_pthread_mutex_unlock(&mem->mutex);
+			return -1;
+		}
+		struct wal_mem_record record;
+		memset(&record, 0, sizeof(record));
+		record.type = WAL_MEM_ROW;
+		for (int j = 0; j < iovcnt; j++)
+			record.size += iov[j].iov_len;
+		record.replica_id = row->replica_id;
+		record.lsn = row->lsn;
+		wal_mem_append(mem, &record, iov, iovcnt);
+	}
+	tt_pthread_mutex_unlock(&mem->mutex);
+	return 0;
+}
+
+void
+wal_mem_write_rotate(struct wal_mem *mem)
+{
+	struct wal_mem_record record;
+	memset(&record, 0, sizeof(record));
+	record.type = WAL_MEM_ROTATE;
+	tt_pthread_mutex_lock(&mem->mutex);
+	wal_mem_append(mem, &record, NULL, 0);
+	tt_pthread_mutex_unlock(&mem->mutex);
+}
+
+int
+wal_mem_seek(struct wal_mem *mem, const struct vclock *vclock,
+	     uint64_t *pos)
+{
+	int rc = -1;
+	tt_pthread_mutex_lock(&mem->mutex);
+	if (vclock_compare(&mem->begin_vclock, vclock) <= 0) {
+		*pos = mem->begin;
+		rc = 0;
+	}
+	tt_pthread_mutex_unlock(&mem->mutex);
+	return rc;
+}
+
+int
+wal_mem_read(struct wal_mem *mem, uint64_t *pos, struct ibuf *buf)
+{
+	tt_pthread_mutex_lock(&mem->mutex);
+	uint64_t begin = mem->begin;
+	uint64_t end = mem->end;
+	tt_pthread_mutex_unlock(&mem->mutex);
+	assert(*pos <= end);
+	if (*pos < begin)
+		return 1;
+	size_t size = end - *pos;
+	if (size == 0)
+		return 0;
+	char *data = ibuf_alloc(buf, size);
+	if (data == NULL) {
+		diag_set(OutOfMemory, size, "ibuf_alloc", "data");
+		return -1;
+	}
+	/*
+	 * Copy the records without holding the mutex so as not to
+	 * stall the WAL thread, which takes it on every write. The
+	 * records up to the end we've seen are immutable until they
+	 * are evicted, and the writer evicts a record before it
+	 * reuses its space, so if the records are still there after
+	 * copying, the copy is consistent.
+	 */
+	wal_mem_copy_out(mem, *pos, data, size);
+	tt_pthread_mutex_lock(&mem->mutex);
+	begin = mem->begin;
+	tt_pthread_mutex_unlock(&mem->mutex);
+	if (*pos < begin)
+		return 1;
+	*pos = end;
+	return 0;
+}
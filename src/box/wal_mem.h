@@ -0,0 +1,174 @@
+#pragma once
+/*
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "vclock/vclock.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct ibuf;
+struct xrow_header;
+
+/**
+ * WAL memory buffer - a ring of the most recently written rows
+ * shared by the WAL thread and relays.
+ *
+ * Every row committed to the WAL is also appended to the buffer
+ * in the encoded form. A relay that has caught up with the WAL
+ * reads new rows from the buffer instead of re-reading and
+ * decoding the xlog files, so that having many replicas doesn't
+ * multiply disk reads and decompression on the master. A relay
+ * that lags behind the oldest row stored in the buffer falls
+ * back on reading files.
+ *
+ * The buffer is addressed by logical byte positions, which only
+ * grow. A position is mapped to the data array modulo capacity.
+ */
+struct wal_mem {
+	/**
+	 * Protects all members below. The ring data is only read
+	 * without it, see wal_mem_read().
+	 */
+	pthread_mutex_t mutex;
+	/** Ring data. */
+	char *data;
+	/** Size of the data array. */
+	size_t capacity;
+	/** Position of the oldest record stored in the buffer. */
+	uint64_t begin;
+	/** Position following the newest record. */
+	uint64_t end;
+	/**
+	 * Vclock of the WAL before the oldest record stored in
+	 * the buffer: a reader whose vclock is greater than or
+	 * equal to it will find all rows it needs in the buffer.
+	 */
+	struct vclock begin_vclock;
+};
+
+enum wal_mem_record_type {
+	/** A row written to the WAL. */
+	WAL_MEM_ROW,
+	/** The WAL switched to a new xlog file. */
+	WAL_MEM_ROTATE,
+};
+
+/** Header of a record stored in the buffer. */
+struct wal_mem_record {
+	/** Record type, see wal_mem_record_type. */
+	uint32_t type;
+	/** Size of the encoded row following the header. */
+	uint32_t size;
+	/** Replica id of the row. */
+	uint32_t replica_id;
+	/** LSN of the row. */
+	int64_t lsn;
+};
+
+enum {
+	/** Default capacity of the WAL memory buffer. */
+	WAL_MEM_CAPACITY = 16 * 1024 * 1024,
+};
+
+/**
+ * Create a WAL memory buffer of the given capacity.
+ * Returns 0 on success, -1 on memory allocation error.
+ */
+int
+wal_mem_create(struct wal_mem *mem, size_t capacity);
+
+/** Destroy a WAL memory buffer. */
+void
+wal_mem_destroy(struct wal_mem *mem);
+
+/**
+ * Drop all records stored in the buffer and make it start
+ * from the given vclock.
+ */
+void
+wal_mem_reset(struct wal_mem *mem, const struct vclock *vclock);
+
+/**
+ * Append rows written to the WAL to the buffer, evicting the
+ * oldest records if there isn't enough space. A row that is
+ * bigger than the buffer capacity empties the buffer.
+ * Returns 0 on success, -1 on row encoding error.
+ */
+int
+wal_mem_write(struct wal_mem *mem, struct xrow_header **rows, int row_count);
+
+/** Append a rotation record to the buffer. */
+void
+wal_mem_write_rotate(struct wal_mem *mem);
+
+/**
+ * Find the position to read rows following the given vclock.
+ * Returns 0 and sets @a pos on success, -1 if some of the rows
+ * have already been evicted from the buffer.
+ */
+int
+wal_mem_seek(struct wal_mem *mem, const struct vclock *vclock,
+	     uint64_t *pos);
+
+/**
+ * Copy all records starting at @a pos to @a buf and advance
+ * @a pos past them. Records are copied as is: a header is
+ * followed by the encoded row, see wal_mem_record_decode().
+ *
+ * Returns 0 on success, 1 if the records at @a pos have already
+ * been evicted, -1 on memory allocation error. The mutex isn't
+ * held while the records are copied. If they are evicted
+ * meanwhile, 1 is returned and the data appended to @a buf must
+ * be discarded.
+ */
+int
+wal_mem_read(struct wal_mem *mem, uint64_t *pos, struct ibuf *buf);
+
+/**
+ * Decode a record header at @a pos copied by wal_mem_read() and
+ * advance @a pos to the encoded row.
+ */
+static inline void
+wal_mem_record_decode(struct wal_mem_record *record, const char **pos)
+{
+	memcpy(record, *pos, sizeof(*record));
+	*pos += sizeof(*record);
+}
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -96,6 +96,7 @@ const struct xlog_opts xlog_opts_default = {
 	.free_cache = false,
 	.sync_is_async = false,
 	.no_compression = false,
+	.zdict = NULL,
 };
 
 /* {{{ struct xlog_meta */
@@ -322,6 +323,39 @@ xlog_meta_parse(struct xlog_meta *meta, const char **data,
 	return 0;
 }
 
+int
+xlog_meta_set_instance_uuid(char *buf, size_t size,
+			    const struct tt_uuid *instance_uuid)
+{
+	const char *end = (const char *)memmem(buf, size, "\n\n", 2);
+	if (end == NULL) {
+		diag_set(XlogError, "failed to find xlog meta");
+		return -1;
+	}
+	char *pos = buf;
+	while (pos < end) {
+		char *eol = (char *)memchr(pos, '\n', end + 1 - pos);
+		assert(eol != NULL);
+		const char *key_end = (const char *)memchr(pos, ':', eol - pos);
+		if (key_end != NULL &&
+		    (xlog_meta_key_equal(pos, key_end, INSTANCE_UUID_KEY) ||
+		     xlog_meta_key_equal(pos, key_end, INSTANCE_UUID_KEY_V12))) {
+			char *val = (char *)key_end + 1;
+			while (*val == ' ' || *val == '\t')
+				++val;
+			if (eol - val != UUID_STR_LEN) {
+				diag_set(XlogError, "can't parse instance UUID");
+				return -1;
+			}
+			memcpy(val, tt_uuid_str(instance_uuid), UUID_STR_LEN);
+			return 0;
+		}
+		pos = eol + 1;
+	}
+	diag_set(XlogError, "failed to find instance UUID in xlog meta");
+	return -1;
+}
+
 /* struct xlog }}} */
 
 /* {{{ struct xdir */
@@ -1138,8 +1172,12 @@ xlog_tx_write_zstd(struct xlog *log)
 
 	uint32_t crc32c = 0;
 	struct iovec *iov;
-	/* 3 is compression level. */
-	ZSTD_compressBegin(log->zctx, 3);
+	if (log->opts.zdict != NULL) {
+		/* Compression level is stored in the dictionary. */
+		ZSTD_compressBegin_usingCDict(log->zctx, log->opts.zdict);
+	} else {
+		ZSTD_compressBegin(log->zctx, XLOG_ZSTD_COMPRESSION_LEVEL);
+	}
 	size_t offset = XLOG_FIXHEADER_SIZE;
 	for (iov = log->obuf.iov; iov->iov_len; ++iov) {
 		/* Estimate max output buffer size. */
@@ -1693,7 +1731,8 @@ xlog_fixheader_decode(struct xlog_fixheader *fixheader,
 
 int
 xlog_tx_decode(const char *data, const char *data_end,
-	       char *rows, char *rows_end, ZSTD_DStream *zdctx)
+	       char *rows, char *rows_end, ZSTD_DStream *zdctx,
+	       const ZSTD_DDict *zddict)
 {
 	/* Decode fixheader */
 	struct xlog_fixheader fixheader;
@@ -1732,7 +1771,10 @@ xlog_tx_decode(const char *data, const char *data_end,
 
 	/* Decompress zstd rows */
 	assert(fixheader.magic == zrow_marker);
-	ZSTD_initDStream(zdctx);
+	if (zddict != NULL)
+		ZSTD_initDStream_usingDDict(zdctx, zddict);
+	else
+		ZSTD_initDStream(zdctx);
 	int rc = xlog_cursor_decompress(&rows, rows_end, &data, data_end,
 					zdctx);
 	if (rc < 0) {
@@ -1756,7 +1798,7 @@ xlog_tx_decode(const char *data, const char *data_end,
 ssize_t
 xlog_tx_cursor_create(struct xlog_tx_cursor *tx_cursor,
 		      const char **data, const char *data_end,
-		      ZSTD_DStream *zdctx)
+		      ZSTD_DStream *zdctx, const ZSTD_DDict *zddict)
 {
 	const char *rpos = *data;
 	struct xlog_fixheader fixheader;
@@ -1798,7 +1840,10 @@ xlog_tx_cursor_create(struct xlog_tx_cursor *tx_cursor,
 	};
 
 	assert(fixheader.magic == zrow_marker);
-	ZSTD_initDStream(zdctx);
+	if (zddict != NULL)
+		ZSTD_initDStream_usingDDict(zdctx, zddict);
+	else
+		ZSTD_initDStream(zdctx);
 	int rc;
 	do {
 		if (ibuf_reserve(&tx_cursor->rows,
@@ -1895,7 +1940,8 @@ xlog_cursor_next_tx(struct xlog_cursor *i)
 	ssize_t to_load;
 	while ((to_load = xlog_tx_cursor_create(&i->tx_cursor,
 						(const char **)&i->rbuf.rpos,
-						i->rbuf.wpos, i->zdctx)) > 0) {
+						i->rbuf.wpos, i->zdctx,
+						i->zddict)) > 0) {
 		/* not enough data in read buffer */
 		int rc = xlog_cursor_ensure(i, ibuf_used(&i->rbuf) + to_load);
 		if (rc < 0)
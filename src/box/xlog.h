@@ -49,6 +49,15 @@ struct xrow_header;
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+enum {
+	/**
+	 * Level of zstd compression of xlog files. Dictionaries
+	 * passed in xlog_opts::zdict should be created with it so
+	 * that files compress alike with and without a dictionary.
+	 */
+	XLOG_ZSTD_COMPRESSION_LEVEL = 3,
+};
+
 /**
  * This structure combines all xlog write options set on xlog
  * creation.
@@ -82,6 +91,13 @@ struct xlog_opts {
 	 * to be read frequently, e.g. L1 run files in Vinyl.
 	 */
 	bool no_compression;
+	/**
+	 * Dictionary used for zstd compression or NULL if
+	 * compression shouldn't use a dictionary. Files written
+	 * with a dictionary can only be decoded with the same
+	 * dictionary, see xlog_tx_decode().
+	 */
+	const ZSTD_CDict *zdict;
 };
 
 extern const struct xlog_opts xlog_opts_default;
@@ -333,6 +349,19 @@ xlog_meta_create(struct xlog_meta *meta, const char *filetype,
 		 const struct vclock *vclock,
 		 const struct vclock *prev_vclock);
 
+/**
+ * Overwrite the instance UUID stored in the meta of an xlog file
+ * in place. @buf must point to the beginning of the file and
+ * contain the whole meta. Used to adopt checkpoint files received
+ * from another instance, see applier_fetch_checkpoint().
+ *
+ * @retval 0 success
+ * @retval -1 the meta is invalid or truncated, diag is set
+ */
+int
+xlog_meta_set_instance_uuid(char *buf, size_t size,
+			    const struct tt_uuid *instance_uuid);
+
 /* }}} */
 
 /**
@@ -582,6 +611,8 @@ struct xlog_tx_cursor
  * Create xlog tx iterator from memory data.
  * *data will be adjusted to end of tx
  *
+ * @param zdctx zstd decompression context
+ * @param zddict dictionary the data was compressed with or NULL
  * @retval 0 for Ok
  * @retval -1 for error
  * @retval >0 how many additional bytes should be read to parse tx
@@ -589,7 +620,7 @@ struct xlog_tx_cursor
 ssize_t
 xlog_tx_cursor_create(struct xlog_tx_cursor *cursor,
 		      const char **data, const char *data_end,
-		      ZSTD_DStream *zdctx);
+		      ZSTD_DStream *zdctx, const ZSTD_DDict *zddict);
 
 /**
  * Destroy xlog tx cursor and free all associated memory
@@ -627,13 +658,15 @@ xlog_tx_cursor_pos(struct xlog_tx_cursor *tx_cursor)
  * @param data_end the end of @a data buffer
  * @param[out] rows a buffer to store decoded rows
  * @param[out] rows_end the end of @a rows buffer
+ * @param zdctx zstd decompression context
+ * @param zddict dictionary the data was compressed with or NULL
  * @retval  0 success
  * @retval -1 error, check diag
  */
 int
 xlog_tx_decode(const char *data, const char *data_end,
 	       char *rows, char *rows_end,
-	       ZSTD_DStream *zdctx);
+	       ZSTD_DStream *zdctx, const ZSTD_DDict *zddict);
 
 /* }}} */
 
@@ -674,6 +707,12 @@ struct xlog_cursor {
 	struct xlog_tx_cursor tx_cursor;
 	/** ZSTD context for decompression */
 	ZSTD_DStream *zdctx;
+	/**
+	 * Dictionary used for decompression or NULL. Must be
+	 * set after opening the cursor if the file was written
+	 * with xlog_opts::zdict.
+	 */
+	const ZSTD_DDict *zddict;
 };
 
 /**
@@ -482,6 +482,27 @@ iproto_reply_id(struct obuf *out, uint64_t sync, uint32_t schema_version)
 	return 0;
 }
 
+int
+iproto_reply_stmt_id(struct obuf *out, uint32_t stmt_id, uint64_t sync,
+		     uint32_t schema_version)
+{
+	size_t size = IPROTO_HEADER_LEN + mp_sizeof_map(1) +
+		mp_sizeof_uint(IPROTO_STMT_ID) + mp_sizeof_uint(stmt_id);
+	char *buf = obuf_alloc(out, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "obuf_alloc", "buf");
+		return -1;
+	}
+	char *data = buf + IPROTO_HEADER_LEN;
+	data = mp_encode_map(data, 1);
+	data = mp_encode_uint(data, IPROTO_STMT_ID);
+	data = mp_encode_uint(data, stmt_id);
+	assert(size == (size_t)(data - buf));
+	iproto_header_encode(buf, IPROTO_OK, sync, schema_version,
+			     size - IPROTO_HEADER_LEN);
+	return 0;
+}
+
 int
 iproto_reply_vclock(struct obuf *out, const struct vclock *vclock,
 		    uint64_t sync, uint32_t schema_version)
@@ -751,6 +772,19 @@ iproto_reply_chunk(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
 }
 
+void
+iproto_reply_select_chunk(struct obuf *buf, struct obuf_svp *svp,
+			  uint64_t sync, uint32_t schema_version,
+			  uint32_t count)
+{
+	char *pos = (char *) obuf_svp_to_ptr(buf, svp);
+	iproto_header_encode(pos, IPROTO_CHUNK, sync, schema_version,
+			     obuf_size(buf) - svp->used - IPROTO_HEADER_LEN);
+	struct iproto_body_bin body = iproto_body_bin;
+	body.v_data_len = mp_bswap_u32(count);
+	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
+}
+
 int
 iproto_send_event(struct obuf *out, const char *key, size_t key_len,
 		  const char *data, const char *data_end)
@@ -798,9 +832,14 @@ iproto_send_event(struct obuf *out, const char *key, size_t key_len,
 	return 0;
 }
 
-int
-xrow_decode_dml(struct xrow_header *row, struct request *request,
-		uint64_t key_map)
+/**
+ * Decode a DML request. If @a allow_stmt is set, the keys of
+ * @a key_map may be omitted in a request that refers to a
+ * prepared statement.
+ */
+static int
+xrow_decode_dml_impl(struct xrow_header *row, struct request *request,
+		     uint64_t key_map, bool allow_stmt)
 {
 	memset(request, 0, sizeof(*request));
 	request->header = row;
@@ -850,6 +889,15 @@ error:
 		case IPROTO_ITERATOR:
 			request->iterator = mp_decode_uint(&value);
 			break;
+		case IPROTO_FETCH_SIZE:
+			request->fetch_size = mp_decode_uint(&value);
+			break;
+		case IPROTO_STMT_ID:
+			request->stmt_id = mp_decode_uint(&value);
+			break;
+		case IPROTO_STMT_TYPE:
+			request->stmt_type = mp_decode_uint(&value);
+			break;
 		case IPROTO_TUPLE:
 			request->tuple = value;
 			request->tuple_end = data;
@@ -858,6 +906,10 @@ error:
 			request->key = value;
 			request->key_end = data;
 			break;
+		case IPROTO_KEY_END:
+			request->end_key = value;
+			request->end_key_end = data;
+			break;
 		case IPROTO_OPS:
 			request->ops = value;
 			request->ops_end = data;
@@ -871,15 +923,45 @@ error:
 		}
 	}
 done:
+	/*
+	 * Parameters of a prepared statement are bound and
+	 * checked in the tx thread, see box_stmt_bind().
+	 */
+	if (allow_stmt && request->stmt_id != 0)
+		key_map = 0;
 	if (key_map) {
 		enum iproto_key key = (enum iproto_key) bit_ctz_u64(key_map);
 		xrow_on_decode_err(row, ER_MISSING_REQUEST_FIELD,
 				   iproto_key_name(key));
 		return -1;
 	}
+	/*
+	 * IPROTO_KEY_END doesn't fit in the key map, which is limited
+	 * to 64 keys, so check it explicitly.
+	 */
+	if (request->type == IPROTO_DELETE_RANGE && request->end_key == NULL &&
+	    !(allow_stmt && request->stmt_id != 0)) {
+		xrow_on_decode_err(row, ER_MISSING_REQUEST_FIELD,
+				   iproto_key_name(IPROTO_KEY_END));
+		return -1;
+	}
 	return 0;
 }
 
+int
+xrow_decode_dml(struct xrow_header *row, struct request *request,
+		uint64_t key_map)
+{
+	return xrow_decode_dml_impl(row, request, key_map, false);
+}
+
+int
+xrow_decode_dml_iproto(struct xrow_header *row, struct request *request,
+		       uint64_t key_map)
+{
+	return xrow_decode_dml_impl(row, request, key_map, true);
+}
+
 static int
 request_snprint(char *buf, int size, const struct request *request)
 {
@@ -896,6 +978,10 @@ request_snprint(char *buf, int size, const struct request *request)
 		SNPRINT(total, snprintf, buf, size, ", key: ");
 		SNPRINT(total, mp_snprint, buf, size, request->key);
 	}
+	if (request->end_key != NULL) {
+		SNPRINT(total, snprintf, buf, size, ", end_key: ");
+		SNPRINT(total, mp_snprint, buf, size, request->end_key);
+	}
 	if (request->tuple != NULL) {
 		SNPRINT(total, snprintf, buf, size, ", tuple: ");
 		SNPRINT(total, mp_snprint, buf, size, request->tuple);
@@ -924,11 +1010,12 @@ xrow_encode_dml(const struct request *request, struct region *region,
 	int iovcnt = 1;
 	const int MAP_LEN_MAX = 40;
 	uint32_t key_len = request->key_end - request->key;
+	uint32_t end_key_len = request->end_key_end - request->end_key;
 	uint32_t ops_len = request->ops_end - request->ops;
 	uint32_t tuple_meta_len = request->tuple_meta_end - request->tuple_meta;
 	uint32_t tuple_len = request->tuple_end - request->tuple;
-	uint32_t len = MAP_LEN_MAX + key_len + ops_len + tuple_meta_len +
-		       tuple_len;
+	uint32_t len = MAP_LEN_MAX + key_len + end_key_len + ops_len +
+		       tuple_meta_len + tuple_len;
 	char *begin = (char *) region_alloc(region, len);
 	if (begin == NULL) {
 		diag_set(OutOfMemory, len, "region_alloc", "begin");
@@ -957,6 +1044,12 @@ xrow_encode_dml(const struct request *request, struct region *region,
 		pos += key_len;
 		map_size++;
 	}
+	if (request->end_key) {
+		pos = mp_encode_uint(pos, IPROTO_KEY_END);
+		memcpy(pos, request->end_key, end_key_len);
+		pos += end_key_len;
+		map_size++;
+	}
 	if (request->ops) {
 		pos = mp_encode_uint(pos, IPROTO_OPS);
 		memcpy(pos, request->ops, ops_len);
@@ -1292,6 +1385,15 @@ error:
 			request->args = value;
 			request->args_end = data;
 			break;
+		case IPROTO_FETCH_SIZE:
+			/*
+			 * Results of CALL and EVAL are materialized by
+			 * the function before they are sent, so they
+			 * aren't streamed in chunks.
+			 */
+			diag_set(ClientError, ER_UNSUPPORTED,
+				 iproto_type_name(row->type), "fetch_size");
+			return -1;
 		default:
 			continue; /* unknown key */
 		}
@@ -1679,11 +1781,14 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter)
+		      uint32_t id_filter, const uint32_t *space_filter,
+		      uint32_t space_filter_size)
 {
 	memset(row, 0, sizeof(*row));
 	size_t size = XROW_BODY_LEN_MAX +
-		      mp_sizeof_vclock_ignore0(vclock);
+		      mp_sizeof_vclock_ignore0(vclock) +
+		      mp_sizeof_array(space_filter_size) +
+		      space_filter_size * mp_sizeof_uint(UINT32_MAX);
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
@@ -1691,7 +1796,12 @@ xrow_encode_subscribe(struct xrow_header *row,
 	}
 	char *data = buf;
 	int filter_size = bit_count_u32(id_filter);
-	data = mp_encode_map(data, filter_size != 0 ? 6 : 5);
+	uint32_t map_size = 5;
+	if (filter_size != 0)
+		map_size++;
+	if (space_filter_size != 0)
+		map_size++;
+	data = mp_encode_map(data, map_size);
 	data = mp_encode_uint(data, IPROTO_CLUSTER_UUID);
 	data = xrow_encode_uuid(data, replicaset_uuid);
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
@@ -1713,6 +1823,12 @@ xrow_encode_subscribe(struct xrow_header *row,
 			data = mp_encode_uint(data, id);
 		}
 	}
+	if (space_filter_size != 0) {
+		data = mp_encode_uint(data, IPROTO_SPACE_FILTER);
+		data = mp_encode_array(data, space_filter_size);
+		for (uint32_t i = 0; i < space_filter_size; i++)
+			data = mp_encode_uint(data, space_filter[i]);
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
@@ -1725,7 +1841,8 @@ int
 xrow_decode_subscribe(const struct xrow_header *row,
 		      struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
-		      uint32_t *version_id, bool *anon, uint32_t *id_filter)
+		      uint32_t *version_id, bool *anon, uint32_t *id_filter,
+		      uint32_t **space_filter, uint32_t *space_filter_size)
 {
 	if (row->bodycnt == 0) {
 		diag_set(ClientError, ER_INVALID_MSGPACK, "request body");
@@ -1750,6 +1867,10 @@ xrow_decode_subscribe(const struct xrow_header *row,
 		*anon = false;
 	if (id_filter != NULL)
 		*id_filter = 0;
+	if (space_filter != NULL) {
+		*space_filter = NULL;
+		*space_filter_size = 0;
+	}
 
 	uint32_t map_size = mp_decode_map(&d);
 	for (uint32_t i = 0; i < map_size; i++) {
@@ -1825,6 +1946,38 @@ id_filter_decode_err:		xrow_on_decode_err(row, ER_INVALID_MSGPACK,
 				*id_filter |= 1 << val;
 			}
 			break;
+		case IPROTO_SPACE_FILTER: {
+			if (space_filter == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_ARRAY) {
+space_filter_decode_err:	xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid SPACE_FILTER");
+				return -1;
+			}
+			uint32_t count = mp_decode_array(&d);
+			if (count == 0)
+				break;
+			size_t size;
+			uint32_t *ids = region_alloc_array(&fiber()->gc,
+							   typeof(ids[0]),
+							   count, &size);
+			if (ids == NULL) {
+				diag_set(OutOfMemory, size,
+					 "region_alloc_array", "space_filter");
+				return -1;
+			}
+			for (uint32_t i = 0; i < count; ++i) {
+				if (mp_typeof(*d) != MP_UINT)
+					goto space_filter_decode_err;
+				uint64_t val = mp_decode_uint(&d);
+				if (val > UINT32_MAX)
+					goto space_filter_decode_err;
+				ids[i] = val;
+			}
+			*space_filter = ids;
+			*space_filter_size = count;
+			break;
+		}
 		default: skip:
 			mp_next(&d); /* value */
 		}
@@ -1859,6 +2012,158 @@ xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
 	return 0;
 }
 
+int
+xrow_encode_fetch_checkpoint(struct xrow_header *row,
+			     const struct tt_uuid *instance_uuid)
+{
+	if (xrow_encode_join(row, instance_uuid) != 0)
+		return -1;
+	row->type = IPROTO_FETCH_CHECKPOINT;
+	return 0;
+}
+
+int
+xrow_encode_file(struct xrow_header *row, const char *name, uint64_t size)
+{
+	memset(row, 0, sizeof(*row));
+	uint32_t name_len = strlen(name);
+	size_t buf_size = mp_sizeof_map(2) +
+			  mp_sizeof_uint(IPROTO_FILE_NAME) +
+			  mp_sizeof_str(name_len) +
+			  mp_sizeof_uint(IPROTO_FILE_SIZE) +
+			  mp_sizeof_uint(size);
+	char *buf = (char *)region_alloc(&fiber()->gc, buf_size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, buf_size, "region_alloc", "buf");
+		return -1;
+	}
+	char *data = buf;
+	data = mp_encode_map(data, 2);
+	data = mp_encode_uint(data, IPROTO_FILE_NAME);
+	data = mp_encode_str(data, name, name_len);
+	data = mp_encode_uint(data, IPROTO_FILE_SIZE);
+	data = mp_encode_uint(data, size);
+	assert(data == buf + buf_size);
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = buf_size;
+	row->bodycnt = 1;
+	row->type = IPROTO_FILE;
+	return 0;
+}
+
+int
+xrow_encode_file_data(struct xrow_header *row, const char *data,
+		      uint32_t size)
+{
+	memset(row, 0, sizeof(*row));
+	size_t buf_size = mp_sizeof_map(1) +
+			  mp_sizeof_uint(IPROTO_FILE_CHUNK) +
+			  mp_sizeof_binl(size);
+	char *buf = (char *)region_alloc(&fiber()->gc, buf_size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, buf_size, "region_alloc", "buf");
+		return -1;
+	}
+	char *pos = buf;
+	pos = mp_encode_map(pos, 1);
+	pos = mp_encode_uint(pos, IPROTO_FILE_CHUNK);
+	pos = mp_encode_binl(pos, size);
+	assert(pos == buf + buf_size);
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = buf_size;
+	row->body[1].iov_base = (void *)data;
+	row->body[1].iov_len = size;
+	row->bodycnt = 2;
+	row->type = IPROTO_FILE_DATA;
+	return 0;
+}
+
+int
+xrow_encode_file_end(struct xrow_header *row, uint32_t crc32)
+{
+	memset(row, 0, sizeof(*row));
+	size_t buf_size = mp_sizeof_map(1) +
+			  mp_sizeof_uint(IPROTO_FILE_CRC32) +
+			  mp_sizeof_uint(crc32);
+	char *buf = (char *)region_alloc(&fiber()->gc, buf_size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, buf_size, "region_alloc", "buf");
+		return -1;
+	}
+	char *data = buf;
+	data = mp_encode_map(data, 1);
+	data = mp_encode_uint(data, IPROTO_FILE_CRC32);
+	data = mp_encode_uint(data, crc32);
+	assert(data == buf + buf_size);
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = buf_size;
+	row->bodycnt = 1;
+	row->type = IPROTO_FILE_END;
+	return 0;
+}
+
+int
+xrow_decode_file(const struct xrow_header *row, struct file_request *request)
+{
+	memset(request, 0, sizeof(*request));
+	if (row->bodycnt == 0) {
+		diag_set(ClientError, ER_INVALID_MSGPACK, "request body");
+		return -1;
+	}
+	assert(row->bodycnt == 1);
+	const char *d = (const char *)row->body[0].iov_base;
+	if (mp_typeof(*d) != MP_MAP) {
+		xrow_on_decode_err(row, ER_INVALID_MSGPACK, "request body");
+		return -1;
+	}
+	uint32_t map_size = mp_decode_map(&d);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*d) != MP_UINT) {
+			mp_next(&d);
+			mp_next(&d);
+			continue;
+		}
+		uint64_t key = mp_decode_uint(&d);
+		switch (key) {
+		case IPROTO_FILE_NAME:
+			if (mp_typeof(*d) != MP_STR) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid file name");
+				return -1;
+			}
+			request->name = mp_decode_str(&d, &request->name_len);
+			break;
+		case IPROTO_FILE_SIZE:
+			if (mp_typeof(*d) != MP_UINT) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid file size");
+				return -1;
+			}
+			request->size = mp_decode_uint(&d);
+			break;
+		case IPROTO_FILE_CHUNK:
+			if (mp_typeof(*d) != MP_BIN) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid file chunk");
+				return -1;
+			}
+			request->data = mp_decode_bin(&d, &request->data_len);
+			break;
+		case IPROTO_FILE_CRC32:
+			if (mp_typeof(*d) != MP_UINT) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid file crc32");
+				return -1;
+			}
+			request->crc32 = mp_decode_uint(&d);
+			break;
+		default:
+			mp_next(&d);
+		}
+	}
+	return 0;
+}
+
 int
 xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock)
 {
@@ -185,6 +185,9 @@ struct request {
 	/** Search key. */
 	const char *key;
 	const char *key_end;
+	/** Exclusive upper bound of the range, DELETE_RANGE only. */
+	const char *end_key;
+	const char *end_key_end;
 	/** Insert/replace/upsert tuple or proc argument or update operations. */
 	const char *tuple;
 	const char *tuple_end;
@@ -196,6 +199,16 @@ struct request {
 	const char *tuple_meta_end;
 	/** Base field offset for UPDATE/UPSERT, e.g. 0 for C and 1 for Lua. */
 	int index_base;
+	/** Max number of tuples in a SELECT reply message, 0 if unlimited. */
+	uint32_t fetch_size;
+	/**
+	 * Id of a prepared statement the request parameters are
+	 * bound from, 0 if not set. For IPROTO_BOX_PREPARE, id of
+	 * the statement to deallocate.
+	 */
+	uint32_t stmt_id;
+	/** Type of the request to prepare, IPROTO_BOX_PREPARE only. */
+	uint32_t stmt_type;
 };
 
 /**
@@ -216,6 +229,17 @@ int
 xrow_decode_dml(struct xrow_header *xrow, struct request *request,
 		uint64_t key_map);
 
+/**
+ * Decode a DML request received from a client. Same as
+ * xrow_decode_dml(), but the keys of @a key_map may be omitted
+ * if the request refers to a prepared statement with
+ * IPROTO_STMT_ID. They are checked when the statement is bound,
+ * @sa box_stmt_bind().
+ */
+int
+xrow_decode_dml_iproto(struct xrow_header *xrow, struct request *request,
+		       uint64_t key_map);
+
 /**
  * Encode the request fields to iovec using region_alloc().
  * @param request request to encode
@@ -476,6 +500,9 @@ xrow_encode_register(struct xrow_header *row,
  * @param anon Whether it is an anonymous subscribe request or not.
  * @param id_filter A List of replica ids to skip rows from
  *		    when feeding a replica.
+ * @param space_filter Ids of user spaces to replicate.
+ * @param space_filter_size Number of ids in @a space_filter,
+ *			    0 means all spaces are replicated.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
@@ -485,7 +512,8 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter);
+		      uint32_t id_filter, const uint32_t *space_filter,
+		      uint32_t space_filter_size);
 
 /**
  * Decode SUBSCRIBE command.
@@ -497,6 +525,9 @@ xrow_encode_subscribe(struct xrow_header *row,
  * @param[out] anon Whether it is an anonymous subscribe.
  * @param[out] id_filter A list of ids to skip rows from when
  *			 feeding a replica.
+ * @param[out] space_filter Ids of user spaces to replicate,
+ *			    allocated on the fiber region.
+ * @param[out] space_filter_size Number of ids in @a space_filter.
  *
  * @retval  0 Success.
  * @retval -1 Memory or format error.
@@ -505,7 +536,8 @@ int
 xrow_decode_subscribe(const struct xrow_header *row,
 		      struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
-		      uint32_t *version_id, bool *anon, uint32_t *id_filter);
+		      uint32_t *version_id, bool *anon, uint32_t *id_filter,
+		      uint32_t **space_filter, uint32_t *space_filter_size);
 
 /**
  * Encode JOIN command.
@@ -532,7 +564,7 @@ xrow_decode_join(const struct xrow_header *row, struct tt_uuid *instance_uuid,
 		 uint32_t *version_id)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, NULL, version_id,
-				     NULL, NULL);
+				     NULL, NULL, NULL, NULL);
 }
 
 /**
@@ -551,9 +583,90 @@ xrow_decode_register(const struct xrow_header *row,
 		     uint32_t *version_id)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, vclock,
-				     version_id, NULL, NULL);
+				     version_id, NULL, NULL, NULL, NULL);
 }
 
+/**
+ * Encode FETCH_CHECKPOINT command. The body is the same as the body
+ * of JOIN command.
+ * @param[out] row Row to encode into.
+ * @param instance_uuid.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_fetch_checkpoint(struct xrow_header *row,
+			     const struct tt_uuid *instance_uuid);
+
+/**
+ * A checkpoint file transfer row: IPROTO_FILE, IPROTO_FILE_DATA,
+ * or IPROTO_FILE_END, see box_process_fetch_checkpoint().
+ */
+struct file_request {
+	/** File name relative to the engine directory (IPROTO_FILE). */
+	const char *name;
+	/** Length of @name. */
+	uint32_t name_len;
+	/** File size (IPROTO_FILE). */
+	uint64_t size;
+	/** File chunk (IPROTO_FILE_DATA). */
+	const char *data;
+	/** Length of @data. */
+	uint32_t data_len;
+	/** CRC32 of the file content (IPROTO_FILE_END). */
+	uint32_t crc32;
+};
+
+/**
+ * Encode the header of a file sent in response to FETCH_CHECKPOINT.
+ * @param[out] row Row to encode into.
+ * @param name File name relative to the engine directory.
+ * @param size File size.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_file(struct xrow_header *row, const char *name, uint64_t size);
+
+/**
+ * Encode a file chunk. The chunk isn't copied: it is attached to
+ * the row as the second body iovec so it must stay valid until
+ * the row is written.
+ * @param[out] row Row to encode into.
+ * @param data Chunk.
+ * @param size Chunk size.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_file_data(struct xrow_header *row, const char *data,
+		      uint32_t size);
+
+/**
+ * Encode the end of a file.
+ * @param[out] row Row to encode into.
+ * @param crc32 CRC32 of the file content.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_file_end(struct xrow_header *row, uint32_t crc32);
+
+/**
+ * Decode IPROTO_FILE, IPROTO_FILE_DATA, or IPROTO_FILE_END.
+ * @param row Row to decode.
+ * @param[out] request Decoded request.
+ *
+ * @retval  0 Success.
+ * @retval -1 Format error.
+ */
+int
+xrow_decode_file(const struct xrow_header *row, struct file_request *request);
+
 /**
  * Encode end of stream command (a response to JOIN command).
  * @param row[out] Row to encode into.
@@ -576,7 +689,8 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock);
 static inline int
 xrow_decode_vclock(const struct xrow_header *row, struct vclock *vclock)
 {
-	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL);
+	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL,
+				     NULL, NULL);
 }
 
 /**
@@ -608,7 +722,7 @@ xrow_decode_subscribe_response(const struct xrow_header *row,
 			       struct vclock *vclock)
 {
 	return xrow_decode_subscribe(row, replicaset_uuid, NULL, vclock, NULL,
-				     NULL, NULL);
+				     NULL, NULL, NULL, NULL);
 }
 
 /**
@@ -694,6 +808,21 @@ iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 int
 iproto_reply_ok(struct obuf *out, uint64_t sync, uint32_t schema_version);
 
+/**
+ * Encode iproto header with IPROTO_OK response code and
+ * a prepared statement id in the body.
+ * @param out Encode to.
+ * @param stmt_id Prepared statement id.
+ * @param sync Request sync.
+ * @param schema_version.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+iproto_reply_stmt_id(struct obuf *out, uint32_t stmt_id, uint64_t sync,
+		     uint32_t schema_version);
+
 /**
  * Encode iproto header with IPROTO_OK response code and protocol features
  * in the body.
@@ -788,6 +917,16 @@ void
 iproto_reply_chunk(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		   uint32_t schema_version);
 
+/**
+ * Write an IPROTO_CHUNK header carrying @a count tuples of
+ * a SELECT reply to a buffer prepared with
+ * iproto_prepare_select().
+ */
+void
+iproto_reply_select_chunk(struct obuf *buf, struct obuf_svp *svp,
+			  uint64_t sync, uint32_t schema_version,
+			  uint32_t count);
+
 /**
  * Encode IPROTO_EVENT packet.
  * @param out Encode to.
@@ -1042,10 +1181,12 @@ xrow_encode_subscribe_xc(struct xrow_header *row,
 			 const struct tt_uuid *replicaset_uuid,
 			 const struct tt_uuid *instance_uuid,
 			 const struct vclock *vclock, bool anon,
-			 uint32_t id_filter)
+			 uint32_t id_filter, const uint32_t *space_filter,
+			 uint32_t space_filter_size)
 {
 	if (xrow_encode_subscribe(row, replicaset_uuid, instance_uuid,
-				  vclock, anon, id_filter) != 0)
+				  vclock, anon, id_filter, space_filter,
+				  space_filter_size) != 0)
 		diag_raise();
 }
 
@@ -1055,11 +1196,13 @@ xrow_decode_subscribe_xc(const struct xrow_header *row,
 			 struct tt_uuid *replicaset_uuid,
 			 struct tt_uuid *instance_uuid, struct vclock *vclock,
 			 uint32_t *replica_version_id, bool *anon,
-			 uint32_t *id_filter)
+			 uint32_t *id_filter, uint32_t **space_filter,
+			 uint32_t *space_filter_size)
 {
 	if (xrow_decode_subscribe(row, replicaset_uuid, instance_uuid,
 				  vclock, replica_version_id, anon,
-				  id_filter) != 0)
+				  id_filter, space_filter,
+				  space_filter_size) != 0)
 		diag_raise();
 }
 
@@ -1091,6 +1234,49 @@ xrow_decode_register_xc(const struct xrow_header *row,
 		diag_raise();
 }
 
+/** @copydoc xrow_encode_fetch_checkpoint. */
+static inline void
+xrow_encode_fetch_checkpoint_xc(struct xrow_header *row,
+				const struct tt_uuid *instance_uuid)
+{
+	if (xrow_encode_fetch_checkpoint(row, instance_uuid) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_encode_file. */
+static inline void
+xrow_encode_file_xc(struct xrow_header *row, const char *name, uint64_t size)
+{
+	if (xrow_encode_file(row, name, size) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_encode_file_data. */
+static inline void
+xrow_encode_file_data_xc(struct xrow_header *row, const char *data,
+			 uint32_t size)
+{
+	if (xrow_encode_file_data(row, data, size) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_encode_file_end. */
+static inline void
+xrow_encode_file_end_xc(struct xrow_header *row, uint32_t crc32)
+{
+	if (xrow_encode_file_end(row, crc32) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_decode_file. */
+static inline void
+xrow_decode_file_xc(const struct xrow_header *row,
+		    struct file_request *request)
+{
+	if (xrow_decode_file(row, request) != 0)
+		diag_raise();
+}
+
 /** @copydoc xrow_encode_vclock. */
 static inline void
 xrow_encode_vclock_xc(struct xrow_header *row, const struct vclock *vclock)
@@ -1135,6 +1321,15 @@ iproto_reply_ok_xc(struct obuf *out, uint64_t sync, uint32_t schema_version)
 		diag_raise();
 }
 
+/** @copydoc iproto_reply_stmt_id. */
+static inline void
+iproto_reply_stmt_id_xc(struct obuf *out, uint32_t stmt_id, uint64_t sync,
+			uint32_t schema_version)
+{
+	if (iproto_reply_stmt_id(out, stmt_id, sync, schema_version) != 0)
+		diag_raise();
+}
+
 /** @copydoc iproto_reply_id. */
 static inline void
 iproto_reply_id_xc(struct obuf *out, uint64_t sync, uint32_t schema_version)
@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "busy_poll.h"
+
+#include <assert.h>
+
+static void
+busy_poll_idle_cb(struct ev_loop *loop, struct ev_idle *watcher, int events)
+{
+	(void)loop;
+	(void)events;
+	struct busy_poll *bp = (struct busy_poll *)watcher->data;
+	bp->was_idle = true;
+}
+
+static void
+busy_poll_prepare_cb(struct ev_loop *loop, struct ev_prepare *watcher,
+		     int events)
+{
+	(void)events;
+	struct busy_poll *bp = (struct busy_poll *)watcher->data;
+	double now = ev_monotonic_now(loop);
+	if (bp->was_idle) {
+		/* Nothing happened on the last iteration. */
+		bp->was_idle = false;
+		bp->spin_time += now - bp->last_prepare;
+		if (bp->idle_start == 0)
+			bp->idle_start = bp->last_prepare;
+		if (now - bp->idle_start >= bp->timeout) {
+			/* Out of budget, let the loop block. */
+			ev_idle_stop(loop, &bp->idle);
+			bp->idle_start = 0;
+			bp->sleep_count++;
+		}
+	} else {
+		/* Some events were processed, keep spinning. */
+		bp->idle_start = 0;
+		if (!ev_is_active(&bp->idle))
+			ev_idle_start(loop, &bp->idle);
+	}
+	bp->last_prepare = now;
+}
+
+void
+busy_poll_create(struct busy_poll *bp, struct ev_loop *loop)
+{
+	bp->loop = loop;
+	ev_idle_init(&bp->idle, busy_poll_idle_cb);
+	ev_set_priority(&bp->idle, EV_MINPRI);
+	bp->idle.data = bp;
+	ev_prepare_init(&bp->prepare, busy_poll_prepare_cb);
+	bp->prepare.data = bp;
+	bp->timeout = 0;
+	bp->was_idle = false;
+	bp->idle_start = 0;
+	bp->last_prepare = 0;
+	bp->spin_time = 0;
+	bp->sleep_count = 0;
+}
+
+void
+busy_poll_destroy(struct busy_poll *bp)
+{
+	busy_poll_set_timeout(bp, 0);
+}
+
+void
+busy_poll_set_timeout(struct busy_poll *bp, double timeout)
+{
+	assert(timeout >= 0);
+	bp->timeout = timeout;
+	if (timeout > 0) {
+		bp->last_prepare = ev_monotonic_now(bp->loop);
+		ev_prepare_start(bp->loop, &bp->prepare);
+		ev_idle_start(bp->loop, &bp->idle);
+	} else {
+		ev_prepare_stop(bp->loop, &bp->prepare);
+		ev_idle_stop(bp->loop, &bp->idle);
+		bp->was_idle = false;
+		bp->idle_start = 0;
+	}
+}
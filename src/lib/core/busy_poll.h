@@ -0,0 +1,77 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tarantool_ev.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Adaptive busy polling of an event loop.
+ *
+ * Normally, an event loop blocks in epoll_wait() when it has
+ * nothing to do, and another thread wakes it up with a write to
+ * an eventfd (ev_async_send()). At low latency targets the sleep
+ * and wakeup cost more than the request itself.
+ *
+ * When enabled, busy polling keeps the loop polling without
+ * blocking for the given timeout after the last iteration that
+ * had some events to process. ev_async_send() doesn't do any
+ * system calls while the target loop is spinning. Once the
+ * timeout expires without events, the loop blocks as usual
+ * until the next event.
+ *
+ * An empty iteration is detected with an idle watcher of the
+ * lowest priority: libev invokes it only if there are no other
+ * pending events.
+ */
+struct busy_poll {
+	/** The event loop polled by this object. */
+	struct ev_loop *loop;
+	/** Keeps the loop from blocking while active. */
+	struct ev_idle idle;
+	/** Invoked before every poll to account the last one. */
+	struct ev_prepare prepare;
+	/**
+	 * Time to keep polling after the last event, in seconds.
+	 * Zero if busy polling is disabled.
+	 */
+	double timeout;
+	/** Set by the idle watcher if the last iteration was empty. */
+	bool was_idle;
+	/** Start of the current run of empty iterations, or 0. */
+	double idle_start;
+	/** Time of the last prepare watcher invocation. */
+	double last_prepare;
+	/** Total time spent in empty iterations, in seconds. */
+	double spin_time;
+	/** Number of times the loop went to sleep after spinning. */
+	int64_t sleep_count;
+};
+
+/** Create a disabled busy poll object for the given loop. */
+void
+busy_poll_create(struct busy_poll *bp, struct ev_loop *loop);
+
+/** Stop busy polling and destroy the object. */
+void
+busy_poll_destroy(struct busy_poll *bp);
+
+/**
+ * Set the busy polling timeout. Zero disables busy polling.
+ * Must be called from the thread that owns the loop.
+ */
+void
+busy_poll_set_timeout(struct busy_poll *bp, double timeout);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
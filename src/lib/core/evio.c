@@ -56,6 +56,12 @@ struct evio_service_entry {
 	struct ev_io ev;
 	/** Pointer to the root evio_service, which contains this object */
 	struct evio_service *service;
+	/**
+	 * Set if the acceptor socket was bound by
+	 * evio_service_attach() rather than shared with
+	 * the source service, so it must be closed on detach.
+	 */
+	bool is_fd_owner;
 };
 
 static inline bool
@@ -159,6 +165,20 @@ evio_service_name(struct evio_service *service)
 	return service->name;
 }
 
+/**
+ * Check if a service entry should use a separate SO_REUSEPORT
+ * socket in every attached service, as requested by the
+ * 'reuseport' URI parameter.
+ */
+static bool
+evio_service_entry_is_reuseport(const struct evio_service_entry *entry)
+{
+	if (entry->addr.sa_family == AF_UNIX)
+		return false;
+	const char *value = uri_param(&entry->uri, "reuseport", 0);
+	return value != NULL && strcmp(value, "true") == 0;
+}
+
 /**
  * A callback invoked by libev when acceptor socket is ready.
  * Accept the socket, initialize it and pass to the on_accept
@@ -263,6 +283,18 @@ evio_service_entry_bind_addr(struct evio_service_entry *entry)
 				   SOCK_STREAM) != 0)
 		goto error;
 
+	if (evio_service_entry_is_reuseport(entry)) {
+#ifdef SO_REUSEPORT
+		int on = 1;
+		if (sio_setsockopt(fd, SOL_SOCKET, SO_REUSEPORT,
+				   &on, sizeof(on)) != 0)
+			goto error;
+#else
+		diag_set(IllegalParams, "SO_REUSEPORT is not supported");
+		goto error;
+#endif
+	}
+
 	if (sio_bind(fd, &entry->addr, entry->addr_len) != 0)
 		goto error;
 
@@ -320,6 +352,7 @@ evio_service_entry_create(struct evio_service_entry *entry,
 	ev_io_set(&entry->ev, -1, 0);
 	entry->ev.data = entry;
 	entry->service = service;
+	entry->is_fd_owner = false;
 }
 
 /**
@@ -385,6 +418,9 @@ evio_service_entry_detach(struct evio_service_entry *entry)
 		ev_io_stop(entry->service->loop, &entry->ev);
 		entry->addr_len = 0;
 	}
+	if (entry->is_fd_owner && entry->ev.fd >= 0 && close(entry->ev.fd) < 0)
+		say_error("Failed to close socket: %s", strerror(errno));
+	entry->is_fd_owner = false;
 	ev_io_set(&entry->ev, -1, 0);
 	uri_destroy(&entry->uri);
 }
@@ -396,8 +432,10 @@ evio_service_entry_stop(struct evio_service_entry *entry)
 	iostream_ctx_destroy(&entry->io_ctx);
 
 	int service_fd = entry->ev.fd;
+	bool is_fd_owner = entry->is_fd_owner;
 	evio_service_entry_detach(entry);
-	if (service_fd < 0)
+	/* An owned socket is closed on detach. */
+	if (service_fd < 0 || is_fd_owner)
 		return;
 
 	if (close(service_fd) < 0)
@@ -412,7 +450,7 @@ evio_service_entry_stop(struct evio_service_entry *entry)
 	}
 }
 
-static void
+static int
 evio_service_entry_attach(struct evio_service_entry *dst,
 			 const struct evio_service_entry *src)
 {
@@ -422,7 +460,20 @@ evio_service_entry_attach(struct evio_service_entry *dst,
 	dst->addrstorage = src->addrstorage;
 	dst->addr_len = src->addr_len;
 	dst->io_ctx = src->io_ctx;
+	if (evio_service_entry_is_reuseport(src)) {
+		/*
+		 * Bind a separate socket to the same address so
+		 * that the kernel spreads incoming connections
+		 * between attached services evenly, instead of
+		 * waking them all on the shared socket.
+		 */
+		if (evio_service_entry_bind_addr(dst) != 0)
+			return -1;
+		dst->is_fd_owner = true;
+		return 0;
+	}
 	ev_io_set(&dst->ev, src->ev.fd, EV_READ);
+	return 0;
 }
 
 static inline int
@@ -473,13 +524,20 @@ evio_service_create(struct ev_loop *loop, struct evio_service *service,
 	service->on_accept_param = on_accept_param;
 }
 
-void
+int
 evio_service_attach(struct evio_service *dst, const struct evio_service *src)
 {
 	assert(dst->entry_count == 0);
 	evio_service_create_entries(dst, src->entry_count);
-	for (int i = 0; i < src->entry_count; i++)
-		evio_service_entry_attach(&dst->entries[i], &src->entries[i]);
+	for (int i = 0; i < src->entry_count; i++) {
+		if (evio_service_entry_attach(&dst->entries[i],
+					      &src->entries[i]) != 0) {
+			/* Close the sockets bound for the other entries. */
+			evio_service_detach(dst);
+			return -1;
+		}
+	}
+	return 0;
 }
 
 void
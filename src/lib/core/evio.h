@@ -131,8 +131,14 @@ evio_service_stop(struct evio_service *service);
 
 /**
  * Updates @a dst evio_service socket settings according @a src evio service.
+ * The acceptor sockets are shared with @a src, unless the URI has the
+ * 'reuseport' parameter set to 'true': in this case @a dst binds its own
+ * SO_REUSEPORT sockets to the same addresses.
+ *
+ * @retval 0 for success
+ * @retval -1 on error, diag is set and @a dst is left detached
  */
-void
+int
 evio_service_attach(struct evio_service *dst, const struct evio_service *src);
 
 bool
@@ -16,6 +16,7 @@
 #include "sio.h"
 #include "ssl.h"
 #include "uri/uri.h"
+#include "zstd_iostream.h"
 
 static const struct iostream_vtab plain_iostream_vtab;
 
@@ -90,6 +91,7 @@ iostream_ctx_create(struct iostream_ctx *ctx, enum iostream_mode mode,
 		    const struct uri *uri)
 {
 	assert(mode == IOSTREAM_SERVER || mode == IOSTREAM_CLIENT);
+	iostream_ctx_clear(ctx);
 	ctx->mode = mode;
 	const char *transport = uri_param(uri, "transport", 0);
 	if (transport != NULL) {
@@ -97,17 +99,25 @@ iostream_ctx_create(struct iostream_ctx *ctx, enum iostream_mode mode,
 			ctx->ssl = ssl_iostream_ctx_new(mode, uri);
 			if (ctx->ssl == NULL)
 				goto err;
-		} else if (strcmp(transport, "plain") == 0) {
-			ctx->ssl = NULL;
-		} else {
+		} else if (strcmp(transport, "plain") != 0) {
 			diag_set(IllegalParams, "Invalid transport: %s",
 				 transport);
 			goto err;
 		}
 	}
+	const char *compression = uri_param(uri, "compression", 0);
+	if (compression != NULL) {
+		if (strcmp(compression, "zstd") == 0) {
+			ctx->is_compressed = true;
+		} else if (strcmp(compression, "none") != 0) {
+			diag_set(IllegalParams, "Invalid compression: %s",
+				 compression);
+			goto err;
+		}
+	}
 	return 0;
 err:
-	iostream_ctx_clear(ctx);
+	iostream_ctx_destroy(ctx);
 	return -1;
 }
 
@@ -129,6 +139,10 @@ iostream_create(struct iostream *io, int fd, const struct iostream_ctx *ctx)
 	} else {
 		plain_iostream_create(io, fd);
 	}
+	if (ctx->is_compressed && zstd_iostream_create(io) != 0) {
+		iostream_destroy(io);
+		goto err;
+	}
 	return 0;
 err:
 	iostream_clear(io);
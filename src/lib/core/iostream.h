@@ -240,6 +240,11 @@ struct iostream_ctx {
 	 * streams created with this context will be unencrypted.
 	 */
 	struct ssl_iostream_ctx *ssl;
+	/**
+	 * If set, streams created with this context compress all data
+	 * they send and decompress all data they receive with zstd.
+	 */
+	bool is_compressed;
 };
 
 /**
@@ -252,6 +257,7 @@ iostream_ctx_clear(struct iostream_ctx *ctx)
 {
 	ctx->mode = IOSTREAM_MODE_UNINITIALIZED;
 	ctx->ssl = NULL;
+	ctx->is_compressed = false;
 }
 
 /**
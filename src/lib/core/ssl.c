@@ -5,15 +5,29 @@
  */
 #include "ssl.h"
 
+#include <errno.h>
+#include <limits.h>
+#include <openssl/bio.h>
 #include <openssl/crypto.h>
 #include <openssl/err.h>
 #include <openssl/evp.h>
 #include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/uio.h>
 
 #include "diag.h"
 #include "iostream.h"
+#include "sio.h"
+#include "ssl_error.h"
 #include "trivia/config.h"
+#include "trivia/util.h"
+#include "tt_static.h"
+#include "uri/uri.h"
 
 #if defined(ENABLE_SSL)
 # error unimplemented
@@ -40,11 +54,424 @@ ssl_free(void)
 #endif
 }
 
+#if OPENSSL_VERSION_NUMBER < 0x10100000L || defined(LIBRESSL_VERSION_NUMBER)
+# define TLS_server_method SSLv23_server_method
+# define TLS_client_method SSLv23_client_method
+#endif
+
+/**
+ * Returns the description of the earliest error in the OpenSSL
+ * error queue and clears the queue. The string is allocated on
+ * the static buffer.
+ */
+static const char *
+ssl_error_str(void)
+{
+	unsigned long err = ERR_get_error();
+	ERR_clear_error();
+	if (err == 0)
+		return "unknown error";
+	char *buf = tt_static_buf();
+	ERR_error_string_n(err, buf, TT_STATIC_BUF_LEN);
+	return buf;
+}
+
+struct ssl_iostream_ctx {
+	SSL_CTX *ctx;
+};
+
+/** Default password callback is replaced to never prompt for it. */
+static int
+ssl_password_cb(char *buf, int size, int rwflag, void *data)
+{
+	(void)rwflag;
+	const char *password = data;
+	if (password == NULL)
+		return 0;
+	int len = strlen(password);
+	if (len > size)
+		return 0;
+	memcpy(buf, password, len);
+	return len;
+}
+
+/**
+ * Makes a client check that the server certificate was issued for
+ * the host from the URI, as a DNS name or an IP address. There's no
+ * host to check for a Unix socket, so only the chain is verified.
+ */
+static int
+ssl_ctx_set_verify_host(SSL_CTX *ctx, const struct uri *uri)
+{
+	if (uri->host == NULL || strcmp(uri->host, URI_HOST_UNIX) == 0)
+		return 0;
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L
+	X509_VERIFY_PARAM *param = SSL_CTX_get0_param(ctx);
+	/* Host hints: 1 - IPv4 address, 2 - IPv6 address. */
+	int rc = uri->host_hint == 1 || uri->host_hint == 2 ?
+		 X509_VERIFY_PARAM_set1_ip_asc(param, uri->host) :
+		 X509_VERIFY_PARAM_set1_host(param, uri->host, 0);
+	if (rc != 1) {
+		diag_set(SSLError, "Failed to set SSL host '%s': %s",
+			 uri->host, ssl_error_str());
+		return -1;
+	}
+	X509_VERIFY_PARAM_set_hostflags(param,
+					X509_CHECK_FLAG_NO_PARTIAL_WILDCARDS);
+	return 0;
+#else
+	(void)ctx;
+	diag_set(IllegalParams, "ssl_ca_file requires OpenSSL 1.0.2 or "
+		 "newer to verify the server host");
+	return -1;
+#endif
+}
+
 struct ssl_iostream_ctx *
 ssl_iostream_ctx_new(enum iostream_mode mode, const struct uri *uri)
 {
-	(void)mode;
-	(void)uri;
-	diag_set(IllegalParams, "SSL is not available in this build");
+	assert(mode == IOSTREAM_SERVER || mode == IOSTREAM_CLIENT);
+	const char *key_file = uri_param(uri, "ssl_key_file", 0);
+	const char *cert_file = uri_param(uri, "ssl_cert_file", 0);
+	const char *password = uri_param(uri, "ssl_password", 0);
+	const char *ca_file = uri_param(uri, "ssl_ca_file", 0);
+	const char *ciphers = uri_param(uri, "ssl_ciphers", 0);
+	if (mode == IOSTREAM_SERVER &&
+	    (key_file == NULL || cert_file == NULL)) {
+		diag_set(IllegalParams, "ssl_key_file and ssl_cert_file "
+			 "parameters are mandatory for a server");
+		return NULL;
+	}
+	if ((key_file == NULL) != (cert_file == NULL)) {
+		diag_set(IllegalParams, "ssl_key_file and ssl_cert_file "
+			 "parameters must be set together");
+		return NULL;
+	}
+	ERR_clear_error();
+	SSL_CTX *ctx = SSL_CTX_new(mode == IOSTREAM_SERVER ?
+				   TLS_server_method() : TLS_client_method());
+	if (ctx == NULL) {
+		diag_set(SSLError, "Failed to create SSL context: %s",
+			 ssl_error_str());
+		return NULL;
+	}
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L && !defined(LIBRESSL_VERSION_NUMBER)
+	SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+#else
+	SSL_CTX_set_options(ctx, SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3 |
+				 SSL_OP_NO_TLSv1 | SSL_OP_NO_TLSv1_1);
+#endif
+	SSL_CTX_set_options(ctx, SSL_OP_NO_COMPRESSION);
+#ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+	/* Treat a peer closing the socket as a regular EOF. */
+	SSL_CTX_set_options(ctx, SSL_OP_IGNORE_UNEXPECTED_EOF);
+#endif
+#ifdef SSL_OP_ENABLE_KTLS
+	/*
+	 * Let the kernel encrypt and decrypt records after the
+	 * handshake. OpenSSL falls back to doing it in userspace
+	 * if the kernel doesn't support the negotiated cipher.
+	 */
+	SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+#endif
+	/* Don't keep IO buffers of idle connections. */
+	SSL_CTX_set_mode(ctx, SSL_MODE_RELEASE_BUFFERS);
+	SSL_CTX_set_default_passwd_cb(ctx, ssl_password_cb);
+	SSL_CTX_set_default_passwd_cb_userdata(ctx, (void *)password);
+	if (cert_file != NULL &&
+	    SSL_CTX_use_certificate_chain_file(ctx, cert_file) != 1) {
+		diag_set(SSLError, "Failed to load SSL certificate file %s: %s",
+			 cert_file, ssl_error_str());
+		goto err;
+	}
+	if (key_file != NULL &&
+	    (SSL_CTX_use_PrivateKey_file(ctx, key_file,
+					 SSL_FILETYPE_PEM) != 1 ||
+	     SSL_CTX_check_private_key(ctx) != 1)) {
+		diag_set(SSLError, "Failed to load SSL key file %s: %s",
+			 key_file, ssl_error_str());
+		goto err;
+	}
+	/* The password isn't needed anymore, and the URI may go away. */
+	SSL_CTX_set_default_passwd_cb_userdata(ctx, NULL);
+	if (ca_file != NULL) {
+		if (SSL_CTX_load_verify_locations(ctx, ca_file, NULL) != 1) {
+			diag_set(SSLError, "Failed to load SSL CA file %s: %s",
+				 ca_file, ssl_error_str());
+			goto err;
+		}
+		int verify = SSL_VERIFY_PEER;
+		if (mode == IOSTREAM_SERVER)
+			verify |= SSL_VERIFY_FAIL_IF_NO_PEER_CERT;
+		SSL_CTX_set_verify(ctx, verify, NULL);
+		if (mode == IOSTREAM_CLIENT &&
+		    ssl_ctx_set_verify_host(ctx, uri) != 0)
+			goto err;
+	}
+	if (ciphers != NULL && SSL_CTX_set_cipher_list(ctx, ciphers) != 1) {
+		diag_set(SSLError, "Failed to set SSL ciphers to '%s': %s",
+			 ciphers, ssl_error_str());
+		goto err;
+	}
+	struct ssl_iostream_ctx *ssl_ctx = malloc(sizeof(*ssl_ctx));
+	if (ssl_ctx == NULL) {
+		diag_set(OutOfMemory, sizeof(*ssl_ctx), "malloc",
+			 "struct ssl_iostream_ctx");
+		goto err;
+	}
+	ssl_ctx->ctx = ctx;
+	return ssl_ctx;
+err:
+	SSL_CTX_free(ctx);
 	return NULL;
 }
+
+void
+ssl_iostream_ctx_delete(struct ssl_iostream_ctx *ctx)
+{
+	SSL_CTX_free(ctx->ctx);
+	free(ctx);
+}
+
+struct ssl_iostream {
+	SSL *ssl;
+	/**
+	 * Buffer used to coalesce written data into TLS records,
+	 * allocated on the first write that needs it.
+	 */
+	char *wbuf;
+	/**
+	 * Size of the data stored in the write buffer that was
+	 * passed to SSL_write(), but hasn't been written yet.
+	 * OpenSSL requires such a write to be retried with the
+	 * same data, and the caller is supposed to retry the write
+	 * with this data in the beginning.
+	 */
+	size_t wbuf_pending;
+};
+
+static const struct iostream_vtab ssl_iostream_vtab;
+
+int
+ssl_iostream_create(struct iostream *io, int fd, enum iostream_mode mode,
+		    const struct ssl_iostream_ctx *ctx)
+{
+	assert(fd >= 0);
+	assert(mode == IOSTREAM_SERVER || mode == IOSTREAM_CLIENT);
+	struct ssl_iostream *stream = malloc(sizeof(*stream));
+	if (stream == NULL) {
+		diag_set(OutOfMemory, sizeof(*stream), "malloc",
+			 "struct ssl_iostream");
+		return -1;
+	}
+	ERR_clear_error();
+	stream->ssl = SSL_new(ctx->ctx);
+	if (stream->ssl == NULL || SSL_set_fd(stream->ssl, fd) != 1) {
+		diag_set(SSLError, "Failed to create SSL connection: %s",
+			 ssl_error_str());
+		SSL_free(stream->ssl);
+		free(stream);
+		return -1;
+	}
+	if (mode == IOSTREAM_SERVER)
+		SSL_set_accept_state(stream->ssl);
+	else
+		SSL_set_connect_state(stream->ssl);
+	stream->wbuf = NULL;
+	stream->wbuf_pending = 0;
+	iostream_clear(io);
+	io->vtab = &ssl_iostream_vtab;
+	io->data = stream;
+	io->fd = fd;
+	return 0;
+}
+
+static void
+ssl_iostream_destroy(struct iostream *io)
+{
+	struct ssl_iostream *stream = io->data;
+	/* SSL_free() doesn't close the fd passed to SSL_set_fd(). */
+	SSL_free(stream->ssl);
+	free(stream->wbuf);
+	free(stream);
+}
+
+/**
+ * Converts the result of a failed SSL_read() or SSL_write() call
+ * to iostream_status. Returns 0 if the peer closed the connection.
+ */
+static ssize_t
+ssl_iostream_status(struct iostream *io, int ret, const char *func)
+{
+	struct ssl_iostream *stream = io->data;
+	switch (SSL_get_error(stream->ssl, ret)) {
+	case SSL_ERROR_WANT_READ:
+		return IOSTREAM_WANT_READ;
+	case SSL_ERROR_WANT_WRITE:
+		return IOSTREAM_WANT_WRITE;
+	case SSL_ERROR_ZERO_RETURN:
+		return 0;
+	case SSL_ERROR_SYSCALL:
+		if (ERR_peek_error() != 0)
+			break;
+		/* Unexpected EOF is reported with errno 0. */
+		if (errno == 0)
+			return 0;
+		diag_set(SocketError, sio_socketname(io->fd), "%s", func);
+		return IOSTREAM_ERROR;
+	default:
+		break;
+	}
+	diag_set(SSLError, "SSL error: %s", ssl_error_str());
+	return IOSTREAM_ERROR;
+}
+
+static ssize_t
+ssl_iostream_read(struct iostream *io, void *buf, size_t count)
+{
+	struct ssl_iostream *stream = io->data;
+	size_t total = 0;
+	/*
+	 * Fill the caller's buffer as much as possible: the event loop
+	 * can't see data buffered by OpenSSL so the caller should be
+	 * left with buffered data only if its buffer is full.
+	 */
+	while (total < count) {
+		ERR_clear_error();
+		errno = 0;
+		int n = SSL_read(stream->ssl, (char *)buf + total,
+				 MIN(count - total, (size_t)INT_MAX));
+		if (n > 0) {
+			total += n;
+			continue;
+		}
+		ssize_t rc = ssl_iostream_status(io, n, "SSL_read");
+		if (total > 0 && rc != IOSTREAM_ERROR)
+			break;
+		return rc;
+	}
+	return total;
+}
+
+/**
+ * Returns true if the kernel encrypts sent data so that it can be
+ * written to the socket directly.
+ */
+static inline bool
+ssl_iostream_has_ktls_send(struct ssl_iostream *stream)
+{
+#ifdef BIO_get_ktls_send
+	return stream->wbuf_pending == 0 &&
+	       SSL_is_init_finished(stream->ssl) &&
+	       BIO_get_ktls_send(SSL_get_wbio(stream->ssl));
+#else
+	(void)stream;
+	return false;
+#endif
+}
+
+/**
+ * Writes the data stored in the write buffer with SSL_write().
+ * On success returns the number of bytes written, on failure
+ * returns iostream_status and keeps the data pending.
+ */
+static ssize_t
+ssl_iostream_write_buf(struct iostream *io, size_t size)
+{
+	struct ssl_iostream *stream = io->data;
+	assert(size > 0 && size <= SSL_IOSTREAM_WBUF_SIZE);
+	ERR_clear_error();
+	errno = 0;
+	int n = SSL_write(stream->ssl, stream->wbuf, size);
+	if (n > 0) {
+		assert((size_t)n == size);
+		stream->wbuf_pending = 0;
+		return n;
+	}
+	stream->wbuf_pending = size;
+	ssize_t rc = ssl_iostream_status(io, n, "SSL_write");
+	if (rc == 0) {
+		diag_set(SSLError, "SSL connection closed by peer");
+		rc = IOSTREAM_ERROR;
+	}
+	return rc;
+}
+
+static ssize_t
+ssl_iostream_writev(struct iostream *io, const struct iovec *iov, int iovcnt)
+{
+	struct ssl_iostream *stream = io->data;
+	if (ssl_iostream_has_ktls_send(stream)) {
+		ssize_t ret = sio_writev(io->fd, iov, iovcnt);
+		if (ret >= 0)
+			return ret;
+		if (sio_wouldblock(errno))
+			return IOSTREAM_WANT_WRITE;
+		return IOSTREAM_ERROR;
+	}
+	if (stream->wbuf == NULL) {
+		stream->wbuf = malloc(SSL_IOSTREAM_WBUF_SIZE);
+		if (stream->wbuf == NULL) {
+			diag_set(OutOfMemory, SSL_IOSTREAM_WBUF_SIZE,
+				 "malloc", "SSL write buffer");
+			return IOSTREAM_ERROR;
+		}
+	}
+	size_t total = 0;
+	/* Position in the input vector. */
+	int i = 0;
+	size_t offset = 0;
+	if (stream->wbuf_pending > 0) {
+		/* Retry the pending write, which starts the input. */
+		size_t size = stream->wbuf_pending;
+		ssize_t rc = ssl_iostream_write_buf(io, size);
+		if (rc < 0)
+			return rc;
+		total = size;
+		offset = size;
+		while (i < iovcnt && offset >= iov[i].iov_len) {
+			offset -= iov[i].iov_len;
+			i++;
+		}
+		assert(i < iovcnt || offset == 0);
+	}
+	while (i < iovcnt) {
+		/* Coalesce the input into a record. */
+		size_t size = 0;
+		while (i < iovcnt && size < SSL_IOSTREAM_WBUF_SIZE) {
+			size_t n = MIN(iov[i].iov_len - offset,
+				       SSL_IOSTREAM_WBUF_SIZE - size);
+			memcpy(stream->wbuf + size,
+			       (const char *)iov[i].iov_base + offset, n);
+			size += n;
+			offset += n;
+			if (offset == iov[i].iov_len) {
+				offset = 0;
+				i++;
+			}
+		}
+		if (size == 0)
+			break;
+		ssize_t rc = ssl_iostream_write_buf(io, size);
+		if (rc == IOSTREAM_ERROR || (rc < 0 && total == 0))
+			return rc;
+		if (rc < 0)
+			break;
+		total += size;
+	}
+	return total;
+}
+
+static ssize_t
+ssl_iostream_write(struct iostream *io, const void *buf, size_t count)
+{
+	struct iovec iov = {(void *)buf, count};
+	return ssl_iostream_writev(io, &iov, 1);
+}
+
+static const struct iostream_vtab ssl_iostream_vtab = {
+	/* .destroy = */ ssl_iostream_destroy,
+	/* .read = */ ssl_iostream_read,
+	/* .write = */ ssl_iostream_write,
+	/* .writev = */ ssl_iostream_writev,
+};
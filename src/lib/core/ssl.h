@@ -12,7 +12,6 @@
 #else /* !defined(ENABLE_SSL) */
 
 #include "iostream.h"
-#include "trivia/util.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -21,33 +20,60 @@ extern "C" {
 struct uri;
 struct ssl_iostream_ctx;
 
+enum {
+	/**
+	 * Size of the buffer used to coalesce data written to an SSL
+	 * stream into TLS records, the max TLS record payload size.
+	 */
+	SSL_IOSTREAM_WBUF_SIZE = 16384,
+};
+
 void
 ssl_init(void);
 
 void
 ssl_free(void);
 
+/**
+ * Creates an SSL context for the given mode from URI parameters:
+ *
+ * - ssl_key_file: private key file (PEM), mandatory for a server;
+ * - ssl_cert_file: certificate chain file (PEM), mandatory for a
+ *   server;
+ * - ssl_password: password for the private key, if encrypted;
+ * - ssl_ca_file: trusted certificate authorities file. If set, the
+ *   peer certificate is verified, and a server requires clients to
+ *   present a certificate. A client also checks that the server
+ *   certificate was issued for the host from the URI;
+ * - ssl_ciphers: colon-separated list of TLSv1.2 ciphers.
+ *
+ * Where the kernel and the OpenSSL library support it, the record
+ * layer of established connections is offloaded to the kernel
+ * (kTLS), see ssl_iostream_create().
+ *
+ * On failure returns NULL and sets diag.
+ */
 struct ssl_iostream_ctx *
 ssl_iostream_ctx_new(enum iostream_mode mode, const struct uri *uri);
 
-static inline void
-ssl_iostream_ctx_delete(struct ssl_iostream_ctx *ctx)
-{
-	(void)ctx;
-	unreachable();
-}
+void
+ssl_iostream_ctx_delete(struct ssl_iostream_ctx *ctx);
 
-static inline int
+/**
+ * Creates an encrypted IO stream for the given fd. The handshake
+ * is done transparently by the first read or write operations,
+ * which may return IOSTREAM_WANT_READ or IOSTREAM_WANT_WRITE
+ * regardless of the operation type until it completes.
+ *
+ * If the kernel takes over encryption of sent data (kTLS), writes
+ * go to the socket directly without copying. Otherwise written
+ * data is coalesced into records of SSL_IOSTREAM_WBUF_SIZE bytes.
+ *
+ * On success returns 0. On failure returns -1 and sets diag.
+ */
+int
 ssl_iostream_create(struct iostream *io, int fd, enum iostream_mode mode,
-		    const struct ssl_iostream_ctx *ctx)
-{
-	(void)io;
-	(void)fd;
-	(void)mode;
-	(void)ctx;
-	unreachable();
-	return 0;
-}
+		    const struct ssl_iostream_ctx *ctx);
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -5,8 +5,11 @@
  */
 #include "ssl_error.h"
 
+#include <stdarg.h>
 #include <stddef.h>
+#include <stdlib.h>
 
+#include "diag.h"
 #include "reflection.h"
 #include "trivia/config.h"
 
@@ -15,3 +18,27 @@
 #endif
 
 const struct type_info type_SSLError = make_type("SSLError", NULL);
+
+SSLError::SSLError(const char *file, unsigned line, const char *format, ...)
+	: Exception(&type_SSLError, file, line)
+{
+	va_list ap;
+	va_start(ap, format);
+	error_vformat_msg(this, format, ap);
+	va_end(ap);
+}
+
+struct error *
+BuildSSLError(const char *file, unsigned line, const char *format, ...)
+{
+	void *p = malloc(sizeof(SSLError));
+	if (p == NULL)
+		return BuildOutOfMemory(file, line, sizeof(SSLError),
+					"malloc", "SSLError");
+	SSLError *e = new (p) SSLError(file, line, "");
+	va_list ap;
+	va_start(ap, format);
+	error_vformat_msg(e, format, ap);
+	va_end(ap);
+	return e;
+}
@@ -22,11 +22,15 @@ extern "C" {
 
 extern const struct type_info type_SSLError;
 
+struct error *
+BuildSSLError(const char *file, unsigned line, const char *format, ...);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 
 class SSLError: public Exception {
 public:
+	SSLError(const char *file, unsigned line, const char *format, ...);
 	SSLError(): Exception(&type_SSLError, NULL, 0) {}
 	virtual void raise() { throw this; }
 };
@@ -0,0 +1,283 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "zstd_iostream.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <zstd.h>
+
+#include "diag.h"
+#include "iostream.h"
+#include "trivia/util.h"
+
+struct zstd_iostream {
+	/** Underlying IO stream used for reading and writing. */
+	struct iostream base;
+	/** Compression context. */
+	ZSTD_CCtx *cctx;
+	/** Decompression context. */
+	ZSTD_DCtx *dctx;
+	/**
+	 * Buffer for compressed data to be written. It doesn't grow:
+	 * when it's full, it's written out to the underlying stream
+	 * before compressing more data.
+	 */
+	char *wbuf;
+	/** Size of the write buffer. */
+	size_t wbuf_size;
+	/** Start of the data not yet written to the underlying stream. */
+	size_t wpos;
+	/** End of the data stored in the write buffer. */
+	size_t wend;
+	/**
+	 * Number of bytes passed to the last writev call that have been
+	 * compressed, but not reported as written, because the compressed
+	 * data hasn't been flushed to the underlying stream yet. The
+	 * caller is supposed to retry the write with the same data, so
+	 * these bytes are skipped by the next writev call.
+	 */
+	size_t held;
+	/**
+	 * Set if the data compressed so far hasn't been completed with
+	 * a block flush yet, so the peer can't decode all of it.
+	 */
+	bool is_flush_pending;
+	/** Buffer for compressed data read from the underlying stream. */
+	char *rbuf;
+	/** Size of the read buffer. */
+	size_t rbuf_size;
+	/** Start of the data not yet decompressed. */
+	size_t rpos;
+	/** End of the data stored in the read buffer. */
+	size_t rend;
+	/**
+	 * Set if the last decompression filled the output buffer so the
+	 * decompression context may still store some decompressed data.
+	 */
+	bool has_pending_output;
+};
+
+static const struct iostream_vtab zstd_iostream_vtab;
+
+static void
+zstd_iostream_delete(struct zstd_iostream *stream)
+{
+	ZSTD_freeCCtx(stream->cctx);
+	ZSTD_freeDCtx(stream->dctx);
+	free(stream->wbuf);
+	free(stream->rbuf);
+	free(stream);
+}
+
+int
+zstd_iostream_create(struct iostream *io)
+{
+	assert(iostream_is_initialized(io));
+	struct zstd_iostream *stream = calloc(1, sizeof(*stream));
+	if (stream == NULL) {
+		diag_set(OutOfMemory, sizeof(*stream), "malloc",
+			 "struct zstd_iostream");
+		return -1;
+	}
+	stream->cctx = ZSTD_createCCtx();
+	stream->dctx = ZSTD_createDCtx();
+	stream->wbuf_size = ZSTD_CStreamOutSize();
+	stream->wbuf = malloc(stream->wbuf_size);
+	stream->rbuf_size = ZSTD_DStreamInSize();
+	stream->rbuf = malloc(stream->rbuf_size);
+	if (stream->cctx == NULL || stream->dctx == NULL ||
+	    stream->wbuf == NULL || stream->rbuf == NULL) {
+		diag_set(OutOfMemory, stream->wbuf_size + stream->rbuf_size,
+			 "malloc", "zstd stream");
+		zstd_iostream_delete(stream);
+		return -1;
+	}
+	size_t rc = ZSTD_CCtx_setParameter(stream->cctx,
+					   ZSTD_c_compressionLevel,
+					   ZSTD_IOSTREAM_LEVEL);
+	assert(!ZSTD_isError(rc));
+	rc = ZSTD_CCtx_setParameter(stream->cctx, ZSTD_c_windowLog,
+				    ZSTD_IOSTREAM_WINDOW_LOG);
+	assert(!ZSTD_isError(rc));
+	rc = ZSTD_DCtx_setParameter(stream->dctx, ZSTD_d_windowLogMax,
+				    ZSTD_IOSTREAM_WINDOW_LOG);
+	assert(!ZSTD_isError(rc));
+	(void)rc;
+	iostream_move(&stream->base, io);
+	io->vtab = &zstd_iostream_vtab;
+	io->data = stream;
+	io->fd = stream->base.fd;
+	return 0;
+}
+
+static void
+zstd_iostream_destroy(struct iostream *io)
+{
+	struct zstd_iostream *stream = io->data;
+	iostream_destroy(&stream->base);
+	zstd_iostream_delete(stream);
+}
+
+static ssize_t
+zstd_iostream_read(struct iostream *io, void *buf, size_t count)
+{
+	struct zstd_iostream *stream = io->data;
+	ZSTD_outBuffer out = {buf, count, 0};
+	/*
+	 * Fill the caller's buffer as much as possible: the event loop
+	 * can't see data buffered by the stream so the caller should
+	 * be left with buffered data only if its buffer is full.
+	 */
+	while (out.pos < out.size) {
+		if (stream->rpos == stream->rend &&
+		    !stream->has_pending_output) {
+			ssize_t n = iostream_read(&stream->base, stream->rbuf,
+						  stream->rbuf_size);
+			if (n <= 0) {
+				if (out.pos > 0)
+					break;
+				return n;
+			}
+			stream->rpos = 0;
+			stream->rend = n;
+		}
+		ZSTD_inBuffer in = {stream->rbuf, stream->rend, stream->rpos};
+		size_t rc = ZSTD_decompressStream(stream->dctx, &out, &in);
+		if (ZSTD_isError(rc)) {
+			diag_set(IllegalParams, "zstd decompression failed: %s",
+				 ZSTD_getErrorName(rc));
+			return IOSTREAM_ERROR;
+		}
+		stream->rpos = in.pos;
+		stream->has_pending_output = out.pos == out.size;
+	}
+	return out.pos;
+}
+
+/**
+ * Writes the compressed data stored in the write buffer to the
+ * underlying stream. Returns 0 if all data has been written,
+ * iostream_status otherwise.
+ */
+static ssize_t
+zstd_iostream_flush(struct zstd_iostream *stream)
+{
+	while (stream->wpos < stream->wend) {
+		ssize_t n = iostream_write(&stream->base,
+					   stream->wbuf + stream->wpos,
+					   stream->wend - stream->wpos);
+		if (n < 0)
+			return n;
+		stream->wpos += n;
+	}
+	stream->wpos = stream->wend = 0;
+	return 0;
+}
+
+/**
+ * Compresses data and appends it to the write buffer. If the buffer
+ * is full, writes it out to the underlying stream first. On success
+ * returns 0 and stores the value of ZSTD_compressStream2 (the number
+ * of bytes left to flush for ZSTD_e_flush) in @a left. Otherwise
+ * returns iostream_status.
+ */
+static ssize_t
+zstd_iostream_compress(struct zstd_iostream *stream, ZSTD_inBuffer *in,
+		       ZSTD_EndDirective mode, size_t *left)
+{
+	if (stream->wend == stream->wbuf_size) {
+		ssize_t rc = zstd_iostream_flush(stream);
+		if (rc != 0)
+			return rc;
+	}
+	ZSTD_outBuffer out = {stream->wbuf, stream->wbuf_size, stream->wend};
+	size_t rc = ZSTD_compressStream2(stream->cctx, &out, in, mode);
+	if (ZSTD_isError(rc)) {
+		diag_set(IllegalParams, "zstd compression failed: %s",
+			 ZSTD_getErrorName(rc));
+		return IOSTREAM_ERROR;
+	}
+	stream->wend = out.pos;
+	*left = rc;
+	return 0;
+}
+
+static ssize_t
+zstd_iostream_writev(struct iostream *io, const struct iovec *iov, int iovcnt)
+{
+	struct zstd_iostream *stream = io->data;
+	ssize_t rc = zstd_iostream_flush(stream);
+	if (rc < 0)
+		return rc;
+	/*
+	 * The data compressed by the previous call has been flushed so
+	 * the bytes held back by it may be reported as written now.
+	 */
+	size_t skip = stream->held;
+	size_t total = 0;
+	size_t left = 0;
+	stream->held = 0;
+	for (int i = 0; i < iovcnt && rc == 0; i++) {
+		const char *data = iov[i].iov_base;
+		size_t size = iov[i].iov_len;
+		if (skip > 0) {
+			size_t n = MIN(skip, size);
+			data += n;
+			size -= n;
+			skip -= n;
+			total += n;
+		}
+		ZSTD_inBuffer in = {data, size, 0};
+		while (in.pos < in.size && rc == 0)
+			rc = zstd_iostream_compress(stream, &in,
+						    ZSTD_e_continue, &left);
+		if (in.pos > 0)
+			stream->is_flush_pending = true;
+		total += in.pos;
+	}
+	assert(skip == 0);
+	/* Complete the block so that the peer can decode it right away. */
+	while (rc == 0 && stream->is_flush_pending) {
+		ZSTD_inBuffer in = {NULL, 0, 0};
+		rc = zstd_iostream_compress(stream, &in, ZSTD_e_flush, &left);
+		if (rc == 0 && left == 0)
+			stream->is_flush_pending = false;
+	}
+	if (rc == 0)
+		rc = zstd_iostream_flush(stream);
+	if (rc == IOSTREAM_ERROR)
+		return rc;
+	if (rc == 0)
+		return total;
+	if (total == 0)
+		return rc;
+	/*
+	 * The compressed data can't be written out right now. Report
+	 * all data but the last byte as written so that the caller
+	 * waits for the socket and retries the write with the last
+	 * byte, which will flush the compressed data.
+	 */
+	stream->held = 1;
+	return total > 1 ? (ssize_t)total - 1 : rc;
+}
+
+static ssize_t
+zstd_iostream_write(struct iostream *io, const void *buf, size_t count)
+{
+	struct iovec iov = {(void *)buf, count};
+	return zstd_iostream_writev(io, &iov, 1);
+}
+
+static const struct iostream_vtab zstd_iostream_vtab = {
+	/* .destroy = */ zstd_iostream_destroy,
+	/* .read = */ zstd_iostream_read,
+	/* .write = */ zstd_iostream_write,
+	/* .writev = */ zstd_iostream_writev,
+};
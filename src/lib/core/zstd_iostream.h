@@ -0,0 +1,46 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct iostream;
+
+enum {
+	/**
+	 * Compression level used by compressed IO streams. The fastest
+	 * level is used, because a stream is compressed on the fly in
+	 * the thread doing network IO.
+	 */
+	ZSTD_IOSTREAM_LEVEL = 1,
+	/**
+	 * Log2 of the window size used by compressed IO streams. The
+	 * decompressor refuses frames that need a bigger window, so a
+	 * peer can't make it allocate more than 1 MB per stream.
+	 */
+	ZSTD_IOSTREAM_WINDOW_LOG = 20,
+};
+
+/**
+ * Wraps an initialized IO stream into a stream that compresses
+ * all data written to it and decompresses all data read from it
+ * with zstd. The original stream is moved into the new one.
+ *
+ * Compression and decompression contexts live as long as the stream
+ * so the data sent earlier serves as a dictionary for the data sent
+ * later, which makes compression efficient even for small messages.
+ *
+ * On success returns 0. On failure returns -1, sets diag, and leaves
+ * the original stream intact.
+ */
+int
+zstd_iostream_create(struct iostream *io);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -39,22 +39,99 @@
 #include <assert.h>
 #include <string.h>
 
+/**
+ * Allocate a table aligned by cache line so that each block
+ * (and hence each split block bucket) fits in one cache line.
+ */
+static struct bloom_block *
+bloom_alloc_table(uint32_t block_count)
+{
+	void *table;
+	if (posix_memalign(&table, BLOOM_CACHE_LINE,
+			   block_count * sizeof(struct bloom_block)) != 0)
+		return NULL;
+	return table;
+}
+
+/**
+ * Expected false positive rate of a split block bloom filter.
+ * Unlike a classic bloom filter, the load of a bucket varies,
+ * so sum the false positive rates over the Poisson distribution
+ * of the number of values per bucket.
+ */
+static double
+bloom_split_block_fpr(uint64_t bucket_count, uint32_t number_of_values)
+{
+	/* Average number of values per bucket. */
+	double lambda = (double)number_of_values / bucket_count;
+	/* Probability of the bucket load being equal to i. */
+	double load_prob = exp(-lambda);
+	/* Probability that a bit of a word is still unset. */
+	double unset_prob = 1;
+	double fpr = 0;
+	uint32_t max_load = lambda + 10 * sqrt(lambda) + 10;
+	for (uint32_t i = 0; i <= max_load; i++) {
+		fpr += load_prob * pow(1 - unset_prob, BLOOM_BUCKET_WORDS);
+		load_prob *= lambda / (i + 1);
+		unset_prob *= 1 - 1.0 / (CHAR_BIT * sizeof(uint32_t));
+	}
+	return fpr;
+}
+
+static int
+bloom_create_split_block(struct bloom *bloom, uint32_t number_of_values,
+			 double false_positive_rate)
+{
+	/*
+	 * Start with the size of the optimal classic bloom filter
+	 * and grow it until the false positive rate is satisfied.
+	 */
+	uint32_t bucket_bits = BLOOM_BUCKET_WORDS * CHAR_BIT * sizeof(uint32_t);
+	uint64_t bucket_count = ceil(number_of_values *
+				     -log(false_positive_rate) /
+				     (log(2) * log(2)) / bucket_bits);
+	if (bucket_count == 0)
+		bucket_count = 1;
+	while (bloom_split_block_fpr(bucket_count, number_of_values) >
+	       false_positive_rate)
+		bucket_count += bucket_count / 16 + 1;
+	uint32_t block_count = (bucket_count + BLOOM_BUCKETS_PER_BLOCK - 1) /
+			       BLOOM_BUCKETS_PER_BLOCK;
+
+	bloom->table = bloom_alloc_table(block_count);
+	if (bloom->table == NULL)
+		return -1;
+	memset(bloom->table, 0, block_count * sizeof(*bloom->table));
+
+	bloom->table_size = block_count;
+	bloom->hash_count = BLOOM_BUCKET_WORDS;
+	bloom->type = BLOOM_SPLIT_BLOCK;
+	return 0;
+}
+
 int
 bloom_create(struct bloom *bloom, uint32_t number_of_values,
-	     double false_positive_rate)
+	     double false_positive_rate, enum bloom_type type)
 {
+	if (type == BLOOM_SPLIT_BLOCK)
+		return bloom_create_split_block(bloom, number_of_values,
+						false_positive_rate);
+	assert(type == BLOOM_CLASSIC);
+
 	/* Optimal hash_count and bit count calculation */
 	uint16_t hash_count = ceil(log(false_positive_rate) / log(0.5));
 	uint64_t bit_count = ceil(number_of_values * hash_count / log(2));
 	uint32_t block_bits = CHAR_BIT * sizeof(struct bloom_block);
 	uint32_t block_count = (bit_count + block_bits - 1) / block_bits;
 
-	bloom->table = calloc(block_count, sizeof(*bloom->table));
+	bloom->table = bloom_alloc_table(block_count);
 	if (bloom->table == NULL)
 		return -1;
+	memset(bloom->table, 0, block_count * sizeof(*bloom->table));
 
 	bloom->table_size = block_count;
 	bloom->hash_count = hash_count;
+	bloom->type = BLOOM_CLASSIC;
 	return 0;
 }
 
@@ -67,6 +144,11 @@ bloom_destroy(struct bloom *bloom)
 double
 bloom_fpr(const struct bloom *bloom, uint32_t number_of_values)
 {
+	if (bloom->type == BLOOM_SPLIT_BLOCK) {
+		return bloom_split_block_fpr((uint64_t)bloom->table_size *
+					     BLOOM_BUCKETS_PER_BLOCK,
+					     number_of_values);
+	}
 	/* Number of hash functions. */
 	uint16_t k = bloom->hash_count;
 	/* Number of bits. */
@@ -95,7 +177,7 @@ int
 bloom_load_table(struct bloom *bloom, const char *table)
 {
 	size_t size = bloom->table_size * sizeof(struct bloom_block);
-	bloom->table = malloc(size);
+	bloom->table = bloom_alloc_table(bloom->table_size);
 	if (bloom->table == NULL)
 		return -1;
 	memcpy(bloom->table, table, size);
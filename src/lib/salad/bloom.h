@@ -41,6 +41,10 @@
  *  "Less Hashing, Same Performance: Building a Better Bloom Filter"
  *   https://www.eecs.harvard.edu/~michaelm/postscripts/tr-02-05.pdf
  * 3) Using only one hash value that is splitted into several independent parts
+ *
+ * Split block bloom filter (see BLOOM_SPLIT_BLOCK):
+ *  Apache Parquet, "Split Block Bloom Filter" specification
+ *  https://github.com/apache/parquet-format/blob/master/BloomFilter.md
  */
 
 #include <stdint.h>
@@ -56,15 +60,45 @@ extern "C" {
 enum {
 	/* Expected cache line of target processor */
 	BLOOM_CACHE_LINE = 64,
+	/* Number of 32-bit words in a split block bloom bucket */
+	BLOOM_BUCKET_WORDS = 8,
+	/* Number of split block bloom buckets in a block */
+	BLOOM_BUCKETS_PER_BLOCK = BLOOM_CACHE_LINE /
+				  (BLOOM_BUCKET_WORDS * sizeof(uint32_t)),
 };
 
 typedef uint32_t bloom_hash_t;
 
+/**
+ * Bloom filter type.
+ */
+enum bloom_type {
+	/**
+	 * All bits of a value are set in the same cache line,
+	 * the number of bits per value depends on the desired
+	 * false positive rate.
+	 */
+	BLOOM_CLASSIC = 0,
+	/**
+	 * A cache line is split into buckets of 8 32-bit words.
+	 * A value sets exactly one bit in each word of a bucket,
+	 * which makes the lookup branchless and vectorizable at
+	 * the cost of a bit more memory for the same false
+	 * positive rate.
+	 */
+	BLOOM_SPLIT_BLOCK = 1,
+	bloom_type_MAX,
+};
+
 /**
  * Cache-line-size block of bloom filter
  */
 struct bloom_block {
-	unsigned char bits[BLOOM_CACHE_LINE];
+	union {
+		unsigned char bits[BLOOM_CACHE_LINE];
+		/* Split block bloom buckets */
+		uint32_t words[BLOOM_CACHE_LINE / sizeof(uint32_t)];
+	};
 };
 
 /**
@@ -75,7 +109,9 @@ struct bloom {
 	uint32_t table_size;
 	/* Number of hash function per value */
 	uint16_t hash_count;
-	/* Bit field table */
+	/* Type of the filter */
+	enum bloom_type type;
+	/* Bit field table, aligned by cache line */
 	struct bloom_block *table;
 };
 
@@ -87,11 +123,12 @@ struct bloom {
  * @param bloom - structure to initialize
  * @param number_of_values - estimated number of values to be added
  * @param false_positive_rate - desired false positive rate
+ * @param type - type of the filter
  * @return 0 - OK, -1 - memory error
  */
 int
 bloom_create(struct bloom *bloom, uint32_t number_of_values,
-	     double false_positive_rate);
+	     double false_positive_rate, enum bloom_type type);
 
 /**
  * Free resources of the bloom filter
@@ -120,6 +157,16 @@ bloom_add(struct bloom *bloom, bloom_hash_t hash);
 static bool
 bloom_maybe_has(const struct bloom *bloom, bloom_hash_t hash);
 
+/**
+ * Prefetch the cache line that would be accessed by
+ * bloom_maybe_has() for the given hash. Useful when
+ * checking a value against many filters at once.
+ * @param bloom - the bloom filter
+ * @param hash - hash of the value
+ */
+static void
+bloom_prefetch(const struct bloom *bloom, bloom_hash_t hash);
+
 /**
  * Return the expected false positive rate of a bloom filter.
  * @param bloom - the bloom filter
@@ -149,7 +196,8 @@ bloom_store(const struct bloom *bloom, char *table);
 
 /**
  * Allocate table and load it from given buffer.
- * Other struct bloom members must be loaded manually.
+ * Other struct bloom members (including type) must be
+ * loaded manually.
  *
  * @param bloom - structure to load to
  * @param table - data to load
@@ -162,9 +210,70 @@ bloom_load_table(struct bloom *bloom, const char *table);
 
 /* {{{ API definition */
 
+/* Salts used for computing split block bloom filter masks */
+static const uint32_t bloom_salt[BLOOM_BUCKET_WORDS] = {
+	0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+	0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+/* Find the split block bloom bucket of a value */
+static inline uint32_t *
+bloom_split_block_bucket(const struct bloom *bloom, bloom_hash_t hash)
+{
+	/* Multiply-shift instead of modulo, see Lemire's fastrange */
+	uint32_t bucket_count = bloom->table_size * BLOOM_BUCKETS_PER_BLOCK;
+	uint32_t bucket = ((uint64_t)hash * bucket_count) >> 32;
+	return bloom->table[bucket / BLOOM_BUCKETS_PER_BLOCK].words +
+	       bucket % BLOOM_BUCKETS_PER_BLOCK * BLOOM_BUCKET_WORDS;
+}
+
+/*
+ * Calculate a split block bloom mask of a value: one bit
+ * per each word of a bucket. The loop has no branches so
+ * the compiler can vectorize it.
+ */
+static inline void
+bloom_split_block_mask(bloom_hash_t hash, uint32_t *mask)
+{
+	/* The high bits were used for choosing a bucket, remix. */
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
+	for (int i = 0; i < BLOOM_BUCKET_WORDS; i++)
+		mask[i] = 1U << ((hash * bloom_salt[i]) >> 27);
+}
+
+static inline void
+bloom_split_block_add(struct bloom *bloom, bloom_hash_t hash)
+{
+	uint32_t *bucket = bloom_split_block_bucket(bloom, hash);
+	uint32_t mask[BLOOM_BUCKET_WORDS];
+	bloom_split_block_mask(hash, mask);
+	for (int i = 0; i < BLOOM_BUCKET_WORDS; i++)
+		bucket[i] |= mask[i];
+}
+
+static inline bool
+bloom_split_block_maybe_has(const struct bloom *bloom, bloom_hash_t hash)
+{
+	const uint32_t *bucket = bloom_split_block_bucket(bloom, hash);
+	uint32_t mask[BLOOM_BUCKET_WORDS];
+	bloom_split_block_mask(hash, mask);
+	uint32_t missing = 0;
+	for (int i = 0; i < BLOOM_BUCKET_WORDS; i++)
+		missing |= mask[i] & ~bucket[i];
+	return missing == 0;
+}
+
 static inline void
 bloom_add(struct bloom *bloom, bloom_hash_t hash)
 {
+	if (bloom->type == BLOOM_SPLIT_BLOCK) {
+		bloom_split_block_add(bloom, hash);
+		return;
+	}
 	/* Using lower part of the has for finding a block */
 	bloom_hash_t pos = hash % bloom->table_size;
 	hash = hash / bloom->table_size;
@@ -185,6 +294,8 @@ bloom_add(struct bloom *bloom, bloom_hash_t hash)
 static inline bool
 bloom_maybe_has(const struct bloom *bloom, bloom_hash_t hash)
 {
+	if (bloom->type == BLOOM_SPLIT_BLOCK)
+		return bloom_split_block_maybe_has(bloom, hash);
 	/* Using lower part of the has for finding a block */
 	bloom_hash_t pos = hash % bloom->table_size;
 	hash = hash / bloom->table_size;
@@ -204,6 +315,17 @@ bloom_maybe_has(const struct bloom *bloom, bloom_hash_t hash)
 	return true;
 }
 
+static inline void
+bloom_prefetch(const struct bloom *bloom, bloom_hash_t hash)
+{
+	const void *addr;
+	if (bloom->type == BLOOM_SPLIT_BLOCK)
+		addr = bloom_split_block_bucket(bloom, hash);
+	else
+		addr = bloom->table + hash % bloom->table_size;
+	__builtin_prefetch(addr, 0);
+}
+
 /* }}} API definition */
 
 #if defined(__cplusplus)
@@ -0,0 +1,55 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        box.cfg{busy_poll_timeout = 0}
+    end)
+end)
+
+g.test_busy_poll_cfg = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'busy_poll_timeout': " ..
+            "value must be >= 0",
+            box.cfg, {busy_poll_timeout = -1})
+        t.assert_equals(box.cfg.busy_poll_timeout, 0)
+    end)
+end
+
+g.test_busy_poll_stat = function()
+    local stat = g.server:exec(function()
+        return box.stat.busy_poll()
+    end)
+    t.assert_equals(stat.tx.time, 0)
+    t.assert_equals(stat.iproto.time, 0)
+    g.server:exec(function()
+        box.cfg{busy_poll_timeout = 0.01}
+    end)
+    local conn = net.connect(g.server.net_box_uri)
+    for _ = 1, 10 do
+        t.assert(conn:ping())
+    end
+    conn:close()
+    t.helpers.retrying({}, function()
+        local stat = g.server:exec(function()
+            return box.stat.busy_poll()
+        end)
+        t.assert_gt(stat.tx.time, 0)
+        t.assert_gt(stat.tx.sleeps, 0)
+        t.assert_gt(stat.iproto.time, 0)
+        t.assert_gt(stat.iproto.sleeps, 0)
+    end)
+end
@@ -0,0 +1,103 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each = function()
+    g.server:exec(function()
+        box.cfg({listen = box.cfg.listen, replication = {}})
+    end)
+end
+
+g.test_invalid = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local listen = box.cfg.listen
+        t.assert_error_msg_equals(
+            'Invalid compression: foo',
+            box.cfg, {listen = {listen, params = {compression = 'foo'}}})
+        t.assert_error_msg_equals(
+            'Invalid compression: foo',
+            box.cfg, {replication = {listen,
+                                     params = {compression = 'foo'}}})
+    end)
+    t.assert_error_msg_equals(
+        'Invalid compression: foo',
+        net.connect, {g.server.net_box_uri, params = {compression = 'foo'}})
+end
+
+g.test_net_box = function()
+    g.server:exec(function()
+        local listen = box.cfg.listen
+        box.cfg({listen = {listen, params = {compression = 'zstd'}}})
+    end)
+    local c = net.connect({g.server.net_box_uri,
+                           params = {compression = 'zstd'}})
+    t.assert_equals(c.state, 'active')
+    -- Check a big compressible reply and a sequence of small ones.
+    local s = string.rep('x', 1024 * 1024)
+    t.assert_equals(c:eval('return ...', {s}), s)
+    for i = 1, 100 do
+        t.assert_equals(c:eval('return ...', {i}), i)
+    end
+    c:close()
+end
+
+g.test_replication = function()
+    g.server:exec(function()
+        local listen = box.cfg.listen
+        box.cfg({listen = {listen, params = {compression = 'zstd'}}})
+        box.schema.user.grant('guest', 'replication', nil, nil,
+                              {if_not_exists = true})
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        -- Data written before the replica joins is sent on join.
+        for i = 1, 100 do
+            s:insert({i, string.rep('x', 10000)})
+        end
+    end)
+    local replica = server:new({
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                server.build_instance_uri('master'),
+                params = {compression = 'zstd'},
+            },
+            replication_timeout = 0.1,
+        },
+    })
+    replica:start()
+    replica:assert_follows_upstream(1)
+    -- Data written after the replica joins is sent on subscribe,
+    -- including writes bigger than the stream buffers.
+    g.server:exec(function()
+        local digest = require('digest')
+        for i = 101, 200 do
+            box.space.test:insert({i, digest.urandom(100000)})
+        end
+    end)
+    replica:wait_vclock(g.server:get_vclock())
+    local checksum = function()
+        local sum = 0
+        for _, tuple in box.space.test:pairs() do
+            sum = sum + tuple:bsize()
+        end
+        return box.space.test:count(), sum,
+               require('digest').md5_hex(box.space.test:get(150)[2])
+    end
+    t.assert_equals({replica:exec(checksum)}, {g.server:exec(checksum)})
+    t.assert_equals(g.server:exec(function()
+        return box.info.replication[2].downstream.status
+    end), 'follow')
+    replica:drop()
+    g.server:exec(function() box.space.test:drop() end)
+end
@@ -0,0 +1,225 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {
+            format = {{'id', 'unsigned'}, {'value', 'string'}},
+        })
+        s:create_index('primary')
+        s:create_index('value', {parts = {'value'}, unique = false})
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function() box.space.test:truncate() end)
+end)
+
+-- Checks that prepared requests are executed with bound parameters.
+g.test_prepare = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local s = conn.space.test
+    local insert = s:prepare('insert')
+    t.assert_equals(tostring(insert), 'net.box.statement')
+    t.assert_equals(insert.type, 'insert')
+    for i = 1, 10 do
+        t.assert_equals(insert:execute({i, 'v' .. i}), {i, 'v' .. i})
+    end
+    local replace = s:prepare('replace')
+    t.assert_equals(replace:execute({10, 'x'}), {10, 'x'})
+
+    local select = s:prepare('select', {iterator = 'GE', limit = 2,
+                                        offset = 1})
+    t.assert_equals(select:execute({5}), {{6, 'v6'}, {7, 'v7'}})
+    t.assert_equals(select:execute(9), {{10, 'x'}})
+    local by_value = s.index.value:prepare('select')
+    local res = by_value:execute('x')
+    t.assert_equals(res, {{10, 'x'}})
+    t.assert_equals(res[1].value, 'x')
+
+    local update = s:prepare('update', {ops = {{'=', 'value', 'y'}}})
+    t.assert_equals(update:execute(1), {1, 'y'})
+    t.assert_equals(update:execute({100}), nil)
+    local upsert = s:prepare('upsert', {ops = {{'=', 2, 'z'}}})
+    t.assert_equals(upsert:execute({2, 'a'}), nil)
+    t.assert_equals(upsert:execute({100, 'a'}), nil)
+    local delete = s.index.primary:prepare('delete')
+    t.assert_equals(delete:execute({2}), {2, 'z'})
+    t.assert_equals(delete:execute({100}), {100, 'a'})
+
+    local future = select:execute({0}, {is_async = true})
+    t.assert_equals(future:wait_result(), {{3, 'v3'}, {4, 'v4'}})
+
+    -- Statements of different types don't mix.
+    insert.type = 'delete'
+    t.assert_error_msg_content_equals(
+        string.format('Illegal parameters, statement %d is prepared for ' ..
+                      'INSERT', insert.id),
+        insert.execute, insert, {1})
+    insert.type = 'insert'
+
+    -- Unprepared statements can't be executed.
+    select:unprepare()
+    t.assert_error_msg_content_equals(
+        string.format('Prepared statement with id %d does not exist',
+                      select.id),
+        select.execute, select, {1})
+    t.assert_error_msg_content_equals(
+        string.format('Prepared statement with id %d does not exist',
+                      select.id),
+        select.unprepare, select)
+    conn:close()
+
+    -- Statements belong to the session.
+    conn = net.connect(g.server.net_box_uri)
+    insert._remote = conn
+    t.assert_error_msg_content_equals(
+        string.format('Prepared statement with id %d does not exist',
+                      insert.id),
+        insert.execute, insert, {11, 'v11'})
+    conn:close()
+end
+
+-- Checks that prepared requests are executed in streams.
+g.test_prepare_stream = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local stream = conn:new_stream()
+    local insert = stream.space.test:prepare('insert')
+    stream:begin()
+    insert:execute({1, 'a'})
+    t.assert_equals(conn.space.test:select(), {})
+    stream:commit()
+    t.assert_equals(conn.space.test:select(), {{1, 'a'}})
+    conn:close()
+end
+
+g.test_prepare_errors = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local s = conn.space.test
+    t.assert_error_msg_content_equals(
+        "Illegal parameters, unknown statement type 'foo'",
+        s.prepare, s, 'foo')
+    t.assert_error_msg_content_equals(
+        'Illegal parameters, ops should be a table',
+        s.prepare, s, 'update')
+    local insert = s:prepare('insert')
+    t.assert_error_msg_contains('Tuple field 1 (id) type does not match',
+                                insert.execute, insert, {'a', 'b'})
+
+    -- Schema changes are seen by prepared statements.
+    g.server:exec(function()
+        box.schema.space.create('tmp'):create_index('primary')
+    end)
+    conn:reload_schema()
+    local tmp = conn.space.tmp:prepare('insert')
+    g.server:exec(function() box.space.tmp:drop() end)
+    t.assert_error_msg_contains('does not exist', tmp.execute, tmp, {1})
+    conn:close()
+end
+
+-- Checks that a statement looks up the space again and checks
+-- its update operations after the space is changed.
+g.test_prepare_space_change = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local s = conn.space.test
+    t.assert_error_msg_content_equals(
+        "Field 'foo' was not found in the tuple",
+        s.prepare, s, 'update', {ops = {{'=', 'foo', 'x'}}})
+    local insert = s:prepare('insert')
+    local select = s.index.value:prepare('select')
+    local update = s:prepare('update', {ops = {{'=', 'value', 'y'}}})
+    insert:execute({1, 'a'})
+    t.assert_equals(select:execute('a'), {{1, 'a'}})
+
+    -- Truncate replaces the space object.
+    g.server:exec(function() box.space.test:truncate() end)
+    t.assert_equals(select:execute('a'), {})
+    insert:execute({1, 'a'})
+    t.assert_equals(select:execute('a'), {{1, 'a'}})
+    t.assert_equals(update:execute(1), {1, 'y'})
+
+    g.server:exec(function()
+        box.space.test:format({{'id', 'unsigned'}, {'val', 'string'}})
+    end)
+    t.assert_error_msg_content_equals(
+        "Field 'value' was not found in the tuple",
+        update.execute, update, 1)
+    g.server:exec(function()
+        box.space.test:format({{'id', 'unsigned'}, {'value', 'string'}})
+    end)
+    t.assert_equals(update:execute(1), {1, 'y'})
+    conn:close()
+end
+
+-- Checks that a statement deallocated while it's being executed
+-- stays valid until the execution ends.
+g.test_unprepare_in_progress = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local s = conn.space.test
+    s:insert({1, 'a'})
+    local update = s:prepare('update', {ops = {{'=', 'value', 'b'}}})
+    g.server:exec(function()
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+    end)
+    local future = update:execute(1, {is_async = true})
+    t.helpers.retrying({}, function()
+        t.assert_equals(g.server:exec(function()
+            return box.stat.net.REQUESTS_IN_PROGRESS.current
+        end), 1)
+    end)
+    update:unprepare()
+    g.server:exec(function()
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+    end)
+    t.assert_equals(future:wait_result(), {1, 'b'})
+    conn:close()
+end
+
+-- Checks the memory limit for prepared statements.
+g.test_prepare_cache_size = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local s = conn.space.test
+    local ops = {}
+    for i = 1, 100 do
+        ops[i] = {'=', 'value', string.rep('x', 100)}
+    end
+    g.server:exec(function() box.cfg({net_stmt_cache_size = 100000}) end)
+    local stmts = {}
+    local ok, err
+    for i = 1, 100 do
+        ok, err = pcall(s.prepare, s, 'update', {ops = ops})
+        if not ok then
+            break
+        end
+        stmts[i] = err
+    end
+    t.assert_not(ok)
+    t.assert_equals(err.code, box.error.STMT_CACHE_FULL)
+    t.assert_gt(#stmts, 0)
+    t.assert_lt(#stmts, 100)
+    -- Freed memory can be reused.
+    stmts[1]:unprepare()
+    stmts[1] = s:prepare('update', {ops = ops})
+    conn:close()
+    -- Statements of closed sessions are freed.
+    conn = net.connect(g.server.net_box_uri)
+    t.helpers.retrying({}, function()
+        conn.space.test:prepare('update', {ops = ops}):unprepare()
+    end)
+    conn:close()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'net_stmt_cache_size': " ..
+            "must be non-negative", box.cfg, {net_stmt_cache_size = -1})
+        box.cfg({net_stmt_cache_size = 5 * 1024 * 1024})
+    end)
+end
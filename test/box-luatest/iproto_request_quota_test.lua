@@ -0,0 +1,155 @@
+local fiber = require('fiber')
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+    g.server:exec(function()
+        local fiber = require('fiber')
+        rawset(_G, 'ch', fiber.channel(100))
+        rawset(_G, 'wait', function() return _G.ch:get() end)
+        box.schema.user.create('alice', {password = 'secret'})
+        box.schema.user.grant('alice', 'super')
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        box.cfg{net_msg_max_per_connection = 0, net_msg_max_per_user = 0}
+    end)
+end)
+
+-- Releases fibers blocked in wait() and checks their results.
+local function release(futures)
+    g.server:exec(function(n)
+        for _ = 1, n do
+            _G.ch:put(true)
+        end
+    end, {#futures})
+    for _, future in ipairs(futures) do
+        t.assert_equals(future:wait_result(10), {true})
+    end
+end
+
+-- Checks that requests of a user over net_msg_max_per_user are shed,
+-- while other users and service requests are not affected.
+g.test_msg_max_per_user = function()
+    g.server:exec(function()
+        box.cfg{net_msg_max_per_user = 2}
+    end)
+    local conn = net.connect(g.server.net_box_uri)
+    local futures = {}
+    for i = 1, 2 do
+        futures[i] = conn:call('wait', {}, {is_async = true})
+    end
+    t.helpers.retrying({}, function()
+        t.assert_equals(g.server:exec(function()
+            return box.stat.net.REQUESTS_IN_PROGRESS.current
+        end), 2)
+    end)
+    -- Another connection of the same user shares the quota.
+    local conn2 = net.connect(g.server.net_box_uri)
+    t.assert_error_msg_content_equals(
+        "Too many requests of user 'guest' are in progress",
+        conn2.call, conn2, 'wait')
+    local ok, err = pcall(conn.eval, conn, 'return 1')
+    t.assert_not(ok)
+    t.assert_equals(err.code, box.error.TOO_MANY_REQUESTS)
+    t.assert(conn:ping())
+    t.assert(conn2:ping())
+
+    local alice = net.connect(g.server.net_box_uri, {
+        user = 'alice', password = 'secret',
+    })
+    t.assert_equals(alice:eval('return 1'), 1)
+    alice:close()
+
+    t.assert_equals(g.server:exec(function()
+        return box.stat.net.REQUESTS_SHED.total
+    end), 2)
+    release(futures)
+    t.assert_equals(conn:eval('return 1'), 1)
+    conn:close()
+    conn2:close()
+end
+
+-- Checks that SQL unprepare requests release the user quota.
+g.test_msg_max_per_user_unprepare = function()
+    g.server:exec(function()
+        box.cfg{net_msg_max_per_user = 1}
+    end)
+    local conn = net.connect(g.server.net_box_uri)
+    for _ = 1, 10 do
+        local stmt = conn:prepare('SELECT 1;')
+        conn:unprepare(stmt.stmt_id)
+    end
+    t.assert_equals(conn:eval('return 1'), 1)
+    conn:close()
+end
+
+-- Checks that a connection with net_msg_max_per_connection requests
+-- in fly doesn't send more to tx, while other connections proceed.
+g.test_msg_max_per_connection = function()
+    g.server:exec(function()
+        box.cfg{net_msg_max_per_connection = 2}
+    end)
+    local conn = net.connect(g.server.net_box_uri)
+    local futures = {}
+    for i = 1, 5 do
+        futures[i] = conn:call('wait', {}, {is_async = true})
+    end
+    t.helpers.retrying({}, function()
+        t.assert_equals(g.server:exec(function()
+            return box.stat.net.REQUESTS_IN_PROGRESS.current
+        end), 2)
+    end)
+    fiber.sleep(0.1)
+    t.assert_equals(g.server:exec(function()
+        return box.stat.net.REQUESTS_IN_PROGRESS.current
+    end), 2)
+    local conn2 = net.connect(g.server.net_box_uri)
+    t.assert_equals(conn2:eval('return 1'), 1)
+    conn2:close()
+    -- The stopped connection is resumed as its requests complete.
+    release(futures)
+    conn:close()
+end
+
+-- Checks the queue time metric.
+g.test_queue_time = function()
+    local conn = net.connect(g.server.net_box_uri)
+    for _ = 1, 10 do
+        t.assert(conn:ping())
+    end
+    conn:close()
+    g.server:exec(function()
+        local stat = box.stat.net()
+        t.assert_ge(stat.QUEUE_TIME.p50, 0)
+        t.assert_ge(stat.QUEUE_TIME.p99, stat.QUEUE_TIME.p50)
+        t.assert_equals(box.stat.net.QUEUE_TIME, stat.QUEUE_TIME)
+        t.assert_type(box.stat.net.thread[1].QUEUE_TIME.p99, 'number')
+        t.assert_equals(stat.REQUESTS_SHED.total,
+                        box.stat.net.REQUESTS_SHED.total)
+    end)
+end
+
+g.test_cfg = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'net_msg_max_per_user': " ..
+            "value must be >= 0", box.cfg, {net_msg_max_per_user = -1})
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'net_msg_max_per_connection': " ..
+            "value must be >= 0", box.cfg, {net_msg_max_per_connection = -1})
+        t.assert_equals(box.cfg.net_msg_max_per_user, 0)
+        t.assert_equals(box.cfg.net_msg_max_per_connection, 0)
+    end)
+end
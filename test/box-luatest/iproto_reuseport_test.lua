@@ -0,0 +1,90 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    t.skip_if(jit.os ~= 'Linux', 'SO_REUSEPORT balancing is Linux-only')
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = {iproto_threads = 4},
+    })
+    g.server:start()
+    g.server:exec(function()
+        box.cfg{listen = {uri = 'localhost:0',
+                          params = {reuseport = 'true'}}}
+    end)
+    g.uri = g.server:exec(function()
+        return box.info.listen
+    end)
+end)
+
+g.after_all(function()
+    if g.server ~= nil then
+        g.server:drop()
+    end
+end)
+
+-- Returns the number of TCP sockets listening on the given port.
+local function count_listening_sockets(port)
+    local count = 0
+    for _, path in ipairs({'/proc/net/tcp', '/proc/net/tcp6'}) do
+        local f = io.open(path)
+        if f ~= nil then
+            for line in f:lines() do
+                local local_port, state = line:match(
+                    '^%s*%d+: %x+:(%x+) %x+:%x+ (%x+)')
+                if local_port ~= nil and tonumber(local_port, 16) == port and
+                   state == '0A' then
+                    count = count + 1
+                end
+            end
+            f:close()
+        end
+    end
+    return count
+end
+
+-- Checks that every iproto thread listens on its own socket and that
+-- connections are spread between the threads.
+g.test_reuseport = function()
+    local port = tonumber(g.uri:match(':(%d+)$'))
+    t.assert_equals(count_listening_sockets(port), 4)
+    local conns = {}
+    for i = 1, 32 do
+        conns[i] = net.connect(g.uri)
+        t.assert_equals(conns[i]:eval('return 1 + 1'), 2)
+    end
+    local per_thread = g.server:exec(function()
+        local per_thread = {}
+        for i = 1, box.cfg.iproto_threads do
+            per_thread[i] = box.stat.net.thread()[i].CONNECTIONS.current
+        end
+        return per_thread
+    end)
+    local total = 0
+    local active_threads = 0
+    for _, count in ipairs(per_thread) do
+        total = total + count
+        if count > 0 then
+            active_threads = active_threads + 1
+        end
+    end
+    t.assert_ge(total, #conns)
+    t.assert_ge(active_threads, 2)
+    for _, conn in ipairs(conns) do
+        conn:close()
+    end
+end
+
+-- Checks that the listening socket can be reconfigured.
+g.test_reuseport_relisten = function()
+    g.server:exec(function()
+        local uri = box.info.listen
+        box.cfg{listen = ''}
+        box.cfg{listen = {uri = uri, params = {reuseport = 'true'}}}
+    end)
+    local conn = net.connect(g.uri)
+    t.assert_equals(conn:eval('return 1 + 1'), 2)
+    conn:close()
+end
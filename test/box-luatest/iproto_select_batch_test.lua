@@ -0,0 +1,53 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('primary')
+        for i = 1, 100 do
+            s:insert({i})
+        end
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+-- Checks that pipelined SELECT requests, which are processed by
+-- the tx thread in batches, get correct replies in order and that
+-- an error in one of them doesn't affect the others.
+g.test_select_batch = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local s = conn.space.test
+    local futures = {}
+    for i = 1, 100 do
+        futures[i] = s:select({i}, {is_async = true})
+    end
+    -- A failing request in the middle of a batch.
+    local bad = conn:_request(net._method.select, {is_async = true},
+                              nil, nil, 1000000, 0, box.index.EQ, 0,
+                              0xFFFFFFFF, {})
+    -- A non-SELECT request ends a batch.
+    local eval = conn:eval('return box.space.test:count()', {},
+                           {is_async = true})
+    local more = {}
+    for i = 1, 10 do
+        more[i] = s:select({i}, {is_async = true})
+    end
+    for i = 1, 100 do
+        t.assert_equals(futures[i]:wait_result(), {{i}})
+    end
+    local _, err = bad:wait_result()
+    t.assert_equals(err.code, box.error.NO_SUCH_SPACE)
+    t.assert_equals(eval:wait_result(), {100})
+    for i = 1, 10 do
+        t.assert_equals(more[i]:wait_result(), {{i}})
+    end
+    conn:close()
+end
@@ -0,0 +1,102 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('primary')
+        s:create_index('hash', {type = 'hash'})
+        for i = 1, 100 do
+            s:insert({i})
+        end
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+local function range(from, to)
+    local ret = {}
+    for i = from, to do
+        table.insert(ret, {i})
+    end
+    return ret
+end
+
+-- Checks that a synchronous select with fetch_size returns the whole
+-- result collected from chunks.
+g.test_fetch_size_sync = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local s = conn.space.test
+    t.assert_equals(s:select({}, {fetch_size = 7}), range(1, 100))
+    t.assert_equals(s:select({}, {fetch_size = 100}), range(1, 100))
+    t.assert_equals(s:select({}, {fetch_size = 1000}), range(1, 100))
+    t.assert_equals(s:select({10}, {fetch_size = 7, iterator = 'GE',
+                                    offset = 5, limit = 20}),
+                    range(15, 34))
+    t.assert_equals(s:select({1000}, {fetch_size = 7}), {})
+    t.assert_error_msg_content_equals(
+        'Illegal parameters, fetch_size should be a non-negative number',
+        s.select, s, {}, {fetch_size = -1})
+    conn:close()
+end
+
+-- Checks that chunks of an async select are returned by future:pairs().
+g.test_fetch_size_async = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local s = conn.space.test
+    local future = s:select({}, {fetch_size = 7, is_async = true})
+    local messages = {}
+    for _, message in future:pairs() do
+        table.insert(messages, message)
+    end
+    t.assert_equals(#messages, 15)
+    local tuples = {}
+    for i, message in ipairs(messages) do
+        t.assert_equals(#message, i < #messages and 7 or 2)
+        for _, tuple in ipairs(message) do
+            table.insert(tuples, tuple)
+        end
+    end
+    t.assert_equals(tuples, range(1, 100))
+    -- Hash iterators don't survive yields, so the reply isn't split.
+    future = s.index.hash:select({}, {fetch_size = 7, is_async = true})
+    messages = {}
+    for _, message in future:pairs() do
+        table.insert(messages, message)
+    end
+    t.assert_equals(#messages, 1)
+    t.assert_equals(#messages[1], 100)
+    conn:close()
+end
+
+-- Checks that requests of a stream aren't split.
+g.test_fetch_size_stream = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local stream = conn:new_stream()
+    local future = stream.space.test:select({}, {fetch_size = 7,
+                                                 is_async = true})
+    local messages = {}
+    for _, message in future:pairs() do
+        table.insert(messages, message)
+    end
+    t.assert_equals(messages, {range(1, 100)})
+    conn:close()
+end
+
+-- Checks that results of CALL and EVAL aren't streamed.
+g.test_fetch_size_call = function()
+    local conn = net.connect(g.server.net_box_uri)
+    t.assert_error_msg_content_equals(
+        'call does not support fetch_size',
+        conn.call, conn, 'box.space.test:select', {}, {fetch_size = 7})
+    t.assert_error_msg_content_equals(
+        'eval does not support fetch_size',
+        conn.eval, conn, 'return 1', {}, {fetch_size = 7})
+    conn:close()
+end
@@ -0,0 +1,123 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('primary')
+        -- Mix big tuples, which are sent without copying, with small ones.
+        for i = 1, 200 do
+            local size = i % 3 == 0 and 10 or 1000 * (i % 50)
+            s:insert({i, string.rep(string.char(65 + i % 26), size)})
+        end
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+local function tuple(i)
+    local size = i % 3 == 0 and 10 or 1000 * (i % 50)
+    return {i, string.rep(string.char(65 + i % 26), size)}
+end
+
+local function range(from, to)
+    local ret = {}
+    for i = from, to do
+        table.insert(ret, tuple(i))
+    end
+    return ret
+end
+
+-- Checks that replies with big tuples are received intact.
+g.test_select = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local s = conn.space.test
+    t.assert_equals(s:select({}), range(1, 200))
+    t.assert_equals(s:select({100}, {iterator = 'LE', limit = 10}),
+                    {tuple(100), tuple(99), tuple(98), tuple(97), tuple(96),
+                     tuple(95), tuple(94), tuple(93), tuple(92), tuple(91)})
+    t.assert_equals(s:select({}, {fetch_size = 7}), range(1, 200))
+    t.assert_equals(s:get(49), tuple(49))
+    conn:close()
+end
+
+-- Checks that many concurrent replies referencing tuples are written
+-- correctly when the output doesn't fit in the socket buffer.
+g.test_select_async = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local s = conn.space.test
+    local futures = {}
+    for i = 1, 50 do
+        futures[i] = s:select({i}, {iterator = 'GE', limit = 100,
+                                    is_async = true})
+    end
+    for i = 1, 50 do
+        t.assert_equals(futures[i]:wait_result(), range(i, i + 99))
+    end
+    conn:close()
+end
+
+-- Checks that tuples returned by DML requests are sent intact and that
+-- a referenced tuple survives its deletion.
+g.test_dml = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local s = conn.space.test
+    local big = string.rep('x', 5000)
+    t.assert_equals(s:replace({1000, big}), {1000, big})
+    t.assert_equals(s:update({1000}, {{'=', 3, big}}), {1000, big, big})
+    t.assert_equals(s:delete({1000}), {1000, big, big})
+    t.assert_equals(s:get(1000), nil)
+    conn:close()
+end
+
+-- Checks that tuples returned by Lua functions are sent intact whether
+-- they are returned as is, in an array, or nested deeper.
+g.test_call = function()
+    g.server:exec(function()
+        rawset(_G, 'ret_tuple', function(i)
+            return box.space.test:get(i)
+        end)
+        rawset(_G, 'ret_multi', function(i)
+            local s = box.space.test
+            return s:get(i), 'x', s:get(i + 1), {s:get(i + 2)}
+        end)
+        rawset(_G, 'ret_select', function(i, n)
+            return box.space.test:select({i}, {iterator = 'GE', limit = n})
+        end)
+        rawset(_G, 'ret_nested', function(i)
+            return {a = box.space.test:get(i), b = {box.space.test:get(i)}}
+        end)
+        rawset(_G, 'ret_error', function(i)
+            return box.space.test:get(i), function() end
+        end)
+    end)
+    local conn = net.connect(g.server.net_box_uri)
+    t.assert_equals(conn:call('ret_tuple', {49}), tuple(49))
+    t.assert_equals({conn:call('ret_multi', {10})},
+                    {tuple(10), 'x', tuple(11), {tuple(12)}})
+    t.assert_equals(conn:call('ret_select', {1, 200}), range(1, 200))
+    t.assert_equals(conn:call('ret_nested', {47}),
+                    {a = tuple(47), b = {tuple(47)}})
+    t.assert_equals(conn:call_16('ret_tuple', 49), {tuple(49)})
+    t.assert_equals(conn:call_16('ret_select', 1, 50), range(1, 50))
+    t.assert_equals(conn:eval('return box.space.test:get(...)', {98}),
+                    tuple(98))
+    -- An encoding error after a referenced tuple doesn't break the
+    -- connection.
+    t.assert_error_msg_contains('unsupported Lua type',
+                                conn.call, conn, 'ret_error', {49})
+    local futures = {}
+    for i = 1, 50 do
+        futures[i] = conn:call('ret_select', {i, 100}, {is_async = true})
+    end
+    for i = 1, 50 do
+        t.assert_equals(futures[i]:wait_result(), {range(i, i + 99)})
+    end
+    conn:close()
+end
@@ -0,0 +1,123 @@
+local msgpack = require('msgpack')
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {
+            format = {{'id', 'unsigned'}, {'value', 'string'}},
+        })
+        s:create_index('primary')
+        s:create_index('value', {parts = {'value'}, unique = false})
+        rawset(_G, 'sum', function(a, b) return a + b end)
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function() box.space.test:truncate() end)
+end)
+
+-- Checks that requests of a batch are sent at once and that results are
+-- returned in order.
+g.test_batch = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local batch = conn:batch()
+    t.assert_equals(tostring(batch), 'net.box.batch')
+    for i = 1, 10 do
+        batch:insert('test', {i, 'v' .. i})
+    end
+    batch:replace('test', {11, 'v11'})
+        :update('test', {1}, {{'=', 2, 'x'}})
+        :upsert('test', {12, 'v12'}, {})
+        :delete('test', {2})
+        :select('test', {5}, {iterator = 'GE', limit = 2})
+        :select('test', {'x'}, {index = 'value'})
+        :call('sum', {1, 2})
+        :eval('return ...', {1, 2, 3})
+    local results, errors = batch:send()
+    t.assert_equals(errors, nil)
+    for i = 1, 10 do
+        t.assert_equals(results[i], {i, 'v' .. i})
+    end
+    t.assert_equals(results[11], {11, 'v11'})
+    t.assert_equals(results[12], {1, 'x'})
+    t.assert_equals(results[13], nil)
+    t.assert_equals(results[14], {2, 'v2'})
+    t.assert_equals(results[15], {{5, 'v5'}, {6, 'v6'}})
+    t.assert_equals(results[16], {{1, 'x'}})
+    t.assert_equals(results[16][1].value, 'x')
+    t.assert_equals(results[17], {3})
+    t.assert_equals(results[18], {1, 2, 3})
+
+    -- The batch is emptied by send() and may be reused.
+    results, errors = batch:select('test', {1}):send()
+    t.assert_equals(errors, nil)
+    t.assert_equals(results, {{{1, 'x'}}})
+    t.assert_equals({batch:send()}, {{}})
+    conn:close()
+end
+
+-- Checks that a failed request doesn't affect the others.
+g.test_batch_errors = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local results, errors = conn:batch()
+        :insert('test', {1, 'a'})
+        :insert('test', {1, 'b'})
+        :call('no_such_function')
+        :select('test', {1})
+        :send()
+    t.assert_equals(results[1], {1, 'a'})
+    t.assert_equals(results[2], nil)
+    t.assert_equals(results[3], nil)
+    t.assert_equals(results[4], {{1, 'a'}})
+    t.assert_equals(errors[2].code, box.error.TUPLE_FOUND)
+    t.assert_equals(errors[3].code, box.error.NO_SUCH_PROC)
+    t.assert_equals(errors[1], nil)
+    t.assert_equals(errors[4], nil)
+
+    local batch = conn:batch()
+    t.assert_error_msg_content_equals(
+        "Space 'no_such_space' does not exist",
+        batch.select, batch, 'no_such_space')
+    t.assert_error_msg_content_equals(
+        "No index 'foo' is defined in space 'test'",
+        batch.select, batch, 'test', nil, {index = 'foo'})
+    batch:call('sum', {1, 2})
+
+    -- A request that can't be encoded fails the whole batch.
+    batch:insert('test', {2, 'b'}):call('sum', {function() end})
+    t.assert_error_msg_contains('unsupported Lua type', batch.send, batch)
+    t.assert_equals(conn._transport:inprogress_request_count(), 0)
+    t.assert_equals(conn.space.test:select({2}), {})
+    t.assert_equals({conn:batch():call('sum', {1, 2}):send()}, {{{3}}})
+
+    batch:call('sum', {1, 2})
+    conn:close()
+    t.assert_error_msg_contains('Connection closed', batch.send, batch)
+end
+
+-- Checks the return_raw and timeout options.
+g.test_batch_opts = function()
+    local conn = net.connect(g.server.net_box_uri)
+    local results = conn:batch()
+        :insert('test', {1, 'a'})
+        :call('sum', {1, 2})
+        :send({return_raw = true})
+    t.assert(msgpack.is_object(results[1]))
+    t.assert_equals(results[1]:decode(), {1, 'a'})
+    t.assert(msgpack.is_object(results[2]))
+    t.assert_equals(results[2]:decode(), {3})
+
+    local batch = conn:batch():eval('require("fiber").sleep(10)')
+    t.assert_error_msg_content_equals('Timeout exceeded',
+                                      batch.send, batch, {timeout = 0.01})
+    conn:close()
+end
@@ -0,0 +1,98 @@
+local fiber = require('fiber')
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+    g.server:exec(function()
+        local fiber = require('fiber')
+        rawset(_G, 'ch', fiber.channel())
+        rawset(_G, 'wait', function() return _G.ch:get() end)
+        rawset(_G, 'echo', function(...) return ... end)
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.test_pool = function()
+    local uri = g.server.net_box_uri
+    local pool = net.pool.new({uri, uri}, {connections = 2})
+    t.assert_equals(tostring(pool), 'net.box.pool')
+    t.assert(pool:wait_connected(10))
+    t.assert_equals(pool:call('echo', {1, 2}), 1)
+    t.assert_equals({pool:eval('return ...', {1, 2})}, {1, 2})
+
+    -- Requests are sent to the least loaded connection.
+    local conns = {}
+    local fibers = {}
+    for i = 1, 4 do
+        local conn = pool:connection()
+        t.assert_equals(conns[conn], nil)
+        conns[conn] = true
+        fibers[i] = fiber.new(conn.call, conn, 'wait')
+        fibers[i]:set_joinable(true)
+        t.helpers.retrying({}, function()
+            t.assert_equals(conn._transport:inprogress_request_count(), 1)
+        end)
+    end
+    local stat = pool:stat()
+    t.assert_equals(#stat, 2)
+    for _, s in ipairs(stat) do
+        t.assert_equals(s.uri, uri)
+        t.assert_equals(s.connections, 2)
+        t.assert_equals(s.active, 2)
+        t.assert_equals(s.inprogress, 2)
+    end
+    g.server:exec(function()
+        for _ = 1, 4 do
+            _G.ch:put(true)
+        end
+    end)
+    for i = 1, 4 do
+        t.assert_equals({fibers[i]:join()}, {true, true})
+    end
+
+    -- Latency is accounted per endpoint.
+    stat = pool:stat()
+    local requests = 0
+    for _, s in ipairs(stat) do
+        t.assert_equals(s.inprogress, 0)
+        t.assert_ge(s.latency.p99, s.latency.p50)
+        requests = requests + s.requests
+    end
+    t.assert_ge(requests, 6)
+    pool:reset_stat()
+    for _, s in ipairs(pool:stat()) do
+        t.assert_equals(s.requests, 0)
+    end
+
+    pool:close()
+    t.assert_error_msg_content_equals('Connection is not established',
+                                      pool.connection, pool)
+end
+
+g.test_pool_health = function()
+    local uri = g.server.net_box_uri
+    local pool = net.pool.new({uri, 'unix/:/no/such/socket'})
+    t.helpers.retrying({}, function()
+        t.assert_equals(pool:stat()[1].active, 1)
+    end)
+    t.assert_equals(pool:stat()[2].active, 0)
+    -- Dead endpoints are skipped.
+    for _ = 1, 10 do
+        t.assert_equals(pool:call('echo', {1}), 1)
+    end
+    pool:close()
+
+    t.assert_error_msg_content_equals(
+        'Illegal parameters, uris should be a non-empty array',
+        net.pool.new, {})
+    t.assert_error_msg_content_equals(
+        'Illegal parameters, connections should be a positive number',
+        net.pool.new, {uri}, {connections = 0})
+end
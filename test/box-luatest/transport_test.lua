@@ -1,3 +1,4 @@
+local fio = require('fio')
 local net = require('net.box')
 local server = require('test.luatest_helpers.server')
 local tarantool = require('tarantool')
@@ -47,31 +48,74 @@ g.test_net_box = function()
         net.connect, {g.server.net_box_uri, params = {transport = 'foo'}})
 end
 
--- Check that SSL isn't available in open-source builds.
+-- Check the SSL transport of open-source builds.
 if tarantool.package ~= 'Tarantool Enterprise' then
 
+local cert_dir = fio.abspath('test/box-luatest/ssl_cert')
+local server_params = {
+    transport = 'ssl',
+    ssl_key_file = fio.pathjoin(cert_dir, 'server.key'),
+    ssl_cert_file = fio.pathjoin(cert_dir, 'server.crt'),
+}
+local client_params = {
+    transport = 'ssl',
+    ssl_ca_file = fio.pathjoin(cert_dir, 'ca.crt'),
+}
+
 g.test_listen_ssl = function()
-    g.server:exec(function()
+    g.server:exec(function(params)
         local t = require('luatest')
+        local listen = box.cfg.listen
         t.assert_error_msg_equals(
-            'SSL is not available in this build',
-            box.cfg, {listen = 'localhost:0?transport=ssl'})
-    end)
+            'ssl_key_file and ssl_cert_file parameters are mandatory ' ..
+            'for a server',
+            box.cfg, {listen = {listen, params = {transport = 'ssl'}}})
+        local bad_params = table.copy(params)
+        bad_params.ssl_key_file = params.ssl_cert_file
+        t.assert_error_msg_contains(
+            'Failed to load SSL key file',
+            box.cfg, {listen = {listen, params = bad_params}})
+        box.cfg({listen = {listen, params = params}})
+        box.cfg({listen = listen})
+    end, {server_params})
 end
 
 g.test_replication_ssl = function()
-    g.server:exec(function()
-        local t = require('luatest')
-        t.assert_error_msg_equals(
-            'SSL is not available in this build',
-            box.cfg, {replication = 'localhost:0?transport=ssl'})
-    end)
+    g.server:exec(function(server_params, client_params)
+        local listen = box.cfg.listen
+        box.cfg({listen = {listen, params = server_params}})
+        box.cfg({replication = {listen, params = client_params}})
+        box.cfg({replication = {}})
+        box.cfg({listen = listen})
+    end, {server_params, client_params})
 end
 
 g.test_net_box_ssl = function()
-    t.assert_error_msg_equals(
-        'SSL is not available in this build',
-        net.connect, {g.server.net_box_uri, params = {transport = 'ssl'}})
+    local uri = g.server.net_box_uri
+    local listen = g.server:exec(function(params)
+        local listen = box.cfg.listen
+        box.cfg({listen = {listen, params = params}})
+        rawset(_G, 'echo', function(...) return ... end)
+        return listen
+    end, {server_params})
+    -- Plain connections aren't accepted by an SSL listener.
+    local c = net.connect(uri, {connect_timeout = 1})
+    t.assert_not_equals(c.state, 'active')
+    c:close()
+    c = net.connect({uri, params = client_params})
+    t.assert_equals(c.state, 'active')
+    t.assert_equals({c:call('echo', {1, 'a'})}, {1, 'a'})
+    -- Check a request that doesn't fit in a single TLS record.
+    local data = string.rep('x', 100000)
+    t.assert_equals(c:eval('return ...', {data}), data)
+    c:close()
+    t.assert_error_msg_contains(
+        'Failed to load SSL CA file',
+        net.connect, {uri, params = {transport = 'ssl',
+                                     ssl_ca_file = server_params.ssl_key_file}})
+    g.server:exec(function(listen)
+        box.cfg({listen = listen})
+    end, {listen})
 end
 
 end -- tarantool.package ~= 'Tarantool Enterprise'
@@ -0,0 +1,61 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+    g.server:exec(function()
+        box.schema.space.create('test')
+        box.space.test:create_index('pk')
+    end)
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.test_cfg = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.wal_group_commit_delay, 0)
+        t.assert_equals(box.cfg.wal_group_commit_min_batch, 16)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'wal_group_commit_delay': " ..
+            "value must be >= 0",
+            box.cfg, {wal_group_commit_delay = -1})
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'wal_group_commit_min_batch': " ..
+            "value must be > 0",
+            box.cfg, {wal_group_commit_min_batch = 0})
+    end)
+end
+
+g.test_group_commit = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        box.stat.reset()
+        box.cfg({wal_group_commit_delay = 0.01,
+                 wal_group_commit_min_batch = 8})
+        local count = 100
+        local fibers = {}
+        for i = 1, count do
+            local f = fiber.new(box.space.test.replace, box.space.test, {i})
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            t.assert(f:join())
+        end
+        box.cfg({wal_group_commit_delay = 0})
+        t.assert_equals(box.space.test:count(), count)
+
+        local stat = box.stat.wal()
+        t.assert_le(stat.batches, count)
+        t.assert_ge(stat.batch_size.p99, 1)
+        t.assert_type(stat.batch_histogram, 'string')
+        t.assert_type(stat.write_histogram, 'string')
+        t.assert_ge(stat.write_latency.p99, 0)
+    end)
+end
@@ -49,6 +49,7 @@ end;
 for k, v in pairs(box.stat.DELETE) do
     table.insert(t, k)
 end;
+table.sort(t);
 t;
 
 ----------------
@@ -0,0 +1,204 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local server = require('test.luatest_helpers.server')
+
+local g = t.group('bootstrap_from_checkpoint')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({alias = 'master'})
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                server.build_instance_uri('master'),
+            },
+            replication_timeout = 1,
+            replication_bootstrap_files = true,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.master:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function check_data(replica)
+    replica:exec(function()
+        local t = require('luatest')
+        for _, name in ipairs({'memtx', 'vinyl'}) do
+            local s = box.space[name]
+            t.assert_equals(s:count(), 2000, name)
+            t.assert_equals(s.index.sk:count(), 2000, name)
+            t.assert_equals(s:get(1), {1, 'z00001', 'y'}, name)
+            t.assert_equals(s:get(1000), {1000, 'z01000', 'y'}, name)
+            t.assert_equals(s:get(1500), {1500, '01500', 'x'}, name)
+            t.assert_equals(s.index.sk:get('01001'),
+                            {1001, '01001', 'x'}, name)
+            t.assert_equals(s.index.sk:get('z01999'),
+                            {1999, 'z01999', 'y'}, name)
+        end
+        -- Group-local data isn't sent, like on join.
+        for _, name in ipairs({'local_memtx', 'local_vinyl'}) do
+            t.assert_equals(box.space[name]:count(), 0, name)
+        end
+    end)
+end
+
+local function create_local_spaces(master)
+    master:exec(function()
+        for _, engine in ipairs({'memtx', 'vinyl'}) do
+            local s = box.schema.space.create('local_' .. engine,
+                                              {engine = engine,
+                                               is_local = true})
+            s:create_index('pk')
+            for i = 1, 10 do
+                s:insert({i})
+            end
+        end
+    end)
+end
+
+-- Checks that the master doesn't leave behind the temporary copies
+-- of checkpoint files it makes for the replica.
+local function check_no_copies(master)
+    master:exec(function()
+        local t = require('luatest')
+        local fio = require('fio')
+        for _, dir in ipairs({box.cfg.memtx_dir, box.cfg.vinyl_dir}) do
+            t.assert_equals(fio.glob(fio.pathjoin(dir, '*.inprogress')), {})
+        end
+    end)
+end
+
+g.test_bootstrap = function(cg)
+    create_local_spaces(cg.master)
+    cg.master:exec(function()
+        box.schema.user.grant('guest', 'replication')
+        for _, engine in ipairs({'memtx', 'vinyl'}) do
+            local s = box.schema.space.create(engine, {engine = engine})
+            s:create_index('pk')
+            s:create_index('sk', {parts = {2, 'string'}})
+            for i = 1, 2000, 100 do
+                box.begin()
+                for j = i, i + 99 do
+                    s:insert({j, string.format('%05d', j), 'x'})
+                end
+                box.commit()
+            end
+        end
+        box.snapshot()
+        -- Rows written after the checkpoint are sent on registration.
+        for _, engine in ipairs({'memtx', 'vinyl'}) do
+            local s = box.space[engine]
+            for i = 1, 2000, 999 do
+                s:replace({i, string.format('z%05d', i), 'y'})
+            end
+        end
+    end)
+    cg.replica:start()
+    t.assert(cg.replica:grep_log('fetching checkpoint'))
+    t.assert(cg.replica:grep_log('checkpoint received'))
+    t.assert_not(cg.replica:grep_log('initial data received'))
+    check_data(cg.replica)
+    check_no_copies(cg.master)
+
+    -- The replica is registered and follows the master.
+    t.assert_equals(cg.replica:instance_id(), 2)
+    cg.replica:assert_follows_upstream(1)
+    cg.master:exec(function()
+        box.space.memtx:insert({3000, 'w03000'})
+        box.space.vinyl:insert({3000, 'w03000'})
+    end)
+    cg.replica:wait_vclock(cg.master:get_vclock())
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.memtx:get(3000), {3000, 'w03000'})
+        t.assert_equals(box.space.vinyl:get(3000), {3000, 'w03000'})
+    end)
+    cg.master:exec(function()
+        box.space.memtx:delete(3000)
+        box.space.vinyl:delete(3000)
+    end)
+    cg.replica:wait_vclock(cg.master:get_vclock())
+
+    -- The replica recovers from its local files after restart.
+    cg.replica:exec(function() box.snapshot() end)
+    cg.replica:restart()
+    check_data(cg.replica)
+    t.assert_equals(cg.replica:instance_id(), 2)
+    cg.replica:assert_follows_upstream(1)
+
+    -- The master doesn't pin the checkpoint after sending it.
+    -- The WAL is pinned only by the consumer of the registered replica.
+    local uuid = cg.replica:instance_uuid()
+    cg.master:exec(function(uuid)
+        local t = require('luatest')
+        for _, c in ipairs(box.info.gc().checkpoints) do
+            t.assert_equals(c.references, {})
+        end
+        local count = 0
+        for _, c in ipairs(box.info.gc().consumers) do
+            if c.name == 'replica ' .. uuid then
+                count = count + 1
+            end
+        end
+        t.assert_equals(count, 1)
+    end, {uuid})
+end
+
+g.test_wal_pinned_until_register = function(cg)
+    create_local_spaces(cg.master)
+    cg.master:exec(function()
+        box.cfg{checkpoint_count = 1}
+        box.schema.user.grant('guest', 'replication')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1})
+        box.snapshot()
+        s:insert({2})
+        box.error.injection.set('ERRINJ_REPLICA_REGISTER_DELAY', true)
+    end)
+    cg.replica:start({wait_for_readiness = false})
+    t.helpers.retrying({}, function()
+        t.assert(cg.master:grep_log('checkpoint sent'))
+    end)
+    cg.master:exec(function()
+        local t = require('luatest')
+        -- The checkpoint is sent, but the WAL written after it is
+        -- still pinned for the replica to register.
+        local checkpoint = box.info.gc().checkpoints[1]
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.info.gc().checkpoints[1].references, {})
+        end)
+        local consumer
+        for _, c in ipairs(box.info.gc().consumers) do
+            if c.name:startswith('replica ') then
+                consumer = c
+            end
+        end
+        t.assert_not_equals(consumer, nil)
+        t.assert_equals(consumer.signature, checkpoint.signature)
+        -- Make the garbage collector delete the checkpoint.
+        for i = 3, 4 do
+            box.space.test:insert({i})
+            box.snapshot()
+        end
+        box.error.injection.set('ERRINJ_REPLICA_REGISTER_DELAY', false)
+    end)
+    cg.replica:wait_for_readiness()
+    t.assert_equals(cg.replica:instance_id(), 2)
+    cg.replica:assert_follows_upstream(1)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:select(), {{1}, {2}, {3}, {4}})
+        t.assert_equals(box.space.local_memtx:count(), 0)
+        t.assert_equals(box.space.local_vinyl:count(), 0)
+    end)
+    check_no_copies(cg.master)
+end
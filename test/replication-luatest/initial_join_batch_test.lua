@@ -0,0 +1,57 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local server = require('test.luatest_helpers.server')
+
+local g = t.group('initial_join_batch')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({alias = 'master'})
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                server.build_instance_uri('master'),
+            },
+            replication_timeout = 1,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.master:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+g.test_initial_join = function(cg)
+    -- Make the data set span several send chunks and spaces.
+    cg.master:exec(function()
+        box.schema.user.grant('guest', 'replication')
+        for i = 1, 3 do
+            local s = box.schema.space.create('test' .. i)
+            s:create_index('pk')
+            s:create_index('sk', {parts = {2, 'string'}})
+            box.begin()
+            for j = 1, 5000 do
+                s:insert({j, string.format('%05d', 5000 - j),
+                          string.rep('x', 100)})
+            end
+            box.commit()
+        end
+        box.snapshot()
+    end)
+    cg.replica:start()
+    for i = 1, 3 do
+        local name = 'test' .. i
+        t.assert_equals(cg.replica:exec(function(name)
+            return box.space[name]:count()
+        end, {name}), 5000)
+        t.assert_equals(cg.replica:exec(function(name)
+            return box.space[name].index.sk:min()[1]
+        end, {name}), 5000)
+    end
+end
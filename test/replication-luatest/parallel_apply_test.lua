@@ -0,0 +1,95 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local server = require('test.luatest_helpers.server')
+
+local g = t.group('parallel_apply', {{engine = 'memtx'}, {engine = 'vinyl'}})
+
+g.before_each(function(cg)
+    local engine = cg.params.engine
+
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication         = {
+            server.build_instance_uri('master')
+        },
+        replication_timeout = 1,
+        read_only           = false
+    }
+
+    cg.master = cg.cluster:build_server({alias = 'master', engine = engine, box_cfg = box_cfg})
+
+    local box_cfg = {
+        replication         = {
+            server.build_instance_uri('master'),
+        },
+        replication_timeout = 1,
+        replication_connect_timeout = 4,
+        replication_apply_parallelism = 16,
+        read_only           = true
+    }
+
+    cg.replica = cg.cluster:build_server({alias = 'replica', engine = engine, box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+g.test_parallel_apply = function(cg)
+    cg.master:exec(function(engine)
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        local u = box.schema.space.create('uniq', {engine = engine})
+        u:create_index('pk')
+        u:create_index('sk', {parts = {2, 'unsigned'}})
+        local fibers = {}
+        for f = 1, 10 do
+            fibers[f] = fiber.new(function()
+                for i = 1, 100 do
+                    local k = i % 20
+                    s:upsert({k, 0}, {{'+', 2, 1}})
+                    s:replace({f * 1000 + i, i})
+                    if i % 10 == 0 then
+                        s:delete({f * 1000 + i - 5})
+                    end
+                    u:replace({k, f * 1000 + i})
+                end
+            end)
+            fibers[f]:set_joinable(true)
+        end
+        for f = 1, 10 do
+            fibers[f]:join()
+        end
+    end, {cg.params.engine})
+
+    local vclock = cg.master:get_vclock()
+    vclock[0] = nil
+    cg.replica:wait_vclock(vclock)
+
+    local select_all = "return box.space.test:select(), box.space.uniq:select()"
+    t.assert_equals(cg.replica:eval(select_all), cg.master:eval(select_all))
+    t.assert_equals(cg.replica:eval(
+        "return box.info.replication[1].upstream.status"), 'follow')
+    t.assert_ge(cg.replica:eval(
+        "return box.info.replication[1].upstream.apply_parallelism"), 1)
+end
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'replication_apply_parallelism': " ..
+            "must be greater than 0, less than or equal to 1000",
+            box.cfg, {replication_apply_parallelism = 0})
+        box.cfg{replication_apply_parallelism = 1}
+        t.assert_equals(box.cfg.replication_apply_parallelism, 1)
+    end)
+end
@@ -0,0 +1,74 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local server = require('test.luatest_helpers.server')
+
+local g = t.group('parallel_apply_yield', {
+    {engine = 'memtx', mvcc = false},
+    {engine = 'memtx', mvcc = true},
+    {engine = 'vinyl', mvcc = false},
+})
+
+local function wait_replica(cg)
+    local vclock = cg.master:get_vclock()
+    vclock[0] = nil
+    cg.replica:wait_vclock(vclock)
+end
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({
+        alias = 'master',
+        box_cfg = {
+            replication = {server.build_instance_uri('master')},
+            replication_timeout = 1,
+        },
+    })
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {server.build_instance_uri('master')},
+            replication_timeout = 1,
+            replication_apply_parallelism = 16,
+            memtx_use_mvcc_engine = cg.params.mvcc,
+            -- Make every commit but the first one wait for WAL.
+            wal_queue_max_size = 1,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+    cg.master:exec(function(engine)
+        box.schema.space.create('test', {engine = engine})
+        box.space.test:create_index('pk')
+    end, {cg.params.engine})
+    wait_replica(cg)
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+-- Checks that transactions of a group survive a yield of a transaction
+-- preceding them, here on a full WAL queue.
+g.test_predecessor_yield = function(cg)
+    cg.replica:exec(function()
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+    end)
+    cg.master:exec(function()
+        for i = 1, 100 do
+            box.space.test:replace({i})
+        end
+    end)
+    cg.replica:exec(function()
+        require('fiber').sleep(0.1)
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+    end)
+    wait_replica(cg)
+    cg.replica:assert_follows_upstream(1)
+    t.assert_equals(cg.replica:exec(function()
+        return box.space.test:count()
+    end), 100)
+    t.assert_not(cg.replica:grep_log('aborted by a fiber yield'))
+end
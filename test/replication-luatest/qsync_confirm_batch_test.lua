@@ -0,0 +1,53 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+
+local g = t.group('qsync-confirm-batch')
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_and_add_server({
+        alias = 'master',
+        box_cfg = {
+            replication_synchro_quorum = 1,
+            replication_synchro_timeout = 1000,
+        },
+    })
+    cg.cluster:start()
+    cg.master:exec(function()
+        box.ctl.promote()
+        box.ctl.wait_rw()
+        local s = box.schema.create_space('test', {is_sync = true})
+        s:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.cluster:drop()
+    cg.cluster.servers = nil
+end)
+
+g.test_confirm_batch = function(cg)
+    cg.master:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local txn_count = 100
+        local lsn = box.info.lsn
+        local fibers = {}
+        for i = 1, txn_count do
+            fibers[i] = fiber.new(box.space.test.insert, box.space.test, {i})
+            fibers[i]:set_joinable(true)
+        end
+        for i = 1, txn_count do
+            t.assert_equals({fibers[i]:join()}, {true, {i}})
+        end
+        t.assert_equals(box.info.synchro.queue.len, 0)
+        -- Every transaction and every CONFIRM takes one LSN. Concurrent
+        -- transactions are confirmed with fewer CONFIRM requests.
+        local confirm_count = box.info.lsn - lsn - txn_count
+        t.assert_ge(confirm_count, 1)
+        t.assert_lt(confirm_count, txn_count)
+        local latency = box.info.synchro.queue.latency
+        t.assert_gt(latency.p99, 0)
+        t.assert_le(latency.p50, latency.p99)
+    end)
+end
@@ -0,0 +1,66 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local server = require('test.luatest_helpers.server')
+
+local g = t.group('space_filter')
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_and_add_server({alias = 'master'})
+    cg.cluster:start()
+    cg.master:exec(function()
+        box.schema.user.grant('guest', 'replication')
+    end)
+    cg.replica = cg.cluster:build_and_add_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                server.build_instance_uri('master'),
+                params = {spaces = {1000}},
+            },
+            replication_timeout = 0.1,
+            read_only = true,
+        },
+    })
+    cg.replica:start()
+end)
+
+g.after_all(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+g.test_space_filter = function(cg)
+    cg.master:exec(function()
+        box.schema.space.create('allowed', {id = 1000})
+        box.space.allowed:create_index('pk')
+        box.schema.space.create('filtered', {id = 1001})
+        box.space.filtered:create_index('pk')
+        for i = 1, 10 do
+            box.space.allowed:insert({i})
+            box.space.filtered:insert({i})
+        end
+    end)
+    -- Rows of the filtered space are received as NOPs,
+    -- so the replica vclock still catches up.
+    local vclock = cg.master:get_vclock()
+    vclock[0] = nil
+    cg.replica:wait_vclock(vclock)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        -- DDL is replicated regardless of the filter.
+        t.assert_not_equals(box.space.filtered, nil)
+        t.assert_equals(box.space.allowed:count(), 10)
+        t.assert_equals(box.space.filtered:count(), 0)
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end)
+end
+
+g.test_invalid_space_filter = function(cg)
+    cg.replica:exec(function(uri)
+        local t = require('luatest')
+        t.assert_error_msg_content_equals(
+            'Invalid spaces: foo', box.cfg,
+            {replication = {uri, params = {spaces = 'foo'}}})
+    end, {server.build_instance_uri('master')})
+end
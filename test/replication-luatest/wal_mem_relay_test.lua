@@ -0,0 +1,108 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local server = require('test.luatest_helpers.server')
+
+local g = t.group('wal_mem_relay')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication         = {
+            server.build_instance_uri('master')
+        },
+        replication_timeout = 1,
+        read_only           = false
+    }
+
+    cg.master = cg.cluster:build_server({alias = 'master', box_cfg = box_cfg})
+
+    local box_cfg = {
+        replication         = {
+            server.build_instance_uri('master'),
+        },
+        replication_timeout = 1,
+        replication_connect_timeout = 4,
+        read_only           = true
+    }
+
+    cg.replica = cg.cluster:build_server({alias = 'replica', box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+-- Returns the number of xlog files opened by the master.
+local function count_open_xlogs(cg)
+    return cg.master:exec(function()
+        local fio = require('fio')
+        local count = 0
+        for _, fd in ipairs(fio.listdir('/proc/self/fd')) do
+            local path = fio.readlink('/proc/self/fd/' .. fd)
+            if path ~= nil and path:endswith('.xlog') then
+                count = count + 1
+            end
+        end
+        return count
+    end)
+end
+
+local function wait_replica(cg)
+    local vclock = cg.master:get_vclock()
+    vclock[0] = nil
+    cg.replica:wait_vclock(vclock)
+end
+
+g.test_relay_from_memory_and_files = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i})
+        end
+    end)
+    wait_replica(cg)
+    t.assert_equals(cg.replica:eval("return box.space.test:count()"), 100)
+
+    -- Write more than the WAL memory buffer can hold while
+    -- the replica is down so that the relay has to read files
+    -- before it can switch back to the buffer.
+    cg.replica:stop()
+    cg.master:exec(function()
+        local s = box.space.test
+        local pad = string.rep('x', 256 * 1024)
+        for i = 101, 200 do
+            s:insert({i, pad})
+        end
+        box.snapshot()
+        for i = 201, 300 do
+            s:insert({i, pad})
+        end
+    end)
+    cg.replica:start()
+    wait_replica(cg)
+    t.assert_equals(cg.replica:eval("return box.space.test:count()"), 300)
+
+    cg.master:exec(function()
+        local s = box.space.test
+        for i = 301, 400 do
+            s:insert({i})
+        end
+        s:delete({1})
+    end)
+    wait_replica(cg)
+    t.assert_equals(cg.replica:eval("return box.space.test:count()"), 399)
+    t.assert_equals(cg.replica:eval(
+        "return box.info.replication[1].upstream.status"), 'follow')
+    -- Only the WAL writer keeps the current xlog file open, the
+    -- relay streaming from the buffer has closed its cursor.
+    if jit.os == 'Linux' then
+        t.assert_equals(count_open_xlogs(cg), 1)
+    end
+end
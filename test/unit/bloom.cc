@@ -10,10 +10,12 @@ uint32_t h(uint32_t i)
 	return i * 2654435761;
 }
 
+static const char *type_name[] = { "classic", "split_block" };
+
 void
-simple_test()
+simple_test(enum bloom_type type)
 {
-	cout << "*** " << __func__ << " ***" << endl;
+	cout << "*** " << __func__ << " " << type_name[type] << " ***" << endl;
 	srand(time(0));
 	uint32_t error_count = 0;
 	uint32_t fp_rate_too_big = 0;
@@ -22,7 +24,7 @@ simple_test()
 		uint64_t false_positive = 0;
 		for (uint32_t count = 1000; count <= 10000; count *= 2) {
 			struct bloom bloom;
-			bloom_create(&bloom, count, p);
+			bloom_create(&bloom, count, p, type);
 			unordered_set<uint32_t> check;
 			for (uint32_t i = 0; i < count; i++) {
 				uint32_t val = rand() % (count * 10);
@@ -50,9 +52,9 @@ simple_test()
 }
 
 void
-store_load_test()
+store_load_test(enum bloom_type type)
 {
-	cout << "*** " << __func__ << " ***" << endl;
+	cout << "*** " << __func__ << " " << type_name[type] << " ***" << endl;
 	srand(time(0));
 	uint32_t error_count = 0;
 	uint32_t fp_rate_too_big = 0;
@@ -61,7 +63,7 @@ store_load_test()
 		uint64_t false_positive = 0;
 		for (uint32_t count = 300; count <= 3000; count *= 10) {
 			struct bloom bloom;
-			bloom_create(&bloom, count, p);
+			bloom_create(&bloom, count, p, type);
 			unordered_set<uint32_t> check;
 			for (uint32_t i = 0; i < count; i++) {
 				uint32_t val = rand() % (count * 10);
@@ -99,6 +101,8 @@ store_load_test()
 int
 main(void)
 {
-	simple_test();
-	store_load_test();
+	simple_test(BLOOM_CLASSIC);
+	store_load_test(BLOOM_CLASSIC);
+	simple_test(BLOOM_SPLIT_BLOCK);
+	store_load_test(BLOOM_SPLIT_BLOCK);
 }
@@ -0,0 +1,269 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "diag.h"
+#include "fiber.h"
+#include "iostream.h"
+#include "memory.h"
+#include "ssl.h"
+#include "trivia/util.h"
+#include "tt_static.h"
+#include "unit.h"
+#include "uri/uri.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#define CERT_DIR SSL_CERT_DIR "/"
+
+static const char server_uri[] =
+	"localhost:3301?transport=ssl"
+	"&ssl_key_file=" CERT_DIR "server.key"
+	"&ssl_cert_file=" CERT_DIR "server.crt";
+
+static const char client_uri[] =
+	"localhost:3301?transport=ssl"
+	"&ssl_ca_file=" CERT_DIR "ca.crt";
+
+static struct ssl_iostream_ctx *
+ctx_new(enum iostream_mode mode, const char *str)
+{
+	struct uri uri;
+	fail_if(uri_create(&uri, str) != 0);
+	struct ssl_iostream_ctx *ctx = ssl_iostream_ctx_new(mode, &uri);
+	uri_destroy(&uri);
+	return ctx;
+}
+
+/**
+ * Creates a pair of connected SSL streams over a socket pair with
+ * a small send buffer so that writes return IOSTREAM_WANT_WRITE.
+ */
+static void
+stream_pair_create(struct iostream *server, struct iostream *client,
+		   struct ssl_iostream_ctx *server_ctx,
+		   struct ssl_iostream_ctx *client_ctx)
+{
+	int sv[2];
+	fail_if(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0);
+	int size = 4096;
+	fail_if(setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF,
+			   &size, sizeof(size)) != 0);
+	for (int i = 0; i < 2; i++)
+		fail_if(fcntl(sv[i], F_SETFL, O_NONBLOCK) != 0);
+	fail_if(ssl_iostream_create(server, sv[0], IOSTREAM_SERVER,
+				    server_ctx) != 0);
+	fail_if(ssl_iostream_create(client, sv[1], IOSTREAM_CLIENT,
+				    client_ctx) != 0);
+}
+
+/** Reads from a stream, retrying while it would block. */
+static ssize_t
+stream_read(struct iostream *io, void *buf, size_t size)
+{
+	ssize_t rc;
+	do {
+		rc = iostream_read(io, buf, size);
+	} while (rc == IOSTREAM_WANT_READ || rc == IOSTREAM_WANT_WRITE);
+	return rc;
+}
+
+/** Writes to a stream, retrying while it would block. */
+static ssize_t
+stream_write(struct iostream *io, const void *buf, size_t size)
+{
+	ssize_t rc;
+	do {
+		rc = iostream_write(io, buf, size);
+	} while (rc == IOSTREAM_WANT_READ || rc == IOSTREAM_WANT_WRITE);
+	return rc;
+}
+
+static void
+test_ctx_new(void)
+{
+	header();
+	plan(4);
+
+	struct ssl_iostream_ctx *ctx;
+	ctx = ctx_new(IOSTREAM_SERVER, "localhost:3301?transport=ssl");
+	is(ctx, NULL, "server without a key and a certificate");
+	ok(strcmp(diag_last_error(diag_get())->errmsg,
+		  "ssl_key_file and ssl_cert_file parameters are mandatory "
+		  "for a server") == 0, "error message");
+	ctx = ctx_new(IOSTREAM_SERVER, server_uri);
+	isnt(ctx, NULL, "server");
+	ssl_iostream_ctx_delete(ctx);
+	ctx = ctx_new(IOSTREAM_CLIENT, client_uri);
+	isnt(ctx, NULL, "client");
+	ssl_iostream_ctx_delete(ctx);
+
+	check_plan();
+	footer();
+}
+
+/**
+ * Sends data that doesn't fit in the socket buffer and in a single
+ * TLS record, then checks a write in the other direction and EOF.
+ */
+static void
+test_transfer(void)
+{
+	header();
+	plan(5);
+
+	struct ssl_iostream_ctx *server_ctx =
+		ctx_new(IOSTREAM_SERVER, server_uri);
+	struct ssl_iostream_ctx *client_ctx =
+		ctx_new(IOSTREAM_CLIENT, client_uri);
+	fail_if(server_ctx == NULL || client_ctx == NULL);
+	struct iostream server, client;
+	stream_pair_create(&server, &client, server_ctx, client_ctx);
+
+	enum { DATA_SIZE = 3 * 1000 * 1000 };
+	char *out = xmalloc(DATA_SIZE);
+	char *in = xmalloc(DATA_SIZE);
+	for (int i = 0; i < DATA_SIZE; i++)
+		out[i] = i * 7 + i / 13;
+	size_t sent = 0, received = 0;
+	bool is_ok = true;
+	while (is_ok && received < DATA_SIZE) {
+		if (sent < DATA_SIZE) {
+			/* Split the data into uneven iovecs. */
+			size_t left = DATA_SIZE - sent;
+			size_t half = left / 2;
+			struct iovec iov[3] = {
+				{out + sent, half},
+				{out + sent + half, 1},
+				{out + sent + half + 1, left - half - 1},
+			};
+			ssize_t rc = iostream_writev(&server, iov, 3);
+			if (rc == IOSTREAM_ERROR)
+				is_ok = false;
+			else if (rc > 0)
+				sent += rc;
+		}
+		ssize_t rc = iostream_read(&client, in + received,
+					   MIN(DATA_SIZE - received, 100000));
+		if (rc == 0 || rc == IOSTREAM_ERROR)
+			is_ok = false;
+		else if (rc > 0)
+			received += rc;
+	}
+	ok(is_ok, "transfer");
+	ok(received == DATA_SIZE && memcmp(in, out, DATA_SIZE) == 0,
+	   "data");
+	free(in);
+	free(out);
+
+	is(stream_write(&client, "hello", 5), 5, "write");
+	char buf[16];
+	ssize_t rc = stream_read(&server, buf, sizeof(buf));
+	ok(rc == 5 && memcmp(buf, "hello", 5) == 0, "read");
+
+	iostream_close(&client);
+	is(stream_read(&server, buf, sizeof(buf)), 0, "eof");
+	iostream_close(&server);
+
+	ssl_iostream_ctx_delete(server_ctx);
+	ssl_iostream_ctx_delete(client_ctx);
+
+	check_plan();
+	footer();
+}
+
+/**
+ * Runs the handshake by sending a byte from the client to the server.
+ * Returns true if the server receives it.
+ */
+static bool
+stream_handshake(struct iostream *server, struct iostream *client)
+{
+	bool sent = false;
+	while (true) {
+		ssize_t rc;
+		if (!sent) {
+			rc = iostream_write(client, "x", 1);
+			if (rc == IOSTREAM_ERROR)
+				return false;
+			sent = rc == 1;
+		}
+		char c;
+		rc = iostream_read(server, &c, 1);
+		if (rc == 0 || rc == IOSTREAM_ERROR)
+			return false;
+		if (rc == 1)
+			return true;
+	}
+}
+
+/**
+ * Checks that a client accepts the server certificate only if it was
+ * issued for the host from the URI. The test certificate is issued
+ * for localhost and 127.0.0.1.
+ */
+static void
+test_verify_host(void)
+{
+	header();
+	plan(5);
+
+	static const struct {
+		const char *host;
+		bool is_ok;
+	} cases[] = {
+		{"localhost:3301", true},
+		{"127.0.0.1:3301", true},
+		{"unix/:/tmp/test.sock", true},
+		{"example.com:3301", false},
+		{"127.0.0.2:3301", false},
+	};
+	struct ssl_iostream_ctx *server_ctx =
+		ctx_new(IOSTREAM_SERVER, server_uri);
+	fail_if(server_ctx == NULL);
+	for (size_t i = 0; i < lengthof(cases); i++) {
+		const char *str = tt_sprintf("%s?transport=ssl"
+					     "&ssl_ca_file=" CERT_DIR "ca.crt",
+					     cases[i].host);
+		struct ssl_iostream_ctx *client_ctx =
+			ctx_new(IOSTREAM_CLIENT, str);
+		fail_if(client_ctx == NULL);
+		struct iostream server, client;
+		stream_pair_create(&server, &client, server_ctx, client_ctx);
+		is(stream_handshake(&server, &client), cases[i].is_ok,
+		   "%s", cases[i].host);
+		iostream_close(&client);
+		iostream_close(&server);
+		ssl_iostream_ctx_delete(client_ctx);
+	}
+	ssl_iostream_ctx_delete(server_ctx);
+
+	check_plan();
+	footer();
+}
+
+int
+main(void)
+{
+	memory_init();
+	fiber_init(fiber_c_invoke);
+	ssl_init();
+
+	header();
+	plan(3);
+	test_ctx_new();
+	test_transfer();
+	test_verify_host();
+	int rc = check_plan();
+	footer();
+
+	ssl_free();
+	fiber_free();
+	memory_free();
+	return rc;
+}
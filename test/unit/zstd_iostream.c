@@ -0,0 +1,187 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "diag.h"
+#include "fiber.h"
+#include "iostream.h"
+#include "memory.h"
+#include "trivia/util.h"
+#include "unit.h"
+#include "zstd_iostream.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <zstd.h>
+
+/**
+ * Creates a pair of connected streams over a socket pair with a
+ * small send buffer so that writes return IOSTREAM_WANT_WRITE.
+ * The first stream is always compressed, the second one only if
+ * @a is_compressed is set.
+ */
+static void
+stream_pair_create(struct iostream *a, struct iostream *b, bool is_compressed)
+{
+	int sv[2];
+	fail_if(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0);
+	int size = 4096;
+	fail_if(setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF,
+			   &size, sizeof(size)) != 0);
+	for (int i = 0; i < 2; i++)
+		fail_if(fcntl(sv[i], F_SETFL, O_NONBLOCK) != 0);
+	plain_iostream_create(a, sv[0]);
+	plain_iostream_create(b, sv[1]);
+	fail_if(zstd_iostream_create(a) != 0);
+	fail_if(is_compressed && zstd_iostream_create(b) != 0);
+}
+
+/** Reads from a stream, retrying while it would block. */
+static ssize_t
+stream_read(struct iostream *io, void *buf, size_t size)
+{
+	ssize_t rc;
+	do {
+		rc = iostream_read(io, buf, size);
+	} while (rc == IOSTREAM_WANT_READ || rc == IOSTREAM_WANT_WRITE);
+	return rc;
+}
+
+/** Writes to a stream, retrying while it would block. */
+static ssize_t
+stream_write(struct iostream *io, const void *buf, size_t size)
+{
+	ssize_t rc;
+	do {
+		rc = iostream_write(io, buf, size);
+	} while (rc == IOSTREAM_WANT_READ || rc == IOSTREAM_WANT_WRITE);
+	return rc;
+}
+
+/**
+ * Sends data that compresses to much more than the socket buffer
+ * and the stream write buffer, so that writes are cut short while
+ * the data is being compressed, then checks a write in the other
+ * direction and EOF.
+ */
+static void
+test_transfer(void)
+{
+	header();
+	plan(5);
+
+	struct iostream server, client;
+	stream_pair_create(&server, &client, true);
+
+	enum { DATA_SIZE = 8 * 1000 * 1000 };
+	char *out = xmalloc(DATA_SIZE);
+	char *in = xmalloc(DATA_SIZE);
+	/* Poorly compressible data. */
+	unsigned seed = 1;
+	for (int i = 0; i < DATA_SIZE; i++) {
+		seed = seed * 1103515245 + 12345;
+		out[i] = i % 4 == 0 ? 'x' : (char)(seed >> 16);
+	}
+	size_t sent = 0, received = 0;
+	bool is_ok = true;
+	while (is_ok && received < DATA_SIZE) {
+		if (sent < DATA_SIZE) {
+			/* Split the data into uneven iovecs. */
+			size_t left = DATA_SIZE - sent;
+			size_t half = left / 2;
+			struct iovec iov[3] = {
+				{out + sent, half},
+				{out + sent + half, 1},
+				{out + sent + half + 1, left - half - 1},
+			};
+			ssize_t rc = iostream_writev(&server, iov, 3);
+			if (rc == IOSTREAM_ERROR)
+				is_ok = false;
+			else if (rc > 0)
+				sent += rc;
+		}
+		ssize_t rc = iostream_read(&client, in + received,
+					   MIN(DATA_SIZE - received, 100000));
+		if (rc == 0 || rc == IOSTREAM_ERROR)
+			is_ok = false;
+		else if (rc > 0)
+			received += rc;
+	}
+	ok(is_ok, "transfer");
+	ok(received == DATA_SIZE && memcmp(in, out, DATA_SIZE) == 0,
+	   "data");
+	free(in);
+	free(out);
+
+	is(stream_write(&client, "hello", 5), 5, "write");
+	char buf[16];
+	ssize_t rc = stream_read(&server, buf, sizeof(buf));
+	ok(rc == 5 && memcmp(buf, "hello", 5) == 0, "read");
+
+	iostream_close(&client);
+	is(stream_read(&server, buf, sizeof(buf)), 0, "eof");
+	iostream_close(&server);
+
+	check_plan();
+	footer();
+}
+
+/**
+ * Checks that a stream refuses to decompress a frame that needs
+ * a window bigger than ZSTD_IOSTREAM_WINDOW_LOG.
+ */
+static void
+test_window_log_max(void)
+{
+	header();
+	plan(2);
+
+	struct iostream server, client;
+	stream_pair_create(&server, &client, false);
+
+	ZSTD_CCtx *cctx = ZSTD_createCCtx();
+	fail_if(cctx == NULL);
+	fail_if(ZSTD_isError(ZSTD_CCtx_setParameter(
+			cctx, ZSTD_c_windowLog, ZSTD_IOSTREAM_WINDOW_LOG + 4)));
+	char frame[256];
+	ZSTD_outBuffer zout = {frame, sizeof(frame), 0};
+	ZSTD_inBuffer zin = {"hello", 5, 0};
+	/* The source size is unknown, so the window is kept. */
+	fail_if(ZSTD_compressStream2(cctx, &zout, &zin, ZSTD_e_flush) != 0);
+	ZSTD_freeCCtx(cctx);
+	fail_if(stream_write(&client, frame, zout.pos) != (ssize_t)zout.pos);
+
+	char buf[16];
+	is(stream_read(&server, buf, sizeof(buf)), IOSTREAM_ERROR, "read");
+	ok(strstr(diag_last_error(diag_get())->errmsg,
+		  "zstd decompression failed") != NULL, "error message");
+
+	iostream_close(&client);
+	iostream_close(&server);
+
+	check_plan();
+	footer();
+}
+
+int
+main(void)
+{
+	memory_init();
+	fiber_init(fiber_c_invoke);
+
+	header();
+	plan(2);
+	test_transfer();
+	test_window_log_max();
+	int rc = check_plan();
+	footer();
+
+	fiber_free();
+	memory_free();
+	return rc;
+}
@@ -0,0 +1,88 @@
+local common = require('test.vinyl-luatest.common')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = common.default_box_cfg(),
+    })
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        local s = box.space.test
+        if s then
+            s:drop()
+        end
+    end)
+end)
+
+g.test_option = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, options parameter 'bloom_type' " ..
+            "should be of type string",
+            s.create_index, s, 'pk', {bloom_type = 1})
+        t.assert_error_msg_content_equals(
+            "Wrong index options (field 4): bloom_type must be " ..
+            "either 'classic' or 'split_block'",
+            s.create_index, s, 'pk', {bloom_type = 'foo'})
+        local i = s:create_index('pk')
+        t.assert_equals(i.options.bloom_type, nil)
+        i:alter({bloom_type = 'split_block'})
+        t.assert_equals(s.index.pk.options.bloom_type, 'split_block')
+        t.assert_equals(box.space._index:get({s.id, i.id}).opts.
+                        bloom_type, 'split_block')
+        i:alter({bloom_type = 'classic'})
+        t.assert_equals(s.index.pk.options.bloom_type, nil)
+    end)
+end
+
+g.test_split_block = function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {parts = {1, 'unsigned', 2, 'unsigned'},
+                              bloom_type = 'split_block'})
+        s:create_index('sk', {parts = {3, 'unsigned'},
+                              bloom_type = 'split_block'})
+        -- Create a few runs so that point lookups check many filters.
+        for k = 1, 3 do
+            for j = 1, 100 do
+                s:replace({j * 3 + k, k, j * 3 + k})
+            end
+            box.snapshot()
+        end
+    end)
+    local function check()
+        g.server:exec(function()
+            local t = require('luatest')
+            local s = box.space.test
+            local pk_hit = s.index.pk:stat().disk.iterator.bloom.hit
+            local sk_hit = s.index.sk:stat().disk.iterator.bloom.hit
+            for k = 1, 3 do
+                for j = 1, 100 do
+                    local v = j * 3 + k
+                    t.assert_equals(s:get({v, k}), {v, k, v})
+                    t.assert_equals(s.index.sk:get({v}), {v, k, v})
+                    t.assert_equals(s:get({v, k + 1}), nil)
+                    t.assert_equals(s.index.sk:get({v + 1000}), nil)
+                end
+            end
+            t.assert_equals(s.index.pk:select({4}), {{4, 1, 4}})
+            t.assert_gt(s.index.pk:stat().disk.iterator.bloom.hit, pk_hit)
+            t.assert_gt(s.index.sk:stat().disk.iterator.bloom.hit, sk_hit)
+        end)
+    end
+    check()
+    g.server:restart()
+    check()
+end
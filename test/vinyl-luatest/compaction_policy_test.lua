@@ -0,0 +1,76 @@
+local common = require('test.vinyl-luatest.common')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = common.default_box_cfg(),
+    })
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        local s = box.space.test
+        if s then
+            s:drop()
+        end
+    end)
+end)
+
+g.test_option = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, options parameter 'compaction_policy' " ..
+            "should be of type string",
+            s.create_index, s, 'pk', {compaction_policy = 1})
+        t.assert_error_msg_content_equals(
+            "Wrong index options (field 4): compaction_policy must be " ..
+            "either 'tiered' or 'leveled'",
+            s.create_index, s, 'pk', {compaction_policy = 'foo'})
+        local i = s:create_index('pk')
+        t.assert_equals(i.options.compaction_policy, nil)
+        t.assert_equals(box.space._index:get({s.id, i.id}).opts.
+                        compaction_policy, nil)
+        i:alter({compaction_policy = 'leveled'})
+        t.assert_equals(s.index.pk.options.compaction_policy, 'leveled')
+        t.assert_equals(box.space._index:get({s.id, i.id}).opts.
+                        compaction_policy, 'leveled')
+        i:alter({compaction_policy = 'tiered'})
+        t.assert_equals(s.index.pk.options.compaction_policy, nil)
+    end)
+end
+
+g.test_leveled = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        -- With the tiered policy, all runs would fit in one level.
+        local i = s:create_index('pk', {
+            compaction_policy = 'leveled',
+            run_count_per_level = 10,
+            run_size_ratio = 1000,
+        })
+        for k = 1, 3 do
+            for j = 1, 10 do
+                s:replace({j, k})
+            end
+            box.snapshot()
+        end
+        t.helpers.retrying({}, function()
+            t.assert_equals(i:stat().run_count, 1)
+        end)
+        local stat = i:stat().amplification
+        t.assert_equals(stat.read, 1)
+        t.assert_equals(stat.space, 1)
+        t.assert_gt(stat.write, 1)
+    end)
+end
@@ -0,0 +1,106 @@
+local common = require('test.vinyl-luatest.common')
+local fio = require('fio')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_each(function()
+    local box_cfg = common.default_box_cfg()
+    box_cfg.force_recovery = true
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = box_cfg,
+    })
+    g.server:start()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk', {page_size = 4096,
+                                        compression_dict = true})
+        for k = 1, 2 do
+            for j = 1, 1000 do
+                s:replace({j, k, string.format(
+                    'user%05d@example.com {"name": "User %d", ' ..
+                    '"status": "active", "role": "reader"}', j, j)})
+            end
+            box.snapshot()
+        end
+        i:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(i:stat().run_count, 1)
+        end)
+    end)
+end)
+
+g.after_test('test_rebuild_index', function()
+    g.server:drop()
+end)
+
+g.after_test('test_index_lost', function()
+    g.server:cleanup()
+end)
+
+g.after_test('test_xlog_reader', function()
+    g.server:drop()
+end)
+
+-- Checks that the index of a run compressed with a dictionary is
+-- rebuilt if the index file can be read but fails to load.
+g.test_rebuild_index = function()
+    g.server:stop()
+    g.server.env = {ERRINJ_VY_RUN_OPEN = '0'}
+    g.server:start()
+    t.assert(g.server:grep_log('rebuilding index for'))
+    t.assert_not(g.server:grep_log('failed to load compression dictionary'))
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), 1000)
+        t.assert_equals(box.space.test:get(1)[2], 2)
+    end)
+    -- The rebuilt index file keeps the dictionary.
+    g.server.env = {}
+    g.server:restart()
+    t.assert_not(g.server:grep_log('rebuilding index for'))
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), 1000)
+    end)
+end
+
+-- The dictionary is stored only in the index file so a run
+-- compressed with it can't be recovered if the file is lost.
+g.test_index_lost = function()
+    g.server:exec(function()
+        local fio = require('fio')
+        local dir = fio.pathjoin(box.cfg.vinyl_dir, box.space.test.id, 0)
+        for _, f in ipairs(fio.glob(fio.pathjoin(dir, '*.index'))) do
+            fio.unlink(f)
+        end
+    end)
+    g.server:stop()
+    g.server:start({wait_for_readiness = false})
+    local filename = fio.pathjoin(g.server.workdir, g.server.alias .. '.log')
+    t.helpers.retrying({}, function()
+        t.assert(g.server:grep_log('Decompression error', nil,
+                                   {filename = filename}))
+    end)
+    t.assert(g.server:grep_log('failed to load compression dictionary',
+                               nil, {filename = filename}))
+end
+
+-- The xlog reader can't decode a run compressed with a dictionary.
+g.test_xlog_reader = function()
+    g.server:exec(function()
+        local fio = require('fio')
+        local t = require('luatest')
+        local xlog = require('xlog')
+        local dir = fio.pathjoin(box.cfg.vinyl_dir, box.space.test.id, 0)
+        -- Runs replaced by compaction may not be deleted yet.
+        local files = fio.glob(fio.pathjoin(dir, '*.run'))
+        table.sort(files)
+        t.assert_error_msg_contains('Decompression error', function()
+            for _ in xlog.pairs(files[#files]) do -- luacheck: ignore
+            end
+        end)
+    end)
+end
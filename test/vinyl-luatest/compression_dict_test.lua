@@ -0,0 +1,84 @@
+local common = require('test.vinyl-luatest.common')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = common.default_box_cfg(),
+    })
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        for _, name in ipairs({'test', 'test_dict'}) do
+            local s = box.space[name]
+            if s then
+                s:drop()
+            end
+        end
+    end)
+end)
+
+g.test_option = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, options parameter 'compression_dict' " ..
+            "should be of type boolean",
+            s.create_index, s, 'pk', {compression_dict = 'yes'})
+        local i = s:create_index('pk')
+        t.assert_equals(i.options.compression_dict, nil)
+        i:alter({compression_dict = true})
+        t.assert_equals(s.index.pk.options.compression_dict, true)
+        t.assert_equals(box.space._index:get({s.id, i.id}).opts.
+                        compression_dict, true)
+        i:alter({compression_dict = false})
+        t.assert_equals(s.index.pk.options.compression_dict, nil)
+    end)
+end
+
+g.test_compression = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local function fill(s)
+            for k = 1, 2 do
+                for j = 1, 1000 do
+                    s:replace({j, k, string.format(
+                        'user%05d@example.com {"name": "User %d", ' ..
+                        '"status": "active", "role": "reader"}', j, j)})
+                end
+                box.snapshot()
+            end
+        end
+        local s1 = box.schema.space.create('test', {engine = 'vinyl'})
+        local i1 = s1:create_index('pk', {page_size = 4096})
+        local s2 = box.schema.space.create('test_dict', {engine = 'vinyl'})
+        local i2 = s2:create_index('pk', {page_size = 4096,
+                                          compression_dict = true})
+        fill(s1)
+        fill(s2)
+        i1:compact()
+        i2:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(i1:stat().run_count, 1)
+            t.assert_equals(i2:stat().run_count, 1)
+        end)
+        t.assert_lt(i2:stat().disk.bytes_compressed,
+                    i1:stat().disk.bytes_compressed)
+    end)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test_dict:select(),
+                        box.space.test:select())
+        t.assert_equals(box.space.test_dict:count(), 1000)
+    end)
+end
@@ -0,0 +1,231 @@
+local common = require('test.vinyl-luatest.common')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = common.default_box_cfg(),
+    })
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_errors = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+        t.assert_error_msg_content_equals(
+            "Secondary index does not support delete_range",
+            s.index.sk.delete_range, s.index.sk, {1}, {2})
+        t.assert_error_msg_content_equals(
+            "Supplied key type of part 0 does not match index part type: " ..
+            "expected unsigned",
+            s.delete_range, s, {'a'}, {2})
+        t.assert_error_msg_content_equals(
+            "Usage index:delete_range(key, end_key)",
+            require('box.internal').delete_range, s.id, 0, {1})
+        s:drop()
+        s = box.schema.space.create('test', {engine = 'memtx'})
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "memtx does not support delete_range",
+            s.delete_range, s, {1}, {2})
+    end)
+end
+
+g.test_delete_range = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {parts = {1, 'unsigned', 2, 'unsigned'}})
+        for i = 1, 10 do
+            for j = 1, 3 do
+                s:replace({i, j})
+            end
+        end
+        -- Full keys: the lower bound is inclusive, the upper bound
+        -- is exclusive.
+        s:delete_range({1, 2}, {2, 2})
+        t.assert_equals(s:select({1}), {{1, 1}})
+        t.assert_equals(s:select({2}), {{2, 2}, {2, 3}})
+        -- Partial keys bound the range by prefixes.
+        s:delete_range({4}, {6})
+        t.assert_equals(s:select({4}), {})
+        t.assert_equals(s:select({5}), {})
+        t.assert_equals(s:select({6}), {{6, 1}, {6, 2}, {6, 3}})
+        -- An empty key means no bound.
+        s:delete_range({9}, {})
+        t.assert_equals(s:select({}, {iterator = 'ge', limit = 1}),
+                        {{1, 1}})
+        t.assert_equals(s:select({}, {iterator = 'le', limit = 1}),
+                        {{8, 3}})
+        -- Tuples inserted after the range delete are visible.
+        s:replace({5, 5})
+        t.assert_equals(s:get({5, 5}), {5, 5})
+        local function check()
+            t.assert_equals(s:select({}, {iterator = 'ge', limit = 2}),
+                            {{1, 1}, {2, 2}})
+            t.assert_equals(s:select({3}, {iterator = 'gt'}),
+                            {{5, 5}, {6, 1}, {6, 2}, {6, 3}, {7, 1},
+                             {7, 2}, {7, 3}, {8, 1}, {8, 2}, {8, 3}})
+            t.assert_equals(s:select({}, {iterator = 'lt', limit = 2}),
+                            {{8, 3}, {8, 2}})
+            t.assert_equals(s:get({4, 1}), nil)
+            t.assert_equals(s:get({9, 3}), nil)
+            t.assert_equals(s:count(), 16)
+        end
+        check()
+        box.snapshot()
+        check()
+        s:replace({6, 1})
+        box.snapshot()
+        check()
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().run_count, 1)
+        end)
+        -- Deleted tuples are purged by compaction.
+        t.assert_equals(s.index.pk:stat().disk.rows, 16)
+        check()
+    end)
+end
+
+g.test_tx = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        for i = 1, 10 do
+            s:replace({i})
+        end
+        -- Own changes.
+        box.begin()
+        s:replace({11})
+        s:delete_range({5}, {})
+        t.assert_equals(s:select({}, {iterator = 'ge'}),
+                        {{1}, {2}, {3}, {4}})
+        s:replace({7})
+        t.assert_equals(s:get({7}), {7})
+        box.rollback()
+        t.assert_equals(s:count(), 10)
+        -- Isolation.
+        local f = fiber.new(function()
+            box.begin()
+            s:delete_range({1}, {4})
+            fiber.sleep(0.1)
+            box.commit()
+        end)
+        f:set_joinable(true)
+        fiber.yield()
+        t.assert_equals(s:get({1}), {1})
+        t.assert_equals(f:join(), true)
+        t.assert_equals(s:get({1}), nil)
+        t.assert_equals(s:count(), 7)
+        -- Conflicts: a transaction that read a key covered by
+        -- a committed range delete is aborted.
+        box.begin()
+        t.assert_equals(s:get({5}), {5})
+        f = fiber.new(function()
+            s:delete_range({5}, {6})
+        end)
+        f:set_joinable(true)
+        t.assert_equals(f:join(), true)
+        s:replace({5, 'x'})
+        t.assert_error_msg_content_equals(
+            "Transaction has been aborted by conflict", box.commit)
+        t.assert_equals(s:get({5}), nil)
+    end)
+end
+
+g.test_secondary = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        local sk = s:create_index('sk', {parts = {2, 'unsigned'}})
+        for i = 1, 20 do
+            s:replace({i, 100 + i})
+        end
+        box.snapshot()
+        s:delete_range({5}, {15})
+        local function check()
+            t.assert_equals(s:count(), 10)
+            t.assert_equals(sk:count(), 10)
+            t.assert_equals(sk:get(110), nil)
+            t.assert_equals(sk:get(120), {20, 120})
+            for _, tuple in sk:pairs() do
+                t.assert_equals(s:get(tuple[1]), tuple)
+            end
+        end
+        check()
+        box.snapshot()
+        check()
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().run_count, 1)
+        end)
+        -- Compaction of the primary index generates deferred DELETEs
+        -- for the secondary index.
+        t.helpers.retrying({}, function()
+            box.snapshot()
+            sk:compact()
+            t.assert_equals(sk:stat().run_count, 1)
+            t.assert_equals(sk:stat().disk.rows, 10)
+        end)
+        check()
+    end)
+end
+
+g.test_recovery = function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        for i = 1, 20 do
+            s:replace({i})
+        end
+        box.snapshot()
+        -- Dumped range tombstone.
+        s:delete_range({1}, {5})
+        box.snapshot()
+        -- Range tombstone in WAL.
+        s:delete_range({10}, {15})
+    end)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local function check()
+            t.assert_equals(s:count(), 11)
+            t.assert_equals(s:select({}, {limit = 2}), {{5}, {6}})
+            t.assert_equals(s:select({9}, {iterator = 'ge', limit = 2}),
+                            {{9}, {15}})
+        end
+        check()
+        box.snapshot()
+        check()
+    end)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s:count(), 11)
+        t.assert_equals(s:get({3}), nil)
+        t.assert_equals(s:get({12}), nil)
+    end)
+end
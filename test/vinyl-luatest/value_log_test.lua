@@ -0,0 +1,175 @@
+local common = require('test.vinyl-luatest.common')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = common.default_box_cfg(),
+    })
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_option = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Wrong index options (field 4): blob_threshold must be " ..
+            "greater than or equal to 0",
+            s.create_index, s, 'pk', {blob_threshold = -1})
+        local i = s:create_index('pk')
+        t.assert_equals(i.options.blob_threshold, nil)
+        i:alter({blob_threshold = 1000})
+        t.assert_equals(s.index.pk.options.blob_threshold, 1000)
+        t.assert_equals(box.space._index:get({s.id, i.id}).opts.
+                        blob_threshold, 1000)
+        i:alter({blob_threshold = 0})
+        t.assert_equals(s.index.pk.options.blob_threshold, nil)
+    end)
+end
+
+g.test_value_log = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local fio = require('fio')
+        -- Returns names of value log files of the given index.
+        local function blob_files(space_id, index_id)
+            local files = fio.glob(fio.pathjoin(box.cfg.vinyl_dir, space_id,
+                                                index_id, '*.blob'))
+            table.sort(files)
+            return files
+        end
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {blob_threshold = 1000})
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+        local function big(j, k)
+            return string.rep(string.format('%05d:%d;', j, k), 200)
+        end
+        for j = 1, 100 do
+            s:replace({j, j, j % 2 == 0 and big(j, 1) or 'small'})
+        end
+        box.snapshot()
+        t.assert_equals(#blob_files(s.id, 0), 1)
+        t.assert_equals(#blob_files(s.id, 1), 0)
+        -- Overwrite some big tuples, update secondary keys to
+        -- generate deferred DELETEs, and apply upserts to blobbed
+        -- tuples so that they have to be loaded from the value log.
+        for j = 1, 100, 3 do
+            s:replace({j, j + 1000, big(j, 2)})
+        end
+        for j = 2, 100, 5 do
+            s:upsert({j, j, big(j, 3)}, {{'+', 2, 2000}})
+        end
+        box.snapshot()
+        t.assert_equals(#blob_files(s.id, 0), 2)
+        local function check()
+            for j = 1, 100 do
+                local k = j
+                local v = j % 2 == 0 and big(j, 1) or 'small'
+                if j % 3 == 1 then
+                    k = j + 1000
+                    v = big(j, 2)
+                end
+                if j % 5 == 2 then
+                    k = k + 2000
+                end
+                local tuple = {j, k, v}
+                t.assert_equals(s:get(j), tuple)
+                t.assert_equals(s.index.sk:get(k), tuple)
+            end
+            t.assert_equals(s:count(), 100)
+            t.assert_equals(s.index.sk:count(), 100)
+        end
+        check()
+        local old = blob_files(s.id, 0)
+        s.index.pk:compact()
+        s.index.sk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().run_count, 1)
+            t.assert_equals(s.index.sk:stat().run_count, 1)
+        end)
+        check()
+        -- Compaction copies references so the old value log files
+        -- are still used. Only payloads of squashed upserts are
+        -- written to a new file.
+        local new = blob_files(s.id, 0)
+        t.assert_le(#new, #old + 1)
+        for _, f in ipairs(old) do
+            t.assert_items_include(new, {f})
+        end
+    end)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s:count(), 100)
+        t.assert_equals(#s.index.pk:select(), 100)
+        for _, tuple in s.index.pk:pairs() do
+            t.assert_equals(s.index.sk:get(tuple[2]), tuple)
+        end
+    end)
+end
+
+g.test_gc = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local fio = require('fio')
+        -- Returns names of value log files of the given index.
+        local function blob_files(space_id, index_id)
+            local files = fio.glob(fio.pathjoin(box.cfg.vinyl_dir, space_id,
+                                                index_id, '*.blob'))
+            table.sort(files)
+            return files
+        end
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local i = s:create_index('pk', {blob_threshold = 100})
+        for j = 1, 100 do
+            s:replace({j, string.rep('x', 1000)})
+        end
+        box.snapshot()
+        local old = blob_files(s.id, 0)
+        t.assert_equals(#old, 1)
+        -- Overwrite most of the payloads so that the old value log
+        -- file is mostly garbage and gets rewritten on compaction.
+        for j = 1, 80 do
+            s:replace({j, string.rep('y', 1000)})
+        end
+        box.snapshot()
+        i:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(i:stat().run_count, 1)
+        end)
+        -- The old file is removed once it isn't needed by checkpoints.
+        t.helpers.retrying({}, function()
+            box.snapshot()
+            local new = blob_files(s.id, 0)
+            t.assert_not_equals(new[1], old[1])
+        end)
+        t.assert_equals(s:count(), 100)
+        for j = 1, 100 do
+            t.assert_equals(s:get(j)[2],
+                            string.rep(j <= 80 and 'y' or 'x', 1000))
+        end
+        -- All value log files are removed after the space is dropped.
+        local id = s.id
+        s:drop()
+        box.snapshot()
+        t.helpers.retrying({}, function()
+            t.assert_equals(blob_files(id, 0), {})
+        end)
+    end)
+end